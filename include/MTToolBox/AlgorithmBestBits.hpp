@@ -42,6 +42,7 @@
 #include <tr1/memory>
 #endif
 #include <vector>
+#include <map>
 #include <MTToolBox/AlgorithmTempering.hpp>
 #include <MTToolBox/TemperingCalculatable.hpp>
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
@@ -163,6 +164,11 @@ namespace MTToolBox {
      * 態遷移関数で十分ビットミックスされていない場合、単純なテンパリン
      * グで均等分布次元を最大化することはできないだろう。
      *
+     * ビームの中のテンパリングパラメータから作るパターンは、シフトに
+     * よって書き換えられるビットや語の外に出るビットのために、しばしば
+     * 同じものになる。同じパターンの均等分布次元は一度だけ計算し、
+     * setMemoBudget() で決めた大きさまで覚えておく。
+     *
      * @tparam U 疑似乱数生成器の出力の型, 符号なし型であること、例えば uint32_t など。
      *\endjapanese
      *\english
@@ -178,6 +184,12 @@ namespace MTToolBox {
      * algorithm, you should consider changing the design of random
      * number generation algorithm.
      *
+     * Patterns made from tempering parameters in the beam are often
+     * identical, because of bits overwritten by shifts and bits out
+     * of the word. Dimensions of equi-distribution of the same
+     * pattern are calculated only once, and remembered up to the size
+     * set by setMemoBudget().
+     *
      * @tparam U type of output of pseudo random number generator.
      * Should be unsigned type.
      *\endenglish
@@ -239,6 +251,10 @@ namespace MTToolBox {
             for (int i = 0; i < size; i++) {
                 shifts[i] = shift_values[i];
             }
+            memoBudget = 16 * 1024 * 1024;
+            memoBytes = 0;
+            memoHits = 0;
+            memoMisses = 0;
         }
 
         /**
@@ -300,9 +316,26 @@ namespace MTToolBox {
             for (int p = 0; p < limit; p++) {
                 vector<shared_ptr<tempp> > current;
                 current.clear();
-                for (unsigned int i = 0; i < params.size(); i++) {
-                    search_best_temper(rand, p, *params[i],
-                                       current, verbose);
+                // 前のビットの結果は二度と使わない
+                clearMemo();
+                bool cancelled = false;
+                try {
+                    for (unsigned int i = 0; i < params.size(); i++) {
+                        if (is_cancelled(this->cancel)) {
+                            throw Cancelled();
+                        }
+                        search_best_temper(rand, p, *params[i],
+                                           current, verbose);
+                    }
+                } catch (Cancelled&) {
+                    cancelled = true;
+                }
+                // 途中で打ち切ったら、前のビットまでの結果を使う
+                if (cancelled) {
+                    if (verbose) {
+                        cout << "cancelled at bit " << dec << p << endl;
+                    }
+                    break;
                 }
                 delta = rand.bitSize() * obSize;
                 for (unsigned int i = 0; i < current.size(); i++) {
@@ -333,9 +366,61 @@ namespace MTToolBox {
                 cout << "delta = " << dec << delta << endl;
             }
             rand.resetReverseOutput();
+            clearMemo();
             return 0;
         }
 
+        /**
+         *\japanese
+         * 均等分布次元を覚えておくメモリの上限を設定する。
+         *
+         * 上限に達したら、そのビットの探索の間は新しい結果を覚えない。
+         * 覚えた結果はビットごと、operator() の呼び出しごとに捨てる。
+         * @param[in] bytes 上限のバイト数、0 なら覚えない
+         *\endjapanese
+         *
+         *\english
+         * Sets the upper limit of memory remembering dimensions of
+         * equi-distribution.
+         *
+         * When the limit is reached, new results are not remembered
+         * while searching the bit. Remembered results are discarded
+         * for each bit and for each call of operator().
+         * @param[in] bytes upper limit in bytes, 0 not to remember
+         *\endenglish
+         */
+        void setMemoBudget(size_t bytes) {
+            memoBudget = bytes;
+        }
+
+        /**
+         *\japanese
+         * @return 覚えた結果を使った回数、インスタンスを作ってからの和
+         *\endjapanese
+         *
+         *\english
+         * @return number of times remembered results were used, summed
+         * from construction
+         *\endenglish
+         */
+        long getMemoHits() const {
+            return memoHits;
+        }
+
+        /**
+         *\japanese
+         * @return 均等分布次元を計算した回数、インスタンスを作ってからの和
+         *\endjapanese
+         *
+         *\english
+         * @return number of times dimensions of equi-distribution were
+         * calculated, summed from construction
+         *\endenglish
+         */
+        long getMemoMisses() const {
+            return memoMisses;
+        }
+
         /**
          *\japanese
          * LSBからのテンパリングかを示す。常にfalse。
@@ -356,6 +441,45 @@ namespace MTToolBox {
         int obSize;
         int * shifts;
         int num_pat;
+        std::map<std::vector<U>, int> memo;
+        size_t memoBudget;
+        size_t memoBytes;
+        long memoHits;
+        long memoMisses;
+
+        void clearMemo() {
+            memo.clear();
+            memoBytes = 0;
+        }
+
+        /*
+         * ビットの探索の間は評価するビット長が一定なので、キーは
+         * パラメータの配列だけでよい。
+         */
+        int memo_equidist(TemperingCalculatable<U>& rand,
+                          const tempp& pattern, int bit_length) {
+            std::vector<U> key(pattern.param, pattern.param + size);
+            typename std::map<std::vector<U>, int>::iterator it
+                = memo.find(key);
+            if (it != memo.end()) {
+                memoHits++;
+                return it->second;
+            }
+            memoMisses++;
+            U mask = 0;
+            mask = ~mask;
+            for (int j = 0; j < size; j++) {
+                rand.setTemperingPattern(mask, pattern.param[j], j);
+            }
+            int delta = get_equidist(rand, bit_length);
+            // 木のノードと配列の分をおおまかに見積もる
+            size_t bytes = sizeof(U) * key.size() + 96;
+            if (memoBytes + bytes <= memoBudget) {
+                memo[key] = delta;
+                memoBytes += bytes;
+            }
+            return delta;
+        }
 
         /**
          *\japanese
@@ -376,8 +500,6 @@ namespace MTToolBox {
                                 vector<shared_ptr<tempp> >& current,
                                 bool verbose) {
             int delta = rand.bitSize() * obSize;
-            U mask = 0;
-            mask = ~mask;
             // size が 2 なら 111, 110, 101, 100, 011, 010, 001, 000 の8パターン
             num_pat = size * (size + 1) / 2;
             for (int32_t i = (1 << num_pat) -1; i >= 0; i--) {
@@ -389,10 +511,7 @@ namespace MTToolBox {
 #if defined(DEBUG)
                 cout << "pattern:" << pattern->toString() << endl;
 #endif
-                for (int j = 0; j < size; j++) {
-                    rand.setTemperingPattern(mask, pattern->param[j], j);
-                }
-                pattern->delta = get_equidist(rand, v_bit + 1);
+                pattern->delta = memo_equidist(rand, *pattern, v_bit + 1);
                 if (verbose) {
                     cout << "pattern->delta:" << dec << pattern->delta << endl;
                 }
@@ -424,6 +543,7 @@ namespace MTToolBox {
         int get_equidist(TemperingCalculatable<U>& rand,
                          int bit_length) {
             AlgorithmEquidistribution<U> sb(rand, bit_length);
+            sb.setCancellation(this->cancel);
             int veq[bit_length];
             return sb.get_all_equidist(veq);
         }
@@ -62,12 +62,14 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <iostream>
+#include <vector>
 #include <inttypes.h>
 #include <NTL/GF2X.h>
 #include <NTL/vec_GF2.h>
 #include <NTL/mat_GF2.h>
 #include <MTToolBox/ReducibleGenerator.hpp>
 #include <MTToolBox/util.hpp>
+#include <MTToolBox/Parallel.hpp>
 
 namespace MTToolBox {
     using namespace std;
@@ -91,9 +93,32 @@ namespace MTToolBox {
     class AlgorithmCalculateParity {
 
     public:
+        /**
+         *\japanese
+         * コンストラクタ
+         * @param[in] threads 単位ベクトルの殲滅を並列に行うスレッド数
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         * @param[in] threads number of threads which annihilate unit
+         * vectors concurrently.
+         *\endenglish
+         */
+        AlgorithmCalculateParity(int threads = 1) {
+            if (threads < 1) {
+                threads = 1;
+            }
+            this->threads = threads;
+            word_width = 0;
+        }
+
         /**
          *\japanese
          * qによってannihilateされる空間の基底を求め、パリティチェック用の定数を求める
+         *
+         * 単位ベクトルを threads 個のスレッドで並列に殲滅し、その結果を
+         * ビット位置の順に基底に加えるので、結果はスレッド数によらない。
          * @param[in] g 可約ジェネレータ
          * @param[in] f mexp次数の既約因子
          * @return パリティチェック用の定数
@@ -102,6 +127,11 @@ namespace MTToolBox {
          *\english
          * calculate the basis of subspace annihilated by q, and get the
          * period certification vector (parity vector).
+         *
+         * Unit vectors are annihilated in parallel by threads threads,
+         * and the results are added to the basis in the order of bit
+         * positions, so the result does not depend on the number of
+         * threads.
          * @param[in] g reducible generator
          * @param[in] f large irreducible factor of characteristic polynomial.
          * @return the period certification vector (parity vector)
@@ -116,51 +146,57 @@ namespace MTToolBox {
             int maxdegree = g.bitSize();
             word_width = bit_size<U>();
             int base_num = maxdegree - mexp;
-            internal_state bases[word_width];
-            internal_state work_base;
-            int count;
-            int bit_pos = 0;
-
+            std::vector<internal_state> bases(
+                static_cast<size_t>(word_width));
             for (int i = 0; i < word_width; i++) {
-                bases[i].rg = new G(g);
-                bases[i].rg->setZero();
+                bases[i].rg = NULL;
                 bases[i].zero = true;
                 setZero(bases[i].next);
             }
-            work_base.rg = new G(g);
-            work_base.rg->setZero();
-            work_base.zero = true;
-            setZero(work_base.next);
-#if defined(DEBUG)
-            cout << "searchParity before while loop" << endl;
-            cout << "word_width = " << word_width << endl;
-            cout << "bit_pos = " << bit_pos << endl;
-            cout << "maxdegree = " << maxdegree << endl;
-            cout << "base_num = " << base_num << endl;
-#endif
-            while(bit_pos < maxdegree) {
-                calc_basis(work_base, f, &bit_pos);
-                addBase(bases, word_width, work_base);
-                count = 0;
-                for (int i = 0; i < word_width; i++) {
-                    if (!isZero(bases[i].next)) {
+            std::vector<char> coefficients(
+                static_cast<size_t>(deg(f) + 1));
+            for (long i = 0; i <= deg(f); i++) {
+                coefficients[static_cast<size_t>(i)]
+                    = static_cast<char>(!IsZero(coeff(f, i)));
+            }
+            AnnihilateJob job(*this, g, threads, maxdegree, coefficients);
+            int count = 0;
+            if (threads == 1) {
+                for (int bit_pos = 0;
+                     bit_pos < maxdegree && count < base_num; bit_pos++) {
+                    slot& s = job.annihilate(0, bit_pos);
+                    if (!s.st.zero && addBase(bases, s.st)) {
                         count++;
                     }
                 }
-#if defined(DEBUG)
-                cout << "in while loop count = " << count << endl;
-#endif
-                if (count >= base_num) {
-                    break;
+            } else {
+                WorkerPool pool;
+                try {
+                    pool.start(job, threads);
+                    for (int bit_pos = 0;
+                         bit_pos < maxdegree && count < base_num;
+                         bit_pos++) {
+                        slot * s = job.take(bit_pos);
+                        if (s == NULL) {
+                            break;
+                        }
+                        if (!s->st.zero && addBase(bases, s->st)) {
+                            count++;
+                        }
+                        job.release(bit_pos);
+                    }
+                } catch (...) {
+                    job.stop();
+                    pool.join();
+                    throw;
                 }
+                job.stop();
+                pool.join();
+                job.rethrow();
             }
 #if defined(DEBUG)
-            cout << "searchParity after while loop" << endl;
-#endif
-            for (int i = 0; i < word_width; i++) {
-                delete bases[i].rg;
-            }
-#if defined(DEBUG)
+            cout << "searchParity after while loop count = " << count
+                 << endl;
             cout << "----" << endl;
             for (int i = 0; i < word_width; i++) {
                 if (isZero(bases[i].next)) {
@@ -173,7 +209,10 @@ namespace MTToolBox {
             }
             cout << "----" << endl;
 #endif
-            U parity = search_parity_check_vector(bases, base_num);
+            for (int i = 0; i < word_width; i++) {
+                delete bases[i].rg;
+            }
+            U parity = search_parity_check_vector(&bases[0], base_num);
             g.setParityValue(parity);
             return parity;
         }
@@ -186,55 +225,152 @@ namespace MTToolBox {
             G * rg;
         };
 
-        int word_width;
+        /*
+         * 単位ベクトルを殲滅した結果。st.rg に足し込むための walker を
+         * 単位ベクトルから進める。
+         */
+        struct slot {
+            internal_state st;
+            G * walker;
+        };
 
-        /**
-         *\japanese
-         * q によって殲滅される部分空間の基底を求める。
-         * @param[in/out] st 基底を構成するひとつのベクトル
-         * @param[in] f mexp次数の既約因子
-         * @param[in/out] bit_pos 状態空間内のビット位置
-         *\endjapanese
+        /*
+         * 単位ベクトルを f で殲滅し、次の非ゼロ値までセットする。
          *
-         *\english
-         *\endenglish
+         * ワーカーは共有のカウンタから次のビット位置を取り、結果を
+         * ビット位置を窓の大きさで割った余りの slot に置く。取り出す側は
+         * take() と release() でビット位置の順に結果を受け取るので、
+         * 結果はスレッド数によらない。取り出されていない結果が窓を
+         * 埋めたら、ワーカーは待つ。slot の生成器は最初に使うワーカーが
+         * 確保するので、WorkerPool::setPinning() でスレッドが固定されて
+         * いれば、そのノードのメモリに置かれる。
          */
-        void calc_basis(internal_state& st, const NTL::GF2X& f, int *bit_pos) {
-#if defined(DEBUG)
-            cout << "calc_basis start bit_pos = " << dec << *bit_pos << endl;
-#endif
-            int maxdegree = st.rg->bitSize();
-            for (;*bit_pos < maxdegree;) {
-#if defined(DEBUG)
-                cout << "in calc_basis bit_pos = " << dec << *bit_pos << endl;
-#endif
-                // 全状態空間の中で1ビットだけ1を立てる
-                st.rg->setOneBit(*bit_pos);
-#if defined(DEBUG)
-                if (st.rg->isZero()) {
-                    cout << "ERROR rg is ZERO" << endl;
+        class AnnihilateJob : public Runnable {
+        public:
+            AnnihilateJob(AlgorithmCalculateParity& owner,
+                          const G& prototype, int threads, int limit,
+                          const std::vector<char>& coefficients)
+                : owner(owner), prototype(prototype),
+                  coefficients(coefficients), changed(mutex) {
+                window = 2 * threads;
+                this->limit = limit;
+                slots.resize(static_cast<size_t>(window));
+                ready.assign(static_cast<size_t>(window), 0);
+                for (int i = 0; i < window; i++) {
+                    slots[i].st.rg = NULL;
+                    slots[i].walker = NULL;
                 }
-#endif
-                (*bit_pos)++;
-                // fによる写像でfのカーネルの像を0にする
-                annihilate(st.rg, f);
-#if defined(DEBUG)
-                if (st.rg->isZero()) {
-                    cout << "ZERO after annihilate" << endl;
-                    cout << "deg(f) = " << deg(f) << endl;
-                } else {
-                    cout << "NON ZERO after annihilate" << endl;
+                next = 0;
+                consumed = 0;
+                stopped = false;
+            }
+
+            ~AnnihilateJob() {
+                for (int i = 0; i < window; i++) {
+                    delete slots[i].st.rg;
+                    delete slots[i].walker;
                 }
-#endif
-                set_state(st);
-                if (!st.zero) {
-                    break;
+            }
+
+            void run(int) {
+                try {
+                    for (;;) {
+                        int bit_pos;
+                        {
+                            ScopedLock lock(mutex);
+                            while (!stopped && next < limit
+                                   && next - consumed >= window) {
+                                changed.wait();
+                            }
+                            if (stopped || next >= limit) {
+                                return;
+                            }
+                            bit_pos = next++;
+                        }
+                        annihilate(bit_pos % window, bit_pos);
+                        ScopedLock lock(mutex);
+                        ready[static_cast<size_t>(bit_pos % window)] = 1;
+                        changed.broadcast();
+                    }
+                } catch (...) {
+                    error.capture();
+                    stop();
                 }
             }
-#if defined(DEBUG)
-            cout << "calc_basis end bit_pos = " << dec << *bit_pos << endl;
-#endif
-        }
+
+            /*
+             * bit_pos 番目の単位ベクトルを index 番目の slot で殲滅する。
+             */
+            slot& annihilate(int index, int bit_pos) {
+                slot& s = slots[static_cast<size_t>(index)];
+                if (s.walker == NULL) {
+                    s.st.rg = new G(prototype);
+                    s.walker = new G(prototype);
+                }
+                s.walker->setOneBit(bit_pos);
+                s.st.rg->setZero();
+                for (size_t j = 0; j < coefficients.size(); j++) {
+                    if (coefficients[j]) {
+                        s.st.rg->add(*s.walker);
+                    }
+                    s.walker->generate();
+                }
+                owner.set_state(s.st);
+                return s;
+            }
+
+            /*
+             * bit_pos 番目の結果を待つ。止められたら NULL を返す。
+             */
+            slot * take(int bit_pos) {
+                size_t index = static_cast<size_t>(bit_pos % window);
+                ScopedLock lock(mutex);
+                while (!stopped && !ready[index]) {
+                    changed.wait();
+                }
+                if (!ready[index]) {
+                    return NULL;
+                }
+                return &slots[index];
+            }
+
+            /*
+             * bit_pos 番目の結果の slot を空ける。
+             */
+            void release(int bit_pos) {
+                ScopedLock lock(mutex);
+                ready[static_cast<size_t>(bit_pos % window)] = 0;
+                consumed = bit_pos + 1;
+                changed.broadcast();
+            }
+
+            void stop() {
+                ScopedLock lock(mutex);
+                stopped = true;
+                changed.broadcast();
+            }
+
+            void rethrow() {
+                error.rethrow();
+            }
+        private:
+            AlgorithmCalculateParity& owner;
+            const G& prototype;
+            const std::vector<char>& coefficients;
+            std::vector<slot> slots;
+            std::vector<char> ready;
+            int window;
+            int limit;
+            int next;
+            int consumed;
+            bool stopped;
+            Mutex mutex;
+            Condition changed;
+            FirstError error;
+        };
+
+        int word_width;
+        int threads;
 
         /**
          *\japanese
@@ -248,15 +384,9 @@ namespace MTToolBox {
          *\endenglish
          */
         void set_state(internal_state& st) {
-#if defined(DEBUG)
-            cout << "set_state start" << endl;
-#endif
             if (st.rg->isZero()) {
                 st.zero = true;
                 setZero(st.next);
-#if defined(DEBUG)
-                cout << "set_state end zero" << endl;
-#endif
                 return;
             }
             st.zero = false;
@@ -270,10 +400,6 @@ namespace MTToolBox {
                 st.rg->generate();
                 st.next = st.rg->getParityValue();
             }
-#if defined(DEBUG)
-            cout << "set_state end parity = "
-                 << hex << setfill('0') << setw(8) << st.next << dec << endl;
-#endif
         }
 
         /**
@@ -316,60 +442,51 @@ namespace MTToolBox {
          *\japanese
          * 基底となるべき集合に、基底候補を加える
          * Mulders and Storjohann アルゴリズムの変種
-         * @param[in/out] bases 基底
-         * @param[in] size bases の大きさ
+         *
+         * 基底の生成器は、はじめて非ゼロになるときに候補の複製として作る。
+         * @param[in/out] bases 基底、word_width 個
          * @param[in/out] work 基底に追加される候補となるベクトル
+         * @return 基底が一つ増えたら true
          *\endjapanese
          *
          *\english
          * add a candidate vector to set of vectors which will be
          * basis in the end.
          * variant of Mulders and Storjohann Algorithm
-         * @param[in/out] bases basis
-         * @param[in] size size of bases
+         *
+         * The generator of a basis vector is made as a copy of the
+         * candidate when it becomes nonzero for the first time.
+         * @param[in/out] bases basis of word_width vectors
          * @param[in/out] work a candidate vector to be a member of basis
+         * @return true if a basis vector is added
          *\endenglish
          */
-        void addBase(internal_state bases[], int size, internal_state& work) {
-#if defined(DEBUG)
-            cout << "addBase start" << endl;
-#endif
+        bool addBase(std::vector<internal_state>& bases,
+                     internal_state& work) {
             int count = bit_size<U>() * 10;
             for (;count >= 0;) {
                 count--;
-#if defined(DEBUG)
-                cout << "addBase work.next = " << hex << work.next << endl;
-#endif
                 if (isZero(work.next)) {
                     get_next_state(work);
                     if (work.zero) {
-#if defined(DEBUG)
-                        cout << "addBase end work.zero" << endl;
-#endif
-                        return;
+                        return false;
                     }
                 }
                 int pivot = calc_1pos(work.next);
-#if defined(DEBUG)
-                cout << "addBase pivot = " << dec << pivot << endl;
-#endif
-                if (pivot >= size) {
+                if (pivot >= word_width) {
                     cout << "pivot > size error pivot = " << dec << pivot
-                         << " size = " << dec << size << endl;
+                         << " size = " << dec << word_width << endl;
                     throw "pivot > size error";
                 }
-                if (isZero(bases[pivot].next)) {
-                    add_state(bases[pivot], work);
-#if defined(DEBUG)
-                    cout << "addBase end next == 0" << endl;
-#endif
-                    return;
+                internal_state& base = bases[static_cast<size_t>(pivot)];
+                if (isZero(base.next)) {
+                    base.rg = new G(*work.rg);
+                    base.next = work.next;
+                    return true;
                 }
-                add_state(work, bases[pivot]);
+                add_state(work, base);
             }
-#if defined(DEBUG)
-            cout << "addBase end" << endl;
-#endif
+            return false;
         }
 
         /**
@@ -49,6 +49,7 @@
 #endif // cplusplus version
 #include <stdexcept>
 #include <MTToolBox/EquidistributionCalculatable.hpp>
+#include <MTToolBox/Cancellation.hpp>
 #include <MTToolBox/period.hpp>
 #include <MTToolBox/util.hpp>
 
@@ -144,9 +145,8 @@ namespace MTToolBox {
          */
         linear_generator_vector<U>(const ECGenerator& generator,
                                    int bit_pos) {
-            shared_ptr<ECGenerator> r(generator.clone());
+            shared_ptr<ECGenerator> r(generator.cloneZero());
             rand = r;
-            rand->setZero();
             count = 0;
             zero = false;
             next = getOne<U>() << (bit_size<U>() - bit_pos - 1);
@@ -294,6 +294,7 @@ namespace MTToolBox {
                                   int mexp = 0) {
             bit_len = bit_length;
             size = bit_len + 1;
+            cancel = NULL;
             basis = new linear_vec * [static_cast<unsigned long>(size)];
             if (mexp == 0) {
                 stateBitSize = rand.bitSize();
@@ -324,6 +325,28 @@ namespace MTToolBox {
 
         int get_all_equidist(int veq[]);
         int get_equidist(int *sum_equidist);
+
+        /**
+         *\japanese
+         * 打ち切りの指示を設定する。
+         *
+         * 設定すると、get_all_equidist() と get_equidist() は計算の
+         * 途中で指示を調べ、打ち切るべきなら Cancelled を投げる。
+         * @param[in] token 打ち切りの指示、NULL なら打ち切らない
+         *\endjapanese
+         *
+         *\english
+         * Sets the direction of cancellation.
+         *
+         * If set, get_all_equidist() and get_equidist() check the
+         * direction during calculation, and throw Cancelled if they
+         * should be cancelled.
+         * @param[in] token direction of cancellation, NULL not to cancel
+         *\endenglish
+         */
+        void setCancellation(const CancellationToken * token) {
+            cancel = token;
+        }
     private:
         int get_equidist_main(int bit_len);
         void adjust(int new_len);
@@ -377,6 +400,17 @@ namespace MTToolBox {
          *\endenglish
          */
         int size;
+
+        /**
+         *\japanese
+         * 打ち切りの指示、NULL なら打ち切らない
+         *\endjapanese
+         *
+         *\english
+         * Direction of cancellation, NULL not to cancel.
+         *\endenglish
+         */
+        const CancellationToken * cancel;
     };
 
     /**
@@ -616,9 +650,14 @@ namespace MTToolBox {
         int bit_len = v;
         int pivot_index;
         int old_pivot = 0;
+        unsigned int polls = 0;
 
         pivot_index = calc_1pos(basis[bit_len]->next);
         while (!basis[bit_len]->zero) {
+            // 時計を読む回数を減らすため 64 回に 1 回だけ調べる
+            if (cancel != NULL && (++polls & 0x3f) == 0) {
+                cancel->throwIfCancelled();
+            }
 #if defined(DEBUG)
             if (pivot_index == -1) {
                 cout << "pivot_index = " << dec << pivot_index << endl;
@@ -0,0 +1,298 @@
+#ifndef MTTOOLBOX_ALGORITHM_FIELD_EQUIDISTRIBUTION_HPP
+#define MTTOOLBOX_ALGORITHM_FIELD_EQUIDISTRIBUTION_HPP
+/**
+ * @file AlgorithmFieldEquidistribution.hpp
+ *
+ *\japanese
+ * @brief 出力の一部のビット列の均等分布次元の計算
+ *
+ * dSFMT の出力は 128 ビットに二つの倍精度浮動小数点数を含み、
+ * 意味のあるビットは各 64 ビットの下位 52 ビットの仮数部である。
+ * このような生成器では、出力をいくつかのレーンに分け、各レーンの
+ * 決まった位置のビット列 (フィールド) を一つの出力として並べた列の
+ * 均等分布次元を求めたい。
+ *
+ * 生成器の状態 g から出力を一度だけ生成してフィールドの各ビットの列を
+ * 詰めて記録し、出力行列の階数から k(v) を求める。T<sup>j</sup>g から
+ * t 回目の出力は g から t + j 回目の出力なので、Krylov 基底
+ * g, Tg, ..., T<sup>n-1</sup>g に関する出力行列の各行は、記録した
+ * ビット列の窓として得られる。フィールドの取り出しは記録のときに一度だけ行うので、
+ * 計算の手間は整数を出力する生成器と変わらない。一回の出力に
+ * 複数のフィールドがあるので、どのレーンから数え始めても均等分布
+ * するように、k(v) は開始レーンについての最小値とする。
+ *
+ * 状態空間が数千ビット程度までの生成器を想定している。
+ *\endjapanese
+ *
+ *\english
+ * @brief Calculation of dimension of equidistribution of bit fields
+ * of outputs
+ *
+ * An output of dSFMT contains two double precision floating point
+ * numbers in 128 bits, and the meaningful bits are the 52-bit
+ * mantissa in the lower bits of each 64 bits. For such generators,
+ * we want dimension of equidistribution of the sequence in which
+ * outputs are divided into lanes and the bit string at a fixed
+ * position of each lane (field) is treated as one output.
+ *
+ * Outputs are generated only once from the state g of the generator,
+ * sequences of each bit of fields are recorded in packed form, and
+ * k(v) is calculated from rank of the output matrix. The t-th output
+ * from T<sup>j</sup>g is the (t + j)-th output from g, so each row of
+ * the output matrix with respect to the Krylov basis g, Tg, ...,
+ * T<sup>n-1</sup>g is a window of the recorded bit sequences. Fields are
+ * extracted only once when recording, so the calculation costs the
+ * same as generators which output integers. As one output contains
+ * several fields, k(v) is the minimum over the starting lane, so that
+ * the sequence is equidistributed from any lane.
+ *
+ * This is intended for generators whose internal state is up to a
+ * few thousand bits.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <vector>
+#include <stdexcept>
+#include <MTToolBox/EquidistributionCalculatable.hpp>
+#include <MTToolBox/GF2Echelon.hpp>
+#include <MTToolBox/util.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class AlgorithmFieldEquidistribution
+     *\japanese
+     * @brief 出力のフィールドの均等分布次元を出力行列の階数によって
+     * 計算する
+     *
+     * 生成器の状態は n 次元の巡回部分空間になければならない。すなわち
+     * 状態の最小多項式の次数が n であること。可約な生成器では、
+     * AlgorithmEquidistribution と同様に、n にメルセンヌ指数を指定し、
+     * 状態を既約成分に落としてから使うこと。
+     *
+     * @tparam U 疑似乱数生成器の出力の型
+     *\endjapanese
+     *
+     *\english
+     * @brief Calculates dimension of equidistribution of fields of
+     * outputs by rank of output matrix
+     *
+     * The state of the generator should lie in a cyclic subspace of
+     * dimension n, that is, degree of the minimal polynomial of the
+     * state should be n. For reducible generators, as
+     * AlgorithmEquidistribution, specify the Mersenne exponent as n
+     * and reduce the state to the irreducible component beforehand.
+     *
+     * @tparam U type of output of pseudo random number generator
+     *\endenglish
+     */
+    template<typename U>
+    class AlgorithmFieldEquidistribution {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         *
+         * 出力を lanes 個のレーンに分け、各レーンの field_top ビット目
+         * から下へ field_width ビットをフィールドとする。ビットの位置は
+         * getBitOfPos() と同じく最下位ビットを 0 とし、レーン l は
+         * 出力の l * (bit_size<U>() / lanes) ビット目から始まる。
+         * 出力は generate() で得るので、rand は出力をビット反転する
+         * 設定になっていてはならない。rand 自身は変更しない。
+         *
+         * dSFMT の仮数部なら lanes = 2, field_top = 51,
+         * field_width = 52 である。
+         * @param[in] rand 疑似乱数生成器
+         * @param[in] lanes 一回の出力のレーンの数
+         * @param[in] field_top レーンの中のフィールドの最上位ビットの位置
+         * @param[in] field_width フィールドのビット数
+         * @param[in] mexp 状態空間の次元 n、0 なら rand.bitSize()
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         *
+         * Outputs are divided into \b lanes lanes, and field_width bits
+         * downward from the field_top-th bit of each lane is the
+         * field. As getBitOfPos(), bit positions count from 0 at LSB,
+         * and lane l starts at the l * (bit_size<U>() / lanes)-th bit
+         * of the output. Outputs are obtained by generate(), so rand
+         * should not be set to reverse bits of outputs. rand itself
+         * is not changed.
+         *
+         * For mantissa of dSFMT, lanes = 2, field_top = 51 and
+         * field_width = 52.
+         * @param[in] rand pseudo random number generator
+         * @param[in] lanes number of lanes in one output
+         * @param[in] field_top position of the most significant bit of
+         * the field in a lane
+         * @param[in] field_width number of bits of the field
+         * @param[in] mexp dimension n of the state space, if 0,
+         * rand.bitSize() is used.
+         *\endenglish
+         */
+        AlgorithmFieldEquidistribution(
+            const EquidistributionCalculatable<U>& rand,
+            int lanes, int field_top, int field_width, int mexp = 0) {
+            if (lanes <= 0 || bit_size<U>() % lanes != 0) {
+                throw std::invalid_argument("bad lanes");
+            }
+            int lane_width = bit_size<U>() / lanes;
+            if (field_top < 0 || field_top >= lane_width
+                || field_width <= 0 || field_width > field_top + 1) {
+                throw std::invalid_argument("bad field");
+            }
+            this->lanes = lanes;
+            width = field_width;
+            if (mexp == 0) {
+                stateBitSize = rand.bitSize();
+            } else {
+                stateBitSize = mexp;
+            }
+            // k(1) <= n なので、出力は n / lanes + 1 回目まで窓の先頭になる
+            length = stateBitSize + stateBitSize / lanes + 2;
+            size_t w = static_cast<size_t>(length / 64 + 2);
+            sequence.assign(static_cast<size_t>(lanes * width),
+                            std::vector<uint64_t>(w, 0));
+            // フィールドの各ビットの出力の中の位置を先に求めておく
+            std::vector<int> pos(static_cast<size_t>(lanes * width));
+            for (int l = 0; l < lanes; l++) {
+                for (int b = 0; b < width; b++) {
+                    pos[static_cast<size_t>(l * width + b)]
+                        = l * lane_width + field_top - b;
+                }
+            }
+            EquidistributionCalculatable<U> * g = rand.clone();
+            for (int i = 0; i < length; i++) {
+                U x = g->generate();
+                uint64_t mask = UINT64_C(1) << (i % 64);
+                size_t word = static_cast<size_t>(i / 64);
+                for (size_t j = 0; j < pos.size(); j++) {
+                    if (getBitOfPos(x, pos[j])) {
+                        sequence[j][word] |= mask;
+                    }
+                }
+            }
+            delete g;
+        }
+
+        /**
+         *\japanese
+         * v ビット精度の均等分布次元 k(v) を返す。k はフィールドの個数で
+         * 数える。
+         * @param[in] v 精度
+         * @return k(v)
+         *\endjapanese
+         *
+         *\english
+         * Returns dimension of equidistribution with v-bit accuracy
+         * k(v). k counts fields.
+         * @param[in] v accuracy
+         * @return k(v)
+         *\endenglish
+         */
+        int get_equidist_v(int v) const {
+            if (v <= 0 || v > width) {
+                throw std::invalid_argument("bad v");
+            }
+            return equidist(v, stateBitSize / v);
+        }
+
+        /**
+         *\japanese
+         * 1 から field_width までのすべての v について k(v) を求める。
+         * @param[out] veq k(v) の配列、veq[v - 1] が k(v)
+         * @return 理論的上限との差の総和
+         *\endjapanese
+         *
+         *\english
+         * Calculates k(v) for all v from 1 to field_width.
+         * @param[out] veq array of k(v), veq[v - 1] is k(v)
+         * @return sum of differences from theoretical upper bounds
+         *\endenglish
+         */
+        int get_all_equidist(int veq[]) const {
+            int sum = 0;
+            int limit = stateBitSize;
+            for (int v = 1; v <= width; v++) {
+                if (limit > stateBitSize / v) {
+                    limit = stateBitSize / v;
+                }
+                veq[v - 1] = equidist(v, limit);
+                limit = veq[v - 1];
+                sum += stateBitSize / v - veq[v - 1];
+            }
+            return sum;
+        }
+    private:
+        int lanes;
+        int width;
+        int stateBitSize;
+        int length;
+        std::vector<std::vector<uint64_t> > sequence;
+
+        /*
+         * 開始レーンについての k(v) の最小値を求める。小さい値が
+         * 見つかれば、それを以降の開始レーンの limit にする。
+         */
+        int equidist(int v, int limit) const {
+            for (int start = 0; start < lanes && limit > 0; start++) {
+                limit = equidist_from(v, limit, start);
+            }
+            return limit;
+        }
+
+        /*
+         * start 番目のレーンから数えた k(v) を求める。j 番目の
+         * フィールドは (start + j) / lanes 回目の出力の
+         * (start + j) % lanes 番目のレーンにある。
+         */
+        int equidist_from(int v, int limit, int start) const {
+            GF2Echelon echelon(stateBitSize);
+            std::vector<uint64_t> row(
+                static_cast<size_t>((stateBitSize + 63) / 64));
+            int k = 0;
+            while (k < limit) {
+                int f = start + k;
+                for (int b = 0; b < v; b++) {
+                    window(row, (f % lanes) * width + b, f / lanes);
+                    if (!echelon.add(&row[0])) {
+                        return k;
+                    }
+                }
+                k++;
+            }
+            return k;
+        }
+
+        /*
+         * c 番目のビットの列の t 項目から n 項を取り出す。
+         */
+        void window(std::vector<uint64_t>& row, int c, int t) const {
+            const std::vector<uint64_t>& s = sequence[static_cast<size_t>(c)];
+            int shift = t % 64;
+            size_t base = static_cast<size_t>(t / 64);
+            for (size_t i = 0; i < row.size(); i++) {
+                uint64_t x = s[base + i] >> shift;
+                if (shift != 0) {
+                    x |= s[base + i + 1] << (64 - shift);
+                }
+                row[i] = x;
+            }
+            int rest = stateBitSize % 64;
+            if (rest != 0) {
+                row[row.size() - 1] &= (UINT64_C(1) << rest) - 1;
+            }
+        }
+    };
+}
+#endif // MTTOOLBOX_ALGORITHM_FIELD_EQUIDISTRIBUTION_HPP
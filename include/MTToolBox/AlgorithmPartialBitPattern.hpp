@@ -150,6 +150,9 @@ namespace MTToolBox {
                     max_depth = try_bit_len;
                 }
                 for (int i = 0; i < param_num; i++) {
+                    if (is_cancelled(this->cancel)) {
+                        break;
+                    }
                     delta = search_best_temper(rand, p, i, max_depth, verbose);
                 }
             }
@@ -250,7 +253,12 @@ namespace MTToolBox {
                     pattern = static_cast<U>(i) << (bit_len - v_bit - size);
                 }
                 make_temper_bit(rand, mask, param_pos, pattern);
-                delta = get_equidist(rand, bit_len);
+                try {
+                    delta = get_equidist(rand, bit_len);
+                } catch (Cancelled&) {
+                    // 計算済みのパターンのうち最良のものを使う
+                    break;
+                }
                 if (delta < min_delta) {
                     if (verbose) {
                         cout << "pattern change " << hex << min_pattern
@@ -298,6 +306,7 @@ namespace MTToolBox {
         int get_equidist(TemperingCalculatable<U>& rand,
                          int bit_length) {
             AlgorithmEquidistribution<U> sb(rand, bit_length);
+            sb.setCancellation(this->cancel);
             int veq[bit_length];
             int sum = sb.get_all_equidist(veq);
             return sum;
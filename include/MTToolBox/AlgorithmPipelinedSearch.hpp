@@ -0,0 +1,619 @@
+#ifndef MTTOOLBOX_ALGORITHM_PIPELINED_SEARCH_HPP
+#define MTTOOLBOX_ALGORITHM_PIPELINED_SEARCH_HPP
+/**
+ * @file AlgorithmPipelinedSearch.hpp
+ *
+ *\japanese
+ * @brief 状態遷移パラメータとテンパリングパラメータの探索をパイプライン
+ * で並列に行う
+ *
+ * AlgorithmRecursionAndTempering と同じ探索を、
+ * 候補生成、最小多項式、原始性判定、テンパリング、均等分布次元計算
+ * の段に分けて、各段を別々のスレッドで実行する。段の間は容量制限付きの
+ * キューでつながっている。テンパリングを行っている間も、次の候補の
+ * 最小多項式の計算が続けられる。
+ *\endjapanese
+ *
+ *\english
+ * @brief Search parameters of state transition function and
+ * tempering parameters in parallel by a pipeline
+ *
+ * The same search as AlgorithmRecursionAndTempering is divided into
+ * stages; candidate generation, minimal polynomial, primitivity
+ * check, tempering and calculation of dimension of
+ * equi-distribution. Each stage runs in its own threads and stages
+ * are connected by bounded queues. Minimal polynomials of next
+ * candidates are calculated while tempering is running.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <MTToolBox/TemperingCalculatable.hpp>
+#include <MTToolBox/AlgorithmEquidistribution.hpp>
+#include <MTToolBox/AlgorithmTempering.hpp>
+#include <MTToolBox/AlgorithmPrimitivity.hpp>
+#include <MTToolBox/ParameterGenerator.hpp>
+#include <MTToolBox/Parallel.hpp>
+#include <MTToolBox/Cancellation.hpp>
+#include <MTToolBox/period.hpp>
+#include <MTToolBox/util.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class PipelineResultHandler
+     *\japanese
+     * @brief AlgorithmPipelinedSearch が見つけたパラメータを受け取る
+     *
+     * search() を呼んだスレッドから呼ばれるので、スレッドセーフで
+     * ある必要はない。
+     * @tparam U 疑似乱数生成器の出力の型
+     *\endjapanese
+     *
+     *\english
+     * @brief Receives parameters found by AlgorithmPipelinedSearch
+     *
+     * This is called from the thread which called search(), and need
+     * not be thread safe.
+     * @tparam U type of output of the generator
+     *\endenglish
+     */
+    template<typename U>
+    class PipelineResultHandler {
+    public:
+        virtual ~PipelineResultHandler() {}
+
+        /**
+         *\japanese
+         * 見つかったパラメータを受け取る。
+         * @param[in] lg 状態遷移パラメータとテンパリングパラメータが
+         * 設定された疑似乱数生成器
+         * @param[in] poly 特性多項式
+         * @param[in] weight 特性多項式のハミングウェイト
+         * @param[in] delta 均等分布次元の理論値との差の総和
+         * @param[in] veq 各ビット長の均等分布次元
+         * @return 探索を続けるときは true
+         *\endjapanese
+         *
+         *\english
+         * Receives found parameters.
+         * @param[in] lg generator whose parameters of state transition
+         * and tempering are set.
+         * @param[in] poly characteristic polynomial
+         * @param[in] weight Hamming weight of characteristic polynomial
+         * @param[in] delta sum of d(v)s
+         * @param[in] veq dimension of equi-distribution of each bit length
+         * @return true if search should continue
+         *\endenglish
+         */
+        virtual bool operator()(TemperingCalculatable<U>& lg,
+                                const NTL::GF2X& poly,
+                                int weight, int delta,
+                                const int veq[]) = 0;
+    };
+
+    /**
+     * @class AlgorithmPipelinedSearch
+     *\japanese
+     * @brief パイプラインによる並列パラメータ探索
+     *
+     * 候補ごとに疑似乱数生成器を clone() するので、clone() されたもの
+     * は元の生成器と独立に動作しなければならない。パラメータ生成器
+     * (ParameterGenerator) はロックして使われる。テンパリングアルゴリズ
+     * ムはスレッドごとに別のオブジェクトを与える。
+     *
+     * NTL はスレッドセーフにビルドされている必要がある。
+     * (NTL_THREADS=on, NTL 10 以降のデフォルト)
+     * @tparam U 疑似乱数生成器の出力の型, 符号なし型であること
+     *\endjapanese
+     *
+     *\english
+     * @brief Parallel parameter search by pipeline
+     *
+     * The generator is clone()d for each candidate, so a clone must
+     * work independently from the original. The parameter generator
+     * (ParameterGenerator) is used under a lock. Each tempering thread
+     * is given its own tempering algorithm objects.
+     *
+     * NTL should be built thread safe (NTL_THREADS=on, which is the
+     * default since NTL 10).
+     * @tparam U type of output of the generator, should be unsigned.
+     *\endenglish
+     */
+    template<typename U>
+    class AlgorithmPipelinedSearch {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         * @param bg パラメータをランダムサーチするための疑似乱数生成器
+         * @param minpoly_workers 最小多項式を計算するスレッド数
+         * @param primitivity_workers 原始性判定をするスレッド数
+         * @param scoring_workers 均等分布次元を計算するスレッド数
+         * @param primitivity 原始性判定アルゴリズム
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         * @param bg a generator used for generating numbers to make
+         * parameters.
+         * @param minpoly_workers number of threads which calculate
+         * minimal polynomials.
+         * @param primitivity_workers number of threads which check
+         * primitivity.
+         * @param scoring_workers number of threads which calculate
+         * dimension of equi-distribution.
+         * @param primitivity An algorithm to check primitivity.
+         *\endenglish
+         */
+        AlgorithmPipelinedSearch(ParameterGenerator& bg,
+                                 int minpoly_workers,
+                                 int primitivity_workers = 1,
+                                 int scoring_workers = 1,
+                                 const AlgorithmPrimitivity& primitivity
+                                 = MersennePrimitivity) {
+            baseGenerator = &bg;
+            isPrime = &primitivity;
+            minpolyWorkers = minpoly_workers < 1 ? 1 : minpoly_workers;
+            primitivityWorkers
+                = primitivity_workers < 1 ? 1 : primitivity_workers;
+            scoringWorkers = scoring_workers < 1 ? 1 : scoring_workers;
+            count = 0;
+            maxTry = 0;
+            found = 0;
+            cancel = NULL;
+        }
+
+        /**
+         *\japanese
+         * 試す候補の数の上限を設定する。0 なら上限なし。
+         * @param max_try 候補の数の上限
+         *\endjapanese
+         *
+         *\english
+         * Sets upper limit of number of candidates. 0 means no limit.
+         * @param max_try upper limit of number of candidates
+         *\endenglish
+         */
+        void setMaxTry(long max_try) {
+            maxTry = max_try;
+        }
+
+        /**
+         *\japanese
+         * 打ち切りの指示を設定する。
+         *
+         * 打ち切られると新しい候補を作らず、各段に残っている候補も
+         * 捨てる。テンパリングの途中で打ち切られた候補は \b handler に
+         * 渡さないので、\b handler が受け取るのは最後まで探索した
+         * パラメータだけである。
+         * @param[in] token 打ち切りの指示、NULL なら打ち切らない
+         *\endjapanese
+         *
+         *\english
+         * Sets the direction of cancellation.
+         *
+         * When cancelled, no more candidates are made, and candidates
+         * left in stages are discarded. Candidates whose tempering is
+         * cancelled are not passed to \b handler, so \b handler only
+         * receives parameters searched to the end.
+         * @param[in] token direction of cancellation, NULL not to cancel
+         *\endenglish
+         */
+        void setCancellation(const CancellationToken * token) {
+            cancel = token;
+        }
+
+        /**
+         *\japanese
+         * 探索する。
+         *
+         * 見つかったパラメータごとに \b handler が呼ばれる。\b handler が
+         * false を返すか、\b result_count 個見つかるか、候補がなくなる
+         * (パラメータ生成器が std::underflow_error を投げる) か、
+         * 候補の数の上限に達するか、打ち切られると終了する。
+         *
+         * テンパリングを行うスレッドの数は \b st1 の要素数である。
+         * @param lg 探索する疑似乱数生成器の原型。clone() して使われる。
+         * @param st1 スレッドごとのテンパリングパラメータ探索アルゴリズム
+         * @param st2 スレッドごとのLSBからのテンパリングパラメータ探索アル
+         * ゴリズム。空なら LSB からのテンパリングはしない。
+         * @param handler 見つかったパラメータを受け取る
+         * @param result_count 探すパラメータの数、0 なら上限なし
+         * @return 見つかったパラメータの数
+         * @throw 各段や \b handler で起きた最初の例外。すべてのスレッドを
+         * 止めてから投げる。
+         *\endjapanese
+         *
+         *\english
+         * Search.
+         *
+         * \b handler is called for each parameter found. The search
+         * finishes when \b handler returns false, \b result_count
+         * parameters are found, candidates are exhausted (the
+         * parameter generator throws std::underflow_error), the
+         * limit of number of candidates is reached, or the search is
+         * cancelled.
+         *
+         * Number of tempering threads is the size of \b st1.
+         * @param lg prototype of the generator, which is clone()d.
+         * @param st1 tempering algorithms for each thread.
+         * @param st2 tempering algorithms from LSB for each thread. If
+         * empty, tempering from LSB is not done.
+         * @param handler receives found parameters.
+         * @param result_count number of parameters to be found, 0 means
+         * no limit.
+         * @return number of parameters found
+         * @throw the first exception thrown in stages or \b handler,
+         * after all threads are stopped.
+         *\endenglish
+         */
+        int search(const TemperingCalculatable<U>& lg,
+                   std::vector<AlgorithmTempering<U> *>& st1,
+                   std::vector<AlgorithmTempering<U> *>& st2,
+                   PipelineResultHandler<U>& handler,
+                   int result_count = 0) {
+            if (st1.empty()) {
+                throw std::invalid_argument("st1 should not be empty");
+            }
+            if (!st2.empty() && st2.size() != st1.size()) {
+                throw std::invalid_argument(
+                    "st2 should be empty or have the same size as st1");
+            }
+            const int queue_size = 2 * minpolyWorkers;
+            BoundedQueue<Item *> candidates(queue_size);
+            BoundedQueue<Item *> full_degree(queue_size);
+            BoundedQueue<Item *> primitive(queue_size);
+            BoundedQueue<Item *> tempered(queue_size);
+            BoundedQueue<Item *> scored(queue_size);
+            Control control(candidates, full_degree, primitive, tempered,
+                            scored, cancel);
+            for (size_t i = 0; i < st1.size(); i++) {
+                st1[i]->setCancellation(cancel);
+            }
+            for (size_t i = 0; i < st2.size(); i++) {
+                st2[i]->setCancellation(cancel);
+            }
+            GenerateStage generate(*this, lg, control, candidates);
+            MinPolyStage minpoly_stage(control, candidates, full_degree,
+                                       minpolyWorkers);
+            PrimitivityStage primitivity_stage(*isPrime, control,
+                                               full_degree, primitive,
+                                               primitivityWorkers);
+            TemperingStage tempering_stage(st1, st2, control, primitive,
+                                           tempered);
+            ScoringStage scoring_stage(control, tempered, scored,
+                                       scoringWorkers);
+            WorkerPool pool;
+            int result = 0;
+            /*
+             * キューを止めずに join() するとワーカーが pop() や push() で
+             * 待ったままになるので、例外のときもキューを止めてから待つ。
+             */
+            try {
+                pool.start(generate, 1);
+                pool.start(minpoly_stage, minpolyWorkers);
+                pool.start(primitivity_stage, primitivityWorkers);
+                pool.start(tempering_stage, static_cast<int>(st1.size()));
+                pool.start(scoring_stage, scoringWorkers);
+                Item * item;
+                while (scored.pop(item)) {
+                    result++;
+                    bool cont;
+                    try {
+                        cont = handler(*item->lg, item->poly, item->weight,
+                                       item->delta, &item->veq[0]);
+                    } catch (...) {
+                        delete item;
+                        throw;
+                    }
+                    delete item;
+                    if (!cont
+                        || (result_count > 0 && result >= result_count)) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                control.shutdown(pool);
+                found += result;
+                throw;
+            }
+            control.shutdown(pool);
+            found += result;
+            // ワーカーのスレッドで起きた例外をここで投げ直す
+            control.error.rethrow();
+            return result;
+        }
+
+        /**
+         *\japanese
+         * これまでに試した候補の数を返す。
+         * @return 試した候補の数
+         *\endjapanese
+         *
+         *\english
+         * Returns number of candidates tried so far.
+         * @return number of candidates tried
+         *\endenglish
+         */
+        long getCount() {
+            ScopedLock lock(mutex);
+            return count;
+        }
+
+        /**
+         *\japanese
+         * これまでに見つかったパラメータの数を返す。
+         * @return 見つかったパラメータの数
+         *\endjapanese
+         *
+         *\english
+         * Returns number of parameters found so far.
+         * @return number of parameters found
+         *\endenglish
+         */
+        long getFound() {
+            return found;
+        }
+    private:
+        struct Item {
+            TemperingCalculatable<U> * lg;
+            NTL::GF2X poly;
+            int weight;
+            int delta;
+            std::vector<int> veq;
+            Item() : lg(NULL), weight(0), delta(0) {}
+            ~Item() {
+                delete lg;
+            }
+        };
+
+        /*
+         * すべての段のキューと、ワーカーで起きた最初の例外、打ち切りの指示
+         */
+        struct Control {
+            Control(BoundedQueue<Item *>& q0, BoundedQueue<Item *>& q1,
+                    BoundedQueue<Item *>& q2, BoundedQueue<Item *>& q3,
+                    BoundedQueue<Item *>& q4, const CancellationToken * c)
+                : token(c) {
+                queues[0] = &q0;
+                queues[1] = &q1;
+                queues[2] = &q2;
+                queues[3] = &q3;
+                queues[4] = &q4;
+            }
+            void cancel() {
+                for (int i = 0; i < 5; i++) {
+                    queues[i]->cancel();
+                }
+            }
+            /* catch ブロックの中で呼ぶ。最初の例外を保存して全体を止める */
+            void fail() {
+                error.capture();
+                cancel();
+            }
+            void shutdown(WorkerPool& pool) {
+                cancel();
+                pool.join();
+                for (int i = 0; i < 5; i++) {
+                    std::vector<Item *> rest;
+                    queues[i]->drain(rest);
+                    for (size_t j = 0; j < rest.size(); j++) {
+                        delete rest[j];
+                    }
+                }
+            }
+            bool cancelled() const {
+                return is_cancelled(token);
+            }
+            BoundedQueue<Item *> * queues[5];
+            FirstError error;
+            const CancellationToken * token;
+        };
+
+        /*
+         * 段の最後のスレッドが終わったら次のキューを閉じる。
+         * 段の中で起きた例外はスレッドから出さずに Control に渡す。
+         */
+        class Stage : public Runnable {
+        public:
+            Stage(Control& c, BoundedQueue<Item *>& in,
+                  BoundedQueue<Item *>& out, int workers)
+                : control(c), input(&in), output(out) {
+                live = workers;
+            }
+            void run(int index) {
+                try {
+                    work(index);
+                } catch (...) {
+                    control.fail();
+                }
+                finish();
+            }
+        protected:
+            Stage(Control& c, BoundedQueue<Item *>& out)
+                : control(c), input(NULL), output(out) {
+                live = 1;
+            }
+            virtual void work(int index) {
+                Item * item;
+                while (input->pop(item)) {
+                    bool passed = false;
+                    try {
+                        if (!control.cancelled()) {
+                            passed = process(item, index);
+                        }
+                    } catch (...) {
+                        delete item;
+                        throw;
+                    }
+                    // 打ち切られた後に終わった処理は途中までかもしれない
+                    if (!passed || control.cancelled()) {
+                        delete item;
+                        continue;
+                    }
+                    if (!output.push(item)) {
+                        delete item;
+                        break;
+                    }
+                }
+            }
+            virtual bool process(Item * item, int index) = 0;
+            void finish() {
+                ScopedLock lock(mutex);
+                live--;
+                if (live == 0) {
+                    output.close();
+                }
+            }
+            Control& control;
+            BoundedQueue<Item *> * input;
+            BoundedQueue<Item *>& output;
+        private:
+            Mutex mutex;
+            int live;
+        };
+
+        class GenerateStage : public Stage {
+        public:
+            GenerateStage(AlgorithmPipelinedSearch<U>& s,
+                          const TemperingCalculatable<U>& prototype,
+                          Control& c, BoundedQueue<Item *>& out)
+                : Stage(c, out), search(s), lg(prototype) {}
+        protected:
+            void work(int) {
+                for (;;) {
+                    Item * item = new Item;
+                    bool next;
+                    try {
+                        item->lg = dynamic_cast<TemperingCalculatable<U> *>(
+                            lg.clone());
+                        next = search.nextCandidate(*item->lg);
+                    } catch (...) {
+                        delete item;
+                        throw;
+                    }
+                    if (!next) {
+                        delete item;
+                        break;
+                    }
+                    if (!this->output.push(item)) {
+                        delete item;
+                        break;
+                    }
+                }
+            }
+            bool process(Item *, int) {
+                return true;
+            }
+        private:
+            AlgorithmPipelinedSearch<U>& search;
+            const TemperingCalculatable<U>& lg;
+        };
+
+        class MinPolyStage : public Stage {
+        public:
+            MinPolyStage(Control& c, BoundedQueue<Item *>& in,
+                         BoundedQueue<Item *>& out, int workers)
+                : Stage(c, in, out, workers) {}
+        protected:
+            bool process(Item * item, int) {
+                item->lg->seed(getOne<U>());
+                minpoly(item->poly, *item->lg);
+                return deg(item->poly) == item->lg->bitSize();
+            }
+        };
+
+        class PrimitivityStage : public Stage {
+        public:
+            PrimitivityStage(const AlgorithmPrimitivity& primitivity,
+                             Control& c, BoundedQueue<Item *>& in,
+                             BoundedQueue<Item *>& out, int workers)
+                : Stage(c, in, out, workers), isPrime(primitivity) {}
+        protected:
+            bool process(Item * item, int) {
+                return isPrime(item->lg->bitSize(), item->poly);
+            }
+        private:
+            const AlgorithmPrimitivity& isPrime;
+        };
+
+        class TemperingStage : public Stage {
+        public:
+            TemperingStage(std::vector<AlgorithmTempering<U> *>& st1,
+                           std::vector<AlgorithmTempering<U> *>& st2,
+                           Control& c, BoundedQueue<Item *>& in,
+                           BoundedQueue<Item *>& out)
+                : Stage(c, in, out, static_cast<int>(st1.size())),
+                  msb(st1), lsb(st2) {}
+        protected:
+            bool process(Item * item, int index) {
+                if (!lsb.empty()) {
+                    (*lsb[index])(*item->lg, false);
+                }
+                (*msb[index])(*item->lg, false);
+                return true;
+            }
+        private:
+            std::vector<AlgorithmTempering<U> *>& msb;
+            std::vector<AlgorithmTempering<U> *>& lsb;
+        };
+
+        class ScoringStage : public Stage {
+        public:
+            ScoringStage(Control& c, BoundedQueue<Item *>& in,
+                         BoundedQueue<Item *>& out, int workers)
+                : Stage(c, in, out, workers) {}
+        protected:
+            bool process(Item * item, int) {
+                item->veq.resize(bit_size<U>());
+                AlgorithmEquidistribution<U> sc(*item->lg, bit_size<U>());
+                item->delta = sc.get_all_equidist(&item->veq[0]);
+                item->weight = static_cast<int>(NTL::weight(item->poly));
+                return true;
+            }
+        };
+
+        /*
+         * パラメータ生成器はスレッドセーフではないのでロックして使う
+         */
+        bool nextCandidate(TemperingCalculatable<U>& lg) {
+            ScopedLock lock(mutex);
+            if (maxTry > 0 && count >= maxTry) {
+                return false;
+            }
+            if (is_cancelled(cancel)) {
+                return false;
+            }
+            try {
+                lg.setUpParam(*baseGenerator);
+            } catch (std::underflow_error&) {
+                return false;
+            }
+            count++;
+            return true;
+        }
+
+        ParameterGenerator * baseGenerator;
+        const AlgorithmPrimitivity * isPrime;
+        int minpolyWorkers;
+        int primitivityWorkers;
+        int scoringWorkers;
+        Mutex mutex;
+        long count;
+        long maxTry;
+        long found;
+        const CancellationToken * cancel;
+    };
+}
+#endif // MTTOOLBOX_ALGORITHM_PIPELINED_SEARCH_HPP
@@ -43,6 +43,8 @@
 #include <MTToolBox/AlgorithmRecursionSearch.hpp>
 #include <MTToolBox/AlgorithmTempering.hpp>
 #include <MTToolBox/ParameterGenerator.hpp>
+#include <MTToolBox/Cancellation.hpp>
+#include <MTToolBox/SearchProgress.hpp>
 #include <MTToolBox/util.hpp>
 
 namespace MTToolBox {
@@ -103,6 +105,9 @@ namespace MTToolBox {
             const AlgorithmPrimitivity& primitivity = MersennePrimitivity) {
             baseGenerator = &bg;
             isPrime = &primitivity;
+            cancel = NULL;
+            progress = NULL;
+            complete = true;
         }
         /**
          *\japanese
@@ -115,6 +120,11 @@ namespace MTToolBox {
          * @param os 出力ストリーム
          * @param no_lsb LSBからのテンパリングをしない
          * @return true 原始多項式を発見しテンパリングパラメータを設定した場合
+         *
+         * 打ち切りの指示が設定されていれば、原始多項式を発見する前に
+         * 打ち切られると false を返す。テンパリングの探索中に打ち切られ
+         * ると、それまでの最良のテンパリングパラメータを設定して true を
+         * 返し、isComplete() は false になる。
          *\endjapanese
          *
          *\english
@@ -131,6 +141,12 @@ namespace MTToolBox {
          * @param no_lsb if true, \b st2 will not be used.
          * @return false if no tempering parameters which gives proper
          * state transition function are found.
+         *
+         * If the direction of cancellation is set and the search is
+         * cancelled before a primitive polynomial is found, returns
+         * false. If cancelled while searching tempering parameters,
+         * sets the best tempering parameters so far and returns true,
+         * and isComplete() becomes false.
          */
         bool search(TemperingCalculatable<U>& lg,
                     AlgorithmTempering<U>& st1,
@@ -144,6 +160,9 @@ namespace MTToolBox {
             out = &os;
             int veq[bit_size<U>()];
             AlgorithmRecursionSearch<U> search(lg, *baseGenerator, *isPrime);
+            search.setCancellation(cancel);
+            search.setProgress(progress);
+            complete = false;
             int mexp = lg.bitSize();
             bool found = false;
             for (int i = 0;; i++) {
@@ -151,6 +170,9 @@ namespace MTToolBox {
                     found = true;
                     break;
                 }
+                if (is_cancelled(cancel)) {
+                    break;
+                }
                 if (verbose) {
                     *out << "not found in " << (i + 1) * 10000 << endl;
                 }
@@ -158,6 +180,10 @@ namespace MTToolBox {
             if (!found) {
                 return false;
             }
+            double begin = 0;
+            if (progress != NULL) {
+                begin = SearchProgress::now();
+            }
             if (verbose) {
                 time_t t = time(NULL);
                 *out << "irreducible parameter is found at " << ctime(&t);
@@ -168,7 +194,9 @@ namespace MTToolBox {
             }
             poly = search.getMinPoly();
             weight = static_cast<int>(NTL::weight(poly));
-            if (verbose) {
+            st1.setCancellation(cancel);
+            st2.setCancellation(cancel);
+            if (verbose && !is_cancelled(cancel)) {
                 AlgorithmEquidistribution<U> sb(lg, bit_size<U>());
                 int delta = sb.get_all_equidist(veq);
                 print_kv(veq, mexp, bit_size<U>());
@@ -176,7 +204,7 @@ namespace MTToolBox {
             }
             if (! no_lsb) {
                 st2(lg, verbose);
-                if (verbose) {
+                if (verbose && !is_cancelled(cancel)) {
                     if (st2.isLSBTempering()) {
                         lg.setReverseOutput();
                     }
@@ -191,6 +219,8 @@ namespace MTToolBox {
                 }
             }
             st1(lg, verbose);
+            complete = !is_cancelled(cancel);
+            // 打ち切られていても、設定したテンパリングの delta は計算する
             AlgorithmEquidistribution<U> sc(lg, bit_size<U>());
             delta = sc.get_all_equidist(veq);
             if (verbose) {
@@ -201,6 +231,9 @@ namespace MTToolBox {
                 print_kv(veq, mexp, bit_size<U>());
                 *out << "delta = " << dec << delta << endl;
             }
+            if (progress != NULL) {
+                progress->addPostProcess(SearchProgress::now() - begin);
+            }
             return true;
         }
 
@@ -240,6 +273,62 @@ namespace MTToolBox {
             return search(lg, st, st, verbose, os, true);
         }
 
+        /**
+         *\japanese
+         * 打ち切りの指示を設定する。
+         * @param[in] token 打ち切りの指示、NULL なら打ち切らない
+         *\endjapanese
+         *
+         *\english
+         * Sets the direction of cancellation.
+         * @param[in] token direction of cancellation, NULL not to cancel
+         *\endenglish
+         */
+        void setCancellation(const CancellationToken * token) {
+            cancel = token;
+        }
+
+        /**
+         *\japanese
+         * 直前の search() がテンパリングパラメータの探索を最後まで
+         * 行ったかどうかを返す。
+         * @return 打ち切られずに終わったら true
+         *\endjapanese
+         *
+         *\english
+         * Returns whether the last search() searched tempering
+         * parameters to the end.
+         * @return true if ended without cancellation
+         *\endenglish
+         */
+        bool isComplete() const {
+            return complete;
+        }
+
+        /**
+         *\japanese
+         * 進み具合の記録を設定する。
+         *
+         * 漸化式のパラメータの候補を AlgorithmRecursionSearch と同様に
+         * 記録し、テンパリングパラメータの探索と均等分布次元の計算を
+         * 後処理として記録する。
+         * @param[in,out] progress 進み具合、NULL なら記録しない
+         *\endjapanese
+         *
+         *\english
+         * Sets a record of progress.
+         *
+         * Candidates of recursion parameters are recorded in the same
+         * way as AlgorithmRecursionSearch, and searching tempering
+         * parameters and calculating dimensions of equidistribution
+         * are recorded as post processing.
+         * @param[in,out] progress progress, NULL not to record
+         *\endenglish
+         */
+        void setProgress(SearchProgress * progress) {
+            this->progress = progress;
+        }
+
         /**
          *\japanese
          * 特性多項式のハミングウェイトを返す
@@ -293,6 +382,9 @@ namespace MTToolBox {
         std::ostream * out;
         ParameterGenerator * baseGenerator;
         const AlgorithmPrimitivity *isPrime;
+        const CancellationToken * cancel;
+        SearchProgress * progress;
+        bool complete;
         void print_kv(int veq[], int mexp, int size) {
             using namespace std;
             for (int i = 0; i < size; i++) {
@@ -32,6 +32,9 @@
 #include <NTL/GF2XFactoring.h>
 #include <MTToolBox/RecursionSearchable.hpp>
 #include <MTToolBox/AlgorithmPrimitivity.hpp>
+#include <MTToolBox/ParameterFilter.hpp>
+#include <MTToolBox/Cancellation.hpp>
+#include <MTToolBox/SearchProgress.hpp>
 #include <MTToolBox/period.hpp>
 #include <MTToolBox/util.hpp>
 
@@ -102,6 +105,10 @@ namespace MTToolBox {
             rand = &generator;
             baseGenerator = &bg;
             count = 0;
+            skipped = 0;
+            filter = NULL;
+            cancel = NULL;
+            progress = NULL;
             isPrime = &MersennePrimitivity;
         }
 
@@ -138,6 +145,10 @@ namespace MTToolBox {
             rand = &generator;
             baseGenerator = &bg;
             count = 0;
+            skipped = 0;
+            filter = NULL;
+            cancel = NULL;
+            progress = NULL;
             isPrime = &primitivity;
         }
 
@@ -174,8 +185,23 @@ namespace MTToolBox {
         bool start(int try_count) {
             long size = rand->bitSize();
             long degree;
+            std::string key;
             for (int i = 0; i < try_count; i++) {
+                if (is_cancelled(cancel)) {
+                    return false;
+                }
                 rand->setUpParam(*baseGenerator);
+                if (filter != NULL) {
+                    key = rand->getRecursionKey();
+                    if (filter->rejected(key)) {
+                        skipped++;
+                        continue;
+                    }
+                }
+                double begin = 0;
+                if (progress != NULL) {
+                    begin = SearchProgress::now();
+                }
                 rand->seed(getOne<U>());
                 minpoly(poly, *rand);
                 count++;
@@ -184,15 +210,111 @@ namespace MTToolBox {
 #if defined(DEBUG)
                     cout << "degree:" << degree << endl;
 #endif
+                    reject(key, begin);
                     continue;
                 }
                 if ((*isPrime)(static_cast<int>(size), poly)) {
+                    if (progress != NULL) {
+                        progress->addCandidate(SearchProgress::now() - begin,
+                                               true);
+                    }
                     return true;
                 }
+                reject(key, begin);
             }
             return false;
         }
 
+        /**
+         *\japanese
+         * 棄却されたパラメータの記録を設定する。
+         *
+         * 設定すると、start() は最小多項式を計算する前に記録を調べ、
+         * 記録にあるパラメータを飛ばす。また棄却したパラメータを記録に
+         * 加える。パラメータは生成器の getRecursionKey() で記録する。
+         * 記録は呼び出し側が所有し、このインスタンスより長く生存
+         * しなければならない。
+         * @param[in,out] filter 記録、NULL なら使わない
+         *\endjapanese
+         *
+         *\english
+         * Sets a record of rejected parameters.
+         *
+         * If set, start() looks up the record before calculating the
+         * minimal polynomial, and skips recorded parameters. Rejected
+         * parameters are added to the record. Parameters are recorded
+         * by getRecursionKey() of the generator. The caller owns the
+         * record, which should live longer than this instance.
+         * @param[in,out] filter record, NULL not to use
+         *\endenglish
+         */
+        void setFilter(ParameterFilter * filter) {
+            this->filter = filter;
+        }
+
+        /**
+         *\japanese
+         * 記録にあったので最小多項式を計算せずに飛ばした回数を返す。
+         * この回数は getCount() に含まれない。
+         * @return 飛ばした回数
+         *\endjapanese
+         *
+         *\english
+         * Returns count of parameters skipped without calculating
+         * minimal polynomial because they were recorded. This count is
+         * not included in getCount().
+         * @return skipped count
+         *\endenglish
+         */
+        long getSkipped() const {
+            return skipped;
+        }
+
+        /**
+         *\japanese
+         * 打ち切りの指示を設定する。
+         *
+         * 設定すると、start() はパラメータをひとつ試すごとに指示を
+         * 調べ、打ち切るべきなら false を返す。
+         * @param[in] token 打ち切りの指示、NULL なら打ち切らない
+         *\endjapanese
+         *
+         *\english
+         * Sets the direction of cancellation.
+         *
+         * If set, start() checks the direction for each parameter,
+         * and returns false if it should be cancelled.
+         * @param[in] token direction of cancellation, NULL not to cancel
+         *\endenglish
+         */
+        void setCancellation(const CancellationToken * token) {
+            cancel = token;
+        }
+
+        /**
+         *\japanese
+         * 進み具合の記録を設定する。
+         *
+         * 設定すると、start() は最小多項式を計算した候補ごとに、かかった
+         * 時間と成否を記録する。記録に飛ばされた候補は数えない。記録は
+         * 呼び出し側が所有する。
+         * @param[in,out] progress 進み具合、NULL なら記録しない
+         *\endjapanese
+         *
+         *\english
+         * Sets a record of progress.
+         *
+         * If set, start() records time spent and success or failure for
+         * each candidate whose minimal polynomial is calculated.
+         * Candidates skipped by the filter are not counted. The caller
+         * owns the record.
+         * @param[in,out] progress progress, NULL not to record
+         *\endenglish
+         */
+        void setProgress(SearchProgress * progress) {
+            this->progress = progress;
+        }
+
         /**
          *\japanese
          * 疑似乱数生成器のパラメータを表す文字列を返す
@@ -253,8 +375,21 @@ namespace MTToolBox {
         RecursionSearchable<U> *rand;
         ParameterGenerator *baseGenerator;
         const AlgorithmPrimitivity *isPrime;
+        ParameterFilter *filter;
+        const CancellationToken *cancel;
+        SearchProgress *progress;
         NTL::GF2X poly;
         long count;
+        long skipped;
+
+        void reject(const std::string& key, double begin) {
+            if (filter != NULL) {
+                filter->reject(key);
+            }
+            if (progress != NULL) {
+                progress->addCandidate(SearchProgress::now() - begin, false);
+            }
+        }
     };
 }
 #endif // MTTOOLBOX_ALGORITHM_RECURSION_SEARCH_HPP
@@ -25,6 +25,7 @@
 
 #include <MTToolBox/ReducibleGenerator.hpp>
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
+#include <MTToolBox/ReducibleAnalysis.hpp>
 
 namespace MTToolBox {
     using namespace std;
@@ -80,6 +81,35 @@ namespace MTToolBox {
             NTL::GF2X quotient = poly / irreducibleFactor;
             annihilate<U>(rand, quotient);
             ae = new AlgorithmEquidistribution<U>(*rand, bit_length, mexp);
+            delete rand;
+        }
+
+        /**
+         *\japanese
+         * コンストラクタ
+         *
+         * 解析結果の、q で殲滅した状態を使うので、特性多項式を計算し直さ
+         * ない。
+         * @param[in] analysis 可約ジェネレータの解析結果
+         * @param[in] bit_length 出力のビット長
+         * @param[in] mexp メルセンヌ指数
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         *
+         * The state annihilated by q kept in the analysis is used, so
+         * the characteristic polynomial is not calculated again.
+         * @param[in] analysis analysis of reducible generator
+         * @param[in] bit_length bit length of output.
+         * @param[in] mexp Mersenne Exponent.
+         *\endenglish
+         */
+        AlgorithmReducibleEquidistribution(ReducibleAnalysis<U, G>& analysis,
+                                           int bit_length,
+                                           int mexp) {
+            ae = new AlgorithmEquidistribution<U>(
+                analysis.getIrreducibleState(), bit_length, mexp);
         }
 
         /**
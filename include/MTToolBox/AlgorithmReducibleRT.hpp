@@ -40,6 +40,7 @@
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
 #include <MTToolBox/AlgorithmTempering.hpp>
 #include <MTToolBox/AlgorithmCalculateParity.hpp>
+#include <MTToolBox/ReducibleAnalysis.hpp>
 #include <MTToolBox/util.hpp>
 
 namespace MTToolBox {
@@ -135,7 +136,6 @@ namespace MTToolBox {
             out = &os;
             int veq[bit_size<U>()];
             AlgorithmReducibleRecursionSearch<U> search(rg, *baseGenerator);
-            AlgorithmCalculateParity<U, G> cp;
             int mexp = rg.bitSize();
             bool found = false;
             for (int i = 0;; i++) {
@@ -159,12 +159,10 @@ namespace MTToolBox {
                 *out << rg.getParamString() << endl;
             }
             poly = search.getIrreducibleFactor();
-            parity = cp.searchParity(rg, poly);
+            ReducibleAnalysis<U, G> analysis(rg, poly);
+            parity = analysis.getParity(rg);
             weight = static_cast<int>(NTL::weight(poly));
-            GF2X lcm(0, 1);
-            calcCharacteristicPolynomial(&rg, lcm);
-            NTL::GF2X quotient = lcm / poly;
-            annihilate(&rg, quotient);
+            analysis.annihilateQuotient(rg);
             if (verbose) {
                 AlgorithmEquidistribution<U> sb(rg, bit_size<U>());
                 int delta = sb.get_all_equidist(veq);
@@ -38,7 +38,11 @@
 #include <MTToolBox/util.hpp>
 #include <MTToolBox/ReducibleGenerator.hpp>
 #include <MTToolBox/AlgorithmPrimitivity.hpp>
+#include <MTToolBox/ParameterFilter.hpp>
+#include <MTToolBox/Cancellation.hpp>
+#include <MTToolBox/SearchProgress.hpp>
 #include <MTToolBox/period.hpp>
+#include <MTToolBox/BerlekampMassey.hpp>
 
 namespace MTToolBox {
     using namespace std;
@@ -112,6 +116,10 @@ namespace MTToolBox {
             rand = &generator;
             baseGenerator = &bg;
             count = 0;
+            skipped = 0;
+            filter = NULL;
+            cancel = NULL;
+            progress = NULL;
         }
 
         /**
@@ -120,8 +128,23 @@ namespace MTToolBox {
         bool start(int try_count) {
             long degree;
             long mexp = rand->getMexp();
+            std::string key;
             for (int i = 0; i < try_count; i++) {
+                if (is_cancelled(cancel)) {
+                    return false;
+                }
                 rand->setUpParam(*baseGenerator);
+                if (filter != NULL) {
+                    key = rand->getRecursionKey();
+                    if (filter->rejected(key)) {
+                        skipped++;
+                        continue;
+                    }
+                }
+                double begin = 0;
+                if (progress != NULL) {
+                    begin = SearchProgress::now();
+                }
                 rand->seed(getOne<U>());
 #if defined(DEBUG)
                 cout << "rand param:";
@@ -135,9 +158,11 @@ namespace MTToolBox {
                     cout << "irrepoly deg = " << deg(irreducible)
                          << " skip" << endl;
 #endif
+                    reject(key, begin);
                     continue;
                 }
-                bool hasFactor = hasFactorOfDegree(irreducible, mexp);
+                bool hasFactor = hasFactorOfDegree(irreducible, mexp,
+                                                   factorStat);
 #if defined(DEBUG)
                 cout << "has factor = " << hasFactor << endl;
 #endif
@@ -146,6 +171,7 @@ namespace MTToolBox {
                     cout << "not has factor of degree irrepoly deg = "
                          << deg(irreducible) << " skip" << endl;
 #endif
+                    reject(key, begin);
                     continue;
                 }
                 degree = deg(irreducible);
@@ -154,8 +180,13 @@ namespace MTToolBox {
                     cout << "degree:" << degree << "degree != mexp skip"
                          << endl;
 #endif
+                    reject(key, begin);
                     continue;
                 }
+                if (progress != NULL) {
+                    progress->addCandidate(SearchProgress::now() - begin,
+                                           true);
+                }
                 return true;
             }
             return false;
@@ -217,13 +248,71 @@ namespace MTToolBox {
             return count;
         }
 
+        /**
+         *\japanese
+         * このインスタンスが作られてから hasFactorOfDegree() にかかった
+         * 計算量を返す。
+         * @return hasFactorOfDegree() の計算量の記録
+         *\endjapanese
+         *
+         *\english
+         * Returns the cost of hasFactorOfDegree() from the instance
+         * was created.
+         * @return record of cost of hasFactorOfDegree()
+         *\endenglish
+         */
+        const FactorStatistics& getFactorStatistics() const {
+            return factorStat;
+        }
+
+        /**
+         * @copydoc AlgorithmRecursionSearch::setFilter
+         */
+        void setFilter(ParameterFilter * filter) {
+            this->filter = filter;
+        }
+
+        /**
+         * @copydoc AlgorithmRecursionSearch::getSkipped
+         */
+        long getSkipped() const {
+            return skipped;
+        }
+
+        /**
+         * @copydoc AlgorithmRecursionSearch::setCancellation
+         */
+        void setCancellation(const CancellationToken * token) {
+            cancel = token;
+        }
+
+        /**
+         * @copydoc AlgorithmRecursionSearch::setProgress
+         */
+        void setProgress(SearchProgress * progress) {
+            this->progress = progress;
+        }
+
     private:
         ReducibleGenerator<U> *rand;
         ParameterGenerator *baseGenerator;
+        ParameterFilter *filter;
+        const CancellationToken *cancel;
+        SearchProgress *progress;
         NTL::GF2X poly;
         NTL::GF2X irreducible;
         long count;
+        long skipped;
+        FactorStatistics factorStat;
 
+        void reject(const std::string& key, double begin) {
+            if (filter != NULL) {
+                filter->reject(key);
+            }
+            if (progress != NULL) {
+                progress->addCandidate(SearchProgress::now() - begin, false);
+            }
+        }
     };
 
     /**
@@ -232,41 +321,37 @@ namespace MTToolBox {
      * 実のところ、特性多項式ではなく最小多項式のLCMを計算しているに過ぎない。
      * 次数が一致すれば特性多項式。特性多項式でなくても、MTToolBoxで使用する
      * 範囲内では特に問題はない。
+     *
+     * 出力は 2n 個を一度だけ生成し、ビット位置ごとの最小多項式を
+     * threads 個ずつ並列に求める。
      * @tparam U 疑似乱数生成器の返す値の型
      * @param[in,out] rand 疑似乱数生成器
      * @param[in,out] poly 特性多項式
+     * @param[in] threads スレッド数
      *\endjapanese
      *
      *\english
      * Calculate the characteristic polynomial of reducible generator.
+     *
+     * 2n outputs are generated only once, and minimal polynomials of
+     * bit positions are calculated in parallel, threads positions at
+     * a time.
      * @tparam U type of return value of random number generator.
      * @param[in,out] rand pseudo random number generator.
      * @param[in,out] poly calculated characteristic polynomial.
+     * @param[in] threads number of threads.
      *\endenglish
      */
     template<typename U>
     void calcCharacteristicPolynomial(ReducibleGenerator<U> *rand,
-                                      NTL::GF2X& poly)
+                                      NTL::GF2X& poly, int threads = 1)
     {
 #if defined(DEBUG)
         cout << "calcCharacteristicPolynomial start" << endl;
 #endif
-        int bitsize = bit_size<U>();
-        NTL::GF2X minpol;
-        NTL::GF2X lcmpoly = poly;
-        int size = rand->bitSize();
-        for (int i = 0; i < bitsize; i++) {
-            if (deg(lcmpoly) == size) {
-                poly = lcmpoly;
-#if defined(DEBUG)
-                cout << "calcCharacteristicPolynomial end" << endl;
-#endif
-                return;
-            }
-            minpoly(minpol, *rand, i);
-            LCM(lcmpoly, lcmpoly, minpol);
+        if (deg(poly) != rand->bitSize()) {
+            lcm_minpoly(poly, *rand, 0, threads);
         }
-        poly = lcmpoly;
 #if defined(DEBUG)
         cout << "calcCharacteristicPolynomial end" << endl;
 #endif
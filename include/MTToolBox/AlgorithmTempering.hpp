@@ -26,6 +26,7 @@
 #include <cstdlib>
 #include <unistd.h>
 #include <MTToolBox/TemperingCalculatable.hpp>
+#include <MTToolBox/Cancellation.hpp>
 
 namespace MTToolBox {
     /**
@@ -59,6 +60,9 @@ namespace MTToolBox {
     template<typename U>
     class AlgorithmTempering {
     public:
+        AlgorithmTempering() {
+            cancel = NULL;
+        }
 
         /**
          *\japanese
@@ -105,6 +109,38 @@ namespace MTToolBox {
         virtual bool isLSBTempering() const {
             return false;
         }
+
+        /**
+         *\japanese
+         * 打ち切りの指示を設定する。
+         *
+         * 設定すると、打ち切るべきときは探索を途中でやめ、それまでに
+         * 見つかった最良のパラメータを \b rand に設定して戻る。
+         * @param[in] token 打ち切りの指示、NULL なら打ち切らない
+         *\endjapanese
+         *
+         *\english
+         * Sets the direction of cancellation.
+         *
+         * If set, the search stops when it should be cancelled, and
+         * the best parameters found so far are set to \b rand.
+         * @param[in] token direction of cancellation, NULL not to cancel
+         *\endenglish
+         */
+        void setCancellation(const CancellationToken * token) {
+            cancel = token;
+        }
+    protected:
+        /**
+         *\japanese
+         * 打ち切りの指示、NULL なら打ち切らない
+         *\endjapanese
+         *
+         *\english
+         * Direction of cancellation, NULL not to cancel.
+         *\endenglish
+         */
+        const CancellationToken * cancel;
     };
 }
 
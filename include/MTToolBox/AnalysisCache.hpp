@@ -0,0 +1,254 @@
+#ifndef MTTOOLBOX_ANALYSIS_CACHE_HPP
+#define MTTOOLBOX_ANALYSIS_CACHE_HPP
+/**
+ * @file AnalysisCache.hpp
+ *
+ *\japanese
+ * @brief パラメータの解析結果をファイルに保存して再利用する
+ *
+ * 最小多項式、既約因子、パリティ、均等分布次元の配列を、生成器の
+ * 種類と getParamString() の組をキーとしてディレクトリに保存する。
+ * 同じパラメータを再び解析するときは、計算しなおさずに読み込める。
+ *\endjapanese
+ *
+ *\english
+ * @brief Saves analysis results of parameters to files, and reuses
+ * them
+ *
+ * Minimal polynomials, irreducible factors, parities and arrays of
+ * dimensions of equidistribution are saved in a directory, keyed by
+ * the pair of the type of generator and getParamString(). When the
+ * same parameter is analysed again, results can be read without
+ * calculation.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <NTL/GF2X.h>
+
+namespace MTToolBox {
+    /**
+     * @class AnalysisRecord
+     *\japanese
+     * @brief ひとつのパラメータの解析結果
+     *
+     * 記録されていない多項式はゼロ多項式、記録されていない配列は空で
+     * ある。
+     *\endjapanese
+     *
+     *\english
+     * @brief Analysis results of a parameter
+     *
+     * Polynomials not recorded are zero, and arrays not recorded are
+     * empty.
+     *\endenglish
+     */
+    class AnalysisRecord {
+    public:
+        /**
+         *\japanese
+         * 最小多項式
+         *\endjapanese
+         *\english
+         * minimal polynomial
+         *\endenglish
+         */
+        NTL::GF2X minpoly;
+        /**
+         *\japanese
+         * 最小多項式の既約因子
+         *\endjapanese
+         *\english
+         * irreducible factor of minimal polynomial
+         *\endenglish
+         */
+        NTL::GF2X factor;
+        /**
+         *\japanese
+         * パリティチェックベクトル
+         *\endjapanese
+         *\english
+         * parity check vector
+         *\endenglish
+         */
+        std::vector<uint64_t> parity;
+        /**
+         *\japanese
+         * 名前をつけた均等分布次元の配列
+         *\endjapanese
+         *\english
+         * named arrays of dimensions of equidistribution
+         *\endenglish
+         */
+        std::map<std::string, std::vector<int> > veq;
+
+        /**
+         *\japanese
+         * 均等分布次元の配列を記録する。
+         * @param[in] name 配列の名前
+         * @param[in] v 均等分布次元の配列
+         * @param[in] size 配列の大きさ
+         *\endjapanese
+         *
+         *\english
+         * Records an array of dimensions of equidistribution.
+         * @param[in] name name of the array
+         * @param[in] v array of dimensions of equidistribution
+         * @param[in] size size of the array
+         *\endenglish
+         */
+        void setVeq(const std::string& name, const int v[], int size) {
+            veq[name] = std::vector<int>(v, v + size);
+        }
+
+        /**
+         *\japanese
+         * 均等分布次元の配列を取り出す。
+         * @param[in] name 配列の名前
+         * @param[out] v 均等分布次元の配列
+         * @param[in] size 配列の大きさ
+         * @return 大きさ \b size の配列が記録されていなければ false
+         *\endjapanese
+         *
+         *\english
+         * Takes an array of dimensions of equidistribution.
+         * @param[in] name name of the array
+         * @param[out] v array of dimensions of equidistribution
+         * @param[in] size size of the array
+         * @return false if array of size \b size is not recorded.
+         *\endenglish
+         */
+        bool getVeq(const std::string& name, int v[], int size) const {
+            std::map<std::string, std::vector<int> >::const_iterator it
+                = veq.find(name);
+            if (it == veq.end()
+                || it->second.size() != static_cast<size_t>(size)) {
+                return false;
+            }
+            for (int i = 0; i < size; i++) {
+                v[i] = it->second[static_cast<size_t>(i)];
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @class AnalysisCache
+     *\japanese
+     * @brief 解析結果のディスクキャッシュ
+     *
+     * キーのハッシュ値をファイル名として、ひとつの記録をひとつのファイル
+     * に保存する。ファイルにはキーそのものも保存するので、ハッシュ値が
+     * 衝突しても別の記録として扱われる。記録は一時ファイルに書いてから
+     * 名前を変え、書き込みはロックで排他制御するので、複数のプロセスや
+     * スレッドが同時に使ってもよい。読み込みはファイルをメモリにマップ
+     * して行う。
+     *\endjapanese
+     *
+     *\english
+     * @brief Disk cache of analysis results
+     *
+     * Each record is saved in a file, whose name is the hash value of
+     * the key. The key itself is also saved in the file, so records
+     * with the same hash value are distinguished. Records are written
+     * to temporary files and renamed, and writing is serialized by a
+     * lock, so several processes and threads can use the cache at the
+     * same time.
+     * Reading is done by mapping files to memory.
+     *\endenglish
+     */
+    class AnalysisCache {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         * @param[in] dir キャッシュのディレクトリ、なければ作る
+         * @throw std::runtime_error ディレクトリを作れないとき
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         * @param[in] dir directory of the cache, created if not exists
+         * @throw std::runtime_error when failed to make the directory
+         *\endenglish
+         */
+        AnalysisCache(const std::string& dir);
+
+        /**
+         *\japanese
+         * キーを作る。
+         * @param[in] type 生成器の種類
+         * @param[in] param getParamString() の値
+         * @return キー
+         *\endjapanese
+         *
+         *\english
+         * Makes a key.
+         * @param[in] type type of generator
+         * @param[in] param value of getParamString()
+         * @return key
+         *\endenglish
+         */
+        static const std::string makeKey(const std::string& type,
+                                         const std::string& param);
+
+        /**
+         *\japanese
+         * 記録を探す。
+         * @param[in] key キー
+         * @param[out] record 記録
+         * @return 見つからなければ false
+         *\endjapanese
+         *
+         *\english
+         * Looks up a record.
+         * @param[in] key key
+         * @param[out] record record
+         * @return false if not found
+         *\endenglish
+         */
+        bool lookup(const std::string& key, AnalysisRecord& record) const;
+
+        /**
+         *\japanese
+         * 記録を保存する。
+         *
+         * 同じキーの記録があれば、\b record で記録されている項目だけを
+         * 置き換え、他の項目は残す。
+         * @param[in] key キー
+         * @param[in] record 記録
+         * @throw std::runtime_error 書けないとき
+         *\endjapanese
+         *
+         *\english
+         * Stores a record.
+         *
+         * If a record of the same key exists, only items recorded in
+         * \b record are replaced, and other items are kept.
+         * @param[in] key key
+         * @param[in] record record
+         * @throw std::runtime_error when failed to write
+         *\endenglish
+         */
+        void store(const std::string& key, const AnalysisRecord& record);
+    private:
+        std::string dir;
+
+        const std::string slotPath(uint64_t hash, int slot) const;
+        int read(const std::string& path, std::string& key,
+                 AnalysisRecord& record) const;
+    };
+}
+#endif // MTTOOLBOX_ANALYSIS_CACHE_HPP
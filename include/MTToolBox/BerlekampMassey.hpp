@@ -0,0 +1,299 @@
+#ifndef MTTOOLBOX_BERLEKAMP_MASSEY_HPP
+#define MTTOOLBOX_BERLEKAMP_MASSEY_HPP
+/**
+ * @file BerlekampMassey.hpp
+ *
+ *\japanese
+ * @brief 逐次型の Berlekamp-Massey 法による最小多項式の計算
+ *
+ * minpoly() は出力列全体を Vec<GF2> に格納してから MinPolySeq を
+ * 呼ぶ。ここでは出力を一ビットずつ受け取り、ビットを 64 ビットワードに
+ * 詰めて Berlekamp-Massey 法を進めるので、大きなメルセンヌ指数でも
+ * 使用メモリは状態空間のビット数の数倍に収まり、途中経過も分かる。
+ *\endjapanese
+ *
+ *\english
+ * @brief Calculation of minimal polynomial by streaming
+ * Berlekamp-Massey algorithm
+ *
+ * minpoly() stores whole output sequence in Vec<GF2> and then calls
+ * MinPolySeq. This file feeds outputs bit by bit, and runs
+ * Berlekamp-Massey algorithm on bits packed in 64-bit words. Memory
+ * usage is bounded by a few times the bit size of the internal state
+ * even for large Mersenne exponents, and progress can be reported.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <iostream>
+#include <vector>
+#include <NTL/GF2X.h>
+#include <MTToolBox/AbstractGenerator.hpp>
+#include <MTToolBox/util.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class BerlekampMassey
+     *\japanese
+     * @brief GF(2) 上の数列を一項ずつ受け取る Berlekamp-Massey 法
+     *
+     * 数列の項、接続多項式とその一つ前の多項式を 64 ビットワードに詰めて
+     * 持つ。一項あたりの計算量は線形複雑度を L として O(L / 64) である。
+     *\endjapanese
+     *
+     *\english
+     * @brief Berlekamp-Massey algorithm which receives a sequence over
+     * GF(2) term by term
+     *
+     * Terms of the sequence, the connection polynomial and the previous
+     * one are packed in 64-bit words. Cost per term is O(L / 64),
+     * where L is the linear complexity.
+     *\endenglish
+     */
+    class BerlekampMassey {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         * @param[in] maxLength 受け取る数列の最大の長さ
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         * @param[in] maxLength maximum length of the sequence
+         *\endenglish
+         */
+        BerlekampMassey(long maxLength);
+
+        /**
+         *\japanese
+         * 数列の次の項を与える。
+         * @param[in] bit 数列の項、0 または 1
+         * @throw std::length_error 最大の長さを超えたとき
+         *\endjapanese
+         *
+         *\english
+         * Gives the next term of the sequence.
+         * @param[in] bit term of the sequence, 0 or 1
+         * @throw std::length_error when exceeds the maximum length
+         *\endenglish
+         */
+        void push(int bit);
+
+        /**
+         *\japanese
+         * これまでに与えた項を生成する最小多項式を返す。
+         * @param[out] poly 最小多項式
+         *\endjapanese
+         *
+         *\english
+         * Returns the minimal polynomial generating terms given so far.
+         * @param[out] poly minimal polynomial
+         *\endenglish
+         */
+        void getMinPoly(NTL::GF2X& poly) const;
+
+        /**
+         *\japanese
+         * @return これまでに与えた項の数
+         *\endjapanese
+         *
+         *\english
+         * @return number of terms given so far
+         *\endenglish
+         */
+        long getCount() const {
+            return count;
+        }
+
+        /**
+         *\japanese
+         * @return これまでに与えた項の線形複雑度
+         *\endjapanese
+         *
+         *\english
+         * @return linear complexity of terms given so far
+         *\endenglish
+         */
+        long getComplexity() const {
+            return complexity;
+        }
+    private:
+        long maxLength;
+        long count;
+        long complexity;
+        long prevComplexity;
+        long shift;
+        std::vector<uint64_t> sequence;
+        std::vector<uint64_t> connection;
+        std::vector<uint64_t> previous;
+        std::vector<uint64_t> work;
+
+        uint64_t discrepancy() const;
+        void addShifted(std::vector<uint64_t>& dst,
+                        const std::vector<uint64_t>& src,
+                        long srcDegree, long s);
+    };
+
+    /**
+     *\japanese
+     * 最小多項式を逐次型の Berlekamp-Massey 法で求める
+     *
+     * 結果は minpoly() と同じである。出力は一語ずつ生成して使うので、
+     * 出力列全体を保持しない。
+     *
+     * @tparam U 疑似乱数生成器の出力の型
+     * @param[out] poly 最小多項式
+     * @param[in] generator GF(2)疑似乱数生成器
+     * @param[in] pos 出力の下位から何ビット目を見るかを指定する
+     * @param[in] stateSize 状態空間のビットサイズ
+     * @param[in] progress NULL でなければ、ここに途中経過を出力する
+     *\endjapanese
+     *
+     *\english
+     * Calculate minimal polynomial of output sequence by streaming
+     * Berlekamp-Massey algorithm.
+     *
+     * The result is the same as minpoly(). Outputs are generated and
+     * used one by one, whole output sequence is not kept.
+     *
+     * @tparam U type of output of pseudo random number generator
+     * @param[out] poly minimal polynomial
+     * @param[in] generator GF(2)-linear pseudo random number generator
+     * @param[in] pos specifies how manieth bit from LSB is checked,
+     * zero means LSB.
+     * @param[in] stateSize bit size of internal state.
+     * @param[in] progress if not NULL, progress is reported to this
+     * stream.
+     *\endenglish
+     */
+    template<typename U> void
+    minpoly_stream(NTL::GF2X& poly, AbstractGenerator<U>& generator,
+                   int pos = 0, int stateSize = 0,
+                   std::ostream * progress = NULL)
+    {
+        using namespace std;
+        long size;
+        if (stateSize <= 0) {
+            size = generator.bitSize();
+        } else {
+            size = stateSize;
+        }
+        long length = 2 * size;
+        BerlekampMassey bm(length);
+        long step = length / 16 + 1;
+        for (long i = 0; i < length; i++) {
+            bm.push(static_cast<int>(getBitOfPos(generator.generate(), pos)));
+            if (progress != NULL && (i + 1) % step == 0) {
+                *progress << "minpoly " << dec << (i + 1) << "/" << length
+                          << " complexity " << bm.getComplexity() << endl;
+            }
+        }
+        bm.getMinPoly(poly);
+    }
+
+    /**
+     *\japanese
+     * 複数の数列の最小多項式の最小公倍多項式を求める
+     *
+     * 各数列の最小多項式を Berlekamp-Massey 法で求め、lcm との最小公倍
+     * 多項式をとる。threads 個の数列ずつ並列に計算し、その都度 lcm の
+     * 次数が degree に達したかを調べるので、必要以上の数列は計算しない。
+     * @param[in,out] lcm 最小公倍多項式、与えた多項式との最小公倍多項式を返す
+     * @param[in] sequences 数列、i 項目は sequences[k][i / 64] の下から
+     * i % 64 ビット目
+     * @param[in] length 数列の長さ
+     * @param[in] degree lcm の次数がこれに達したら終了する
+     * @param[in] threads スレッド数
+     *\endjapanese
+     *
+     *\english
+     * Calculates LCM of minimal polynomials of several sequences.
+     *
+     * Minimal polynomial of each sequence is calculated by
+     * Berlekamp-Massey algorithm, and LCM with lcm is taken.
+     * Sequences are processed in parallel, threads sequences at a
+     * time, and the degree of lcm is checked after each batch, so
+     * sequences are not processed more than needed.
+     * @param[in,out] lcm LCM, LCM with the given polynomial is returned.
+     * @param[in] sequences sequences, the i-th term is the (i % 64)-th
+     * bit from LSB of sequences[k][i / 64].
+     * @param[in] length length of sequences
+     * @param[in] degree stops when degree of lcm reaches this.
+     * @param[in] threads number of threads
+     *\endenglish
+     */
+    void lcm_minpoly_sequences(
+        NTL::GF2X& lcm,
+        const std::vector<std::vector<uint64_t> >& sequences,
+        long length, long degree, int threads = 1);
+
+    /**
+     *\japanese
+     * 出力のすべてのビット位置の最小多項式の最小公倍多項式を求める
+     *
+     * minpoly() をビット位置ごとに呼ぶと、そのたびに生成器を 2n 回
+     * 動かすことになる。ここでは 2n 個の出力を一度だけ生成して、
+     * ビット位置ごとの数列に分けてから lcm_minpoly_sequences() を呼ぶ。
+     * 生成器は 2n 回動かされる。
+     * @tparam U 疑似乱数生成器の出力の型
+     * @param[in,out] lcm 最小公倍多項式、与えた多項式との最小公倍多項式を返す
+     * @param[in,out] generator GF(2)疑似乱数生成器
+     * @param[in] stateSize 状態空間のビットサイズ、0 なら generator.bitSize()
+     * @param[in] threads スレッド数
+     *\endjapanese
+     *
+     *\english
+     * Calculates LCM of minimal polynomials of all bit positions of
+     * outputs.
+     *
+     * Calling minpoly() for each bit position steps the generator 2n
+     * times each time. This function generates 2n outputs only once,
+     * splits them into sequences of each bit position and calls
+     * lcm_minpoly_sequences(). The generator is stepped 2n times.
+     * @tparam U type of output of pseudo random number generator
+     * @param[in,out] lcm LCM, LCM with the given polynomial is returned.
+     * @param[in,out] generator GF(2)-linear pseudo random number generator
+     * @param[in] stateSize bit size of internal state, if 0,
+     * generator.bitSize() is used.
+     * @param[in] threads number of threads
+     *\endenglish
+     */
+    template<typename U> void
+    lcm_minpoly(NTL::GF2X& lcm, AbstractGenerator<U>& generator,
+                int stateSize = 0, int threads = 1)
+    {
+        long size;
+        if (stateSize <= 0) {
+            size = generator.bitSize();
+        } else {
+            size = stateSize;
+        }
+        long length = 2 * size;
+        int bits = bit_size<U>();
+        std::vector<std::vector<uint64_t> > sequences(
+            static_cast<size_t>(bits),
+            std::vector<uint64_t>(static_cast<size_t>(length / 64 + 1), 0));
+        for (long i = 0; i < length; i++) {
+            U x = generator.generate();
+            size_t w = static_cast<size_t>(i / 64);
+            uint64_t mask = UINT64_C(1) << (i % 64);
+            for (int b = 0; b < bits; b++) {
+                if (getBitOfPos(x, b)) {
+                    sequences[static_cast<size_t>(b)][w] |= mask;
+                }
+            }
+        }
+        lcm_minpoly_sequences(lcm, sequences, length, size, threads);
+    }
+}
+#endif // MTTOOLBOX_BERLEKAMP_MASSEY_HPP
@@ -0,0 +1,247 @@
+#ifndef MTTOOLBOX_CANCELLATION_HPP
+#define MTTOOLBOX_CANCELLATION_HPP
+/**
+ * @file Cancellation.hpp
+ *
+ *\japanese
+ * @brief 時間制限とシグナルによる探索の打ち切り
+ *
+ * バッチスケジューラは決まった長さの時間枠を割り当て、枠が終わると
+ * SIGTERM を送ってくる。CancellationToken を探索アルゴリズムに渡して
+ * おくと、アルゴリズムは区切りのよいところで打ち切りを調べ、それまで
+ * に見つかった最良の結果を持って戻る。
+ *\endjapanese
+ *
+ *\english
+ * @brief Cancellation of searches by time limit and signals
+ *
+ * Batch schedulers allot time slots of fixed length, and send
+ * SIGTERM when the slot ends. If a CancellationToken is given to
+ * search algorithms, they check for cancellation at convenient
+ * points and return with the best result found so far.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stddef.h>
+#include <stdexcept>
+
+namespace MTToolBox {
+    /**
+     * @class Cancelled
+     *\japanese
+     * @brief 計算が打ち切られたことを表す例外
+     *
+     * 途中で止めると結果が意味をなさない計算、たとえば
+     * AlgorithmEquidistribution が投げる。探索アルゴリズムはこれを
+     * 受け止めて、それまでの最良の結果を使う。
+     *\endjapanese
+     *
+     *\english
+     * @brief Exception which shows that calculation was cancelled
+     *
+     * This is thrown by calculations whose result is meaningless if
+     * stopped in the middle, such as AlgorithmEquidistribution. Search
+     * algorithms catch it and use the best result so far.
+     *\endenglish
+     */
+    class Cancelled : public std::runtime_error {
+    public:
+        Cancelled() : std::runtime_error("cancelled") {}
+    };
+
+    /**
+     * @class CancellationToken
+     *\japanese
+     * @brief 打ち切りの指示
+     *
+     * cancel() が呼ばれたとき、期限を過ぎたとき、handleSignals() で
+     * 設定したシグナルを受け取ったときに打ち切りを指示する。ひとつの
+     * トークンを複数のスレッドで調べてよい。
+     *\endjapanese
+     *
+     *\english
+     * @brief Direction of cancellation
+     *
+     * Directs cancellation when cancel() is called, when the deadline
+     * passes, or when a signal set up by handleSignals() is received.
+     * Several threads may check one token.
+     *\endenglish
+     */
+    class CancellationToken {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ。期限はない。
+         *\endjapanese
+         *
+         *\english
+         * Constructor. There is no deadline.
+         *\endenglish
+         */
+        CancellationToken() {
+            cancelled = 0;
+            deadline = -1;
+        }
+
+        /**
+         *\japanese
+         * 打ち切りを指示する。
+         *\endjapanese
+         *
+         *\english
+         * Directs cancellation.
+         *\endenglish
+         */
+        void cancel() {
+            cancelled = 1;
+        }
+
+        /**
+         *\japanese
+         * 期限を今から \b seconds 秒後にする。
+         * @param[in] seconds 残り時間
+         *\endjapanese
+         *
+         *\english
+         * Sets the deadline \b seconds after now.
+         * @param[in] seconds time left
+         *\endenglish
+         */
+        void setTimeLimit(double seconds) {
+            deadline = now() + seconds;
+        }
+
+        /**
+         *\japanese
+         * 期限をなくす。
+         *\endjapanese
+         *
+         *\english
+         * Removes the deadline.
+         *\endenglish
+         */
+        void clearTimeLimit() {
+            deadline = -1;
+        }
+
+        /**
+         *\japanese
+         * @return 期限までの秒数、期限がなければ負
+         *\endjapanese
+         *
+         *\english
+         * @return seconds to the deadline, negative if there is no
+         * deadline
+         *\endenglish
+         */
+        double remaining() const {
+            if (deadline < 0) {
+                return -1;
+            }
+            double r = deadline - now();
+            return r > 0 ? r : 0;
+        }
+
+        /**
+         *\japanese
+         * @return 打ち切るべきなら true
+         *\endjapanese
+         *
+         *\english
+         * @return true if should be cancelled
+         *\endenglish
+         */
+        bool isCancelled() const {
+            if (cancelled || signalled()) {
+                return true;
+            }
+            return deadline >= 0 && now() >= deadline;
+        }
+
+        /**
+         *\japanese
+         * 打ち切るべきなら Cancelled を投げる。
+         * @throw Cancelled 打ち切るべきとき
+         *\endjapanese
+         *
+         *\english
+         * Throws Cancelled if should be cancelled.
+         * @throw Cancelled if should be cancelled
+         *\endenglish
+         */
+        void throwIfCancelled() const {
+            if (isCancelled()) {
+                throw Cancelled();
+            }
+        }
+
+        /**
+         *\japanese
+         * SIGTERM と SIGINT を受け取ると、すべてのトークンが打ち切りを
+         * 指示するようにする。プロセスは終了しないので、探索は結果を
+         * 出力してから正常に終われる。
+         *\endjapanese
+         *
+         *\english
+         * Makes all tokens direct cancellation when SIGTERM or SIGINT is
+         * received. The process is not terminated, so searches can
+         * output results and end normally.
+         *\endenglish
+         */
+        static void handleSignals();
+
+        /**
+         *\japanese
+         * @return handleSignals() で設定したシグナルを受け取っていれば
+         * true
+         *\endjapanese
+         *
+         *\english
+         * @return true if a signal set up by handleSignals() has been
+         * received
+         *\endenglish
+         */
+        static bool signalled();
+
+        /**
+         *\japanese
+         * @return 単調増加する時計の現在の秒数
+         *\endjapanese
+         *
+         *\english
+         * @return current seconds of a monotonic clock
+         *\endenglish
+         */
+        static double now();
+    private:
+        volatile int cancelled;
+        double deadline;
+    };
+
+    /**
+     *\japanese
+     * トークンが与えられていて、打ち切るべきなら true を返す。
+     * @param[in] token トークン、NULL でもよい
+     * @return 打ち切るべきなら true
+     *\endjapanese
+     *
+     *\english
+     * Returns true if a token is given and cancellation is directed.
+     * @param[in] token token, may be NULL
+     * @return true if should be cancelled
+     *\endenglish
+     */
+    inline bool is_cancelled(const CancellationToken * token) {
+        return token != NULL && token->isCancelled();
+    }
+}
+#endif // MTTOOLBOX_CANCELLATION_HPP
@@ -0,0 +1,208 @@
+#ifndef MTTOOLBOX_COW_BUFFER_HPP
+#define MTTOOLBOX_COW_BUFFER_HPP
+/**
+ * @file CowBuffer.hpp
+ *
+ *\japanese
+ * @brief 書き込み時にコピーする状態配列
+ *
+ * EquidistributionCalculatable::clone() は均等分布次元の計算、線形性の
+ * テスト、annihilate() などで何度も呼ばれ、その多くはすぐに setZero()
+ * されるか、読まれるだけで捨てられる。状態配列をこのクラスで持てば、
+ * clone() は配列を共有するだけになり、コピーは書き込むときまで遅らされ、
+ * 共有中の setZero() はコピーをせずに新しいゼロの配列を作る。
+ *\endjapanese
+ *
+ *\english
+ * @brief State array copied on write
+ *
+ * EquidistributionCalculatable::clone() is called many times in
+ * calculation of dimension of equidistribution, linearity tests,
+ * annihilate() and so on, and most clones are setZero()ed at once, or
+ * only read and discarded. If the state array is kept in this class,
+ * clone() only shares the array, copying is delayed until writing,
+ * and setZero() while sharing makes a new zero array without copying.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Manieth Corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (C) 2015, 2016 Mutsuo Saito, Makoto Matsumoto, Manieth Corp.
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stddef.h>
+#include <string.h>
+
+namespace MTToolBox {
+    /**
+     * @class CowBuffer
+     *\japanese
+     * @brief 書き込み時にコピーする配列
+     *
+     * コピーは配列を共有し、参照カウントを増やすだけである。const でない
+     * アクセスをすると、共有されていれば自分用の複製を作る。参照カウント
+     * の増減はアトミックなので、同じ配列を共有する別々のオブジェクトを
+     * 別々のスレッドで使ってよい。ひとつのオブジェクトを複数のスレッドで
+     * 同時に使ってはならない。
+     *
+     * @tparam T 要素の型、memset と memcpy で扱える型であること
+     *\endjapanese
+     *
+     *\english
+     * @brief Array which is copied on write
+     *
+     * Copying shares the array and only increments the reference
+     * count. A non-const access makes a private copy if the array is
+     * shared. Reference counting is atomic, so different objects
+     * sharing an array can be used in different threads. A single
+     * object should not be used by several threads at once.
+     *
+     * @tparam T type of elements, which can be handled by memset and
+     * memcpy.
+     *\endenglish
+     */
+    template<typename T>
+    class CowBuffer {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ、要素はすべて 0 になる。
+         * @param[in] size 要素数
+         *\endjapanese
+         *
+         *\english
+         * Constructor, all elements are set to 0.
+         * @param[in] size number of elements
+         *\endenglish
+         */
+        explicit CowBuffer(size_t size = 0) {
+            rep = allocate(size);
+            memset(rep->data, 0, size * sizeof(T));
+        }
+
+        CowBuffer(const CowBuffer& that) {
+            rep = that.rep;
+            __sync_add_and_fetch(&rep->count, 1);
+        }
+
+        CowBuffer& operator=(const CowBuffer& that) {
+            if (rep != that.rep) {
+                __sync_add_and_fetch(&that.rep->count, 1);
+                release(rep);
+                rep = that.rep;
+            }
+            return *this;
+        }
+
+        ~CowBuffer() {
+            release(rep);
+        }
+
+        size_t size() const {
+            return rep->size;
+        }
+
+        const T& operator[](size_t i) const {
+            return rep->data[i];
+        }
+
+        /**
+         *\japanese
+         * 書き込み用のアクセス、共有されていればコピーする。
+         *\endjapanese
+         *
+         *\english
+         * Access for writing, the array is copied if shared.
+         *\endenglish
+         */
+        T& operator[](size_t i) {
+            return writable()[i];
+        }
+
+        const T * data() const {
+            return rep->data;
+        }
+
+        /**
+         *\japanese
+         * 書き込み用の先頭ポインタを返す。共有されていればコピーする。
+         * @return 自分だけが持つ配列の先頭
+         *\endjapanese
+         *
+         *\english
+         * Returns pointer to the head for writing. The array is copied
+         * if shared.
+         * @return head of the array owned only by this object
+         *\endenglish
+         */
+        T * writable() {
+            if (rep->count != 1) {
+                Rep * r = allocate(rep->size);
+                memcpy(r->data, rep->data, rep->size * sizeof(T));
+                release(rep);
+                rep = r;
+            }
+            return rep->data;
+        }
+
+        /**
+         *\japanese
+         * すべての要素を 0 にする。共有されていれば、コピーせずに新しい
+         * 配列を作る。
+         *\endjapanese
+         *
+         *\english
+         * Sets all elements to 0. If the array is shared, a new array is
+         * made without copying.
+         *\endenglish
+         */
+        void setZero() {
+            if (rep->count != 1) {
+                Rep * r = allocate(rep->size);
+                release(rep);
+                rep = r;
+            }
+            memset(rep->data, 0, rep->size * sizeof(T));
+        }
+
+        /**
+         *\japanese
+         * @return 他のオブジェクトと配列を共有していれば true
+         *\endjapanese
+         *
+         *\english
+         * @return true if the array is shared with other objects
+         *\endenglish
+         */
+        bool isShared() const {
+            return rep->count != 1;
+        }
+    private:
+        struct Rep {
+            volatile int count;
+            size_t size;
+            T * data;
+        };
+        Rep * rep;
+
+        static Rep * allocate(size_t size) {
+            Rep * r = new Rep;
+            r->count = 1;
+            r->size = size;
+            r->data = new T[size > 0 ? size : 1];
+            return r;
+        }
+
+        static void release(Rep * r) {
+            if (__sync_sub_and_fetch(&r->count, 1) == 0) {
+                delete[] r->data;
+                delete r;
+            }
+        }
+    };
+}
+#endif // MTTOOLBOX_COW_BUFFER_HPP
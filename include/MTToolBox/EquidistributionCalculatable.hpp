@@ -76,6 +76,33 @@ namespace MTToolBox {
          */
         virtual EquidistributionCalculatable<U> * clone() const = 0;
 
+        /**
+         *\japanese
+         * 状態空間がゼロの自分のコピーを返す。
+         *
+         * clone() してすぐ setZero() するのと同じである。状態配列を
+         * CowBuffer で持つ生成器では、状態をコピーせずにゼロの配列を
+         * 作るだけになる。状態のコピーを避ける方法が別にあれば、
+         * オーバーライドしてよい。
+         * @return 状態空間がゼロの自分自身のコピー
+         *\endjapanese
+         *
+         *\english
+         * Return copy of myself whose internal state is zero.
+         *
+         * This is the same as clone() followed by setZero(). For
+         * generators which keep state arrays in CowBuffer, this only
+         * makes a zero array without copying the state. Override this
+         * if there is another way to avoid copying the state.
+         * @return copy of myself whose internal state is zero.
+         *\endenglish
+         */
+        virtual EquidistributionCalculatable<U> * cloneZero() const {
+            EquidistributionCalculatable<U> * r = clone();
+            r->setZero();
+            return r;
+        }
+
         /**
          *\japanese
          * 上位(MSBから) \b outBitLen だけ出力する。
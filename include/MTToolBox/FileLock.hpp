@@ -0,0 +1,115 @@
+#ifndef MTTOOLBOX_FILE_LOCK_HPP
+#define MTTOOLBOX_FILE_LOCK_HPP
+/**
+ * @file FileLock.hpp
+ *
+ *\japanese
+ * @brief プロセス間の排他制御のためのファイルロック
+ *\endjapanese
+ *
+ *\english
+ * @brief File lock for mutual exclusion among processes
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string>
+#include <stdexcept>
+
+namespace MTToolBox {
+    /**
+     * @class FileLock
+     *\japanese
+     * @brief fcntl によるファイル全体の書き込みロック
+     *
+     * コンストラクタでロックをかけ、デストラクタで外す。他のプロセスが
+     * ロックを持っていれば待つ。同じプロセスのスレッド間の排他制御には
+     * ならないので、スレッド間では Mutex を併用すること。
+     *\endjapanese
+     *
+     *\english
+     * @brief Write lock of whole file by fcntl
+     *
+     * The constructor locks and the destructor unlocks. Waits if
+     * another process holds the lock. This does not exclude threads
+     * in the same process, use Mutex together among threads.
+     *\endenglish
+     */
+    class FileLock {
+    public:
+        /**
+         *\japanese
+         * ロックをかける。
+         * @param[in] fd ロックするファイルのファイル記述子
+         * @throw std::runtime_error ロックできないとき
+         *\endjapanese
+         *
+         *\english
+         * Locks.
+         * @param[in] fd file descriptor of the file to be locked
+         * @throw std::runtime_error when failed to lock
+         *\endenglish
+         */
+        FileLock(int fd) {
+            this->fd = fd;
+            if (set(F_WRLCK, F_SETLKW) < 0) {
+                throw std::runtime_error("can't lock file");
+            }
+        }
+        ~FileLock() {
+            set(F_UNLCK, F_SETLK);
+        }
+
+        /**
+         *\japanese
+         * ロック用のファイルを開く。なければ作る。
+         * @param[in] path ファイル名
+         * @return ファイル記述子
+         * @throw std::runtime_error 開けないとき
+         *\endjapanese
+         *
+         *\english
+         * Opens a file for locking. Creates it if not exists.
+         * @param[in] path file name
+         * @return file descriptor
+         * @throw std::runtime_error when failed to open
+         *\endenglish
+         */
+        static int open(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0666);
+            if (fd < 0) {
+                throw std::runtime_error("can't open lock file " + path);
+            }
+            return fd;
+        }
+    private:
+        int fd;
+
+        int set(short type, int cmd) {
+            struct flock fl;
+            fl.l_type = type;
+            fl.l_whence = SEEK_SET;
+            fl.l_start = 0;
+            fl.l_len = 0;
+            int r;
+            do {
+                r = fcntl(fd, cmd, &fl);
+            } while (r < 0 && errno == EINTR);
+            return r;
+        }
+        FileLock(const FileLock&);
+        FileLock& operator=(const FileLock&);
+    };
+}
+#endif // MTTOOLBOX_FILE_LOCK_HPP
@@ -0,0 +1,110 @@
+#ifndef MTTOOLBOX_GF2_ECHELON_HPP
+#define MTTOOLBOX_GF2_ECHELON_HPP
+/**
+ * @file GF2Echelon.hpp
+ *
+ *\japanese
+ * @brief 64 ビットワードに詰めた GF(2) 上の行ベクトルの階数
+ *
+ * 出力行列の階数から均等分布次元を求めるときに使う。
+ *\endjapanese
+ *
+ *\english
+ * @brief Rank of row vectors over GF(2) packed in 64-bit words
+ *
+ * Used to calculate dimensions of equidistribution from the rank of
+ * output matrices.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <vector>
+
+namespace MTToolBox {
+    /**
+     * @class GF2Echelon
+     *\japanese
+     * @brief 行ベクトルを一本ずつ加えて階数を求める
+     *
+     * 加えた行ベクトルを最下位の 1 の位置が互いに異なるように簡約して
+     * 保持する。
+     *\endjapanese
+     *
+     *\english
+     * @brief Calculates rank by adding row vectors one by one
+     *
+     * Added row vectors are reduced and kept so that positions of
+     * their lowest 1s are different from each other.
+     *\endenglish
+     */
+    class GF2Echelon {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         * @param[in] cols 行ベクトルのビット数
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         * @param[in] cols number of bits in a row vector
+         *\endenglish
+         */
+        GF2Echelon(int cols);
+
+        /**
+         *\japanese
+         * 行ベクトルを加える。
+         * @param[in] v 行ベクトル、(cols + 63) / 64 ワード
+         * @return これまでの行ベクトルと一次独立なら true
+         *\endjapanese
+         *
+         *\english
+         * Adds a row vector.
+         * @param[in] v row vector of (cols + 63) / 64 words
+         * @return true if independent of row vectors added so far
+         *\endenglish
+         */
+        bool add(const uint64_t * v);
+
+        /**
+         *\japanese
+         * @return これまでに加えた行ベクトルの階数
+         *\endjapanese
+         *
+         *\english
+         * @return rank of row vectors added so far
+         *\endenglish
+         */
+        int rank() const {
+            return count;
+        }
+
+        /**
+         *\japanese
+         * 空にする。
+         *\endjapanese
+         *
+         *\english
+         * Makes empty.
+         *\endenglish
+         */
+        void clear();
+    private:
+        int words;
+        int count;
+        std::vector<uint64_t> basis;
+        std::vector<int> pivot;
+        std::vector<uint64_t> work;
+    };
+}
+#endif // MTTOOLBOX_GF2_ECHELON_HPP
@@ -26,23 +26,32 @@
 #include <inttypes.h>
 #include <string>
 #include <MTToolBox/ParameterGenerator.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace MTToolBox {
     /**
      *\japanese
      * Mersenne Twister 疑似乱数生成器
      *
-     * @note この実装では、AbstractGenerator の仕様にあわせて、
-     * 一度の呼び出しで１個の疑似乱数を生成するようにしてある。
-     * そうするとまとめて作る場合よりも生成速度が落ちるので、
-     * 気休め程度でも速度を向上させるために、状態空間より大きな配列を使用して
-     * 剰余演算をビットマスクで済ませるようにしてある。
+     * @note 状態配列を使い切ったら配列全体を一度に更新し、調律した
+     * N 個の出力をバッファに置いて、そこから１個ずつ返す。SSE2 が
+     * 使えれば、更新と調律は４語ずつ計算する。出力列は１語ずつ
+     * 更新する通常の実装と同じである。大量の出力が必要なら
+     * fill_array32() を使うとバッファを経由しない。
      *\endjapanese
      *
      *\english
      * Mersenne Twister pseudo random number generator.
      *
-     *
+     * @note When the state array is used up, the whole array is
+     * regenerated at once, and N tempered outputs are put in a buffer,
+     * from which words are handed out one by one. If SSE2 is
+     * available, regeneration and tempering are computed four words
+     * at a time. The output sequence is the same as the usual
+     * implementation which updates one word at a time. When many
+     * outputs are needed, fill_array32() bypasses the buffer.
      *\endenglish
      */
     class MersenneTwister : public ParameterGenerator {
@@ -57,7 +66,8 @@ namespace MTToolBox {
          *\endenglish
          */
         MersenneTwister() {
-            mt = new uint32_t[LARGE_N];
+            mt = new uint32_t[N];
+            out = new uint32_t[N];
             seed(5489);
         }
 
@@ -73,7 +83,8 @@ namespace MTToolBox {
          *\endenglish
          */
         MersenneTwister(uint32_t value) {
-            mt = new uint32_t[LARGE_N];
+            mt = new uint32_t[N];
+            out = new uint32_t[N];
             seed(value);
         }
 
@@ -89,7 +100,8 @@ namespace MTToolBox {
          *\endenglish
          */
         MersenneTwister(const std::string& value) {
-            mt = new uint32_t[LARGE_N];
+            mt = new uint32_t[N];
+            out = new uint32_t[N];
             seed(value);
         }
 
@@ -107,7 +119,8 @@ namespace MTToolBox {
          *\endenglish
          */
         MersenneTwister(const uint32_t *value, int size) {
-            mt = new uint32_t[LARGE_N];
+            mt = new uint32_t[N];
+            out = new uint32_t[N];
             seed(value, size);
         }
 
@@ -122,6 +135,7 @@ namespace MTToolBox {
          */
         ~MersenneTwister() {
             delete[] mt;
+            delete[] out;
         }
 
         /**
@@ -278,28 +292,140 @@ namespace MTToolBox {
          *\endenglish
          */
         uint32_t next() {
-            using namespace std;
+            if (mti >= N) {
+                regenerate();
+                temper_block(out, mt);
+                mti = 0;
+            }
+            return out[mti++];
+        }
+
+        /**
+         *\japanese
+         * 疑似乱数を配列に書き込む
+         *
+         * next() を size 回呼んだのと同じ結果になる。N 語ごとの塊は
+         * バッファを経由せず、array に直接調律して書き込む。
+         * @param[out] array 出力先
+         * @param[in] size 出力する語数
+         *\endjapanese
+         *
+         *\english
+         * Fills an array with pseudo random numbers
+         *
+         * The result is the same as calling next() \b size times.
+         * Each block of N words is tempered directly into \b array
+         * without passing through the buffer.
+         * @param[out] array destination
+         * @param[in] size number of words to output
+         *\endenglish
+         */
+        void fill_array32(uint32_t * array, int size) {
+            int i = 0;
+            while (i < size && mti < N) {
+                array[i++] = out[mti++];
+            }
+            while (size - i >= N) {
+                regenerate();
+                temper_block(&array[i], mt);
+                i += N;
+            }
+            while (i < size) {
+                array[i++] = next();
+            }
+        }
+
+    private:
+        enum {N = 624, M = 397};
+        uint32_t *mt;    /* the array for the state vector  */
+        uint32_t *out;   /* tempered outputs of the last block */
+        unsigned int mti;
 
-            const uint32_t LARGE_MASK = UINT32_C(0x3ff);
+        /*
+         * 状態配列全体を N 語分進める。
+         * i < N - M では mt[i + M] はまだ古い値、それ以降では
+         * mt[i + M - N] はもう新しい値で、どちらも４語以上離れて
+         * いるので４語ずつ計算してよい。
+         */
+        void regenerate() {
             const uint32_t UPPER_MASK = UINT32_C(0x80000000);
             const uint32_t LOWER_MASK = UINT32_C(0x7fffffff);
             const uint32_t mag01[2] = {0x0UL, UINT32_C(0x9908b0df)};
+            int i = 0;
             uint32_t y;
+#if defined(__SSE2__)
+            for (; i + 4 <= N - M; i += 4) {
+                twist4(&mt[i], &mt[i + M]);
+            }
+#endif
+            for (; i < N - M; i++) {
+                y = (mt[i] & UPPER_MASK) | (mt[i + 1] & LOWER_MASK);
+                mt[i] = mt[i + M] ^ (y >> 1) ^ mag01[y & 0x1UL];
+            }
+#if defined(__SSE2__)
+            for (; i + 4 <= N - 1; i += 4) {
+                twist4(&mt[i], &mt[i + M - N]);
+            }
+#endif
+            for (; i < N - 1; i++) {
+                y = (mt[i] & UPPER_MASK) | (mt[i + 1] & LOWER_MASK);
+                mt[i] = mt[i + M - N] ^ (y >> 1) ^ mag01[y & 0x1UL];
+            }
+            y = (mt[N - 1] & UPPER_MASK) | (mt[0] & LOWER_MASK);
+            mt[N - 1] = mt[M - 1] ^ (y >> 1) ^ mag01[y & 0x1UL];
+        }
 
-            y = (mt[(LARGE_N - N + mti) & LARGE_MASK] & UPPER_MASK)
-                | (mt[(LARGE_N - N + mti + 1) & LARGE_MASK] & LOWER_MASK);
-            mt[mti] = mt[(LARGE_N - N + M + mti) & LARGE_MASK]
-                ^ (y >> 1) ^ mag01[y & 0x1UL];
-            y = temper(mt[mti]);
-            mti = (mti + 1) & LARGE_MASK;
-            return y;
+#if defined(__SSE2__)
+        static void twist4(uint32_t * p, const uint32_t * q) {
+            const __m128i upper = _mm_set1_epi32(
+                static_cast<int>(UINT32_C(0x80000000)));
+            const __m128i lower = _mm_set1_epi32(0x7fffffff);
+            const __m128i one = _mm_set1_epi32(1);
+            const __m128i matrix = _mm_set1_epi32(
+                static_cast<int>(UINT32_C(0x9908b0df)));
+            __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i *>(p));
+            __m128i b = _mm_loadu_si128(
+                reinterpret_cast<__m128i *>(p + 1));
+            __m128i c = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(q));
+            __m128i y = _mm_or_si128(_mm_and_si128(a, upper),
+                                     _mm_and_si128(b, lower));
+            __m128i m = _mm_sub_epi32(_mm_setzero_si128(),
+                                      _mm_and_si128(y, one));
+            __m128i r = _mm_xor_si128(c, _mm_srli_epi32(y, 1));
+            r = _mm_xor_si128(r, _mm_and_si128(m, matrix));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p), r);
         }
+#endif
 
-    private:
-        enum {LARGE_N = 1024, N = 624, M = 397};
-        uint32_t *mt;    /* the array for the state vector  */
-        unsigned int mti;
-        uint32_t temper(uint32_t y) {
+        /*
+         * src の N 語を調律して dst に書き込む。
+         */
+        static void temper_block(uint32_t * dst, const uint32_t * src) {
+            int i = 0;
+#if defined(__SSE2__)
+            const __m128i c1 = _mm_set1_epi32(
+                static_cast<int>(UINT32_C(0x9d2c5680)));
+            const __m128i c2 = _mm_set1_epi32(
+                static_cast<int>(UINT32_C(0xefc60000)));
+            for (; i + 4 <= N; i += 4) {
+                __m128i y = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(&src[i]));
+                y = _mm_xor_si128(y, _mm_srli_epi32(y, 11));
+                y = _mm_xor_si128(y, _mm_and_si128(_mm_slli_epi32(y, 7),
+                                                   c1));
+                y = _mm_xor_si128(y, _mm_and_si128(_mm_slli_epi32(y, 15),
+                                                   c2));
+                y = _mm_xor_si128(y, _mm_srli_epi32(y, 18));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i]), y);
+            }
+#endif
+            for (; i < N; i++) {
+                dst[i] = temper(src[i]);
+            }
+        }
+
+        static uint32_t temper(uint32_t y) {
             y ^= (y >> 11);
             y ^= (y << 7) & UINT32_C(0x9d2c5680);
             y ^= (y << 15) & UINT32_C(0xefc60000);
@@ -33,6 +33,9 @@
 #include <inttypes.h>
 #include <string>
 #include <MTToolBox/ParameterGenerator.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #if defined(DEBUG)
 #include <iostream>
 #include <iomanip>
@@ -42,12 +45,17 @@ namespace MTToolBox {
     /**
      *\japanese
      * 64 bit Mersenne Twister 疑似乱数生成器
+     *
+     * @note MersenneTwister と同様に、状態配列全体を一度に更新して
+     * 調律した出力をバッファから返す。SSE2 が使えれば２語ずつ計算する。
      *\endjapanese
      *
      *\english
      * Mersenne Twister pseudo random number generator.
      *
-     *
+     * @note As MersenneTwister, the whole state array is regenerated
+     * at once and tempered outputs are handed out from a buffer. If
+     * SSE2 is available, two words are computed at a time.
      *\endenglish
      */
     class MersenneTwister64 : public ParameterGenerator {
@@ -63,6 +71,7 @@ namespace MTToolBox {
          */
         MersenneTwister64() {
             mt = new uint64_t[N];
+            out = new uint64_t[N];
             seed(UINT64_C(19650218));
         }
 
@@ -79,6 +88,7 @@ namespace MTToolBox {
          */
         MersenneTwister64(uint64_t value) {
             mt = new uint64_t[N];
+            out = new uint64_t[N];
             seed(value);
         }
 
@@ -95,6 +105,7 @@ namespace MTToolBox {
          */
         MersenneTwister64(const std::string& value) {
             mt = new uint64_t[N];
+            out = new uint64_t[N];
             seed(value);
         }
 
@@ -113,6 +124,7 @@ namespace MTToolBox {
          */
         MersenneTwister64(const uint64_t *value, int size) {
             mt = new uint64_t[N];
+            out = new uint64_t[N];
             seed(value, size);
         }
 
@@ -127,6 +139,7 @@ namespace MTToolBox {
          */
         ~MersenneTwister64() {
             delete[] mt;
+            delete[] out;
         }
 
         /**
@@ -147,7 +160,7 @@ namespace MTToolBox {
                     + UINT64_C(6364136223846793005)
                     * (mt[mti-1] ^ (mt[mti-1] >> 62));
             }
-            mti = 0;
+            mti = N;
         }
 
         /**
@@ -233,7 +246,7 @@ namespace MTToolBox {
             }
             /* MSB is 1; assuring non-zero initial array */
             mt[0] = UINT64_C(1) << 63;
-            mti = 0;
+            mti = N;
         }
 
         /**
@@ -278,17 +291,47 @@ namespace MTToolBox {
          *\endenglish
          */
         uint64_t next() {
-            const uint64_t UPPER_MASK = UINT64_C(0xFFFFFFFF80000000);
-            const uint64_t LOWER_MASK = UINT64_C(0x000000007FFFFFFF);
-            const uint64_t mag01[2] = {0x0UL, UINT64_C(0xB5026F5AA96619E9)};
-            uint64_t x;
+            if (mti >= N) {
+                regenerate();
+                temper_block(out, mt);
+                mti = 0;
+            }
+            return out[mti++];
+        }
 
-            x = (mt[mti] & UPPER_MASK) | (mt[(mti + 1) % N] & LOWER_MASK);
-            mt[mti] = mt[(mti + M) % N] ^ (x >> 1)
-                ^ mag01[(int)(x & UINT64_C(1))];
-            x = mt[mti];
-            mti = (mti + 1) % N;
-            return temper(x);
+        /**
+         *\japanese
+         * 疑似乱数を配列に書き込む
+         *
+         * next() を size 回呼んだのと同じ結果になる。N 語ごとの塊は
+         * バッファを経由せず、array に直接調律して書き込む。
+         * @param[out] array 出力先
+         * @param[in] size 出力する語数
+         *\endjapanese
+         *
+         *\english
+         * Fills an array with pseudo random numbers
+         *
+         * The result is the same as calling next() \b size times.
+         * Each block of N words is tempered directly into \b array
+         * without passing through the buffer.
+         * @param[out] array destination
+         * @param[in] size number of words to output
+         *\endenglish
+         */
+        void fill_array64(uint64_t * array, int size) {
+            int i = 0;
+            while (i < size && mti < N) {
+                array[i++] = out[mti++];
+            }
+            while (size - i >= N) {
+                regenerate();
+                temper_block(&array[i], mt);
+                i += N;
+            }
+            while (i < size) {
+                array[i++] = next();
+            }
         }
 
         /**
@@ -308,8 +351,96 @@ namespace MTToolBox {
     private:
         enum {N = 312, M = 156};
         uint64_t *mt;    /* the array for the state vector  */
+        uint64_t *out;   /* tempered outputs of the last block */
         int mti;
-        uint64_t temper(uint64_t y) {
+
+        /*
+         * 状態配列全体を N 語分進める。MersenneTwister::regenerate() と
+         * 同じ理由で２語ずつ計算してよい。
+         */
+        void regenerate() {
+            const uint64_t UPPER_MASK = UINT64_C(0xFFFFFFFF80000000);
+            const uint64_t LOWER_MASK = UINT64_C(0x000000007FFFFFFF);
+            const uint64_t mag01[2] = {0x0UL, UINT64_C(0xB5026F5AA96619E9)};
+            int i = 0;
+            uint64_t x;
+#if defined(__SSE2__)
+            for (; i + 2 <= N - M; i += 2) {
+                twist2(&mt[i], &mt[i + M]);
+            }
+#endif
+            for (; i < N - M; i++) {
+                x = (mt[i] & UPPER_MASK) | (mt[i + 1] & LOWER_MASK);
+                mt[i] = mt[i + M] ^ (x >> 1) ^ mag01[x & UINT64_C(1)];
+            }
+#if defined(__SSE2__)
+            for (; i + 2 <= N - 1; i += 2) {
+                twist2(&mt[i], &mt[i + M - N]);
+            }
+#endif
+            for (; i < N - 1; i++) {
+                x = (mt[i] & UPPER_MASK) | (mt[i + 1] & LOWER_MASK);
+                mt[i] = mt[i + M - N] ^ (x >> 1) ^ mag01[x & UINT64_C(1)];
+            }
+            x = (mt[N - 1] & UPPER_MASK) | (mt[0] & LOWER_MASK);
+            mt[N - 1] = mt[M - 1] ^ (x >> 1) ^ mag01[x & UINT64_C(1)];
+        }
+
+#if defined(__SSE2__)
+        static void twist2(uint64_t * p, const uint64_t * q) {
+            const __m128i upper = _mm_set1_epi64x(
+                static_cast<long long>(UINT64_C(0xFFFFFFFF80000000)));
+            const __m128i lower = _mm_set1_epi64x(
+                static_cast<long long>(UINT64_C(0x000000007FFFFFFF)));
+            const __m128i one = _mm_set1_epi64x(1);
+            const __m128i matrix = _mm_set1_epi64x(
+                static_cast<long long>(UINT64_C(0xB5026F5AA96619E9)));
+            __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i *>(p));
+            __m128i b = _mm_loadu_si128(
+                reinterpret_cast<__m128i *>(p + 1));
+            __m128i c = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(q));
+            __m128i x = _mm_or_si128(_mm_and_si128(a, upper),
+                                     _mm_and_si128(b, lower));
+            __m128i m = _mm_sub_epi64(_mm_setzero_si128(),
+                                      _mm_and_si128(x, one));
+            __m128i r = _mm_xor_si128(c, _mm_srli_epi64(x, 1));
+            r = _mm_xor_si128(r, _mm_and_si128(m, matrix));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p), r);
+        }
+#endif
+
+        /*
+         * src の N 語を調律して dst に書き込む。
+         */
+        static void temper_block(uint64_t * dst, const uint64_t * src) {
+            int i = 0;
+#if defined(__SSE2__)
+            const __m128i c0 = _mm_set1_epi64x(
+                static_cast<long long>(UINT64_C(0x5555555555555555)));
+            const __m128i c1 = _mm_set1_epi64x(
+                static_cast<long long>(UINT64_C(0x71D67FFFEDA60000)));
+            const __m128i c2 = _mm_set1_epi64x(
+                static_cast<long long>(UINT64_C(0xFFF7EEE000000000)));
+            for (; i + 2 <= N; i += 2) {
+                __m128i y = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(&src[i]));
+                y = _mm_xor_si128(y, _mm_and_si128(_mm_srli_epi64(y, 29),
+                                                   c0));
+                y = _mm_xor_si128(y, _mm_and_si128(_mm_slli_epi64(y, 17),
+                                                   c1));
+                y = _mm_xor_si128(y, _mm_and_si128(_mm_slli_epi64(y, 37),
+                                                   c2));
+                y = _mm_xor_si128(y, _mm_srli_epi64(y, 43));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i]), y);
+            }
+#endif
+            for (; i < N; i++) {
+                dst[i] = temper(src[i]);
+            }
+        }
+
+        static uint64_t temper(uint64_t y) {
             y ^= (y >> 29) & UINT64_C(0x5555555555555555);
             y ^= (y << 17) & UINT64_C(0x71D67FFFEDA60000);
             y ^= (y << 37) & UINT64_C(0xFFF7EEE000000000);
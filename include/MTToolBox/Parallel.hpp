@@ -0,0 +1,557 @@
+#ifndef MTTOOLBOX_PARALLEL_HPP
+#define MTTOOLBOX_PARALLEL_HPP
+/**
+ * @file Parallel.hpp
+ *
+ *\japanese
+ * @brief 並列探索のための小さなスレッドライブラリ
+ *
+ * POSIX スレッドの薄いラッパーである。ミューテックス、条件変数、
+ * 容量制限付きのキュー、同じ処理を複数のスレッドで実行する
+ * ワーカープールを提供する。
+ *\endjapanese
+ *
+ *\english
+ * @brief Small thread library for parallel search
+ *
+ * This is a thin wrapper of POSIX threads. It provides mutex,
+ * condition variable, bounded queue and worker pool which runs
+ * the same job in several threads.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <pthread.h>
+#include <unistd.h>
+#include <deque>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#if __cplusplus >= 201103L
+#include <exception>
+#endif
+#include <MTToolBox/Topology.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class Mutex
+     *\japanese
+     * @brief ミューテックス
+     *\endjapanese
+     *
+     *\english
+     * @brief Mutex
+     *\endenglish
+     */
+    class Mutex {
+    public:
+        Mutex() {
+            pthread_mutex_init(&mutex, NULL);
+        }
+        ~Mutex() {
+            pthread_mutex_destroy(&mutex);
+        }
+        void lock() {
+            pthread_mutex_lock(&mutex);
+        }
+        void unlock() {
+            pthread_mutex_unlock(&mutex);
+        }
+    private:
+        friend class Condition;
+        pthread_mutex_t mutex;
+        Mutex(const Mutex&);
+        Mutex& operator=(const Mutex&);
+    };
+
+    /**
+     * @class ScopedLock
+     *\japanese
+     * @brief スコープを抜けるときにロックを解放する
+     *\endjapanese
+     *
+     *\english
+     * @brief Releases lock when leaving scope
+     *\endenglish
+     */
+    class ScopedLock {
+    public:
+        ScopedLock(Mutex& m) : mutex(m) {
+            mutex.lock();
+        }
+        ~ScopedLock() {
+            mutex.unlock();
+        }
+    private:
+        Mutex& mutex;
+        ScopedLock(const ScopedLock&);
+        ScopedLock& operator=(const ScopedLock&);
+    };
+
+    /**
+     * @class Condition
+     *\japanese
+     * @brief 条件変数
+     *\endjapanese
+     *
+     *\english
+     * @brief Condition variable
+     *\endenglish
+     */
+    class Condition {
+    public:
+        Condition(Mutex& m) : mutex(m) {
+            pthread_cond_init(&cond, NULL);
+        }
+        ~Condition() {
+            pthread_cond_destroy(&cond);
+        }
+        /**
+         *\japanese
+         * 通知を待つ。ミューテックスをロックしてから呼ぶこと。
+         *\endjapanese
+         *
+         *\english
+         * Waits for a notification. The mutex should be locked.
+         *\endenglish
+         */
+        void wait() {
+            pthread_cond_wait(&cond, &mutex.mutex);
+        }
+        void signal() {
+            pthread_cond_signal(&cond);
+        }
+        void broadcast() {
+            pthread_cond_broadcast(&cond);
+        }
+    private:
+        Mutex& mutex;
+        pthread_cond_t cond;
+        Condition(const Condition&);
+        Condition& operator=(const Condition&);
+    };
+
+    /**
+     * @class BoundedQueue
+     *\japanese
+     * @brief 容量制限付きのスレッドセーフなキュー
+     *
+     * 満杯のときの push と空のときの pop は待つ。close() の後は push
+     * できないが、残っている要素は pop できる。cancel() の後は
+     * push も pop もすぐに false を返す。
+     * @tparam T 要素の型
+     *\endjapanese
+     *
+     *\english
+     * @brief Thread safe queue with capacity
+     *
+     * push waits while full and pop waits while empty. After close(),
+     * push fails but remaining elements can be popped. After cancel(),
+     * both push and pop return false immediately.
+     * @tparam T type of elements
+     *\endenglish
+     */
+    template<typename T>
+    class BoundedQueue {
+    public:
+        BoundedQueue(size_t capacity) :
+            not_full(mutex), not_empty(mutex) {
+            this->capacity = capacity;
+            closed = false;
+            canceled = false;
+        }
+
+        /**
+         *\japanese
+         * 要素を追加する。
+         * @param[in] x 追加する要素
+         * @return 閉じられていて追加できなかったら false
+         *\endjapanese
+         *
+         *\english
+         * Adds an element.
+         * @param[in] x element to be added
+         * @return false if closed and not added
+         *\endenglish
+         */
+        bool push(const T& x) {
+            ScopedLock lock(mutex);
+            while (queue.size() >= capacity && !closed && !canceled) {
+                not_full.wait();
+            }
+            if (closed || canceled) {
+                return false;
+            }
+            queue.push_back(x);
+            not_empty.signal();
+            return true;
+        }
+
+        /**
+         *\japanese
+         * 要素を取り出す。
+         * @param[out] x 取り出した要素
+         * @return 閉じられていて空なら false
+         *\endjapanese
+         *
+         *\english
+         * Takes an element.
+         * @param[out] x the element
+         * @return false if closed and empty
+         *\endenglish
+         */
+        bool pop(T& x) {
+            ScopedLock lock(mutex);
+            while (queue.empty() && !closed && !canceled) {
+                not_empty.wait();
+            }
+            if (canceled || queue.empty()) {
+                return false;
+            }
+            x = queue.front();
+            queue.pop_front();
+            not_full.signal();
+            return true;
+        }
+
+        void close() {
+            ScopedLock lock(mutex);
+            closed = true;
+            not_full.broadcast();
+            not_empty.broadcast();
+        }
+
+        void cancel() {
+            ScopedLock lock(mutex);
+            canceled = true;
+            not_full.broadcast();
+            not_empty.broadcast();
+        }
+
+        /**
+         *\japanese
+         * 残っている要素をすべて取り出す。スレッドの終了後に使う。
+         * @param[out] rest 残っていた要素
+         *\endjapanese
+         *
+         *\english
+         * Takes all remaining elements. Used after threads finished.
+         * @param[out] rest remaining elements
+         *\endenglish
+         */
+        void drain(std::vector<T>& rest) {
+            ScopedLock lock(mutex);
+            rest.insert(rest.end(), queue.begin(), queue.end());
+            queue.clear();
+        }
+    private:
+        Mutex mutex;
+        Condition not_full;
+        Condition not_empty;
+        std::deque<T> queue;
+        size_t capacity;
+        bool closed;
+        bool canceled;
+    };
+
+    /**
+     * @class Runnable
+     *\japanese
+     * @brief スレッドで実行される処理
+     *\endjapanese
+     *
+     *\english
+     * @brief Job executed by threads
+     *\endenglish
+     */
+    class Runnable {
+    public:
+        virtual ~Runnable() {}
+        /**
+         *\japanese
+         * 処理本体。同じオブジェクトが複数のスレッドで同時に実行される。
+         * @param[in] index ワーカーの番号 0 \<= index \< スレッド数
+         *\endjapanese
+         *
+         *\english
+         * Body of job. The same object is executed by several threads
+         * concurrently.
+         * @param[in] index index of worker, 0 \<= index \< number of threads
+         *\endenglish
+         */
+        virtual void run(int index) = 0;
+    };
+
+    /**
+     * @class FirstError
+     *\japanese
+     * @brief ワーカーのスレッドで最初に起きた例外を保存する
+     *
+     * スレッドから例外が抜けるとプロセスが終了してしまうので、
+     * ワーカーは例外を catch ブロックの中で capture() に渡し、
+     * join() の後で呼び出し側が rethrow() する。C++11 より前では
+     * 例外の型は保存できないので、メッセージを持つ
+     * std::runtime_error として投げ直す。
+     *\endjapanese
+     *
+     *\english
+     * @brief Keeps the first exception thrown in worker threads
+     *
+     * An exception leaving a thread terminates the process, so a
+     * worker passes the exception to capture() in a catch block, and
+     * the caller calls rethrow() after join(). Before C++11, the type
+     * of exception can't be kept, so it is rethrown as a
+     * std::runtime_error with the message.
+     *\endenglish
+     */
+    class FirstError {
+    public:
+        FirstError() {
+            caught = false;
+        }
+
+        /**
+         *\japanese
+         * 処理中の例外を保存する。catch ブロックの中で呼ぶこと。
+         * 既に保存されていれば何もしない。
+         * @return 最初の例外なら true
+         *\endjapanese
+         *
+         *\english
+         * Keeps the exception being handled. Should be called in a
+         * catch block. Does nothing if one is already kept.
+         * @return true if it is the first exception
+         *\endenglish
+         */
+        bool capture() {
+            ScopedLock lock(mutex);
+            if (caught) {
+                return false;
+            }
+            caught = true;
+#if __cplusplus >= 201103L
+            error = std::current_exception();
+#else
+            try {
+                throw;
+            } catch (std::exception& e) {
+                message = e.what();
+            } catch (...) {
+                message = "unknown exception in worker thread";
+            }
+#endif
+            return true;
+        }
+
+        /**
+         *\japanese
+         * @return 例外が保存されていれば true
+         *\endjapanese
+         *
+         *\english
+         * @return true if an exception is kept
+         *\endenglish
+         */
+        bool failed() {
+            ScopedLock lock(mutex);
+            return caught;
+        }
+
+        /**
+         *\japanese
+         * 保存した例外を投げる。保存されていなければ何もしない。
+         *\endjapanese
+         *
+         *\english
+         * Throws the kept exception. Does nothing if none is kept.
+         *\endenglish
+         */
+        void rethrow() {
+            ScopedLock lock(mutex);
+            if (!caught) {
+                return;
+            }
+#if __cplusplus >= 201103L
+            std::rethrow_exception(error);
+#else
+            throw std::runtime_error(message);
+#endif
+        }
+    private:
+        Mutex mutex;
+        bool caught;
+#if __cplusplus >= 201103L
+        std::exception_ptr error;
+#else
+        std::string message;
+#endif
+        FirstError(const FirstError&);
+        FirstError& operator=(const FirstError&);
+    };
+
+    /**
+     * @class WorkerPool
+     *\japanese
+     * @brief 同じ処理を複数のスレッドで実行する
+     *
+     * setPinning(true) の後は、各スレッドを CpuTopology::placement()
+     * の CPU に固定してから処理を始める。ひとつのプールの中では、
+     * start() を何度呼んでも通し番号で CPU を割り当てる。
+     *\endjapanese
+     *
+     *\english
+     * @brief Runs the same job in several threads
+     *
+     * After setPinning(true), each thread is pinned to the CPU of
+     * CpuTopology::placement() before starting the job. In a pool,
+     * CPUs are assigned by serial numbers however many times start()
+     * is called.
+     *\endenglish
+     */
+    class WorkerPool {
+    public:
+        WorkerPool() {
+            placed = 0;
+        }
+        ~WorkerPool() {
+            join();
+        }
+
+        /**
+         *\japanese
+         * \b count 個のスレッドで \b job を開始する。
+         * @param[in] job 処理
+         * @param[in] count スレッド数
+         *\endjapanese
+         *
+         *\english
+         * Starts \b job in \b count threads.
+         * @param[in] job job
+         * @param[in] count number of threads
+         *\endenglish
+         */
+        void start(Runnable& job, int count) {
+            for (int i = 0; i < count; i++) {
+                Worker * w = new Worker;
+                w->job = &job;
+                w->index = i;
+                w->cpu = -1;
+                if (getPinning()) {
+                    w->cpu = CpuTopology::system().placement(placed++);
+                }
+                if (pthread_create(&w->thread, NULL, entry, w) != 0) {
+                    delete w;
+                    throw std::runtime_error("can't create thread");
+                }
+                workers.push_back(w);
+            }
+        }
+
+        /**
+         *\japanese
+         * すべてのスレッドの終了を待つ。
+         *\endjapanese
+         *
+         *\english
+         * Waits for all threads to finish.
+         *\endenglish
+         */
+        void join() {
+            for (size_t i = 0; i < workers.size(); i++) {
+                pthread_join(workers[i]->thread, NULL);
+                delete workers[i];
+            }
+            workers.clear();
+        }
+
+        /**
+         *\japanese
+         * 使用可能なプロセッサの数を返す。
+         *\endjapanese
+         *
+         *\english
+         * Returns number of available processors.
+         *\endenglish
+         */
+        static int hardwareConcurrency() {
+            long n = sysconf(_SC_NPROCESSORS_ONLN);
+            if (n < 1) {
+                return 1;
+            }
+            return static_cast<int>(n);
+        }
+
+        /**
+         *\japanese
+         * 以後に開始するスレッドを CPU に固定するかどうかを、プロセス
+         * 全体で設定する。
+         *
+         * 固定したスレッドが確保して最初に書き込んだメモリは、その CPU
+         * のノードに置かれる。同じ計算機で複数のプロセスを動かすときは、
+         * 同じ CPU に固定されて競合するので使わないこと。
+         * @param[in] pin 固定するなら true
+         *\endjapanese
+         *
+         *\english
+         * Sets whether threads started afterwards are pinned to CPUs,
+         * for the whole process.
+         *
+         * Memory allocated and first written by a pinned thread is
+         * placed on the node of the CPU. Do not use this when several
+         * processes run on the same machine, because they are pinned to
+         * the same CPUs and compete.
+         * @param[in] pin true to pin
+         *\endenglish
+         */
+        static void setPinning(bool pin) {
+            pinning() = pin ? 1 : 0;
+        }
+
+        /**
+         *\japanese
+         * @return スレッドを CPU に固定するなら true
+         *\endjapanese
+         *
+         *\english
+         * @return true if threads are pinned to CPUs
+         *\endenglish
+         */
+        static bool getPinning() {
+            return pinning() != 0;
+        }
+    private:
+        struct Worker {
+            pthread_t thread;
+            Runnable * job;
+            int index;
+            int cpu;
+        };
+        std::vector<Worker *> workers;
+        int placed;
+
+        static int& pinning() {
+            static int pin = 0;
+            return pin;
+        }
+
+        static void * entry(void * arg) {
+            Worker * w = static_cast<Worker *>(arg);
+            if (w->cpu >= 0) {
+                CpuTopology::pin(w->cpu);
+            }
+            w->job->run(w->index);
+            return NULL;
+        }
+        WorkerPool(const WorkerPool&);
+        WorkerPool& operator=(const WorkerPool&);
+    };
+}
+#endif // MTTOOLBOX_PARALLEL_HPP
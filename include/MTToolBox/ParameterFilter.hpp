@@ -0,0 +1,371 @@
+#ifndef MTTOOLBOX_PARAMETER_FILTER_HPP
+#define MTTOOLBOX_PARAMETER_FILTER_HPP
+/**
+ * @file ParameterFilter.hpp
+ *
+ *\japanese
+ * @brief 既に棄却されたパラメータを覚えておき、再試行を避ける
+ *
+ * AlgorithmRecursionSearch などは ParameterGenerator からパラメータを
+ * 作るので、同じ種で実行しなおしたり、別の実行で同じ範囲を探したり
+ * すると、既に棄却されたパラメータの最小多項式を何度も計算する
+ * ことになる。このファイルのクラスは棄却されたパラメータの
+ * getRecursionKey() を記録し、最小多項式を計算する前に調べられる
+ * ようにする。記録はファイルに保存できるので、同じ生成器、同じ
+ * メルセンヌ指数の探索を繰り返すときに使える。
+ *
+ * ひとつの記録ファイルは、ひとつの種類の生成器とひとつのメルセンヌ
+ * 指数の探索だけに使うこと。パラメータ文字列が同じでも、生成器や
+ * 指数が違えば棄却されるかどうかは違う。
+ *\endjapanese
+ *
+ *\english
+ * @brief Remembers rejected parameters, and avoids trying them again
+ *
+ * AlgorithmRecursionSearch and others make parameters from
+ * ParameterGenerator, so rerunning with the same seed or searching
+ * the same range in another run calculates minimal polynomials of
+ * already rejected parameters again and again. Classes in this file
+ * record getRecursionKey() of rejected parameters so that they can be
+ * looked up before calculating minimal polynomials. Records can be
+ * saved in a file and used by repeated searches of the same
+ * generator and the same Mersenne exponent.
+ *
+ * Use one record file only for searches of one type of generator and
+ * one Mersenne exponent. Whether a parameter is rejected or not
+ * depends on the generator and the exponent even if the parameter
+ * strings are the same.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <string>
+#include <set>
+#include <MTToolBox/Parallel.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class ParameterFilter
+     *\japanese
+     * @brief 棄却されたパラメータの記録
+     *
+     * rejected() で調べ、reject() で記録する。調べた回数、記録に
+     * あった回数、記録した回数を数える。複数のスレッドから同時に
+     * 使ってよい。
+     *\endjapanese
+     *
+     *\english
+     * @brief Record of rejected parameters
+     *
+     * rejected() looks up and reject() records. Counts of look ups,
+     * hits and records are kept. Several threads may use an instance
+     * at the same time.
+     *\endenglish
+     */
+    class ParameterFilter {
+    public:
+        ParameterFilter() {
+            lookups = 0;
+            hits = 0;
+            inserts = 0;
+        }
+        virtual ~ParameterFilter() {}
+
+        /**
+         *\japanese
+         * パラメータが記録されているか調べる。
+         * @param[in] key getRecursionKey() の値
+         * @return 記録されていれば true
+         *\endjapanese
+         *
+         *\english
+         * Looks up a parameter.
+         * @param[in] key value of getRecursionKey()
+         * @return true if recorded
+         *\endenglish
+         */
+        bool rejected(const std::string& key) {
+            __sync_add_and_fetch(&lookups, 1);
+            if (contains(key)) {
+                __sync_add_and_fetch(&hits, 1);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         *\japanese
+         * 棄却されたパラメータを記録する。
+         * @param[in] key getRecursionKey() の値
+         *\endjapanese
+         *
+         *\english
+         * Records a rejected parameter.
+         * @param[in] key value of getRecursionKey()
+         *\endenglish
+         */
+        void reject(const std::string& key) {
+            __sync_add_and_fetch(&inserts, 1);
+            add(key);
+        }
+
+        /**
+         *\japanese
+         * @return rejected() を呼んだ回数
+         *\endjapanese
+         *
+         *\english
+         * @return number of calls of rejected()
+         *\endenglish
+         */
+        long getLookups() const {
+            return lookups;
+        }
+
+        /**
+         *\japanese
+         * @return rejected() が true を返した回数
+         *\endjapanese
+         *
+         *\english
+         * @return number of times rejected() returned true
+         *\endenglish
+         */
+        long getHits() const {
+            return hits;
+        }
+
+        /**
+         *\japanese
+         * @return reject() を呼んだ回数
+         *\endjapanese
+         *
+         *\english
+         * @return number of calls of reject()
+         *\endenglish
+         */
+        long getInserts() const {
+            return inserts;
+        }
+
+        /**
+         *\japanese
+         * @return rejected() が true を返した割合、調べていなければ 0
+         *\endjapanese
+         *
+         *\english
+         * @return ratio of rejected() returning true, 0 if not looked
+         * up yet
+         *\endenglish
+         */
+        double getHitRate() const {
+            if (lookups == 0) {
+                return 0;
+            }
+            return static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    protected:
+        /**
+         *\japanese
+         * @param[in] key パラメータ文字列
+         * @return 記録されていれば true
+         *\endjapanese
+         *
+         *\english
+         * @param[in] key parameter string
+         * @return true if recorded
+         *\endenglish
+         */
+        virtual bool contains(const std::string& key) = 0;
+
+        /**
+         *\japanese
+         * @param[in] key 記録するパラメータ文字列
+         *\endjapanese
+         *
+         *\english
+         * @param[in] key parameter string to be recorded
+         *\endenglish
+         */
+        virtual void add(const std::string& key) = 0;
+    private:
+        long lookups;
+        long hits;
+        long inserts;
+        ParameterFilter(const ParameterFilter&);
+        ParameterFilter& operator=(const ParameterFilter&);
+    };
+
+    /**
+     * @class BloomParameterFilter
+     *\japanese
+     * @brief ブルームフィルタによる記録
+     *
+     * 記録は一定の大きさのビット配列で、ファイルを共有メモリとして
+     * マップして持つ。ビットの設定は不可分に行うので、同じファイルを
+     * 複数のプロセスが同時に使ってもよい。記録していないパラメータを
+     * 記録済みと答えることがあり、その確率はビット数 m、ハッシュ関数
+     * の数 k、記録した数 n に対しておよそ (1 - exp(-kn/m))^k である。
+     * この場合、よいパラメータがひとつ試されずに終わるだけで、誤った
+     * パラメータが出力されることはない。
+     *
+     * ファイルはホストのバイト順で書かれるので、異なるバイト順の計算機
+     * の間では共有できない。
+     *\endjapanese
+     *
+     *\english
+     * @brief Record by a Bloom filter
+     *
+     * The record is a bit array of fixed size, held by mapping a file
+     * as shared memory. Bits are set atomically, so several processes
+     * can use the same file at the same time. A parameter not
+     * recorded may be reported as recorded, and its probability is
+     * about (1 - exp(-kn/m))^k for m bits, k hash functions and n
+     * records. In that case, a good parameter is just not tried, and
+     * wrong parameters are never output.
+     *
+     * The file is written in the byte order of the host, and cannot be
+     * shared among machines with different byte orders.
+     *\endenglish
+     */
+    class BloomParameterFilter : public ParameterFilter {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         *
+         * ファイルが既にあれば、その大きさとハッシュ関数の数を使い、
+         * \b bits と \b hashes は無視する。
+         * @param[in] path 記録ファイル、空文字列ならメモリ上だけに持つ
+         * @param[in] bits ビット数、64 の倍数に切り上げる
+         * @param[in] hashes ハッシュ関数の数
+         * @throw std::invalid_argument bits か hashes が正でないとき
+         * @throw std::runtime_error ファイルを作れないか、形式が違うとき
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         *
+         * If the file exists, its size and number of hash functions are
+         * used, and \b bits and \b hashes are ignored.
+         * @param[in] path record file, empty string to hold only in
+         * memory
+         * @param[in] bits number of bits, rounded up to a multiple of 64
+         * @param[in] hashes number of hash functions
+         * @throw std::invalid_argument when bits or hashes is not
+         * positive
+         * @throw std::runtime_error when failed to make the file, or
+         * format of the file is wrong
+         *\endenglish
+         */
+        BloomParameterFilter(const std::string& path,
+                             uint64_t bits = UINT64_C(1) << 27,
+                             int hashes = 7);
+        ~BloomParameterFilter();
+
+        /**
+         *\japanese
+         * @return ビット数
+         *\endjapanese
+         *
+         *\english
+         * @return number of bits
+         *\endenglish
+         */
+        uint64_t getBits() const {
+            return bits;
+        }
+
+        /**
+         *\japanese
+         * @return ハッシュ関数の数
+         *\endjapanese
+         *
+         *\english
+         * @return number of hash functions
+         *\endenglish
+         */
+        int getHashes() const {
+            return hashes;
+        }
+    protected:
+        bool contains(const std::string& key);
+        void add(const std::string& key);
+    private:
+        int fd;
+        void * map;
+        size_t mapSize;
+        uint64_t * words;
+        uint64_t bits;
+        int hashes;
+    };
+
+    /**
+     * @class ExactParameterFilter
+     *\japanese
+     * @brief 文字列の集合による記録
+     *
+     * パラメータ文字列をそのまま集合に持つので誤りはないが、記録した
+     * 数に比例するメモリを使う。パラメータ空間が小さいときに使う。
+     * ファイルを与えると、記録をファイルの末尾に追加していき、次回は
+     * ファイルから読み込む。
+     *\endjapanese
+     *
+     *\english
+     * @brief Record by a set of strings
+     *
+     * Parameter strings are kept in a set, so there are no errors, but
+     * memory proportional to the number of records is used. This is
+     * for small parameter spaces. If a file is given, records are
+     * appended to the file, and read from the file next time.
+     *\endenglish
+     */
+    class ExactParameterFilter : public ParameterFilter {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         * @param[in] path 記録ファイル、空文字列ならメモリ上だけに持つ
+         * @throw std::runtime_error ファイルを開けないか、形式が違うとき
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         * @param[in] path record file, empty string to hold only in
+         * memory
+         * @throw std::runtime_error when failed to open the file, or
+         * format of the file is wrong
+         *\endenglish
+         */
+        ExactParameterFilter(const std::string& path = "");
+        ~ExactParameterFilter();
+
+        /**
+         *\japanese
+         * @return 記録されているパラメータの数
+         *\endjapanese
+         *
+         *\english
+         * @return number of recorded parameters
+         *\endenglish
+         */
+        size_t size();
+    protected:
+        bool contains(const std::string& key);
+        void add(const std::string& key);
+    private:
+        int fd;
+        Mutex mutex;
+        std::set<std::string> keys;
+    };
+}
+#endif // MTTOOLBOX_PARAMETER_FILTER_HPP
@@ -108,6 +108,39 @@ namespace MTToolBox {
          *\endenglish
          */
         virtual const std::string getParamString() = 0;
+
+        /**
+         *\japanese
+         * 状態遷移関数を決めるパラメータだけの文字列表現を返す。
+         *
+         * ParameterFilter はこの値で棄却されたパラメータを記録する。
+         * getParamString() が、パリティベクトルやテンパリングパラメータ
+         * のように探索で見つかった後に設定される値を含む場合は、
+         * それらを除いた文字列を返すようにオーバーライドすること。
+         * そうしないと、前回見つかったパラメータの値が残ったまま同じ
+         * パラメータを作っても別のキーになり、記録が役に立たない。
+         * デフォルトでは getParamString() を返す。
+         * @return 状態遷移関数のパラメータの文字列
+         *\endjapanese
+         *
+         *\english
+         * Returns string expression of only the parameters which
+         * determine the recursion.
+         *
+         * ParameterFilter records rejected parameters by this value.
+         * If getParamString() contains values which are set after the
+         * parameter is found, such as parity vectors and tempering
+         * parameters, override this to return a string without them.
+         * Otherwise the same parameters make different keys while the
+         * values of the previously found parameter remain, and the
+         * record does not work. By default, getParamString() is
+         * returned.
+         * @return string of parameters of the recursion
+         *\endenglish
+         */
+        virtual const std::string getRecursionKey() {
+            return getParamString();
+        }
     };
 }
 
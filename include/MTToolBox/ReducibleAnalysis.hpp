@@ -0,0 +1,398 @@
+#ifndef MTTOOLBOX_REDUCIBLE_ANALYSIS_HPP
+#define MTTOOLBOX_REDUCIBLE_ANALYSIS_HPP
+/**
+ * @file ReducibleAnalysis.hpp
+ *
+ *\japanese
+ * @brief 可約ジェネレータの解析結果を共有する
+ *
+ * 可約ジェネレータのパラメータが見つかった後、パリティチェックベクトル、
+ * 固定点、均等分布次元の計算は、いずれも特性多項式 h = f * q の分解と、
+ * 多項式による状態空間の殲滅を使う。これまではそれぞれの計算が最小多項式、
+ * 既約因子、特性多項式を計算し直していた。ReducibleAnalysis はひとつの
+ * パラメータについて分解を一度だけ行い、射影の多項式と殲滅した状態を
+ * 保持して、それぞれの計算に提供する。
+ *\endjapanese
+ *
+ *\english
+ * @brief Shares analysis results of a reducible generator
+ *
+ * After parameters of a reducible generator are found, calculations
+ * of the parity check vector, the fixed point and dimension of
+ * equidistribution all use the decomposition h = f * q of the
+ * characteristic polynomial and annihilation of the state space by
+ * polynomials. Each of them used to calculate the minimal
+ * polynomial, the irreducible factor and the characteristic
+ * polynomial again. ReducibleAnalysis makes the decomposition only
+ * once for a parameter, keeps polynomials of projections and
+ * annihilated states, and serves them to each calculation.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Manieth Corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (C) 2015, 2016 Mutsuo Saito, Makoto Matsumoto, Manieth Corp.
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdexcept>
+#include <NTL/GF2X.h>
+#include <MTToolBox/ReducibleGenerator.hpp>
+#include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
+#include <MTToolBox/AlgorithmCalculateParity.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class ReducibleAnalysis
+     *\japanese
+     * @brief ひとつのパラメータについての可約ジェネレータの解析
+     *
+     * 特性多項式 h、既約因子 f、商 q = h / f を一度だけ求めて保持する。
+     * f で殲滅される部分空間への射影 e (e &equiv; 1 mod f,
+     * e &equiv; 0 mod q) やパリティチェックベクトル、q で殲滅した状態は
+     * 最初に必要になったときに計算して保持する。
+     *
+     * 状態遷移のパラメータを変えたら、新しいインスタンスを作ること。
+     * @tparam U 疑似乱数生成器の出力の型
+     * @tparam G 疑似乱数生成器、ReducibleGenerator<U> の派生クラス
+     *\endjapanese
+     *
+     *\english
+     * @brief Analysis of a reducible generator for one parameter
+     *
+     * The characteristic polynomial h, the irreducible factor f and the
+     * quotient q = h / f are calculated only once and kept. The
+     * projection e to the subspace annihilated by f (e &equiv; 1 mod f,
+     * e &equiv; 0 mod q), the parity check vector and the state
+     * annihilated by q are calculated when they are needed first, and
+     * kept.
+     *
+     * Make a new instance when parameters of the state transition are
+     * changed.
+     * @tparam U type of output of the generator
+     * @tparam G generator, derived class of ReducibleGenerator<U>
+     *\endenglish
+     */
+    template<typename U, typename G>
+    class ReducibleAnalysis {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         *
+         * 特性多項式は generator の複製を使って calcCharacteristicPolynomial()
+         * で求める。その次数が状態空間のビット数に達しない場合、得られる
+         * のは generator の状態を殲滅する多項式であり、殲滅や射影は
+         * その状態から生成される部分空間でのみ正しい。全空間で必要なら、
+         * 特性多項式を与えるコンストラクタを使うこと。
+         * @param[in] generator 可約ジェネレータ、状態も複製して保持する
+         * @param[in] irreducible 特性多項式のメルセンヌ指数次の既約因子
+         * @param[in] threads 計算に使うスレッド数
+         * @throw std::invalid_argument irreducible が特性多項式を割り切らない
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         *
+         * The characteristic polynomial is calculated by
+         * calcCharacteristicPolynomial() using a copy of generator. If
+         * its degree does not reach the bit size of the state space,
+         * what is obtained is a polynomial annihilating the state of
+         * generator, and annihilation and projection are valid only in
+         * the subspace generated from that state. Use the constructor
+         * which receives the characteristic polynomial if the whole
+         * space is needed.
+         * @param[in] generator reducible generator, its state is also
+         * copied and kept.
+         * @param[in] irreducible irreducible factor of the characteristic
+         * polynomial whose degree is the Mersenne exponent.
+         * @param[in] threads number of threads used for calculation.
+         * @throw std::invalid_argument if irreducible does not divide
+         * the characteristic polynomial.
+         *\endenglish
+         */
+        ReducibleAnalysis(const G& generator, const NTL::GF2X& irreducible,
+                          int threads = 1) : base(generator) {
+            G work(generator);
+            NTL::GF2X lcm;
+            calcCharacteristicPolynomial(&work, lcm, threads);
+            init(irreducible, lcm, threads);
+        }
+
+        /**
+         *\japanese
+         * コンストラクタ
+         *
+         * 特性多項式がすでに分かっている場合に使う。
+         * @param[in] generator 可約ジェネレータ、状態も複製して保持する
+         * @param[in] irreducible 特性多項式のメルセンヌ指数次の既約因子
+         * @param[in] characteristic 特性多項式、または状態空間を殲滅する多項式
+         * @param[in] threads 計算に使うスレッド数
+         * @throw std::invalid_argument irreducible が characteristic を
+         * 割り切らない
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         *
+         * Used when the characteristic polynomial is already known.
+         * @param[in] generator reducible generator, its state is also
+         * copied and kept.
+         * @param[in] irreducible irreducible factor of the characteristic
+         * polynomial whose degree is the Mersenne exponent.
+         * @param[in] characteristic characteristic polynomial, or a
+         * polynomial which annihilates the state space.
+         * @param[in] threads number of threads used for calculation.
+         * @throw std::invalid_argument if irreducible does not divide
+         * characteristic.
+         *\endenglish
+         */
+        ReducibleAnalysis(const G& generator, const NTL::GF2X& irreducible,
+                          const NTL::GF2X& characteristic, int threads = 1)
+            : base(generator) {
+            init(irreducible, characteristic, threads);
+        }
+
+        ~ReducibleAnalysis() {
+            delete irreducibleState;
+        }
+
+        const NTL::GF2X& getIrreducibleFactor() const {
+            return irreducible;
+        }
+
+        const NTL::GF2X& getCharacteristicPolynomial() const {
+            return characteristic;
+        }
+
+        /**
+         *\japanese
+         * @return 商 q = h / f
+         *\endjapanese
+         *
+         *\english
+         * @return quotient q = h / f
+         *\endenglish
+         */
+        const NTL::GF2X& getQuotient() const {
+            return quotient;
+        }
+
+        /**
+         *\japanese
+         * f で殲滅される部分空間への射影を返す。
+         *
+         * e &equiv; 1 mod f, e &equiv; 0 mod q となる deg(h) 未満の多項式
+         * である。状態を e で殲滅すると、q で殲滅される成分が消え、
+         * f で殲滅される成分はそのまま残る。
+         * @return 射影 e
+         * @throw std::logic_error f と q が互いに素でない
+         *\endjapanese
+         *
+         *\english
+         * Returns the projection to the subspace annihilated by f.
+         *
+         * This is the polynomial of degree less than deg(h) such that
+         * e &equiv; 1 mod f and e &equiv; 0 mod q. Annihilating a
+         * state by e removes the component annihilated by q, and keeps
+         * the component annihilated by f as is.
+         * @return projection e
+         * @throw std::logic_error if f and q are not coprime
+         *\endenglish
+         */
+        const NTL::GF2X& getProjector() {
+            if (IsZero(projector)) {
+                NTL::GF2X b;
+                inverseModIrreducible(b, quotient);
+                NTL::MulMod(projector, b, quotient, characteristic);
+            }
+            return projector;
+        }
+
+        /**
+         *\japanese
+         * f を法とした p の逆元を求める。
+         * @param[out] r p * r &equiv; 1 mod f となる多項式
+         * @param[in] p f と互いに素な多項式
+         * @throw std::logic_error p と f が互いに素でない
+         *\endjapanese
+         *
+         *\english
+         * Calculates inverse of p modulo f.
+         * @param[out] r polynomial such that p * r &equiv; 1 mod f
+         * @param[in] p polynomial coprime to f
+         * @throw std::logic_error if p and f are not coprime
+         *\endenglish
+         */
+        void inverseModIrreducible(NTL::GF2X& r, const NTL::GF2X& p) const {
+            NTL::GF2X d;
+            NTL::GF2X a;
+            NTL::XGCD(d, a, r, irreducible, p);
+            if (deg(d) != 0) {
+                throw std::logic_error("polynomial is not coprime to"
+                                       " irreducible factor");
+            }
+        }
+
+        /**
+         *\japanese
+         * 二つの多項式の積を h を法として求める。
+         *
+         * 多項式を続けて適用する代わりに積を一度適用すれば、生成器を
+         * 進める回数は deg(h) 未満になる。
+         * @param[out] r 積 a * b mod h
+         * @param[in] a 多項式
+         * @param[in] b 多項式
+         *\endjapanese
+         *
+         *\english
+         * Calculates product of two polynomials modulo h.
+         *
+         * Applying the product once instead of applying polynomials one
+         * after another, the generator is stepped less than deg(h)
+         * times.
+         * @param[out] r product a * b mod h
+         * @param[in] a polynomial
+         * @param[in] b polynomial
+         *\endenglish
+         */
+        void multiply(NTL::GF2X& r, const NTL::GF2X& a,
+                      const NTL::GF2X& b) const {
+            NTL::GF2X x = a % characteristic;
+            NTL::GF2X y = b % characteristic;
+            NTL::MulMod(r, x, y, characteristic);
+        }
+
+        /**
+         *\japanese
+         * h を法として簡約した多項式で状態を殲滅する。
+         * @param[in,out] g 可約ジェネレータ
+         * @param[in] poly 殲滅多項式
+         *\endjapanese
+         *
+         *\english
+         * Annihilates the state by a polynomial reduced modulo h.
+         * @param[in,out] g reducible generator
+         * @param[in] poly annihilator polynomial
+         *\endenglish
+         */
+        void apply(G& g, const NTL::GF2X& poly) const {
+            if (deg(poly) < deg(characteristic)) {
+                annihilate<U>(&g, poly);
+            } else {
+                annihilate<U>(&g, poly % characteristic);
+            }
+        }
+
+        /**
+         *\japanese
+         * 状態を q で殲滅し、f で殲滅される部分空間に落とす。
+         * @param[in,out] g 可約ジェネレータ
+         *\endjapanese
+         *
+         *\english
+         * Annihilates the state by q, which drops it to the subspace
+         * annihilated by f.
+         * @param[in,out] g reducible generator
+         *\endenglish
+         */
+        void annihilateQuotient(G& g) const {
+            annihilate<U>(&g, quotient);
+        }
+
+        /**
+         *\japanese
+         * コンストラクタに与えた状態を q で殲滅した状態を返す。
+         *
+         * 均等分布次元の計算に使う。最初の呼び出しで計算して保持する。
+         * @return f で殲滅される部分空間の状態
+         *\endjapanese
+         *
+         *\english
+         * Returns the state given to the constructor annihilated by q.
+         *
+         * This is used for calculation of dimension of
+         * equidistribution. It is calculated at the first call and
+         * kept.
+         * @return state in the subspace annihilated by f
+         *\endenglish
+         */
+        const G& getIrreducibleState() {
+            if (irreducibleState == NULL) {
+                irreducibleState = new G(base);
+                annihilateQuotient(*irreducibleState);
+            }
+            return *irreducibleState;
+        }
+
+        /**
+         *\japanese
+         * パリティチェックベクトルを求め、g に設定する。
+         *
+         * 最初の呼び出しで AlgorithmCalculateParity を使って計算し、
+         * 以降は保持した値を設定するだけである。
+         * @param[in,out] g 可約ジェネレータ、パリティチェックベクトルが
+         * 設定される
+         * @return パリティチェックベクトル
+         *\endjapanese
+         *
+         *\english
+         * Calculates the parity check vector and sets it to g.
+         *
+         * It is calculated by AlgorithmCalculateParity at the first
+         * call, and the kept value is only set after that.
+         * @param[in,out] g reducible generator, the parity check vector
+         * is set.
+         * @return parity check vector
+         *\endenglish
+         */
+        U getParity(G& g) {
+            if (!hasParity) {
+                AlgorithmCalculateParity<U, G> cp(threads);
+                parity = cp.searchParity(g, irreducible);
+                hasParity = true;
+                base.setParityValue(parity);
+                if (irreducibleState != NULL) {
+                    irreducibleState->setParityValue(parity);
+                }
+            } else {
+                g.setParityValue(parity);
+            }
+            return parity;
+        }
+    private:
+        G base;
+        G * irreducibleState;
+        NTL::GF2X irreducible;
+        NTL::GF2X characteristic;
+        NTL::GF2X quotient;
+        NTL::GF2X projector;
+        U parity;
+        bool hasParity;
+        int threads;
+
+        void init(const NTL::GF2X& irreducible,
+                  const NTL::GF2X& characteristic, int threads) {
+            NTL::GF2X r;
+            NTL::DivRem(quotient, r, characteristic, irreducible);
+            if (deg(irreducible) <= 0 || !IsZero(r)) {
+                throw std::invalid_argument("irreducible factor does not"
+                                            " divide characteristic"
+                                            " polynomial");
+            }
+            this->irreducible = irreducible;
+            this->characteristic = characteristic;
+            this->threads = threads;
+            irreducibleState = NULL;
+            hasParity = false;
+            setZero(parity);
+        }
+
+        ReducibleAnalysis(const ReducibleAnalysis&);
+        ReducibleAnalysis& operator=(const ReducibleAnalysis&);
+    };
+}
+#endif // MTTOOLBOX_REDUCIBLE_ANALYSIS_HPP
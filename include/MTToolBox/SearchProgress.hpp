@@ -0,0 +1,362 @@
+#ifndef MTTOOLBOX_SEARCH_PROGRESS_HPP
+#define MTTOOLBOX_SEARCH_PROGRESS_HPP
+/**
+ * @file SearchProgress.hpp
+ *
+ *\japanese
+ * @brief 探索の進み具合と残り時間の見積もり
+ *
+ * 次数 n の漸化式をでたらめに選ぶと、特性多項式が原始的である確率は
+ * およそ φ(2<sup>n</sup>-1)/(n 2<sup>n</sup>) であり、
+ * 2<sup>n</sup>-1 が素数なら約 1/n である。この確率を事前の見込みとし、
+ * 実際に試した候補の数と見つかった数で補正する。さらに候補ひとつに
+ * かかる時間と、見つかった後の処理 (テンパリングなど) にかかる時間を
+ * 別々に測り、残りの個数を見つけるまでの時間の期待値と信頼区間を
+ * 求める。
+ *\endjapanese
+ *
+ *\english
+ * @brief Progress of searches and estimate of remaining time
+ *
+ * When a recursion of degree n is chosen at random, its
+ * characteristic polynomial is primitive with probability about
+ * φ(2<sup>n</sup>-1)/(n 2<sup>n</sup>), which is about 1/n if
+ * 2<sup>n</sup>-1 is a prime. This probability is used as the prior
+ * expectation, and corrected by the numbers of candidates tried and
+ * found. Time spent for one candidate and time spent after finding
+ * one (tempering and others) are measured separately, and the
+ * expected time to find the rest and its confidence interval are
+ * calculated.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stddef.h>
+#include <ostream>
+#include <MTToolBox/Parallel.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class SearchProgress
+     *\japanese
+     * @brief 探索の進み具合
+     *
+     * 探索アルゴリズムは候補をひとつ試すごとに addCandidate() を、
+     * 見つかった後の処理を終えるごとに addPostProcess() を呼ぶ。
+     * setReport() で出力先を設定すると、addCandidate() の中で一定の
+     * 間隔ごとに report() を出力する。複数のスレッドから同時に使って
+     * よく、その場合は各段階の処理時間の和と経過時間の比を並列度と
+     * みなす。
+     *
+     * 信頼区間は、成功確率を推定値に固定したときの待ち時間のガンマ
+     * 分布から求める。成功確率の推定の誤差は含まないので、見つかった
+     * 数が少ないうちは区間が狭すぎることがある。
+     *\endjapanese
+     *
+     *\english
+     * @brief Progress of a search
+     *
+     * Search algorithms call addCandidate() for each candidate tried,
+     * and addPostProcess() after processing each found one. If an
+     * output stream is set by setReport(), report() is output at
+     * regular intervals in addCandidate(). Several threads may use an
+     * instance at the same time, and then the ratio of the sum of
+     * processing time of stages to the elapsed time is regarded as
+     * the degree of parallelism.
+     *
+     * The confidence interval is calculated from the gamma
+     * distribution of the waiting time with the success probability
+     * fixed to its estimate. Errors of the estimate are not included,
+     * so the interval may be too narrow while few are found.
+     *\endenglish
+     */
+    class SearchProgress {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ。経過時間はここから測る。
+         * @param[in] probability 候補ひとつが成功する事前の確率
+         * @param[in] target 見つけたい数
+         * @throw std::invalid_argument probability が 0 より大きく 1 以下
+         * でないとき
+         *\endjapanese
+         *
+         *\english
+         * Constructor. Elapsed time is measured from here.
+         * @param[in] probability prior probability of success of one
+         * candidate
+         * @param[in] target number to be found
+         * @throw std::invalid_argument when probability is not greater
+         * than 0 and less than or equal to 1
+         *\endenglish
+         */
+        SearchProgress(double probability, long target = 1);
+
+        /**
+         *\japanese
+         * 次数 \b degree の多項式がでたらめに選ばれたとき、原始多項式で
+         * ある確率 φ(2<sup>degree</sup>-1)/(degree 2<sup>degree</sup>)
+         * を返す。
+         * @param[in] degree 次数、メルセンヌ指数
+         * @param[in] prime_factors 2<sup>degree</sup>-1 の素因数を表す
+         * 文字列の配列 (NULL で終わる)、NULL なら 2<sup>degree</sup>-1
+         * を素数とみなす
+         * @return 原始多項式である確率
+         *\endjapanese
+         *
+         *\english
+         * Returns probability φ(2<sup>degree</sup>-1)/(degree
+         * 2<sup>degree</sup>) that a polynomial of degree \b degree
+         * chosen at random is primitive.
+         * @param[in] degree degree, Mersenne exponent
+         * @param[in] prime_factors array of strings of prime factors of
+         * 2<sup>degree</sup>-1 terminated by NULL, if NULL
+         * 2<sup>degree</sup>-1 is regarded as a prime
+         * @return probability of being primitive
+         *\endenglish
+         */
+        static double primitiveProbability(int degree,
+                                           const char * prime_factors[]
+                                           = NULL);
+
+        /**
+         *\japanese
+         * @return 単調増加する時計の現在の秒数
+         *\endjapanese
+         *
+         *\english
+         * @return current seconds of a monotonic clock
+         *\endenglish
+         */
+        static double now();
+
+        /**
+         *\japanese
+         * 見つけたい数を設定する。
+         * @param[in] target 見つけたい数
+         *\endjapanese
+         *
+         *\english
+         * Sets the number to be found.
+         * @param[in] target number to be found
+         *\endenglish
+         */
+        void setTarget(long target);
+
+        /**
+         *\japanese
+         * 途中経過を出力する先と間隔を設定する。
+         * @param[in] os 出力先、NULL なら出力しない
+         * @param[in] interval 出力の間隔 (秒)
+         *\endjapanese
+         *
+         *\english
+         * Sets where and how often progress is output.
+         * @param[in] os output stream, NULL not to output
+         * @param[in] interval interval of output in seconds
+         *\endenglish
+         */
+        void setReport(std::ostream * os, double interval);
+
+        /**
+         *\japanese
+         * 候補をひとつ試したことを記録する。
+         * @param[in] seconds 候補を試すのにかかった秒数
+         * @param[in] found 成功したら true
+         *\endjapanese
+         *
+         *\english
+         * Records that a candidate was tried.
+         * @param[in] seconds seconds spent for the candidate
+         * @param[in] found true if succeeded
+         *\endenglish
+         */
+        void addCandidate(double seconds, bool found);
+
+        /**
+         *\japanese
+         * 見つかったものの後処理をひとつ終えたことを記録する。
+         * @param[in] seconds 後処理にかかった秒数
+         *\endjapanese
+         *
+         *\english
+         * Records that post processing of a found one ended.
+         * @param[in] seconds seconds spent for post processing
+         *\endenglish
+         */
+        void addPostProcess(double seconds);
+
+        /**
+         *\japanese
+         * @return 試した候補の数
+         *\endjapanese
+         *
+         *\english
+         * @return number of candidates tried
+         *\endenglish
+         */
+        long getCandidates() const;
+
+        /**
+         *\japanese
+         * @return 成功した候補の数
+         *\endjapanese
+         *
+         *\english
+         * @return number of candidates succeeded
+         *\endenglish
+         */
+        long getFound() const;
+
+        /**
+         *\japanese
+         * @return コンストラクタからの経過秒数
+         *\endjapanese
+         *
+         *\english
+         * @return seconds elapsed from the constructor
+         *\endenglish
+         */
+        double getElapsed() const;
+
+        /**
+         *\japanese
+         * @return 経過時間あたりの候補の数 (個/秒)
+         *\endjapanese
+         *
+         *\english
+         * @return candidates per elapsed second
+         *\endenglish
+         */
+        double getRate() const;
+
+        /**
+         *\japanese
+         * 事前の確率を候補 1/probability 個のうち 1 個の成功とみなし、
+         * 実際の数と合わせて推定した成功確率を返す。
+         * @return 推定した成功確率
+         *\endjapanese
+         *
+         *\english
+         * Returns the success probability estimated by regarding the
+         * prior probability as one success in 1/probability candidates,
+         * combined with actual numbers.
+         * @return estimated success probability
+         *\endenglish
+         */
+        double getProbability() const;
+
+        /**
+         *\japanese
+         * @return 候補ひとつにかかる平均の秒数
+         *\endjapanese
+         *
+         *\english
+         * @return mean seconds for a candidate
+         *\endenglish
+         */
+        double getCandidateCost() const;
+
+        /**
+         *\japanese
+         * @return 後処理ひとつにかかる平均の秒数
+         *\endjapanese
+         *
+         *\english
+         * @return mean seconds for post processing
+         *\endenglish
+         */
+        double getPostProcessCost() const;
+
+        /**
+         *\japanese
+         * @return 見つけたい数に達するまでの秒数の期待値、まだ候補を
+         * 試していなければ負
+         *\endjapanese
+         *
+         *\english
+         * @return expected seconds to reach the number to be found,
+         * negative if no candidates are tried yet
+         *\endenglish
+         */
+        double getRemaining() const;
+
+        /**
+         *\japanese
+         * 見つけたい数に達するまでの秒数の信頼区間を求める。
+         * @param[in] confidence 信頼水準、たとえば 0.9
+         * @param[out] low 区間の下限
+         * @param[out] high 区間の上限
+         * まだ候補を試していなければ、どちらも負になる。
+         * @throw std::invalid_argument confidence が 0 と 1 の間に
+         * ないとき
+         *\endjapanese
+         *
+         *\english
+         * Calculates the confidence interval of seconds to reach the
+         * number to be found.
+         * @param[in] confidence confidence level, for example 0.9
+         * @param[out] low lower bound of the interval
+         * @param[out] high upper bound of the interval
+         * Both are negative if no candidates are tried yet.
+         * @throw std::invalid_argument when confidence is not between 0
+         * and 1
+         *\endenglish
+         */
+        void getInterval(double confidence, double& low, double& high) const;
+
+        /**
+         *\japanese
+         * 候補の数、速さ、見つかった数、推定した成功確率、残り時間と
+         * その 90% 信頼区間を一行で出力する。
+         * @param[in,out] os 出力先
+         *\endjapanese
+         *
+         *\english
+         * Outputs numbers of candidates, rate, number found, estimated
+         * success probability, remaining time and its 90% confidence
+         * interval in a line.
+         * @param[in,out] os output stream
+         *\endenglish
+         */
+        void report(std::ostream& os) const;
+    private:
+        struct snapshot {
+            long candidates;
+            long found;
+            long target;
+            long post;
+            double candidateSeconds;
+            double postSeconds;
+            double elapsed;
+        };
+        mutable Mutex mutex;
+        double prior;
+        long target;
+        double start;
+        long candidates;
+        long found;
+        long post;
+        double candidateSeconds;
+        double postSeconds;
+        std::ostream * out;
+        double interval;
+        double lastReport;
+        void take(snapshot& s) const;
+        double probability(const snapshot& s) const;
+        double parallelism(const snapshot& s) const;
+        void costs(const snapshot& s, double& search, double& postCost)
+            const;
+        SearchProgress(const SearchProgress&);
+        SearchProgress& operator=(const SearchProgress&);
+    };
+}
+#endif // MTTOOLBOX_SEARCH_PROGRESS_HPP
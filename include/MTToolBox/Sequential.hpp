@@ -56,6 +56,7 @@ namespace MTToolBox {
          *\endenglish
          */
         Sequential() {
+            floor = 0;
         }
 
         /**
@@ -73,6 +74,8 @@ namespace MTToolBox {
         Sequential(T p_mask) {
             status = static_cast<T>(-1);
             mask = p_mask;
+            floor = 0;
+            last = status;
             error = false;
         }
 
@@ -93,6 +96,43 @@ namespace MTToolBox {
         Sequential(T p_mask, T seed) {
             status = seed;
             mask = p_mask;
+            floor = 0;
+            last = seed;
+            error = false;
+        }
+
+        /**
+         *\japanese
+         * マスクとシードと下限付きコンストラクタ
+         *
+         * 内部カウンタは \b seed から \b p_floor まで数える。\b p_floor
+         * を返した後で呼ばれると std::underflow_error を投げる。
+         * 範囲を分割して並列に数えるために使う。
+         * @param[in] p_mask 出力の際にカウンタと排他的論理和を取るためのマスク
+         * @param[in] seed 内部カウンタの初期値
+         * @param[in] p_floor 内部カウンタの下限
+         * @see SequentialShards
+         *\endjapanese
+         *
+         *\english
+         * Constructor with mask, seed and floor
+         *
+         * The internal counter counts from \b seed down to \b p_floor.
+         * std::underflow_error is thrown when called after \b p_floor
+         * is returned. This is used for counting divided ranges in
+         * parallel.
+         * @param[in] p_mask \b p_mask and internal counter are
+         * exclusively or-ed when output time.
+         * @param[in] seed initial value of the internal counter
+         * @param[in] p_floor lower limit of the internal counter
+         * @see SequentialShards
+         *\endenglish
+         */
+        Sequential(T p_mask, T seed, T p_floor) {
+            status = seed;
+            mask = p_mask;
+            floor = p_floor;
+            last = seed;
             error = false;
         }
 
@@ -110,6 +150,8 @@ namespace MTToolBox {
         Sequential(Sequential<T>& src) : ParameterGenerator() {
             status = src.status;
             mask = src.mask;
+            floor = src.floor;
+            last = src.last;
             error = src.error;
         }
 
@@ -176,7 +218,7 @@ namespace MTToolBox {
          *\endenglish
          */
         uint32_t getUint32() {
-            return next();
+            return static_cast<uint32_t>(next());
         }
 
         /*
@@ -205,8 +247,8 @@ namespace MTToolBox {
          *
          * 内部カウンタとマスクとの排他的論理和をとって返す。
          * 返却値を決定後に、内部カウンタをひとつ減らす。
-         * @throw std::underflow_exception ゼロを返した後、さらにこのメ
-         * ソッドが呼ばれた場合
+         * @throw std::underflow_exception ゼロ（下限）を返した後、さらに
+         * このメソッドが呼ばれた場合
          *\endjapanese
          *
          *\english
@@ -217,7 +259,7 @@ namespace MTToolBox {
          * After return value is decided, the internal counter
          * will be decremented.
          * @throws std::underflow_exception when this method
-         * is called after this method returns zero.
+         * is called after this method returns zero (the floor).
          * @return next value
          *\endenglish
          */
@@ -225,14 +267,63 @@ namespace MTToolBox {
             if (error) {
                 throw std::underflow_error("count over zero exception");
             }
-            if (status <= 0) {
+            if (status <= floor) {
                 error = true;
             }
             T work = status;
+            last = work;
             status -= 1;
             return work ^ mask;
         }
 
+        /**
+         *\japanese
+         * 次に返す内部カウンタの値を返す。
+         * @return 内部カウンタ
+         *\endjapanese
+         *
+         *\english
+         * Returns internal counter which will be returned next.
+         * @return internal counter
+         *\endenglish
+         */
+        T getStatus() const {
+            return status;
+        }
+
+        /**
+         *\japanese
+         * 最後に返した数の、マスクと排他的論理和を取る前の値を返す。
+         * 探索結果を元の順番に並べるためのキーに使う。
+         * @return 最後に返した内部カウンタの値
+         *\endjapanese
+         *
+         *\english
+         * Returns the value of internal counter last returned, before
+         * exclusive or-ed with mask. This is used as a key to sort
+         * search results in the original order.
+         * @return internal counter last returned
+         *\endenglish
+         */
+        T getLast() const {
+            return last;
+        }
+
+        /**
+         *\japanese
+         * 下限まで数え終わったかどうか
+         * @return 数え終わっていれば true
+         *\endjapanese
+         *
+         *\english
+         * Checks if the counter reached the floor.
+         * @return true if counting finished
+         *\endenglish
+         */
+        bool isExhausted() const {
+            return error;
+        }
+
         /*
          *\japanese
          * 内部カウンタのビットサイズを返す。
@@ -255,6 +346,8 @@ namespace MTToolBox {
     private:
         T status;
         T mask;
+        T floor;
+        T last;
         bool error;
     };
 }
@@ -0,0 +1,437 @@
+#ifndef MTTOOLBOX_SEQUENTIAL_SHARDS_HPP
+#define MTTOOLBOX_SEQUENTIAL_SHARDS_HPP
+/**
+ * @file SequentialShards.hpp
+ *
+ *\japanese
+ * @brief Sequential の範囲を分割して並列に数える
+ *
+ * Sequential が数える範囲を互いに素な N 個のシャードに分ける。
+ * シャードごとに進み具合を記録してファイルに保存でき、中断した探索を
+ * シャードごとに再開できる。シャードごとの探索結果は merge() で
+ * 分割しなかったときと同じ順番に並べることができる。
+ *\endjapanese
+ *
+ *\english
+ * @brief Counts divided ranges of Sequential in parallel
+ *
+ * The range counted by Sequential is divided into N disjoint shards.
+ * Progress of each shard can be recorded and saved to a file, and an
+ * interrupted search can be resumed per shard. Search results of
+ * shards can be sorted by merge() in the same order as the search
+ * without division.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <MTToolBox/Sequential.hpp>
+#include <MTToolBox/Parallel.hpp>
+
+namespace MTToolBox {
+    /**
+     * @class SequentialShards
+     *\japanese
+     * @brief Sequential の範囲のシャード分割
+     *
+     * シャード 0 が一番大きい値を含み、シャード番号の順に分割しないとき
+     * の Sequential の順番になる。進み具合の記録はスレッドセーフである。
+     * @tparam T 内部カウンタの型、符号なし整数型であること
+     *\endjapanese
+     *
+     *\english
+     * @brief Shards of range of Sequential
+     *
+     * Shard 0 contains the largest values, and the order of shard
+     * numbers is the order of Sequential without division. Recording
+     * progress is thread safe.
+     * @tparam T type of internal counter, should be unsigned integer.
+     *\endenglish
+     */
+    template<typename T>
+    class SequentialShards {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         *
+         * \b start から \b floor までの範囲を \b count 個に分割する。
+         * 範囲の大きさが \b count より小さいときは空のシャードができる。
+         * @param[in] mask 出力の際にカウンタと排他的論理和を取るためのマスク
+         * @param[in] start 内部カウンタの初期値
+         * @param[in] floor 内部カウンタの下限
+         * @param[in] count シャードの数
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         *
+         * Range from \b start down to \b floor is divided into \b count
+         * shards. Empty shards are made if the range is smaller than
+         * \b count.
+         * @param[in] mask \b mask and internal counter are exclusively
+         * or-ed when output time.
+         * @param[in] start initial value of the internal counter
+         * @param[in] floor lower limit of the internal counter
+         * @param[in] count number of shards
+         *\endenglish
+         */
+        SequentialShards(T mask, T start, T floor, int count) {
+            if (count < 1 || start < floor) {
+                throw std::invalid_argument("invalid shard range");
+            }
+            this->mask = mask;
+            this->start = start;
+            this->floor = floor;
+            T span = start - floor;
+            T n = static_cast<T>(count);
+            T per = span / n;
+            T rem = span % n;
+            T top = start;
+            for (int i = 0; i < count; i++) {
+                Shard s;
+                T len = per;
+                if (static_cast<T>(i) <= rem) {
+                    len += 1;
+                }
+                s.top = top;
+                s.status = top;
+                if (len == 0) {
+                    s.floor = top;
+                    s.done = true;
+                } else {
+                    s.floor = top - (len - 1);
+                    s.done = false;
+                    top = s.floor - 1;
+                }
+                s.claimed = false;
+                shards.push_back(s);
+            }
+        }
+
+        /**
+         *\japanese
+         * シャードの数を返す。
+         *\endjapanese
+         *
+         *\english
+         * Returns number of shards.
+         *\endenglish
+         */
+        int getShardCount() const {
+            return static_cast<int>(shards.size());
+        }
+
+        /**
+         *\japanese
+         * シャードの最初の値を返す。
+         * @param[in] index シャード番号
+         *\endjapanese
+         *
+         *\english
+         * Returns the first value of shard.
+         * @param[in] index shard number
+         *\endenglish
+         */
+        T getShardStart(int index) const {
+            return shards.at(index).top;
+        }
+
+        /**
+         *\japanese
+         * シャードの下限を返す。
+         * @param[in] index シャード番号
+         *\endjapanese
+         *
+         *\english
+         * Returns the floor of shard.
+         * @param[in] index shard number
+         *\endenglish
+         */
+        T getShardFloor(int index) const {
+            return shards.at(index).floor;
+        }
+
+        /**
+         *\japanese
+         * シャードを数える Sequential を作る。
+         *
+         * 記録された進み具合から数え始める。
+         * @param[in] index シャード番号
+         * @return 新しい Sequential、シャードが終わっていれば NULL
+         *\endjapanese
+         *
+         *\english
+         * Makes Sequential which counts the shard.
+         *
+         * Counting starts from the recorded progress.
+         * @param[in] index shard number
+         * @return new Sequential, or NULL if the shard is done.
+         *\endenglish
+         */
+        Sequential<T> * newShard(int index) {
+            ScopedLock lock(mutex);
+            const Shard& s = shards.at(index);
+            if (s.done) {
+                return NULL;
+            }
+            return new Sequential<T>(mask, s.status, s.floor);
+        }
+
+        /**
+         *\japanese
+         * まだ誰も担当していない、終わっていないシャードを取る。
+         * @return シャード番号、なければ -1
+         *\endjapanese
+         *
+         *\english
+         * Claims a shard which is not done and not claimed yet.
+         * @return shard number, or -1 if no shard remains.
+         *\endenglish
+         */
+        int claim() {
+            ScopedLock lock(mutex);
+            for (size_t i = 0; i < shards.size(); i++) {
+                if (!shards[i].done && !shards[i].claimed) {
+                    shards[i].claimed = true;
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        /**
+         *\japanese
+         * シャードの進み具合を記録する。
+         *
+         * \b sq がこれまでに返した数に対する処理は終わっていなければなら
+         * ない。
+         * @param[in] index シャード番号
+         * @param[in] sq newShard() で作ったシャードの Sequential
+         *\endjapanese
+         *
+         *\english
+         * Records progress of the shard.
+         *
+         * Processing of all numbers returned by \b sq must have been
+         * finished.
+         * @param[in] index shard number
+         * @param[in] sq Sequential of the shard made by newShard()
+         *\endenglish
+         */
+        void checkpoint(int index, const Sequential<T>& sq) {
+            ScopedLock lock(mutex);
+            Shard& s = shards.at(index);
+            if (sq.isExhausted()) {
+                s.done = true;
+                s.status = s.floor;
+            } else {
+                s.status = sq.getStatus();
+            }
+        }
+
+        /**
+         *\japanese
+         * シャードが終わったかどうか
+         * @param[in] index シャード番号
+         * @return 終わっていれば true
+         *\endjapanese
+         *
+         *\english
+         * Checks if the shard is done.
+         * @param[in] index shard number
+         * @return true if done
+         *\endenglish
+         */
+        bool isDone(int index) {
+            ScopedLock lock(mutex);
+            return shards.at(index).done;
+        }
+
+        /**
+         *\japanese
+         * すべてのシャードが終わったかどうか
+         * @return すべて終わっていれば true
+         *\endjapanese
+         *
+         *\english
+         * Checks if all shards are done.
+         * @return true if all shards are done
+         *\endenglish
+         */
+        bool isAllDone() {
+            ScopedLock lock(mutex);
+            for (size_t i = 0; i < shards.size(); i++) {
+                if (!shards[i].done) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         *\japanese
+         * 進み具合をファイルに保存する。
+         *
+         * 一時ファイルに書いてから名前を変えるので、途中で中断されても
+         * 前の内容が残る。
+         * @param[in] path ファイル名
+         * @return 保存できたら true
+         *\endjapanese
+         *
+         *\english
+         * Saves progress to a file.
+         *
+         * Progress is written to a temporary file and renamed, so the
+         * previous contents remain if interrupted.
+         * @param[in] path file name
+         * @return true if saved
+         *\endenglish
+         */
+        bool saveProgress(const std::string& path) {
+            using namespace std;
+            ScopedLock lock(mutex);
+            string tmp = path + ".tmp";
+            {
+                ofstream ofs(tmp.c_str());
+                if (!ofs) {
+                    return false;
+                }
+                ofs << header() << endl;
+                for (size_t i = 0; i < shards.size(); i++) {
+                    ofs << dec << i << " " << hex << shards[i].status
+                        << " " << dec << (shards[i].done ? 1 : 0) << endl;
+                }
+                if (!ofs) {
+                    return false;
+                }
+            }
+            return rename(tmp.c_str(), path.c_str()) == 0;
+        }
+
+        /**
+         *\japanese
+         * 進み具合をファイルから読み込む。
+         *
+         * ファイルのマスク、範囲、シャード数がこのオブジェクトと違う
+         * ときは読み込まない。
+         * @param[in] path ファイル名
+         * @return 読み込めたら true
+         *\endjapanese
+         *
+         *\english
+         * Loads progress from a file.
+         *
+         * If mask, range or number of shards in the file are
+         * different from this object, the file is not loaded.
+         * @param[in] path file name
+         * @return true if loaded
+         *\endenglish
+         */
+        bool loadProgress(const std::string& path) {
+            using namespace std;
+            ScopedLock lock(mutex);
+            ifstream ifs(path.c_str());
+            if (!ifs) {
+                return false;
+            }
+            string line;
+            if (!getline(ifs, line) || line != header()) {
+                return false;
+            }
+            vector<Shard> work = shards;
+            for (size_t i = 0; i < work.size(); i++) {
+                size_t index;
+                T status;
+                int done;
+                if (!(ifs >> dec >> index >> hex >> status >> dec >> done)
+                    || index != i
+                    || status > work[i].top || status < work[i].floor) {
+                    return false;
+                }
+                work[i].status = status;
+                work[i].done = done != 0;
+            }
+            shards = work;
+            return true;
+        }
+
+        /**
+         *\japanese
+         * シャードごとの探索結果を、分割しないときと同じ順番に並べる。
+         *
+         * 結果は Sequential::getLast() の値をキーとした組で表す。
+         * キーの降順に並べ、再開によって重複したキーは最初のものだけを
+         * 残す。
+         * @tparam R 結果の型
+         * @param[in,out] results すべてのシャードの結果を集めたもの
+         *\endjapanese
+         *
+         *\english
+         * Sorts search results of shards in the same order as the
+         * search without division.
+         *
+         * A result is a pair whose key is the value of
+         * Sequential::getLast(). Results are sorted in descending order
+         * of keys, and for keys duplicated by resuming only the first
+         * one is kept.
+         * @tparam R type of result
+         * @param[in,out] results results collected from all shards
+         *\endenglish
+         */
+        template<typename R>
+        static void merge(std::vector<std::pair<T, R> >& results) {
+            std::stable_sort(results.begin(), results.end(), greater_key<R>);
+            std::vector<std::pair<T, R> > unique;
+            for (size_t i = 0; i < results.size(); i++) {
+                if (i == 0 || results[i].first != results[i - 1].first) {
+                    unique.push_back(results[i]);
+                }
+            }
+            results.swap(unique);
+        }
+    private:
+        struct Shard {
+            T top;
+            T floor;
+            T status;
+            bool done;
+            bool claimed;
+        };
+        T mask;
+        T start;
+        T floor;
+        std::vector<Shard> shards;
+        Mutex mutex;
+
+        const std::string header() const {
+            using namespace std;
+            stringstream ss;
+            ss << "# sequential shards " << hex << mask << " " << start
+               << " " << floor << " " << dec << shards.size();
+            return ss.str();
+        }
+
+        template<typename R>
+        static bool greater_key(const std::pair<T, R>& a,
+                                const std::pair<T, R>& b) {
+            return a.first > b.first;
+        }
+    };
+}
+#endif // MTTOOLBOX_SEQUENTIAL_SHARDS_HPP
@@ -0,0 +1,273 @@
+#ifndef MTTOOLBOX_SOURCE_EMITTER_HPP
+#define MTTOOLBOX_SOURCE_EMITTER_HPP
+/**
+ * @file SourceEmitter.hpp
+ *
+ *\japanese
+ * @brief 見つかったパラメータに特化した生成器のソースを書き出す
+ *
+ * パラメータ探索プログラムが、見つけたパラメータをコンパイル時定数
+ * として埋め込んだ単独の C++ ヘッダを書き出すための道具である。
+ * 生成器ごとの漸化式は各サンプルが書き、このクラスはインデント、
+ * インクルードガード、定数、自己検査用の出力列の配列といった
+ * 共通の部分を受け持つ。
+ *\endjapanese
+ *
+ *\english
+ * @brief Writes source of a generator specialized for found
+ * parameters
+ *
+ * This is a tool for parameter search programs to write a
+ * standalone C++ header in which found parameters are embedded as
+ * compile time constants. Each sample writes the recursion of its
+ * generator, and this class takes care of common parts such as
+ * indentation, include guards, constants and arrays of outputs for
+ * self check.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace MTToolBox {
+    /**
+     * @class SourceEmitter
+     *\japanese
+     * @brief C++ ソースを書き出す
+     *
+     * 行は現在のインデントで書かれる。open() と close() でブロックを
+     * 開閉すると、インデントが増減する。
+     *\endjapanese
+     *
+     *\english
+     * @brief Writes C++ source
+     *
+     * Lines are written with the current indent. open() and close()
+     * open and close a block, and increase and decrease the indent.
+     *\endenglish
+     */
+    class SourceEmitter {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ
+         * @param[in] out 出力先
+         * @param[in] name 生成器の名前、C の識別子でなければならない。
+         * @throw std::invalid_argument name が識別子でないとき
+         *\endjapanese
+         *
+         *\english
+         * Constructor
+         * @param[in] out output stream
+         * @param[in] name name of generator, which should be a C
+         * identifier.
+         * @throw std::invalid_argument when name is not an identifier
+         *\endenglish
+         */
+        SourceEmitter(std::ostream& out, const std::string& name);
+
+        /**
+         *\japanese
+         * @return 生成器の名前
+         *\endjapanese
+         *
+         *\english
+         * @return name of generator
+         *\endenglish
+         */
+        const std::string& getName() const {
+            return name;
+        }
+
+        /**
+         *\japanese
+         * ヘッダの先頭を書く。説明のコメント、インクルードガード、
+         * stdint.h と string.h のインクルードである。
+         * @param[in] description コメントに書く説明、複数行でもよい。
+         *\endjapanese
+         *
+         *\english
+         * Writes the beginning of the header, which consists of a
+         * comment of description, include guard and includes of
+         * stdint.h and string.h.
+         * @param[in] description description written in the comment,
+         * which may have several lines.
+         *\endenglish
+         */
+        void beginHeader(const std::string& description);
+
+        /**
+         *\japanese
+         * ヘッダの末尾を書く。
+         *\endjapanese
+         *
+         *\english
+         * Writes the end of the header.
+         *\endenglish
+         */
+        void endHeader();
+
+        /**
+         *\japanese
+         * 現在のインデントで一行書く。空文字列なら空行を書く。
+         * @param[in] text 行の内容
+         *\endjapanese
+         *
+         *\english
+         * Writes a line with the current indent. If text is empty,
+         * writes an empty line.
+         * @param[in] text content of the line
+         *\endenglish
+         */
+        void line(const std::string& text);
+
+        /**
+         *\japanese
+         * インデントせずに一行書く。プリプロセッサの指令に使う。
+         * @param[in] text 行の内容
+         *\endjapanese
+         *
+         *\english
+         * Writes a line without indent, which is used for
+         * preprocessor directives.
+         * @param[in] text content of the line
+         *\endenglish
+         */
+        void directive(const std::string& text);
+
+        /**
+         *\japanese
+         * head に続けて { を書き、インデントを増やす。
+         * @param[in] head ブロックの前に書く内容
+         *\endjapanese
+         *
+         *\english
+         * Writes { after head, and increases the indent.
+         * @param[in] head content before the block
+         *\endenglish
+         */
+        void open(const std::string& head);
+
+        /**
+         *\japanese
+         * インデントを減らして } を書き、続けて tail を書く。
+         * @param[in] tail ブロックの後に書く内容、クラスなら ";"
+         *\endjapanese
+         *
+         *\english
+         * Decreases the indent and writes }, followed by tail.
+         * @param[in] tail content after the block, ";" for classes
+         *\endenglish
+         */
+        void close(const std::string& tail = "");
+
+        /**
+         *\japanese
+         * 整数の定数を enum として書く。
+         * @param[in] constName 定数の名前
+         * @param[in] value 値
+         *\endjapanese
+         *
+         *\english
+         * Writes an integer constant as an enum.
+         * @param[in] constName name of constant
+         * @param[in] value value
+         *\endenglish
+         */
+        void enumConstant(const std::string& constName, int value);
+
+        /**
+         *\japanese
+         * 32 ビットの定数を static const として書く。
+         * @param[in] constName 定数の名前
+         * @param[in] value 値
+         *\endjapanese
+         *
+         *\english
+         * Writes a 32-bit constant as static const.
+         * @param[in] constName name of constant
+         * @param[in] value value
+         *\endenglish
+         */
+        void constant32(const std::string& constName, uint32_t value);
+
+        /**
+         *\japanese
+         * 64 ビットの定数を static const として書く。
+         * @param[in] constName 定数の名前
+         * @param[in] value 値
+         *\endjapanese
+         *
+         *\english
+         * Writes a 64-bit constant as static const.
+         * @param[in] constName name of constant
+         * @param[in] value value
+         *\endenglish
+         */
+        void constant64(const std::string& constName, uint64_t value);
+
+        /**
+         *\japanese
+         * 32 ビット整数の static const 配列を書く。自己検査の期待値に
+         * 使う。
+         * @param[in] arrayName 配列の名前
+         * @param[in] values 値
+         *\endjapanese
+         *
+         *\english
+         * Writes a static const array of 32-bit integers, which is
+         * used for expected values of self check.
+         * @param[in] arrayName name of array
+         * @param[in] values values
+         *\endenglish
+         */
+        void array32(const std::string& arrayName,
+                     const std::vector<uint32_t>& values);
+
+        /**
+         *\japanese
+         * 32 ビット整数を UINT32_C(0x...) の形の文字列にする。
+         * @param[in] value 値
+         * @return C のリテラル
+         *\endjapanese
+         *
+         *\english
+         * Makes a string of the form UINT32_C(0x...) from a 32-bit
+         * integer.
+         * @param[in] value value
+         * @return C literal
+         *\endenglish
+         */
+        static std::string literal32(uint32_t value);
+
+        /**
+         *\japanese
+         * @param[in] str 文字列
+         * @return str が C の識別子なら true
+         *\endjapanese
+         *
+         *\english
+         * @param[in] str string
+         * @return true if str is a C identifier
+         *\endenglish
+         */
+        static bool isIdentifier(const std::string& str);
+    private:
+        std::ostream& out;
+        std::string name;
+        int indent;
+        std::string guard() const;
+    };
+}
+#endif // MTTOOLBOX_SOURCE_EMITTER_HPP
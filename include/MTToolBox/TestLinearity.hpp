@@ -33,10 +33,14 @@
  * LICENSE.txt
  */
 
+#include <stdint.h>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <string>
 #include <MTToolBox/AbstractGenerator.hpp>
 #include <MTToolBox/EquidistributionCalculatable.hpp>
+#include <MTToolBox/Parallel.hpp>
 #include <MTToolBox/util.hpp>
 
 namespace MTToolBox {
@@ -57,6 +61,14 @@ namespace MTToolBox {
      * EquidistributionCalculatable#add() の実装に問題があるかもしれな
      * い。
      *
+     * 既定では二つの決まった種で 100 個の出力を調べる。新しい生成器を
+     * 使う前には、setTrials() で種の組を増やし、setLength() で出力を
+     * 長くし、setThreads() で並列に調べるとよい。種の組ごとに、
+     * clone() の出力が元と一致すること、自分自身を add() するとゼロに
+     * なること、setZero() と cloneZero() がゼロの状態を作ること、
+     * 二つの状態の和の出力が出力の和になることを調べる。どれかの
+     * スレッドが失敗を見つけたら、残りの組は調べない。
+     *
      * @tparam U 疑似乱数生成器の出力の型、符号なし型であること
      *\endjapanese
      *
@@ -72,12 +84,108 @@ namespace MTToolBox {
      * @note If users are sure that the generator is GF(2)-linear and
      * the generator fails this test, there may be a problem in
      * user's implementation of Equidistribution#add in user's generator.
+     *
+     * By default 100 outputs from two fixed seeds are checked. Before
+     * using a new generator, increase pairs of seeds by setTrials(),
+     * lengthen outputs by setLength(), and check in parallel by
+     * setThreads(). For each pair of seeds, it checks that outputs of
+     * clone() agree with the original, that add() of itself makes
+     * zero, that setZero() and cloneZero() make zero states, and that
+     * outputs of the sum of two states are sums of outputs. When a
+     * thread finds a failure, the rest of pairs are not checked.
      * @tparam U type of output of the generator, should be unsigned number.
      *\endenglish
      */
     template<typename U>
     class TestLinearity {
     public:
+        TestLinearity() {
+            trials = 0;
+            length = 100;
+            threads = 1;
+            seed = 1;
+        }
+
+        /**
+         *\japanese
+         * 決まった種の組に加えて調べる、でたらめな種の組の数を設定する。
+         * @param[in] trials 種の組の数、既定は 0
+         *\endjapanese
+         *
+         *\english
+         * Sets number of random pairs of seeds checked in addition to
+         * the fixed pair.
+         * @param[in] trials number of pairs of seeds, 0 by default
+         *\endenglish
+         */
+        void setTrials(int trials) {
+            this->trials = trials;
+        }
+
+        /**
+         *\japanese
+         * でたらめな種の組の検査で比べる出力の数を設定する。
+         * 決まった種の組では、これまで通り 100 個を比べる。
+         * @param[in] length 出力の数、既定は 100
+         *\endjapanese
+         *
+         *\english
+         * Sets number of outputs compared in each check of random
+         * pairs of seeds. The fixed pair compares 100 outputs as
+         * before.
+         * @param[in] length number of outputs, 100 by default
+         *\endenglish
+         */
+        void setLength(int length) {
+            this->length = length;
+        }
+
+        /**
+         *\japanese
+         * でたらめな種の組を調べるスレッドの数を設定する。
+         * @param[in] threads スレッドの数、既定は 1
+         *\endjapanese
+         *
+         *\english
+         * Sets number of threads checking random pairs of seeds.
+         * @param[in] threads number of threads, 1 by default
+         *\endenglish
+         */
+        void setThreads(int threads) {
+            this->threads = threads;
+        }
+
+        /**
+         *\japanese
+         * でたらめな種の組を作る種を設定する。同じ種なら、スレッドの数に
+         * よらず同じ組を調べる。
+         * @param[in] seed 種
+         *\endjapanese
+         *
+         *\english
+         * Sets the seed which makes random pairs of seeds. The same seed
+         * checks the same pairs regardless of number of threads.
+         * @param[in] seed seed
+         *\endenglish
+         */
+        void setSeed(uint64_t seed) {
+            this->seed = seed;
+        }
+
+        /**
+         *\japanese
+         * @return 最後の operator() で失敗した検査と種、成功したなら空
+         *\endjapanese
+         *
+         *\english
+         * @return the failed check and seeds of the last operator(),
+         * empty if succeeded
+         *\endenglish
+         */
+        const std::string& getFailure() const {
+            return failure;
+        }
+
         /**
          *\japanese
          * generator がGF(2)線形であるかどうかテストする。
@@ -99,13 +207,157 @@ namespace MTToolBox {
             EquidistributionCalculatable<U> *g2 = generator.clone();
             g1->seed(convert<U>(1234U));
             g2->seed(convert<U>(4321U));
-            bool result = test1(*g1) && test2(*g1, *g2);
+            failure.clear();
+            if (!test1(*g1)) {
+                failure = describe("add self", 1234U, 4321U);
+            } else if (!test2(*g1, *g2)) {
+                failure = describe("add", 1234U, 4321U);
+            }
             delete g1;
             delete g2;
-            return result;
+            if (!failure.empty()) {
+                return false;
+            }
+            if (trials <= 0) {
+                return true;
+            }
+            TrialJob job(*this, generator);
+            if (threads <= 1) {
+                job.run(0);
+            } else {
+                WorkerPool pool;
+                pool.start(job, threads);
+                pool.join();
+            }
+            return failure.empty();
         }
 
     private:
+        int trials;
+        int length;
+        int threads;
+        uint64_t seed;
+        std::string failure;
+        Mutex mutex;
+
+        /*
+         * 種の組は番号だけから決める (splitmix64)
+         */
+        uint32_t trial_seed(int trial, int which) const {
+            uint64_t z = seed + UINT64_C(0x9e3779b97f4a7c15)
+                * static_cast<uint64_t>(2 * trial + which + 1);
+            z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+            z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+            return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+        }
+
+        static const std::string describe(const char * check,
+                                          uint32_t s1, uint32_t s2) {
+            std::stringstream ss;
+            ss << check << " failed: seeds " << std::dec << s1 << ", "
+               << s2;
+            return ss.str();
+        }
+
+        void fail(const std::string& message) {
+            ScopedLock lock(mutex);
+            if (failure.empty()) {
+                failure = message;
+            }
+        }
+
+        bool failed() {
+            ScopedLock lock(mutex);
+            return !failure.empty();
+        }
+
+        bool all_zero(EquidistributionCalculatable<U>& g) {
+            for (int i = 0; i < length; i++) {
+                if (!isZero(g.generate())) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*
+         * 種の組ひとつを調べ、失敗した検査の名前を返す。
+         */
+        const char * check(const EquidistributionCalculatable<U>& generator,
+                           uint32_t s1, uint32_t s2) {
+            EquidistributionCalculatable<U> *g1 = generator.clone();
+            EquidistributionCalculatable<U> *g2 = generator.clone();
+            g1->seed(convert<U>(s1));
+            g2->seed(convert<U>(s2));
+            EquidistributionCalculatable<U> *c1 = g1->clone();
+            EquidistributionCalculatable<U> *self = g1->clone();
+            EquidistributionCalculatable<U> *zero = g1->clone();
+            EquidistributionCalculatable<U> *czero = g1->cloneZero();
+            EquidistributionCalculatable<U> *sum = g2->clone();
+            const char * result = NULL;
+            self->add(*g1);
+            zero->setZero();
+            sum->add(*g1);
+            if (g1->isZero()) {
+                result = "isZero";
+            } else if (!self->isZero() || !all_zero(*self)) {
+                result = "add self";
+            } else if (!zero->isZero() || !all_zero(*zero)) {
+                result = "setZero";
+            } else if (!czero->isZero() || !all_zero(*czero)) {
+                result = "cloneZero";
+            }
+            for (int i = 0; result == NULL && i < length; i++) {
+                U res1 = g1->generate();
+                U res2 = g2->generate();
+                if (!(c1->generate() == res1)) {
+                    result = "clone";
+                } else if (!((res1 ^ res2) == sum->generate())) {
+                    result = "add";
+                }
+            }
+            delete g1;
+            delete g2;
+            delete c1;
+            delete self;
+            delete zero;
+            delete czero;
+            delete sum;
+            return result;
+        }
+
+        /*
+         * 次の組の番号を共有し、失敗が見つかったら止める。
+         */
+        class TrialJob : public Runnable {
+        public:
+            TrialJob(TestLinearity& owner,
+                     const EquidistributionCalculatable<U>& generator)
+                : owner(owner), generator(generator) {
+                next = 0;
+            }
+
+            void run(int) {
+                for (;;) {
+                    int trial = __sync_fetch_and_add(&next, 1);
+                    if (trial >= owner.trials || owner.failed()) {
+                        return;
+                    }
+                    uint32_t s1 = owner.trial_seed(trial, 0);
+                    uint32_t s2 = owner.trial_seed(trial, 1);
+                    const char * r = owner.check(generator, s1, s2);
+                    if (r != NULL) {
+                        owner.fail(describe(r, s1, s2));
+                        return;
+                    }
+                }
+            }
+        private:
+            TestLinearity& owner;
+            const EquidistributionCalculatable<U>& generator;
+            int next;
+        };
+
         bool test1(EquidistributionCalculatable<U>& g1) {
             using namespace std;
             EquidistributionCalculatable<U> *g2 = g1.clone();
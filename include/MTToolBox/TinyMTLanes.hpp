@@ -0,0 +1,667 @@
+#ifndef MTTOOLBOX_TINYMT_LANES_HPP
+#define MTTOOLBOX_TINYMT_LANES_HPP
+/**
+ * @file TinyMTLanes.hpp
+ *
+ *\japanese
+ * @brief パラメータの異なる複数の TinyMT を SIMD のレーンで同時に動かす
+ *
+ * tinymt32dc で作ったパラメータは、ひとつのストリームにひとつずつ
+ * 使われる。TinyMT の状態は 127 ビットしかなく、一個ずつ動かしても
+ * SIMD レジスタを使い切れない。このファイルのクラスは、L 個の
+ * TinyMT の状態とパラメータを要素ごとの配列に並べ、全レーンを
+ * 一斉に一歩ずつ進める。パラメータによる分岐はマスクで置き換える
+ * ので、レーンごとにパラメータが違っても同じ命令列で計算できる。
+ * 各レーンの出力は、同じパラメータと種の tinymt32, tinymt64 の
+ * 参照実装と一致する。
+ *\endjapanese
+ *
+ *\english
+ * @brief Runs several TinyMTs with different parameters in SIMD
+ * lanes at once
+ *
+ * Parameters made by tinymt32dc are used one per stream. The state
+ * of TinyMT is only 127 bits, and stepping one generator at a time
+ * cannot fill SIMD registers. Classes in this file arrange states and
+ * parameters of L TinyMTs in per-element arrays and step all lanes in
+ * lockstep. Branches on parameters are replaced by masks, so lanes
+ * with different parameters are computed by the same instructions.
+ * Outputs of each lane are the same as those of the reference
+ * implementations of tinymt32 and tinymt64 with the same parameter
+ * and seed.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <inttypes.h>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define MTTOOLBOX_TINYMT_VECTOR_BYTES 64
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define MTTOOLBOX_TINYMT_VECTOR_BYTES 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MTTOOLBOX_TINYMT_VECTOR_BYTES 16
+#else
+#define MTTOOLBOX_TINYMT_VECTOR_BYTES 0
+#endif
+
+namespace MTToolBox {
+    /**
+     *\japanese
+     * TinyMT のレーン計算のカーネル。B バイトのベクトルを扱う。
+     * B = 0 は SIMD が使えないことを表し、スカラーで計算される。
+     * @tparam B ベクトルのバイト数
+     *\endjapanese
+     *
+     *\english
+     * Kernel of lane computation of TinyMT, which handles vectors of
+     * B bytes. B = 0 means SIMD is not available, and lanes are
+     * computed by scalar code.
+     * @tparam B number of bytes of a vector
+     *\endenglish
+     */
+    template<int B>
+    struct tinymt_kernel {
+        enum { lanes32 = 0, lanes64 = 0 };
+    };
+
+#if MTTOOLBOX_TINYMT_VECTOR_BYTES >= 16
+    template<>
+    struct tinymt_kernel<16> {
+        typedef __m128i vec;
+        enum { lanes32 = 4, lanes64 = 2 };
+        static vec load(const void * p) {
+            return _mm_loadu_si128(static_cast<const __m128i *>(p));
+        }
+        static void store(void * p, vec v) {
+            _mm_storeu_si128(static_cast<__m128i *>(p), v);
+        }
+        static vec bxor(vec a, vec b) { return _mm_xor_si128(a, b); }
+        static vec band(vec a, vec b) { return _mm_and_si128(a, b); }
+        static vec set32(uint32_t x) {
+            return _mm_set1_epi32(static_cast<int>(x));
+        }
+        static vec set64(uint64_t x) {
+            return _mm_set1_epi64x(static_cast<long long>(x));
+        }
+        static vec add32(vec a, vec b) { return _mm_add_epi32(a, b); }
+        static vec add64(vec a, vec b) { return _mm_add_epi64(a, b); }
+        static vec shl32(vec a, int n) { return _mm_slli_epi32(a, n); }
+        static vec shr32(vec a, int n) { return _mm_srli_epi32(a, n); }
+        static vec shl64(vec a, int n) { return _mm_slli_epi64(a, n); }
+        static vec shr64(vec a, int n) { return _mm_srli_epi64(a, n); }
+        /* 最下位ビットが 1 の要素だけすべて 1 にする */
+        static vec mask32(vec a) {
+            return _mm_sub_epi32(_mm_setzero_si128(),
+                                 _mm_and_si128(a, _mm_set1_epi32(1)));
+        }
+        static vec mask64(vec a) {
+            return _mm_sub_epi64(_mm_setzero_si128(),
+                                 _mm_and_si128(a, _mm_set1_epi64x(1)));
+        }
+    };
+#endif
+
+#if MTTOOLBOX_TINYMT_VECTOR_BYTES >= 32
+    template<>
+    struct tinymt_kernel<32> {
+        typedef __m256i vec;
+        enum { lanes32 = 8, lanes64 = 4 };
+        static vec load(const void * p) {
+            return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+        }
+        static void store(void * p, vec v) {
+            _mm256_storeu_si256(static_cast<__m256i *>(p), v);
+        }
+        static vec bxor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+        static vec band(vec a, vec b) { return _mm256_and_si256(a, b); }
+        static vec set32(uint32_t x) {
+            return _mm256_set1_epi32(static_cast<int>(x));
+        }
+        static vec set64(uint64_t x) {
+            return _mm256_set1_epi64x(static_cast<long long>(x));
+        }
+        static vec add32(vec a, vec b) { return _mm256_add_epi32(a, b); }
+        static vec add64(vec a, vec b) { return _mm256_add_epi64(a, b); }
+        static vec shl32(vec a, int n) { return _mm256_slli_epi32(a, n); }
+        static vec shr32(vec a, int n) { return _mm256_srli_epi32(a, n); }
+        static vec shl64(vec a, int n) { return _mm256_slli_epi64(a, n); }
+        static vec shr64(vec a, int n) { return _mm256_srli_epi64(a, n); }
+        static vec mask32(vec a) {
+            return _mm256_sub_epi32(_mm256_setzero_si256(),
+                                    _mm256_and_si256(a,
+                                                     _mm256_set1_epi32(1)));
+        }
+        static vec mask64(vec a) {
+            return _mm256_sub_epi64(_mm256_setzero_si256(),
+                                    _mm256_and_si256(a,
+                                                     _mm256_set1_epi64x(1)));
+        }
+    };
+#endif
+
+#if MTTOOLBOX_TINYMT_VECTOR_BYTES >= 64
+    template<>
+    struct tinymt_kernel<64> {
+        typedef __m512i vec;
+        enum { lanes32 = 16, lanes64 = 8 };
+        static vec load(const void * p) {
+            return _mm512_loadu_si512(p);
+        }
+        static void store(void * p, vec v) {
+            _mm512_storeu_si512(p, v);
+        }
+        static vec bxor(vec a, vec b) { return _mm512_xor_si512(a, b); }
+        static vec band(vec a, vec b) { return _mm512_and_si512(a, b); }
+        static vec set32(uint32_t x) {
+            return _mm512_set1_epi32(static_cast<int>(x));
+        }
+        static vec set64(uint64_t x) {
+            return _mm512_set1_epi64(static_cast<long long>(x));
+        }
+        static vec add32(vec a, vec b) { return _mm512_add_epi32(a, b); }
+        static vec add64(vec a, vec b) { return _mm512_add_epi64(a, b); }
+        /*
+         * GCC 12 は _mm512_slli_epi32 などの中の未定義値に誤った警告を
+         * 出すので、全ビットのマスクを付けた maskz 版を使う。
+         */
+        static vec shl32(vec a, int n) {
+            return _mm512_maskz_slli_epi32(static_cast<__mmask16>(0xffff), a,
+                                           static_cast<unsigned int>(n));
+        }
+        static vec shr32(vec a, int n) {
+            return _mm512_maskz_srli_epi32(static_cast<__mmask16>(0xffff), a,
+                                           static_cast<unsigned int>(n));
+        }
+        static vec shl64(vec a, int n) {
+            return _mm512_maskz_slli_epi64(static_cast<__mmask8>(0xff), a,
+                                           static_cast<unsigned int>(n));
+        }
+        static vec shr64(vec a, int n) {
+            return _mm512_maskz_srli_epi64(static_cast<__mmask8>(0xff), a,
+                                           static_cast<unsigned int>(n));
+        }
+        static vec mask32(vec a) {
+            return _mm512_sub_epi32(_mm512_setzero_si512(),
+                                    _mm512_and_si512(a,
+                                                     _mm512_set1_epi32(1)));
+        }
+        static vec mask64(vec a) {
+            return _mm512_sub_epi64(_mm512_setzero_si512(),
+                                    _mm512_and_si512(a,
+                                                     _mm512_set1_epi64(1)));
+        }
+    };
+#endif
+
+    /**
+     * @class TinyMT32Lanes
+     *\japanese
+     * @brief L 個の tinymt32 を一斉に動かす
+     *
+     * レーンごとに setParam() でパラメータを、seed() で種を与えてから
+     * generate() または fill_array() を呼ぶ。レーン l の出力列は、
+     * 同じ mat1, mat2, tmat と種で tinymt32_init() した tinymt32 の
+     * tinymt32_generate_uint32() の列と同じである。
+     *
+     * @tparam L レーン数。SIMD の幅で割り切れない分はスカラーで計算
+     * する。
+     *\endjapanese
+     *
+     *\english
+     * @brief Steps L tinymt32s in lockstep
+     *
+     * Give parameters by setParam() and seeds by seed() to each lane,
+     * then call generate() or fill_array(). The output sequence of
+     * lane l is the same as tinymt32_generate_uint32() of tinymt32
+     * initialized by tinymt32_init() with the same mat1, mat2, tmat
+     * and seed.
+     *
+     * @tparam L number of lanes. Lanes beyond a multiple of SIMD
+     * width are computed by scalar code.
+     *\endenglish
+     */
+    template<int L>
+    class TinyMT32Lanes {
+    public:
+        enum { lanes = L };
+
+        /**
+         *\japanese
+         * コンストラクタ。パラメータと状態はすべて 0 になる。
+         *\endjapanese
+         *
+         *\english
+         * Constructor. All parameters and states are set to 0.
+         *\endenglish
+         */
+        TinyMT32Lanes() {
+            for (int l = 0; l < L; l++) {
+                st0[l] = 0;
+                st1[l] = 0;
+                st2[l] = 0;
+                st3[l] = 0;
+                mat1[l] = 0;
+                mat2[l] = 0;
+                tmat[l] = 0;
+            }
+        }
+
+        /**
+         *\japanese
+         * レーンのパラメータを設定する。
+         * @param[in] lane レーン番号
+         * @param[in] m1 mat1
+         * @param[in] m2 mat2
+         * @param[in] t tmat
+         *\endjapanese
+         *
+         *\english
+         * Sets parameters of a lane.
+         * @param[in] lane lane number
+         * @param[in] m1 mat1
+         * @param[in] m2 mat2
+         * @param[in] t tmat
+         *\endenglish
+         */
+        void setParam(int lane, uint32_t m1, uint32_t m2, uint32_t t) {
+            mat1[lane] = m1;
+            mat2[lane] = m2;
+            tmat[lane] = t;
+        }
+
+        /**
+         *\japanese
+         * レーンを tinymt32_init() と同じ方法で初期化する。
+         * パラメータを設定してから呼ぶこと。
+         * @param[in] lane レーン番号
+         * @param[in] value 種
+         *\endjapanese
+         *
+         *\english
+         * Initializes a lane in the same way as tinymt32_init().
+         * Parameters should be set beforehand.
+         * @param[in] lane lane number
+         * @param[in] value seed
+         *\endenglish
+         */
+        void seed(int lane, uint32_t value) {
+            uint32_t st[4] = {value, mat1[lane], mat2[lane], tmat[lane]};
+            for (int i = 1; i < 8; i++) {
+                st[i & 3] ^= static_cast<uint32_t>(i)
+                    + UINT32_C(1812433253)
+                    * (st[(i - 1) & 3] ^ (st[(i - 1) & 3] >> 30));
+            }
+            if ((st[0] & UINT32_C(0x7fffffff)) == 0 && st[1] == 0
+                && st[2] == 0 && st[3] == 0) {
+                st[0] = 'T';
+                st[1] = 'I';
+                st[2] = 'N';
+                st[3] = 'Y';
+            }
+            st0[lane] = st[0];
+            st1[lane] = st[1];
+            st2[lane] = st[2];
+            st3[lane] = st[3];
+            for (int i = 0; i < 8; i++) {
+                next_state(lane);
+            }
+        }
+
+        /**
+         *\japanese
+         * すべてのレーンを同じ種で初期化する。
+         * @param[in] value 種
+         *\endjapanese
+         *
+         *\english
+         * Initializes all lanes by the same seed.
+         * @param[in] value seed
+         *\endenglish
+         */
+        void seed(uint32_t value) {
+            for (int l = 0; l < L; l++) {
+                seed(l, value);
+            }
+        }
+
+        /**
+         *\japanese
+         * 全レーンを一歩進め、レーンごとに１個ずつ出力する。
+         * @param[out] out L 個の出力、out[l] がレーン l の出力
+         *\endjapanese
+         *
+         *\english
+         * Steps all lanes, and outputs one number for each lane.
+         * @param[out] out L outputs, out[l] is output of lane l
+         *\endenglish
+         */
+        void generate(uint32_t out[]) {
+            int l = 0;
+#if MTTOOLBOX_TINYMT_VECTOR_BYTES > 0
+            typedef tinymt_kernel<MTTOOLBOX_TINYMT_VECTOR_BYTES> K;
+            for (; l + K::lanes32 <= L; l += K::lanes32) {
+                step_vector<K>(l, &out[l]);
+            }
+#endif
+            for (; l < L; l++) {
+                next_state(l);
+                out[l] = temper(l);
+            }
+        }
+
+        /**
+         *\japanese
+         * generate() を steps 回呼んで、出力を順に並べる。
+         * @param[out] array steps * L 個の出力、array[t * L + l] が
+         * レーン l の t 番目の出力
+         * @param[in] steps 何歩進めるか
+         *\endjapanese
+         *
+         *\english
+         * Calls generate() \b steps times, and arranges outputs in
+         * order.
+         * @param[out] array steps * L outputs, array[t * L + l] is
+         * the t-th output of lane l
+         * @param[in] steps number of steps
+         *\endenglish
+         */
+        void fill_array(uint32_t * array, int steps) {
+            for (int t = 0; t < steps; t++) {
+                generate(&array[t * L]);
+            }
+        }
+    private:
+        uint32_t st0[L];
+        uint32_t st1[L];
+        uint32_t st2[L];
+        uint32_t st3[L];
+        uint32_t mat1[L];
+        uint32_t mat2[L];
+        uint32_t tmat[L];
+
+        void next_state(int l) {
+            uint32_t y = st3[l];
+            uint32_t x = (st0[l] & UINT32_C(0x7fffffff)) ^ st1[l] ^ st2[l];
+            x ^= (x << 1);
+            y ^= (y >> 1) ^ x;
+            st0[l] = st1[l];
+            st1[l] = st2[l];
+            st2[l] = x ^ (y << 10);
+            st3[l] = y;
+            if (y & 1) {
+                st1[l] ^= mat1[l];
+                st2[l] ^= mat2[l];
+            }
+        }
+
+        uint32_t temper(int l) const {
+            uint32_t t0 = st3[l];
+            uint32_t t1 = st0[l] + (st2[l] >> 8);
+            t0 ^= t1;
+            if (t1 & 1) {
+                t0 ^= tmat[l];
+            }
+            return t0;
+        }
+
+        /*
+         * next_state() と temper() をレーン l から K::lanes32 個分
+         * まとめて計算する。
+         */
+        template<typename K>
+        void step_vector(int l, uint32_t * out) {
+            typedef typename K::vec vec;
+            vec s0 = K::load(&st0[l]);
+            vec s1 = K::load(&st1[l]);
+            vec s2 = K::load(&st2[l]);
+            vec y = K::load(&st3[l]);
+            vec x = K::bxor(K::band(s0, K::set32(UINT32_C(0x7fffffff))),
+                            K::bxor(s1, s2));
+            x = K::bxor(x, K::shl32(x, 1));
+            y = K::bxor(y, K::bxor(K::shr32(y, 1), x));
+            vec m = K::mask32(y);
+            s0 = s1;
+            s1 = K::bxor(s2, K::band(m, K::load(&mat1[l])));
+            s2 = K::bxor(K::bxor(x, K::shl32(y, 10)),
+                         K::band(m, K::load(&mat2[l])));
+            K::store(&st0[l], s0);
+            K::store(&st1[l], s1);
+            K::store(&st2[l], s2);
+            K::store(&st3[l], y);
+            vec t1 = K::add32(s0, K::shr32(s2, 8));
+            vec t0 = K::bxor(y, t1);
+            t0 = K::bxor(t0, K::band(K::mask32(t1), K::load(&tmat[l])));
+            K::store(out, t0);
+        }
+    };
+
+    /**
+     * @class TinyMT64Lanes
+     *\japanese
+     * @brief L 個の tinymt64 を一斉に動かす
+     *
+     * TinyMT32Lanes の 64 ビット版である。レーン l の出力列は、同じ
+     * mat1, mat2, tmat と種で tinymt64_init() した tinymt64 の
+     * tinymt64_generate_uint64() の列と同じである。
+     *
+     * @tparam L レーン数
+     *\endjapanese
+     *
+     *\english
+     * @brief Steps L tinymt64s in lockstep
+     *
+     * This is the 64-bit version of TinyMT32Lanes. The output
+     * sequence of lane l is the same as tinymt64_generate_uint64() of
+     * tinymt64 initialized by tinymt64_init() with the same mat1,
+     * mat2, tmat and seed.
+     *
+     * @tparam L number of lanes
+     *\endenglish
+     */
+    template<int L>
+    class TinyMT64Lanes {
+    public:
+        enum { lanes = L };
+
+        /**
+         *\japanese
+         * コンストラクタ。パラメータと状態はすべて 0 になる。
+         *\endjapanese
+         *
+         *\english
+         * Constructor. All parameters and states are set to 0.
+         *\endenglish
+         */
+        TinyMT64Lanes() {
+            for (int l = 0; l < L; l++) {
+                st0[l] = 0;
+                st1[l] = 0;
+                mat1[l] = 0;
+                mat2[l] = 0;
+                tmat[l] = 0;
+            }
+        }
+
+        /**
+         *\japanese
+         * レーンのパラメータを設定する。
+         * @param[in] lane レーン番号
+         * @param[in] m1 mat1
+         * @param[in] m2 mat2
+         * @param[in] t tmat
+         *\endjapanese
+         *
+         *\english
+         * Sets parameters of a lane.
+         * @param[in] lane lane number
+         * @param[in] m1 mat1
+         * @param[in] m2 mat2
+         * @param[in] t tmat
+         *\endenglish
+         */
+        void setParam(int lane, uint32_t m1, uint32_t m2, uint64_t t) {
+            mat1[lane] = m1;
+            mat2[lane] = static_cast<uint64_t>(m2) << 32;
+            tmat[lane] = t;
+        }
+
+        /**
+         *\japanese
+         * レーンを tinymt64_init() と同じ方法で初期化する。
+         * パラメータを設定してから呼ぶこと。
+         * @param[in] lane レーン番号
+         * @param[in] value 種
+         *\endjapanese
+         *
+         *\english
+         * Initializes a lane in the same way as tinymt64_init().
+         * Parameters should be set beforehand.
+         * @param[in] lane lane number
+         * @param[in] value seed
+         *\endenglish
+         */
+        void seed(int lane, uint64_t value) {
+            uint64_t st[2] = {value ^ (mat1[lane] << 32),
+                              (mat2[lane] >> 32) ^ tmat[lane]};
+            for (int i = 1; i < 8; i++) {
+                st[i & 1] ^= static_cast<uint64_t>(i)
+                    + UINT64_C(6364136223846793005)
+                    * (st[(i - 1) & 1] ^ (st[(i - 1) & 1] >> 62));
+            }
+            if ((st[0] & UINT64_C(0x7fffffffffffffff)) == 0 && st[1] == 0) {
+                st[0] = 'T';
+                st[1] = 'M';
+            }
+            st0[lane] = st[0];
+            st1[lane] = st[1];
+        }
+
+        /**
+         *\japanese
+         * すべてのレーンを同じ種で初期化する。
+         * @param[in] value 種
+         *\endjapanese
+         *
+         *\english
+         * Initializes all lanes by the same seed.
+         * @param[in] value seed
+         *\endenglish
+         */
+        void seed(uint64_t value) {
+            for (int l = 0; l < L; l++) {
+                seed(l, value);
+            }
+        }
+
+        /**
+         *\japanese
+         * 全レーンを一歩進め、レーンごとに１個ずつ出力する。
+         * @param[out] out L 個の出力、out[l] がレーン l の出力
+         *\endjapanese
+         *
+         *\english
+         * Steps all lanes, and outputs one number for each lane.
+         * @param[out] out L outputs, out[l] is output of lane l
+         *\endenglish
+         */
+        void generate(uint64_t out[]) {
+            int l = 0;
+#if MTTOOLBOX_TINYMT_VECTOR_BYTES > 0
+            typedef tinymt_kernel<MTTOOLBOX_TINYMT_VECTOR_BYTES> K;
+            for (; l + K::lanes64 <= L; l += K::lanes64) {
+                step_vector<K>(l, &out[l]);
+            }
+#endif
+            for (; l < L; l++) {
+                next_state(l);
+                out[l] = temper(l);
+            }
+        }
+
+        /**
+         *\japanese
+         * generate() を steps 回呼んで、出力を順に並べる。
+         * @param[out] array steps * L 個の出力、array[t * L + l] が
+         * レーン l の t 番目の出力
+         * @param[in] steps 何歩進めるか
+         *\endjapanese
+         *
+         *\english
+         * Calls generate() \b steps times, and arranges outputs in
+         * order.
+         * @param[out] array steps * L outputs, array[t * L + l] is
+         * the t-th output of lane l
+         * @param[in] steps number of steps
+         *\endenglish
+         */
+        void fill_array(uint64_t * array, int steps) {
+            for (int t = 0; t < steps; t++) {
+                generate(&array[t * L]);
+            }
+        }
+    private:
+        uint64_t st0[L];
+        uint64_t st1[L];
+        uint64_t mat1[L];
+        uint64_t mat2[L];    /* mat2 << 32 */
+        uint64_t tmat[L];
+
+        void next_state(int l) {
+            uint64_t x = (st0[l] & UINT64_C(0x7fffffffffffffff)) ^ st1[l];
+            x ^= x << 12;
+            x ^= x >> 32;
+            x ^= x << 32;
+            x ^= x << 11;
+            st0[l] = st1[l];
+            st1[l] = x;
+            if (x & 1) {
+                st0[l] ^= mat1[l];
+                st1[l] ^= mat2[l];
+            }
+        }
+
+        uint64_t temper(int l) const {
+            uint64_t x = st0[l] + st1[l];
+            x ^= st0[l] >> 8;
+            if (x & 1) {
+                x ^= tmat[l];
+            }
+            return x;
+        }
+
+        template<typename K>
+        void step_vector(int l, uint64_t * out) {
+            typedef typename K::vec vec;
+            vec s0 = K::load(&st0[l]);
+            vec s1 = K::load(&st1[l]);
+            vec x = K::bxor(K::band(s0, K::set64(
+                                        UINT64_C(0x7fffffffffffffff))), s1);
+            x = K::bxor(x, K::shl64(x, 12));
+            x = K::bxor(x, K::shr64(x, 32));
+            x = K::bxor(x, K::shl64(x, 32));
+            x = K::bxor(x, K::shl64(x, 11));
+            vec m = K::mask64(x);
+            s0 = K::bxor(s1, K::band(m, K::load(&mat1[l])));
+            s1 = K::bxor(x, K::band(m, K::load(&mat2[l])));
+            K::store(&st0[l], s0);
+            K::store(&st1[l], s1);
+            vec t = K::bxor(K::add64(s0, s1), K::shr64(s0, 8));
+            t = K::bxor(t, K::band(K::mask64(t), K::load(&tmat[l])));
+            K::store(out, t);
+        }
+    };
+}
+#endif // MTTOOLBOX_TINYMT_LANES_HPP
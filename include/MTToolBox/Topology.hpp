@@ -0,0 +1,267 @@
+#ifndef MTTOOLBOX_TOPOLOGY_HPP
+#define MTTOOLBOX_TOPOLOGY_HPP
+/**
+ * @file Topology.hpp
+ *
+ *\japanese
+ * @brief CPU の配置と最終段キャッシュの大きさ
+ *
+ * 並列探索のワーカーは、それぞれ生成器の複製や基底の配列を持つ。
+ * 大きなメルセンヌ指数ではこれがスレッドあたり数メガバイトになり、
+ * 共有の最終段キャッシュ (LLC) を奪い合ったり、別のソケットの
+ * メモリを読んだりする。このファイルは Linux の sysfs から CPU、
+ * NUMA ノード、LLC の構成を読み、ワーカーを置く CPU の順番と、
+ * 作業領域の大きさに見合ったスレッド数を決める。
+ *
+ * ワーカーを CPU に固定し、作業領域をワーカー自身が確保して最初に
+ * 書き込めば、Linux の first touch の方針により作業領域はそのノードの
+ * メモリに置かれる。WorkerPool::setPinning() を参照。
+ *\endjapanese
+ *
+ *\english
+ * @brief Placement of CPUs and size of last level caches
+ *
+ * Workers of parallel searches hold clones of generators and arrays
+ * of bases. For large Mersenne exponents these become megabytes per
+ * thread, which compete for shared last level caches (LLC) and read
+ * memory of other sockets. This file reads the structure of CPUs,
+ * NUMA nodes and LLCs from sysfs of Linux, and decides the order of
+ * CPUs on which workers are placed and the number of threads which
+ * fits the size of working sets.
+ *
+ * If workers are pinned to CPUs and allocate and first write their
+ * working sets by themselves, the working sets are placed in memory
+ * of the node by the first touch policy of Linux. See
+ * WorkerPool::setPinning().
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace MTToolBox {
+    /**
+     * @class CpuTopology
+     *\japanese
+     * @brief CPU、NUMA ノード、LLC の構成
+     *
+     * sysfs が読めなければ、オンラインの CPU がすべてひとつのノード、
+     * ひとつの LLC に属するとみなす。
+     *\endjapanese
+     *
+     *\english
+     * @brief Structure of CPUs, NUMA nodes and LLCs
+     *
+     * If sysfs cannot be read, all online CPUs are regarded as
+     * belonging to one node and one LLC.
+     *\endenglish
+     */
+    class CpuTopology {
+    public:
+        /**
+         *\japanese
+         * コンストラクタ。この計算機を調べ、このプロセスが使える CPU
+         * だけを対象にする。
+         *\endjapanese
+         *
+         *\english
+         * Constructor. Probes this machine, and only CPUs which this
+         * process can use are considered.
+         *\endenglish
+         */
+        CpuTopology();
+
+        /**
+         *\japanese
+         * コンストラクタ。\b root 以下を sysfs の /sys/devices/system と
+         * して読む。プロセスの CPU の制限は見ない。
+         * @param[in] root sysfs の devices/system にあたるディレクトリ
+         *\endjapanese
+         *
+         *\english
+         * Constructor. Reads under \b root as /sys/devices/system of
+         * sysfs. CPU restriction of the process is not considered.
+         * @param[in] root directory corresponding to devices/system of
+         * sysfs
+         *\endenglish
+         */
+        explicit CpuTopology(const std::string& root);
+
+        /**
+         *\japanese
+         * @return この計算機の構成、最初の呼び出しで一度だけ調べる
+         *\endjapanese
+         *
+         *\english
+         * @return structure of this machine, probed once at the first
+         * call
+         *\endenglish
+         */
+        static const CpuTopology& system();
+
+        /**
+         *\japanese
+         * 生成器の状態を \b copies 個持つ作業領域の大きさを見積もる。
+         * @param[in] bitSize 状態のビット数、bitSize() の値
+         * @param[in] copies 複製の数
+         * @return 作業領域のバイト数
+         *\endjapanese
+         *
+         *\english
+         * Estimates size of a working set holding \b copies states of a
+         * generator.
+         * @param[in] bitSize number of bits of the state, value of
+         * bitSize()
+         * @param[in] copies number of copies
+         * @return bytes of the working set
+         *\endenglish
+         */
+        static size_t workingSet(int bitSize, int copies);
+
+        /**
+         *\japanese
+         * 呼び出したスレッドを CPU に固定する。
+         * @param[in] cpu CPU の番号
+         * @return 固定できたら true
+         *\endjapanese
+         *
+         *\english
+         * Pins the calling thread to a CPU.
+         * @param[in] cpu number of the CPU
+         * @return true if pinned
+         *\endenglish
+         */
+        static bool pin(int cpu);
+
+        /**
+         *\japanese
+         * @return 使える CPU の数
+         *\endjapanese
+         *
+         *\english
+         * @return number of usable CPUs
+         *\endenglish
+         */
+        int getCpus() const {
+            return static_cast<int>(cpus.size());
+        }
+
+        /**
+         *\japanese
+         * @return 使える CPU を持つ NUMA ノードの数
+         *\endjapanese
+         *
+         *\english
+         * @return number of NUMA nodes which have usable CPUs
+         *\endenglish
+         */
+        int getNodes() const {
+            return nodes;
+        }
+
+        /**
+         *\japanese
+         * @return LLC の数
+         *\endjapanese
+         *
+         *\english
+         * @return number of LLCs
+         *\endenglish
+         */
+        int getCacheDomains() const {
+            return static_cast<int>(cacheSize.size());
+        }
+
+        /**
+         *\japanese
+         * @return LLC ひとつのバイト数、わからなければ 0
+         *\endjapanese
+         *
+         *\english
+         * @return bytes of one LLC, 0 if unknown
+         *\endenglish
+         */
+        size_t getCacheSize() const;
+
+        /**
+         *\japanese
+         * \b index 番目のワーカーを置く CPU を返す。
+         *
+         * ノードを順番に巡り、各ノードの中では LLC を順番に巡る。
+         * SMT の兄弟スレッドは、すべてのコアにひとつずつ置いた後に使う。
+         * CPU の数を越えたら最初に戻る。
+         * @param[in] index ワーカーの番号
+         * @return CPU の番号
+         *\endjapanese
+         *
+         *\english
+         * Returns the CPU on which the \b index th worker is placed.
+         *
+         * Nodes are visited in turn, and LLCs are visited in turn in
+         * each node. SMT siblings are used after one thread is placed
+         * on each core. It wraps around after the number of CPUs.
+         * @param[in] index index of the worker
+         * @return number of the CPU
+         *\endenglish
+         */
+        int placement(int index) const;
+
+        /**
+         *\japanese
+         * @param[in] cpu CPU の番号
+         * @return その CPU の NUMA ノードの順番、使えない CPU なら -1
+         *\endjapanese
+         *
+         *\english
+         * @param[in] cpu number of a CPU
+         * @return index of the NUMA node of the CPU, -1 if the CPU is
+         * not usable
+         *\endenglish
+         */
+        int getNode(int cpu) const;
+
+        /**
+         *\japanese
+         * 作業領域が LLC に収まるスレッド数を返す。
+         *
+         * LLC ごとに、その大きさを \b workingSet で割った数のスレッドを
+         * 使う。ただし LLC ごとに 1 以上、その LLC を共有する CPU の数
+         * 以下とする。
+         * @param[in] workingSet ワーカーひとつの作業領域のバイト数、
+         * 0 なら CPU の数を返す
+         * @return スレッド数
+         *\endjapanese
+         *
+         *\english
+         * Returns number of threads whose working sets fit in LLCs.
+         *
+         * For each LLC, its size divided by \b workingSet threads are
+         * used, but at least one and at most the number of CPUs sharing
+         * the LLC.
+         * @param[in] workingSet bytes of the working set of a worker, 0
+         * to return the number of CPUs
+         * @return number of threads
+         *\endenglish
+         */
+        int concurrencyFor(size_t workingSet) const;
+    private:
+        std::vector<int> cpus;
+        std::vector<int> node;
+        std::vector<int> domain;
+        std::vector<size_t> cacheSize;
+        std::vector<int> order;
+        int nodes;
+        void probe(const std::string& root, bool affinity);
+    };
+}
+#endif // MTTOOLBOX_TOPOLOGY_HPP
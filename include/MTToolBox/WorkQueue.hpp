@@ -0,0 +1,310 @@
+#ifndef MTTOOLBOX_WORK_QUEUE_HPP
+#define MTTOOLBOX_WORK_QUEUE_HPP
+/**
+ * @file WorkQueue.hpp
+ *
+ *\japanese
+ * @brief 複数のプロセスで探索を分担するためのファイル上の作業キュー
+ *
+ * 探索範囲を SequentialShards と同じ方法で分割してファイルに書き、
+ * 複数のプロセス(ワーカー)がひとつずつ取って探索する。ワーカーは
+ * 見つけたパラメータと、試した数をキューに報告する。ファイルの更新は
+ * fcntl によるロックで排他制御するので、同じファイルシステムを見る
+ * プロセスならどこからでも使える。
+ *\endjapanese
+ *
+ *\english
+ * @brief File backed work queue to share a search among several
+ * processes
+ *
+ * The search range is divided in the same way as SequentialShards
+ * and written to a file, and several processes (workers) take them
+ * one by one and search. Workers report found parameters and numbers
+ * of tried parameters to the queue. Updates of the file are
+ * serialized by fcntl locks, so any process which sees the same file
+ * system can use the queue.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace MTToolBox {
+    /**
+     * @class WorkItem
+     *\japanese
+     * @brief キューから取った探索範囲
+     *
+     * \b start から \b floor までを Sequential で数える。
+     *\endjapanese
+     *
+     *\english
+     * @brief Search range taken from the queue
+     *
+     * Count from \b start down to \b floor by Sequential.
+     *\endenglish
+     */
+    struct WorkItem {
+        int index;
+        uint64_t start;
+        uint64_t floor;
+    };
+
+    /**
+     * @class WorkQueue
+     *\japanese
+     * @brief ファイル上の作業キュー
+     *
+     * ファイル \b path に範囲の状態を、\b path.results に見つかった
+     * パラメータを記録する。\b path.lock はロック用のファイルである。
+     * 状態のファイルは一時ファイルに書いてから名前を変えるので、
+     * 途中で中断されても壊れない。終了せずに止まったワーカーが取った
+     * 範囲は、同じホストのプロセスが存在しなければ別のワーカーが
+     * 取り直す。
+     *\endjapanese
+     *
+     *\english
+     * @brief File backed work queue
+     *
+     * States of ranges are recorded in file \b path, and found
+     * parameters in \b path.results. \b path.lock is used for
+     * locking. The state file is written to a temporary file and
+     * renamed, so it is not broken by interruption. A range taken by a
+     * worker which stopped without finishing it is taken again by
+     * another worker, if the process does not exist on the same host.
+     *\endenglish
+     */
+    class WorkQueue {
+    public:
+        /**
+         *\japanese
+         * 既存のキューを開く。
+         * @param[in] path キューのファイル名
+         *\endjapanese
+         *
+         *\english
+         * Opens an existing queue.
+         * @param[in] path file name of the queue
+         *\endenglish
+         */
+        WorkQueue(const std::string& path);
+        ~WorkQueue();
+
+        /**
+         *\japanese
+         * キューを作る。
+         *
+         * \b start から \b floor までの範囲を \b count 個に分割する。
+         * @param[in] path キューのファイル名
+         * @param[in] start 内部カウンタの初期値
+         * @param[in] floor 内部カウンタの下限
+         * @param[in] count 範囲の数
+         * @throw std::runtime_error キューが既にあるとき、作れないとき
+         *\endjapanese
+         *
+         *\english
+         * Creates a queue.
+         *
+         * Range from \b start down to \b floor is divided into \b count
+         * ranges.
+         * @param[in] path file name of the queue
+         * @param[in] start initial value of the internal counter
+         * @param[in] floor lower limit of the internal counter
+         * @param[in] count number of ranges
+         * @throw std::runtime_error when the queue already exists or
+         * can't be created.
+         *\endenglish
+         */
+        static void create(const std::string& path,
+                           uint64_t start, uint64_t floor, int count);
+
+        /**
+         *\japanese
+         * 誰も担当していない範囲を取る。
+         * @param[out] item 取った範囲
+         * @return 取れなかったら false
+         *\endjapanese
+         *
+         *\english
+         * Claims a range which nobody works on.
+         * @param[out] item claimed range
+         * @return false if no range remains.
+         *\endenglish
+         */
+        bool claim(WorkItem& item);
+
+        /**
+         *\japanese
+         * 見つかったパラメータを報告する。
+         *
+         * key の次を範囲の進み具合として記録するので、報告の後で
+         * ワーカーが止まっても、取り直したワーカーは報告済みの
+         * パラメータの次から探索する。同じキーのパラメータが既に
+         * 報告されていれば、記録しない。
+         * @param[in] item 探索中の範囲
+         * @param[in] key 結果を並べるためのキー、Sequential::getLast()
+         * @param[in] line パラメータを表す文字列、改行を含まないこと
+         * @return これまでに報告されたパラメータの数、同じキーは
+         * 一つと数える
+         *\endjapanese
+         *
+         *\english
+         * Reports a found parameter.
+         *
+         * The next of \b key is recorded as progress of the range, so
+         * if the worker stops after reporting, a worker which claims
+         * the range again searches from the next of reported
+         * parameters.
+         * If a parameter with the same key is already reported, it is
+         * not recorded.
+         * @param[in] item range in search
+         * @param[in] key key to sort results, Sequential::getLast()
+         * @param[in] line string representing the parameter, must not
+         * include new line.
+         * @return number of reported parameters, parameters of the
+         * same key are counted as one.
+         *\endenglish
+         */
+        uint64_t report(const WorkItem& item, uint64_t key,
+                        const std::string& line);
+
+        /**
+         *\japanese
+         * 範囲の探索を途中でやめて、残りを他のワーカーに返す。
+         * @param[in] item 探索中の範囲
+         * @param[in] status 次に数える内部カウンタの値
+         * Sequential::getStatus()
+         * @param[in] tried 範囲を取ってから試したパラメータの数
+         * @param[in] found 見つかったパラメータの数
+         *\endjapanese
+         *
+         *\english
+         * Stops searching the range, and returns the rest to other
+         * workers.
+         * @param[in] item range in search
+         * @param[in] status next value of internal counter,
+         * Sequential::getStatus()
+         * @param[in] tried number of parameters tried since the range was
+         * claimed
+         * @param[in] found number of found parameters
+         *\endenglish
+         */
+        void release(const WorkItem& item, uint64_t status,
+                     uint64_t tried, uint64_t found);
+
+        /**
+         *\japanese
+         * 範囲の探索が終わったことを報告する。
+         * @param[in] item 探索した範囲
+         * @param[in] tried 範囲を取ってから試したパラメータの数
+         * @param[in] found 見つかったパラメータの数
+         *\endjapanese
+         *
+         *\english
+         * Reports that search of the range finished.
+         * @param[in] item searched range
+         * @param[in] tried number of parameters tried since the range was
+         * claimed
+         * @param[in] found number of found parameters
+         *\endenglish
+         */
+        void complete(const WorkItem& item, uint64_t tried, uint64_t found);
+
+        /**
+         *\japanese
+         * すべての範囲の探索が終わったかどうか
+         *\endjapanese
+         *
+         *\english
+         * Checks if search of all ranges finished.
+         *\endenglish
+         */
+        bool isAllDone();
+
+        /**
+         *\japanese
+         * 報告された試行数と発見数の合計を返す。
+         * 探索中の範囲の分は、最後に報告したパラメータまでを含む。
+         * @param[out] tried 試したパラメータの数
+         * @param[out] found 見つかったパラメータの数
+         *\endjapanese
+         *
+         *\english
+         * Returns totals of reported numbers of tried and found
+         * parameters. Ranges in search are included up to the last
+         * reported parameter.
+         * @param[out] tried number of tried parameters
+         * @param[out] found number of found parameters
+         *\endenglish
+         */
+        void getStatistics(uint64_t& tried, uint64_t& found);
+
+        /**
+         *\japanese
+         * これまでに報告されたパラメータの数を返す。
+         * 探索中の範囲の分も含み、同じキーは一つと数える。
+         *\endjapanese
+         *
+         *\english
+         * Returns number of reported parameters, including ranges in
+         * search. Parameters of the same key are counted as one.
+         *\endenglish
+         */
+        uint64_t getReported();
+
+        /**
+         *\japanese
+         * 報告されたパラメータを、分割しないで探索したときの順番に並べて
+         * 返す。
+         * @param[out] results キーとパラメータの組
+         *\endjapanese
+         *
+         *\english
+         * Returns reported parameters in the order of search without
+         * division.
+         * @param[out] results pairs of key and parameter
+         *\endenglish
+         */
+        void collect(std::vector<std::pair<uint64_t, std::string> >&
+                     results);
+    private:
+        enum item_state { pending, claimed, done };
+        struct Record {
+            uint64_t top;
+            uint64_t floor;
+            uint64_t status;
+            item_state state;
+            uint64_t tried;
+            uint64_t found;
+            std::string host;
+            long pid;
+        };
+        std::string path;
+        int lock_fd;
+        uint64_t reported;
+        std::vector<Record> records;
+
+        WorkQueue();
+        void read();
+        void write();
+        uint64_t countReported(int index, uint64_t low,
+                               uint64_t high) const;
+        void credit(const WorkItem& item, Record& r,
+                    uint64_t tried, uint64_t found) const;
+        bool isAlive(const Record& r) const;
+        WorkQueue(const WorkQueue&);
+        WorkQueue& operator=(const WorkQueue&);
+    };
+}
+#endif // MTTOOLBOX_WORK_QUEUE_HPP
@@ -0,0 +1,175 @@
+#ifndef MTTOOLBOX_BITOPS_HPP
+#define MTTOOLBOX_BITOPS_HPP
+/**
+ * @file bitops.hpp
+ *
+ *\japanese
+ * @brief 実行時に CPU を判定して選ばれるビット演算プリミティブ
+ *
+ * 64ビットワードの配列に対する 1 の個数、最下位・最上位の 1 の位置、
+ * ビット抽出を、実行中の CPU が持つ命令（POPCNT, LZCNT, TZCNT, BMI2,
+ * AVX-512 VPOPCNTDQ）を使って計算する。ライブラリを -march=native
+ * でビルドしなくても、世代の異なる CPU でそれぞれ最速の実装が使われる。
+ *
+ * 1ワードだけの演算は util.hpp のインライン関数の方が速いので、
+ * こちらは wbits のような長いワードや配列に使う。
+ *\endjapanese
+ *
+ *\english
+ * @brief Bit primitives selected at runtime by CPU detection
+ *
+ * Population count, positions of the lowest and highest 1, and
+ * bit extraction over arrays of 64-bit words are computed by
+ * instructions of the running CPU (POPCNT, LZCNT, TZCNT, BMI2,
+ * AVX-512 VPOPCNTDQ). The fastest implementation is used on each
+ * CPU generation without building the library with -march=native.
+ *
+ * Inline functions in util.hpp are faster for a single word, these
+ * are for long words like wbits and for arrays.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <inttypes.h>
+
+namespace MTToolBox {
+    /**
+     * @struct bit_primitives_t
+     *\japanese
+     * @brief ビット演算プリミティブの実装の組
+     *\endjapanese
+     *
+     *\english
+     * @brief A set of implementations of bit primitives
+     *\endenglish
+     */
+    struct bit_primitives_t {
+        /**
+         *\japanese
+         * 実装の名前 "generic", "popcnt", "bmi2", "avx512" のいずれか
+         *\endjapanese
+         *
+         *\english
+         * name of implementation, one of "generic", "popcnt", "bmi2"
+         * and "avx512"
+         *\endenglish
+         */
+        const char * name;
+
+        /**
+         *\japanese
+         * 配列 p[0..n-1] の中の1の個数を返す。
+         *\endjapanese
+         *
+         *\english
+         * Returns number of 1s in array p[0..n-1].
+         *\endenglish
+         */
+        int (*count_bit)(const uint64_t * p, int n);
+
+        /**
+         *\japanese
+         * 配列 p[0..n-1] を p[0] の LSB を 0 番目とするビット列とみなして、
+         * 最下位の 1 の位置を返す。すべて 0 なら -1 を返す。
+         *\endjapanese
+         *
+         *\english
+         * Regarding array p[0..n-1] as a bit sequence whose bit 0 is
+         * LSB of p[0], returns position of the lowest 1. Returns -1
+         * if all bits are 0.
+         *\endenglish
+         */
+        int (*lowest_one)(const uint64_t * p, int n);
+
+        /**
+         *\japanese
+         * lowest_one と同じ番号付けで、最上位の 1 の位置を返す。
+         * すべて 0 なら -1 を返す。
+         *\endjapanese
+         *
+         *\english
+         * Returns position of the highest 1 in the same numbering as
+         * lowest_one. Returns -1 if all bits are 0.
+         *\endenglish
+         */
+        int (*highest_one)(const uint64_t * p, int n);
+
+        /**
+         *\japanese
+         * x の mask が 1 の位置のビットを取り出して下位に詰める。(PEXT)
+         *\endjapanese
+         *
+         *\english
+         * Extracts bits of x at 1s of mask, and packs them to lower
+         * bits. (PEXT)
+         *\endenglish
+         */
+        uint64_t (*extract_bits)(uint64_t x, uint64_t mask);
+    };
+
+    /**
+     *\japanese
+     * 実行中の CPU で使える最速の実装を返す。
+     *
+     * 最初の呼び出しで CPU を判定する。環境変数 MTTOOLBOX_BITOPS に
+     * 実装の名前が設定されていて、その実装が使えるときはそれを返す。
+     * @return ビット演算プリミティブの実装
+     *\endjapanese
+     *
+     *\english
+     * Returns the fastest implementation on the running CPU.
+     *
+     * CPU is detected at the first call. If environment variable
+     * MTTOOLBOX_BITOPS is set to a name of an implementation and the
+     * implementation is available, it is returned.
+     * @return implementation of bit primitives
+     *\endenglish
+     */
+    const bit_primitives_t& bit_primitives();
+
+    /**
+     *\japanese
+     * 名前を指定して実装を返す。ベンチマークやテストのために使う。
+     * @param[in] name 実装の名前
+     * @return 実装、実行中の CPU で使えないときは NULL
+     *\endjapanese
+     *
+     *\english
+     * Returns an implementation specified by name, used by benchmarks
+     * and tests.
+     * @param[in] name name of implementation
+     * @return implementation, or NULL if it is not available on the
+     * running CPU.
+     *\endenglish
+     */
+    const bit_primitives_t * bit_primitives_by_name(const char * name);
+
+    /**
+     *\japanese
+     * 配列の中の1の個数を返す。
+     * @param[in] p 64ビットワードの配列
+     * @param[in] n 配列の長さ
+     * @return 1の個数
+     *\endjapanese
+     *
+     *\english
+     * Returns number of 1s in an array.
+     * @param[in] p array of 64-bit words
+     * @param[in] n length of array
+     * @return number of 1s
+     *\endenglish
+     */
+    inline int count_bit_words(const uint64_t * p, int n) {
+        return bit_primitives().count_bit(p, n);
+    }
+}
+#endif // MTTOOLBOX_BITOPS_HPP
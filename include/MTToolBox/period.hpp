@@ -225,5 +225,68 @@ namespace MTToolBox {
      *\endenglish
      */
     bool hasFactorOfDegree(NTL::GF2X& poly, long degree);
+
+    /**
+     * @class FactorStatistics
+     *\japanese
+     * @brief hasFactorOfDegree() の計算量の記録
+     *
+     * 呼び出し回数、true を返した回数、法の下での二乗の回数、GCD の
+     * 回数、割り出した因子の数、経過時間（マイクロ秒）を持つ。
+     * 呼び出し側が用意し、呼び出しごとに加算される。スレッドごとに別の
+     * インスタンスを使うこと。
+     *\endjapanese
+     *
+     *\english
+     * @brief Record of cost of hasFactorOfDegree()
+     *
+     * Holds the number of calls, calls returned true, modular
+     * squarings, GCDs, factors divided out, and elapsed time in
+     * microseconds. Prepared by the caller, and accumulated on each
+     * call. Use different instances for each thread.
+     *\endenglish
+     */
+    struct FactorStatistics {
+        FactorStatistics() {
+            clear();
+        }
+        void clear() {
+            calls = 0;
+            found = 0;
+            squarings = 0;
+            gcds = 0;
+            divisions = 0;
+            microseconds = 0;
+        }
+        long calls;
+        long found;
+        long squarings;
+        long gcds;
+        long divisions;
+        long microseconds;
+    };
+
+    /**
+     *\japanese
+     * hasFactorOfDegree() と同じ判定をし、計算量を \b stat に加算する。
+     *
+     * @param[in, out] poly GF(2)係数多項式
+     * @param[in] degree \b poly に \b degree 次の原始多項式が含まれているか
+     * @param[in, out] stat 計算量の記録
+     * @return true poly が指定する次数の原始多項式を含む場合
+     *\endjapanese
+     *
+     *\english
+     * Same as hasFactorOfDegree(), and adds the cost to \b stat.
+     *
+     * @param[in, out] poly polynomial over GF(2)
+     * @param[in] degree if \b poly has primitive polynomial with \b degree
+     * in its factors.
+     * @param[in, out] stat record of cost
+     * @return true if \b poly has primitive polynomial with \b degree.
+     *\endenglish
+     */
+    bool hasFactorOfDegree(NTL::GF2X& poly, long degree,
+                           FactorStatistics& stat);
 }
 #endif // MTTOOLBOX_PERIOD_HPP
@@ -0,0 +1,153 @@
+#ifndef MTTOOLBOX_POLYIO_HPP
+#define MTTOOLBOX_POLYIO_HPP
+/**
+ * @file polyio.hpp
+ *
+ *\japanese
+ * @brief GF(2)係数多項式のバイナリ形式での入出力とハッシュ
+ *
+ * 多項式を 64 ビットワードの列に詰めて扱う。係数をひとつずつ取り
+ * 出すより速いので、大きな次数の特性多項式をファイルに保存したり、
+ * ハッシュ値で区別したりするのに使う。
+ *\endjapanese
+ *
+ *\english
+ * @brief Binary input and output of polynomials over GF(2), and
+ * hashing
+ *
+ * Polynomials are packed into sequences of 64-bit words. This is
+ * faster than taking coefficients one by one, and is used for saving
+ * characteristic polynomials of large degree to files and for
+ * distinguishing them by hash values.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <NTL/GF2X.h>
+
+namespace MTToolBox {
+    /**
+     *\japanese
+     * 多項式を 64 ビットワードの列に詰める。
+     *
+     * i 次の係数は words[i / 64] の下から i % 64 ビット目になる。
+     * ワードの数は (deg(poly) + 64) / 64 で、ゼロ多項式なら空になる。
+     * @param[out] words ワードの列
+     * @param[in] poly GF(2)係数多項式
+     *\endjapanese
+     *
+     *\english
+     * Packs a polynomial into a sequence of 64-bit words.
+     *
+     * Coefficient of degree i becomes the (i % 64)-th bit from LSB of
+     * words[i / 64]. The number of words is (deg(poly) + 64) / 64,
+     * and empty for the zero polynomial.
+     * @param[out] words sequence of words
+     * @param[in] poly polynomial over GF(2)
+     *\endenglish
+     */
+    void poly_to_words(std::vector<uint64_t>& words, const NTL::GF2X& poly);
+
+    /**
+     *\japanese
+     * 64 ビットワードの列から多項式を作る。poly_to_words() の逆。
+     * @param[out] poly GF(2)係数多項式
+     * @param[in] words ワードの列
+     *\endjapanese
+     *
+     *\english
+     * Makes a polynomial from a sequence of 64-bit words. Inverse of
+     * poly_to_words().
+     * @param[out] poly polynomial over GF(2)
+     * @param[in] words sequence of words
+     *\endenglish
+     */
+    void words_to_poly(NTL::GF2X& poly, const std::vector<uint64_t>& words);
+
+    /**
+     *\japanese
+     * 多項式をバイナリ形式で書く。
+     *
+     * 次数を 8 バイト、続いて poly_to_words() のワードを 8 バイトずつ、
+     * いずれもリトルエンディアンで書く。
+     * @param[in,out] os 出力ストリーム、バイナリモードで開くこと
+     * @param[in] poly GF(2)係数多項式
+     *\endjapanese
+     *
+     *\english
+     * Writes a polynomial in binary format.
+     *
+     * Degree in 8 bytes, followed by words of poly_to_words() in 8
+     * bytes each, are written in little endian.
+     * @param[in,out] os output stream, opened in binary mode
+     * @param[in] poly polynomial over GF(2)
+     *\endenglish
+     */
+    void write_poly(std::ostream& os, const NTL::GF2X& poly);
+
+    /**
+     *\japanese
+     * write_poly() で書いた多項式を読む。
+     * @param[out] poly GF(2)係数多項式
+     * @param[in,out] is 入力ストリーム、バイナリモードで開くこと
+     * @return 読めなければ false
+     *\endjapanese
+     *
+     *\english
+     * Reads a polynomial written by write_poly().
+     * @param[out] poly polynomial over GF(2)
+     * @param[in,out] is input stream, opened in binary mode
+     * @return false if failed to read
+     *\endenglish
+     */
+    bool read_poly(NTL::GF2X& poly, std::istream& is);
+
+    /**
+     *\japanese
+     * 多項式の 64 ビットハッシュ値を計算する。
+     *
+     * 暗号学的ハッシュではない。ワード単位で計算するので poly_sha1()
+     * よりずっと速い。
+     * @param[in] poly GF(2)係数多項式
+     * @return ハッシュ値
+     *\endjapanese
+     *
+     *\english
+     * Calculates 64-bit hash value of a polynomial.
+     *
+     * This is not a cryptographic hash. This is much faster than
+     * poly_sha1(), because it is calculated word by word.
+     * @param[in] poly polynomial over GF(2)
+     * @return hash value
+     *\endenglish
+     */
+    uint64_t poly_hash(const NTL::GF2X& poly);
+
+    /**
+     *\japanese
+     * 多項式のハッシュ値を 16 桁の十六進文字列で返す。
+     * @param[out] str 出力文字列
+     * @param[in] poly GF(2)係数多項式
+     *\endjapanese
+     *
+     *\english
+     * Returns hash value of a polynomial in 16 hexadecimal digits.
+     * @param[out] str output string
+     * @param[in] poly polynomial over GF(2)
+     *\endenglish
+     */
+    void poly_hash_string(std::string& str, const NTL::GF2X& poly);
+}
+#endif // MTTOOLBOX_POLYIO_HPP
@@ -31,6 +31,7 @@
 #include <NTL/GF2X.h>
 
 #if defined(USE_SHA)
+#include <vector>
 #include <openssl/sha.h>
 #endif
 
@@ -212,7 +213,9 @@ namespace MTToolBox {
      *
      * 多項式の係数を昇巾の順で01からなる文字列に変換し、その後その文字
      * 列のSHA1ダイジェストを計算する。計算されたSHA1ダイジェストは十六
-     * 進文字列として返される
+     * 進文字列として返される。
+     * 互換性のために残している。速いハッシュが必要なら polyio.hpp の
+     * poly_hash() を使うこと。
      *
      * @param[out] str 出力文字列
      * @param[in] poly GF(2)係数多項式
@@ -225,6 +228,8 @@ namespace MTToolBox {
      * of lowest degree appears first. Then Calculate SHA1 digest of
      * the string. Finally, the calculated digest is converted to
      * a hexadecimal string and returned.
+     * This is kept for compatibility. Use poly_hash() in polyio.hpp
+     * if a fast hash is needed.
      *
      * @param[out] str output string
      * @param[in] poly polynomial over GF(2)
@@ -233,26 +238,40 @@ namespace MTToolBox {
     inline static void poly_sha1(std::string& str, const NTL::GF2X& poly) {
         using namespace NTL;
         using namespace std;
+        static const char hex_digits[] = "0123456789abcdef";
         SHA_CTX ctx;
         SHA1_Init(&ctx);
-        if (deg(poly) < 0) {
+        long d = deg(poly);
+        if (d < 0) {
             SHA1_Update(&ctx, "-1", 2);
         }
-        for(int i = 0; i <= deg(poly); i++) {
-            if(rep(coeff(poly, i)) == 1) {
-                SHA1_Update(&ctx, "1", 1);
-            } else {
-                SHA1_Update(&ctx, "0", 1);
+        // 係数をまとめて取り出し、文字列をある程度ためてから渡す
+        long n = NumBytes(poly);
+        vector<unsigned char> bytes(static_cast<size_t>(n) + 1);
+        if (n > 0) {
+            BytesFromGF2X(&bytes[0], poly, n);
+        }
+        char buf[4096];
+        size_t len = 0;
+        for (long i = 0; i <= d; i++) {
+            buf[len++] = ((bytes[static_cast<size_t>(i / 8)] >> (i % 8)) & 1)
+                ? '1' : '0';
+            if (len == sizeof(buf)) {
+                SHA1_Update(&ctx, buf, len);
+                len = 0;
             }
         }
+        if (len > 0) {
+            SHA1_Update(&ctx, buf, len);
+        }
         unsigned char md[SHA_DIGEST_LENGTH];
         SHA1_Final(md, &ctx);
-        stringstream ss;
+        char hex_str[SHA_DIGEST_LENGTH * 2];
         for (int i = 0; i < SHA_DIGEST_LENGTH; i++) {
-            ss << setfill('0') << setw(2) << hex
-               << static_cast<int>(md[i]);
+            hex_str[2 * i] = hex_digits[md[i] >> 4];
+            hex_str[2 * i + 1] = hex_digits[md[i] & 0x0f];
         }
-        ss >> str;
+        str.assign(hex_str, sizeof(hex_str));
     }
 #endif
 
@@ -260,7 +279,8 @@ namespace MTToolBox {
      *\japanese
      * 入力をビット列とみなして最上位の1の位置を0とした最も右側の（下位の）1の位置を返す。
      *
-     * 1の位置を求めるアルゴリズムは以下のページのものを使用した。
+     * GCC 互換コンパイラでは組み込み関数 (BSF/TZCNT 命令) を使う。
+     * そうでなければ以下のページのアルゴリズムを使用した。
      * @see http://aggregate.org/MAGIC/#Trailing Zero Count
      * @param[in] x 入力
      * @return 最下位の1のあるビットの上位から数えた位置を返す。
@@ -270,7 +290,9 @@ namespace MTToolBox {
      * Returns the position of 1 which appears lowest (most right
      * side) in \b x, where the position of MSB becomes zero.
      *
-     * Algorithm to search position of 1 is from this page;
+     * GCC compatible compilers use a builtin function (BSF/TZCNT
+     * instruction). Otherwise, algorithm to search position of 1 is
+     * from this page;
      * @see http://aggregate.org/MAGIC/#Trailing Zero Count
      * @param[in] x input
      * @return the position of 1 which appears lowest (most right
@@ -282,9 +304,13 @@ namespace MTToolBox {
         if (x == 0) {
             return -1;
         }
+#if defined(__GNUC__)
+        return 15 - __builtin_ctz(x);
+#else
         int16_t y = (int16_t)x;
         y = static_cast<int16_t>(count_bit(static_cast<uint16_t>((y & -y) - 1)));
         return 15 - y;
+#endif
     }
 
     /**
@@ -316,9 +342,13 @@ namespace MTToolBox {
         if (x == 0) {
             return -1;
         }
+#if defined(__GNUC__)
+        return 31 - __builtin_ctz(x);
+#else
         int32_t y = (int32_t)x;
         y = count_bit((uint32_t)(y & -y) - 1);
         return 31 - y;
+#endif
     }
 
     /**
@@ -350,9 +380,13 @@ namespace MTToolBox {
         if (x == 0) {
             return -1;
         }
+#if defined(__GNUC__)
+        return 63 - __builtin_ctzll(x);
+#else
         int64_t y = (int64_t)x;
         y = count_bit((uint64_t)(y & -y) - 1);
         return 63 - static_cast<int>(y);
+#endif
     }
 
     /**
@@ -361,6 +395,8 @@ namespace MTToolBox {
      *
      * レジスタ内SIMDアルゴリズム
      * http://aggregate.org/MAGIC/ より引用
+     * POPCNT 命令が使えるようにコンパイルされたときは POPCNT 命令を使う。
+     * 実行時に CPU を判定したいときは bitops.hpp を使うこと。
      *
      * @param[in] x ビットパターン
      * @returns x の中の1の個数
@@ -371,16 +407,22 @@ namespace MTToolBox {
      *
      * SIMD within a Register algorithm
      * citing from a website http://aggregate.org/MAGIC/
+     * POPCNT instruction is used when compiled for it. Use bitops.hpp
+     * to detect CPU at runtime.
      * @param[in] x bit pattern
      * @return number of 1s in \b x.
      *\endenglish
      */
     inline static int count_bit(uint16_t x) {
+#if defined(__POPCNT__)
+        return __builtin_popcount(x);
+#else
         x -= (x >> 1) & UINT16_C(0x5555);
         x = ((x >> 2) & UINT16_C(0x3333)) + (x & UINT16_C(0x3333));
         x = ((x >> 4) + x) & UINT16_C(0x0f0f);
         x += (x >> 8);
         return (int)(x & 0x1f);
+#endif
     }
 
     /**
@@ -397,12 +439,16 @@ namespace MTToolBox {
      *\endenglish
      */
     inline static int count_bit(uint32_t x) {
+#if defined(__POPCNT__)
+        return __builtin_popcount(x);
+#else
         x -= (x >> 1) & UINT32_C(0x55555555);
         x = ((x >> 2) & UINT32_C(0x33333333)) + (x & UINT32_C(0x33333333));
         x = ((x >> 4) + x) & UINT32_C(0x0f0f0f0f);
         x += (x >> 8);
         x += (x >> 16);
         return (int)(x & 0x3f);
+#endif
     }
 
     /**
@@ -419,6 +465,9 @@ namespace MTToolBox {
      *\endenglish
      */
     inline static int count_bit(uint64_t x) {
+#if defined(__POPCNT__)
+        return __builtin_popcountll(x);
+#else
         x -= (x >> 1) & UINT64_C(0x5555555555555555);
         x = ((x >> 2) & UINT64_C(0x3333333333333333))
             + (x & UINT64_C(0x3333333333333333));
@@ -427,6 +476,7 @@ namespace MTToolBox {
         x += (x >> 16);
         x += (x >> 32);
         return (int)(x & 0x7f);
+#endif
     }
 
     /**
@@ -434,6 +484,8 @@ namespace MTToolBox {
      * ビットを反転する
      *
      * 入力ビットの上位と下位を反転する。最上位ビットは最下位ビットになる
+     * バイト内のビットを反転した後、GCC 互換コンパイラではバイトの並びを
+     * BSWAP 命令で反転する。
      * レジスタ内SIMDアルゴリズム
      * http://aggregate.org/MAGIC/ より引用
      * @param x ビットパターン
@@ -445,6 +497,8 @@ namespace MTToolBox {
      *
      * Reverse upper side and lower side in input.
      * The MSB bocomes the LSB.
+     * After reversing bits in each byte, GCC compatible compilers
+     * reverse the order of bytes by BSWAP instruction.
      * SIMD within a Register algorithm
      * citing from a website http://aggregate.org/MAGIC/
      * @param[in] x bit pattern
@@ -459,9 +513,13 @@ namespace MTToolBox {
         x = (((x >> 2) & y) | ((x & y) << 2));
         y = 0x0f0f0f0f;
         x = (((x >> 4) & y) | ((x & y) << 4));
+#if defined(__GNUC__)
+        return __builtin_bswap32(x);
+#else
         y = 0x00ff00ff;
         x = (((x >> 8) & y) | ((x & y) << 8));
         return((x >> 16) | (x << 16));
+#endif
     }
 
     /**
@@ -485,11 +543,15 @@ namespace MTToolBox {
         x = (((x >> 2) & y) | ((x & y) << 2));
         y = UINT64_C(0x0f0f0f0f0f0f0f0f);
         x = (((x >> 4) & y) | ((x & y) << 4));
+#if defined(__GNUC__)
+        return __builtin_bswap64(x);
+#else
         y = UINT64_C(0x00ff00ff00ff00ff);
         x = (((x >> 8) & y) | ((x & y) << 8));
         y = UINT64_C(0x0000ffff0000ffff);
         x = (((x >> 16) & y) | ((x & y) << 16));
         return((x >> 32) | (x << 32));
+#endif
     }
 
     /**
@@ -0,0 +1,557 @@
+#ifndef MTTOOLBOX_WBITS_HPP
+#define MTTOOLBOX_WBITS_HPP
+/**
+ * @file wbits.hpp
+ *
+ *\japanese
+ * @brief 固定長の長いビットベクトル型（128, 256, 512 ビット）
+ *
+ * アルゴリズムテンプレートの U として使用できる、出力が 64 ビットより
+ * 長い疑似乱数生成器のための型。util.hpp のテンプレート関数をすべて
+ * 特殊化している。ビット演算は AVX-512, AVX2, SSE2 が使えるときは
+ * それを使い、使えないときは 64 ビット整数で計算する。
+ *
+ * ビットの番号付けは符号なし整数と同じで、u64[0] の最下位ビットが
+ * 0 番目のビット（LSB）、u64[N/64 - 1] の最上位ビットが MSB である。
+ *\endjapanese
+ *
+ *\english
+ * @brief Fixed width long bit vector types (128, 256 and 512 bits)
+ *
+ * These types can be used as U of the algorithm templates for
+ * generators whose outputs are wider than 64 bits. All template
+ * functions in util.hpp are specialized. Bit operations use
+ * AVX-512, AVX2 or SSE2 when they are available, otherwise they
+ * are computed by 64-bit integers.
+ *
+ * Bits are numbered as unsigned integers; the least significant
+ * bit of u64[0] is bit 0 (LSB) and the most significant bit of
+ * u64[N/64 - 1] is the MSB.
+ *\endenglish
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <iostream>
+#include <iomanip>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <MTToolBox/util.hpp>
+#include <MTToolBox/bitops.hpp>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define MTTOOLBOX_WBITS_VECTOR_BYTES 64
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define MTTOOLBOX_WBITS_VECTOR_BYTES 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MTTOOLBOX_WBITS_VECTOR_BYTES 16
+#else
+#define MTTOOLBOX_WBITS_VECTOR_BYTES 8
+#endif
+
+namespace MTToolBox {
+    /**
+     * @class wbits
+     *\japanese
+     * @brief N ビットのビットベクトル
+     *
+     * 集成体なので、w128_t と同様に初期化子で初期化できる。
+     * @tparam N ビット長、128, 256, 512 のいずれか
+     *\endjapanese
+     *
+     *\english
+     * @brief bit vector of N bits
+     *
+     * This is an aggregate, and can be initialized by an initializer
+     * list like w128_t.
+     * @tparam N bit length, one of 128, 256 and 512
+     *\endenglish
+     */
+    template<int N>
+    union wbits {
+        uint32_t u[N / 32];
+        uint64_t u64[N / 64];
+    };
+
+    typedef wbits<128> wbits128_t;
+    typedef wbits<256> wbits256_t;
+    typedef wbits<512> wbits512_t;
+
+    /**
+     *\japanese
+     * ビット演算のカーネル。B バイトを一度に計算する。
+     * @tparam B 一度に計算するバイト数
+     *\endjapanese
+     *
+     *\english
+     * Kernel of bit operations, which computes B bytes at once.
+     * @tparam B number of bytes computed at once
+     *\endenglish
+     */
+    template<int B>
+    struct wbits_kernel {
+        typedef uint64_t vec;
+        enum { bytes = 8 };
+        static vec load(const void * p) {
+            vec v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        static void store(void * p, vec v) {
+            memcpy(p, &v, sizeof(v));
+        }
+        static vec bxor(vec a, vec b) { return a ^ b; }
+        static vec band(vec a, vec b) { return a & b; }
+        static vec bor(vec a, vec b) { return a | b; }
+        static vec bnot(vec a) { return ~a; }
+        static bool zero(vec a) { return a == 0; }
+    };
+
+#if MTTOOLBOX_WBITS_VECTOR_BYTES >= 16
+    template<>
+    struct wbits_kernel<16> {
+        typedef __m128i vec;
+        enum { bytes = 16 };
+        static vec load(const void * p) {
+            return _mm_loadu_si128(static_cast<const __m128i *>(p));
+        }
+        static void store(void * p, vec v) {
+            _mm_storeu_si128(static_cast<__m128i *>(p), v);
+        }
+        static vec bxor(vec a, vec b) { return _mm_xor_si128(a, b); }
+        static vec band(vec a, vec b) { return _mm_and_si128(a, b); }
+        static vec bor(vec a, vec b) { return _mm_or_si128(a, b); }
+        static vec bnot(vec a) {
+            return _mm_xor_si128(a, _mm_set1_epi32(-1));
+        }
+        static bool zero(vec a) {
+            vec z = _mm_cmpeq_epi8(a, _mm_setzero_si128());
+            return _mm_movemask_epi8(z) == 0xffff;
+        }
+    };
+#endif
+
+#if MTTOOLBOX_WBITS_VECTOR_BYTES >= 32
+    template<>
+    struct wbits_kernel<32> {
+        typedef __m256i vec;
+        enum { bytes = 32 };
+        static vec load(const void * p) {
+            return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+        }
+        static void store(void * p, vec v) {
+            _mm256_storeu_si256(static_cast<__m256i *>(p), v);
+        }
+        static vec bxor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+        static vec band(vec a, vec b) { return _mm256_and_si256(a, b); }
+        static vec bor(vec a, vec b) { return _mm256_or_si256(a, b); }
+        static vec bnot(vec a) {
+            return _mm256_xor_si256(a, _mm256_set1_epi32(-1));
+        }
+        static bool zero(vec a) { return _mm256_testz_si256(a, a) != 0; }
+    };
+#endif
+
+#if MTTOOLBOX_WBITS_VECTOR_BYTES >= 64
+    template<>
+    struct wbits_kernel<64> {
+        typedef __m512i vec;
+        enum { bytes = 64 };
+        static vec load(const void * p) {
+            return _mm512_loadu_si512(p);
+        }
+        static void store(void * p, vec v) {
+            _mm512_storeu_si512(p, v);
+        }
+        static vec bxor(vec a, vec b) { return _mm512_xor_si512(a, b); }
+        static vec band(vec a, vec b) { return _mm512_and_si512(a, b); }
+        static vec bor(vec a, vec b) { return _mm512_or_si512(a, b); }
+        static vec bnot(vec a) {
+            return _mm512_xor_si512(a, _mm512_set1_epi32(-1));
+        }
+        static bool zero(vec a) {
+            return _mm512_test_epi64_mask(a, a) == 0;
+        }
+    };
+#endif
+
+    /**
+     *\japanese
+     * wbits<N> に使うカーネルを選ぶ。ベクトル長が N より長いときは
+     * N ビットのカーネルを使う。
+     * @tparam N ビット長
+     *\endjapanese
+     *
+     *\english
+     * Selects the kernel for wbits<N>. When the vector length is
+     * longer than N, kernel of N bits is used.
+     * @tparam N bit length
+     *\endenglish
+     */
+    template<int N>
+    struct wbits_traits {
+        enum { bytes = (N / 8 < MTTOOLBOX_WBITS_VECTOR_BYTES)
+               ? N / 8 : MTTOOLBOX_WBITS_VECTOR_BYTES };
+        typedef wbits_kernel<bytes> kernel;
+    };
+
+    template<int N>
+    inline const wbits<N> operator^(const wbits<N>& x, const wbits<N>& y) {
+        typedef typename wbits_traits<N>::kernel K;
+        wbits<N> r;
+        for (int i = 0; i < N / 64; i += K::bytes / 8) {
+            K::store(&r.u64[i], K::bxor(K::load(&x.u64[i]),
+                                        K::load(&y.u64[i])));
+        }
+        return r;
+    }
+
+    template<int N>
+    inline const wbits<N> operator&(const wbits<N>& x, const wbits<N>& y) {
+        typedef typename wbits_traits<N>::kernel K;
+        wbits<N> r;
+        for (int i = 0; i < N / 64; i += K::bytes / 8) {
+            K::store(&r.u64[i], K::band(K::load(&x.u64[i]),
+                                        K::load(&y.u64[i])));
+        }
+        return r;
+    }
+
+    template<int N>
+    inline const wbits<N> operator|(const wbits<N>& x, const wbits<N>& y) {
+        typedef typename wbits_traits<N>::kernel K;
+        wbits<N> r;
+        for (int i = 0; i < N / 64; i += K::bytes / 8) {
+            K::store(&r.u64[i], K::bor(K::load(&x.u64[i]),
+                                       K::load(&y.u64[i])));
+        }
+        return r;
+    }
+
+    template<int N>
+    inline const wbits<N> operator~(const wbits<N>& x) {
+        typedef typename wbits_traits<N>::kernel K;
+        wbits<N> r;
+        for (int i = 0; i < N / 64; i += K::bytes / 8) {
+            K::store(&r.u64[i], K::bnot(K::load(&x.u64[i])));
+        }
+        return r;
+    }
+
+    template<int N>
+    inline wbits<N>& operator^=(wbits<N>& x, const wbits<N>& y) {
+        x = x ^ y;
+        return x;
+    }
+
+    template<int N>
+    inline wbits<N>& operator&=(wbits<N>& x, const wbits<N>& y) {
+        x = x & y;
+        return x;
+    }
+
+    template<int N>
+    inline wbits<N>& operator|=(wbits<N>& x, const wbits<N>& y) {
+        x = x | y;
+        return x;
+    }
+
+    /**
+     *\japanese
+     * 左シフト（上位方向へのシフト）。N 以上のシフトはゼロになる。
+     *\endjapanese
+     *
+     *\english
+     * Left shift (toward MSB). Shift of N or more makes zero.
+     *\endenglish
+     */
+    template<int N>
+    inline const wbits<N> operator<<(const wbits<N>& x, int s) {
+        wbits<N> r;
+        int q = s / 64;
+        int m = s % 64;
+        for (int i = N / 64 - 1; i >= 0; i--) {
+            uint64_t w = 0;
+            if (i - q >= 0) {
+                w = x.u64[i - q] << m;
+                if (m != 0 && i - q - 1 >= 0) {
+                    w |= x.u64[i - q - 1] >> (64 - m);
+                }
+            }
+            r.u64[i] = w;
+        }
+        return r;
+    }
+
+    /**
+     *\japanese
+     * 右シフト（下位方向へのシフト）。N 以上のシフトはゼロになる。
+     *\endjapanese
+     *
+     *\english
+     * Right shift (toward LSB). Shift of N or more makes zero.
+     *\endenglish
+     */
+    template<int N>
+    inline const wbits<N> operator>>(const wbits<N>& x, int s) {
+        wbits<N> r;
+        int q = s / 64;
+        int m = s % 64;
+        for (int i = 0; i < N / 64; i++) {
+            uint64_t w = 0;
+            if (i + q < N / 64) {
+                w = x.u64[i + q] >> m;
+                if (m != 0 && i + q + 1 < N / 64) {
+                    w |= x.u64[i + q + 1] << (64 - m);
+                }
+            }
+            r.u64[i] = w;
+        }
+        return r;
+    }
+
+    template<int N>
+    inline bool wbits_is_zero(const wbits<N>& x) {
+        typedef typename wbits_traits<N>::kernel K;
+        typename K::vec acc = K::load(&x.u64[0]);
+        for (int i = K::bytes / 8; i < N / 64; i += K::bytes / 8) {
+            acc = K::bor(acc, K::load(&x.u64[i]));
+        }
+        return K::zero(acc);
+    }
+
+    template<int N>
+    inline bool operator==(const wbits<N>& x, const wbits<N>& y) {
+        return wbits_is_zero(x ^ y);
+    }
+
+    template<int N>
+    inline bool operator!=(const wbits<N>& x, const wbits<N>& y) {
+        return !wbits_is_zero(x ^ y);
+    }
+
+    /**
+     *\japanese
+     * 上位の64ビットから順に十六進で出力する。64ビットごとに '.' で区切る。
+     *\endjapanese
+     *
+     *\english
+     * Outputs in hexadecimal from upper 64 bits. Every 64 bits are
+     * separated by '.'.
+     *\endenglish
+     */
+    template<int N>
+    inline std::ostream& operator<<(std::ostream& os, const wbits<N>& x) {
+        std::ios::fmtflags flags = os.flags();
+        char fill = os.fill();
+        os << std::hex << std::setfill('0');
+        for (int i = N / 64 - 1; i >= 0; i--) {
+            os << std::setw(16) << x.u64[i];
+            if (i > 0) {
+                os << ".";
+            }
+        }
+        os.flags(flags);
+        os.fill(fill);
+        return os;
+    }
+
+    /**
+     *\japanese
+     * 上位の n ビットが1で残りが0のビット列を返す。
+     * @param[in] n 1 の個数 0 \<= n \<= N
+     * @return 上位 n ビットのマスク
+     *\endjapanese
+     *
+     *\english
+     * Returns bit vector whose upper n bits are 1 and others are 0.
+     * @param[in] n number of 1s, 0 \<= n \<= N
+     * @return mask of upper n bits
+     *\endenglish
+     */
+    template<int N>
+    inline wbits<N> wbits_msb_mask(int n) {
+        wbits<N> r;
+        for (int i = 0; i < N / 64; i++) {
+            r.u64[i] = ~UINT64_C(0);
+        }
+        if (n <= 0) {
+            for (int i = 0; i < N / 64; i++) {
+                r.u64[i] = 0;
+            }
+            return r;
+        }
+        return r << (N - n);
+    }
+
+    /**
+     *\japanese
+     * \copydoc calc_1pos(uint16_t)
+     * @param[in] x 入力
+     * @return 最下位の1のあるビットの上位から数えた位置を返す。
+     *\endjapanese
+     *
+     *\english
+     * \copydoc calc_1pos(uint16_t)
+     * @param[in] x input
+     * @return the position of 1 which appears lowest (most right
+     * side) in \b x, where the position of MSB becomes zero.
+     *\endenglish
+     */
+    template<int N>
+    inline int calc_1pos(const wbits<N>& x)
+    {
+        for (int i = 0; i < N / 64; i++) {
+            if (x.u64[i] != 0) {
+                int p = calc_1pos(x.u64[i]);
+                return N - 64 * (i + 1) + p;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     *\japanese
+     * \copydoc count_bit(uint16_t)
+     * POPCNT 命令を使うようにコンパイルされていなければ、実行時に選ば
+     * れた実装 (bitops.hpp) を使う。
+     * @param[in] x ビットパターン
+     * @returns x の中の1の個数
+     *\endjapanese
+     *
+     *\english
+     * \copydoc count_bit(uint16_t)
+     * Unless compiled for POPCNT instruction, implementation selected
+     * at runtime (bitops.hpp) is used.
+     * @param[in] x bit pattern
+     * @return number of 1s in \b x.
+     *\endenglish
+     */
+    template<int N>
+    inline int count_bit(const wbits<N>& x) {
+#if defined(__POPCNT__)
+        int c = 0;
+        for (int i = 0; i < N / 64; i++) {
+            c += count_bit(x.u64[i]);
+        }
+        return c;
+#else
+        return count_bit_words(x.u64, N / 64);
+#endif
+    }
+
+    /**
+     *\japanese
+     * \copydoc reverse_bit(uint32_t)
+     * @param[in] x ビットパターン
+     * @returns x を反転したビットパターン
+     *\endjapanese
+     *
+     *\english
+     * \copydoc reverse_bit(uint32_t)
+     * @param[in] x bit pattern
+     * @return reverse of \b x
+     *\endenglish
+     */
+    template<int N>
+    inline wbits<N> reverse_bit(const wbits<N>& x) {
+        wbits<N> r;
+        for (int i = 0; i < N / 64; i++) {
+            r.u64[N / 64 - 1 - i] = reverse_bit(x.u64[i]);
+        }
+        return r;
+    }
+
+    /**
+     *\japanese
+     * \copydoc toGF2Vec
+     *\endjapanese
+     *
+     *\english
+     * \copydoc toGF2Vec
+     *\endenglish
+     */
+    template<int N>
+    inline static void toGF2Vec(NTL::vec_GF2& result, const wbits<N>& value) {
+        result.SetLength(N);
+        for (int i = 0; i < N; i++) {
+            int pos = N - 1 - i;
+            result.put(i, (value.u64[pos / 64] >> (pos % 64)) & 1);
+        }
+    }
+
+    template<int N>
+    inline wbits<N> wbits_from_uint64(uint64_t x) {
+        wbits<N> r;
+        r.u64[0] = x;
+        for (int i = 1; i < N / 64; i++) {
+            r.u64[i] = 0;
+        }
+        return r;
+    }
+
+/*
+ * util.hpp のテンプレート関数の特殊化。
+ * 関数テンプレートは部分特殊化できないので、ビット長ごとに特殊化する。
+ */
+#define MTTOOLBOX_WBITS_SPECIALIZE(N)                                   \
+    template<>                                                          \
+    inline wbits<N> getOne() {                                          \
+        return wbits_from_uint64<N>(1);                                 \
+    }                                                                   \
+                                                                        \
+    template<>                                                          \
+    inline void setZero(wbits<N>& x) {                                  \
+        for (int i = 0; i < N / 64; i++) {                              \
+            x.u64[i] = 0;                                               \
+        }                                                               \
+    }                                                                   \
+                                                                        \
+    template<>                                                          \
+    inline unsigned int getBitOfPos(wbits<N> bits, int pos) {           \
+        return static_cast<unsigned int>(                               \
+            (bits.u64[pos / 64] >> (pos % 64)) & 1);                    \
+    }                                                                   \
+                                                                        \
+    template<>                                                          \
+    inline void setBitOfPos(wbits<N> * bits, int pos, unsigned int b) { \
+        uint64_t mask = UINT64_C(1) << (pos % 64);                      \
+        bits->u64[pos / 64] &= ~mask;                                   \
+        if (b & 1) {                                                    \
+            bits->u64[pos / 64] |= mask;                                \
+        }                                                               \
+    }                                                                   \
+                                                                        \
+    template<>                                                          \
+    inline bool isZero(wbits<N> x) {                                    \
+        return wbits_is_zero(x);                                        \
+    }                                                                   \
+                                                                        \
+    template<>                                                          \
+    inline wbits<N> convert(uint32_t x) {                               \
+        return wbits_from_uint64<N>(x);                                 \
+    }                                                                   \
+                                                                        \
+    template<>                                                          \
+    inline wbits<N> convert(uint64_t x) {                               \
+        return wbits_from_uint64<N>(x);                                 \
+    }
+
+    MTTOOLBOX_WBITS_SPECIALIZE(128)
+    MTTOOLBOX_WBITS_SPECIALIZE(256)
+    MTTOOLBOX_WBITS_SPECIALIZE(512)
+
+#undef MTTOOLBOX_WBITS_SPECIALIZE
+}
+#endif // MTTOOLBOX_WBITS_HPP
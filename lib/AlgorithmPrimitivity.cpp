@@ -35,12 +35,10 @@ namespace MTToolBox {
         if (max_degree != deg(poly)) {
             return false;
         }
-        if (!IterIrredTest(poly)) {
-            return false;
-        }
         if (mersenne) {
-            return true;
+            return isIrreducible(poly);
         }
+        // isPrime が既約判定もする
         if (isPrime(poly, max_degree, *primes)) {
             return true;
         } else {
@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <sstream>
+#include <stdexcept>
+#include <MTToolBox/AnalysisCache.hpp>
+#include <MTToolBox/FileLock.hpp>
+#include <MTToolBox/Parallel.hpp>
+#include <MTToolBox/polyio.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+    using namespace NTL;
+
+    /*
+     * 記録ファイルの形式
+     * 先頭の 8 バイトは magic、続いてキーの長さとキー、その後に
+     * タグ (4 バイト)、長さ (8 バイト)、内容からなる項目が並ぶ。
+     * 数値はすべてリトルエンディアン。知らないタグは読み飛ばす。
+     */
+    /*
+     * fcntl のロックは同じプロセスのスレッドを排他制御しない。また
+     * ロック用のファイルをどれかの記述子で閉じるとプロセスのロックが
+     * すべて外れるので、オブジェクトごとではなくプロセスでひとつの
+     * Mutex を使う。
+     */
+    static Mutex cache_mutex;
+
+    static const char magic[8] = {'M', 'T', 'T', 'B', 'A', 'C', '0', '1'};
+    static const char tag_minpoly[4] = {'M', 'P', 'O', 'L'};
+    static const char tag_factor[4] = {'F', 'A', 'C', 'T'};
+    static const char tag_parity[4] = {'P', 'R', 'T', 'Y'};
+    static const char tag_veq[4] = {'V', 'E', 'Q', '_'};
+
+    static void put_u64(string& buf, uint64_t x) {
+        for (int i = 0; i < 8; i++) {
+            buf += static_cast<char>((x >> (8 * i)) & 0xff);
+        }
+    }
+
+    static void put_tag(string& buf, const char tag[4], uint64_t length) {
+        buf.append(tag, 4);
+        put_u64(buf, length);
+    }
+
+    static void put_poly(string& buf, const char tag[4], const GF2X& poly) {
+        if (deg(poly) < 0) {
+            return;
+        }
+        stringstream ss;
+        write_poly(ss, poly);
+        string s = ss.str();
+        put_tag(buf, tag, s.size());
+        buf += s;
+    }
+
+    static const string serialize(const string& key,
+                                  const AnalysisRecord& record) {
+        string buf(magic, 8);
+        put_u64(buf, key.size());
+        buf += key;
+        put_poly(buf, tag_minpoly, record.minpoly);
+        put_poly(buf, tag_factor, record.factor);
+        if (!record.parity.empty()) {
+            put_tag(buf, tag_parity, record.parity.size() * 8);
+            for (size_t i = 0; i < record.parity.size(); i++) {
+                put_u64(buf, record.parity[i]);
+            }
+        }
+        map<string, vector<int> >::const_iterator it;
+        for (it = record.veq.begin(); it != record.veq.end(); ++it) {
+            const vector<int>& v = it->second;
+            put_tag(buf, tag_veq, 16 + it->first.size() + v.size() * 8);
+            put_u64(buf, it->first.size());
+            buf += it->first;
+            put_u64(buf, v.size());
+            for (size_t i = 0; i < v.size(); i++) {
+                int64_t x = v[i];
+                put_u64(buf, static_cast<uint64_t>(x));
+            }
+        }
+        return buf;
+    }
+
+    /*
+     * マップしたメモリから読む。範囲外を読もうとしたら失敗にする。
+     */
+    class Reader {
+    public:
+        Reader(const unsigned char * p, size_t size) {
+            this->p = p;
+            this->size = size;
+            pos = 0;
+        }
+        bool getU64(uint64_t& x) {
+            if (size - pos < 8) {
+                return false;
+            }
+            x = 0;
+            for (int i = 0; i < 8; i++) {
+                x |= static_cast<uint64_t>(p[pos + i]) << (8 * i);
+            }
+            pos += 8;
+            return true;
+        }
+        bool getBytes(const unsigned char *& q, uint64_t length) {
+            if (size - pos < length) {
+                return false;
+            }
+            q = p + pos;
+            pos += length;
+            return true;
+        }
+        bool getString(string& s) {
+            uint64_t length;
+            const unsigned char * q;
+            if (!getU64(length) || !getBytes(q, length)) {
+                return false;
+            }
+            s.assign(reinterpret_cast<const char *>(q), length);
+            return true;
+        }
+        bool getPoly(GF2X& poly) {
+            uint64_t d;
+            if (!getU64(d)) {
+                return false;
+            }
+            int64_t degree = static_cast<int64_t>(d);
+            if (degree < 0) {
+                return false;
+            }
+            uint64_t count = d / 64 + 1;
+            if ((size - pos) / 8 < count) {
+                return false;
+            }
+            vector<uint64_t> words(count);
+            for (size_t i = 0; i < count; i++) {
+                getU64(words[i]);
+            }
+            words_to_poly(poly, words);
+            return deg(poly) == degree;
+        }
+        bool atEnd() const {
+            return pos == size;
+        }
+    private:
+        const unsigned char * p;
+        size_t size;
+        size_t pos;
+    };
+
+    static bool parse_item(Reader& reader, const char * tag,
+                           AnalysisRecord& record) {
+        if (memcmp(tag, tag_minpoly, 4) == 0) {
+            return reader.getPoly(record.minpoly) && reader.atEnd();
+        }
+        if (memcmp(tag, tag_factor, 4) == 0) {
+            return reader.getPoly(record.factor) && reader.atEnd();
+        }
+        if (memcmp(tag, tag_parity, 4) == 0) {
+            record.parity.clear();
+            uint64_t x;
+            while (!reader.atEnd()) {
+                if (!reader.getU64(x)) {
+                    return false;
+                }
+                record.parity.push_back(x);
+            }
+            return true;
+        }
+        if (memcmp(tag, tag_veq, 4) == 0) {
+            string name;
+            uint64_t count;
+            if (!reader.getString(name) || !reader.getU64(count)) {
+                return false;
+            }
+            vector<int> v;
+            for (uint64_t i = 0; i < count; i++) {
+                uint64_t x;
+                if (!reader.getU64(x)) {
+                    return false;
+                }
+                v.push_back(static_cast<int>(static_cast<int64_t>(x)));
+            }
+            record.veq[name] = v;
+            return reader.atEnd();
+        }
+        return true;
+    }
+
+    static bool parse(const unsigned char * p, size_t size,
+                      string& key, AnalysisRecord& record) {
+        Reader reader(p, size);
+        const unsigned char * q;
+        if (!reader.getBytes(q, 8) || memcmp(q, magic, 8) != 0) {
+            return false;
+        }
+        if (!reader.getString(key)) {
+            return false;
+        }
+        while (!reader.atEnd()) {
+            const unsigned char * tag;
+            uint64_t length;
+            const unsigned char * body;
+            if (!reader.getBytes(tag, 4) || !reader.getU64(length)
+                || !reader.getBytes(body, length)) {
+                return false;
+            }
+            Reader item(body, length);
+            if (!parse_item(item, reinterpret_cast<const char *>(tag),
+                            record)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * キーのハッシュ値 (MurmurHash64A)
+     */
+    static uint64_t hash_key(const string& key) {
+        const uint64_t m = UINT64_C(0xc6a4a7935bd1e995);
+        const int r = 47;
+        uint64_t h = UINT64_C(0x3c6ef372fe94f82b) ^ (key.size() * m);
+        size_t n = key.size() / 8;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t k = 0;
+            for (int j = 0; j < 8; j++) {
+                k |= static_cast<uint64_t>(
+                    static_cast<unsigned char>(key[i * 8 + j])) << (8 * j);
+            }
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+        size_t rest = key.size() % 8;
+        if (rest > 0) {
+            uint64_t k = 0;
+            for (size_t j = 0; j < rest; j++) {
+                k |= static_cast<uint64_t>(
+                    static_cast<unsigned char>(key[n * 8 + j])) << (8 * j);
+            }
+            h ^= k;
+            h *= m;
+        }
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+
+    static void make_dir(const string& path) {
+        if (mkdir(path.c_str(), 0777) != 0 && errno != EEXIST) {
+            throw runtime_error("can't make directory " + path);
+        }
+    }
+
+    AnalysisCache::AnalysisCache(const string& dir) {
+        this->dir = dir;
+        make_dir(dir);
+    }
+
+    const string AnalysisCache::makeKey(const string& type,
+                                        const string& param) {
+        return type + "\n" + param;
+    }
+
+    const string AnalysisCache::slotPath(uint64_t hash, int slot) const {
+        char name[64];
+        snprintf(name, sizeof(name), "/%02x/%016llx-%d",
+                 static_cast<unsigned int>(hash >> 56),
+                 static_cast<unsigned long long>(hash), slot);
+        return dir + name;
+    }
+
+    /*
+     * 記録ファイルをメモリにマップして読む。
+     * ファイルがなければ -1、読めなければ 0、読めたら 1 を返す。
+     * 読めないファイルは使わないが、スロットは埋まっているとみなす。
+     */
+    int AnalysisCache::read(const string& path, string& key,
+                            AnalysisRecord& record) const {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return -1;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            close(fd);
+            return 0;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void * p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+            return 0;
+        }
+        AnalysisRecord work;
+        bool ok = parse(static_cast<const unsigned char *>(p), size,
+                        key, work);
+        munmap(p, size);
+        if (!ok) {
+            return 0;
+        }
+        record = work;
+        return 1;
+    }
+
+    bool AnalysisCache::lookup(const string& key,
+                               AnalysisRecord& record) const {
+        ScopedLock guard(cache_mutex);
+        uint64_t hash = hash_key(key);
+        for (int slot = 0;; slot++) {
+            string found;
+            AnalysisRecord work;
+            int r = read(slotPath(hash, slot), found, work);
+            if (r < 0) {
+                return false;
+            }
+            if (r > 0 && found == key) {
+                record = work;
+                return true;
+            }
+        }
+    }
+
+    void AnalysisCache::store(const string& key,
+                              const AnalysisRecord& record) {
+        ScopedLock guard(cache_mutex);
+        uint64_t hash = hash_key(key);
+        string sub = slotPath(hash, 0);
+        make_dir(sub.substr(0, sub.rfind('/')));
+        int fd = FileLock::open(dir + "/lock");
+        try {
+            FileLock lock(fd);
+            AnalysisRecord merged;
+            int slot;
+            for (slot = 0;; slot++) {
+                string found;
+                AnalysisRecord work;
+                int r = read(slotPath(hash, slot), found, work);
+                if (r < 0) {
+                    break;
+                }
+                if (r > 0 && found == key) {
+                    merged = work;
+                    break;
+                }
+            }
+            if (deg(record.minpoly) >= 0) {
+                merged.minpoly = record.minpoly;
+            }
+            if (deg(record.factor) >= 0) {
+                merged.factor = record.factor;
+            }
+            if (!record.parity.empty()) {
+                merged.parity = record.parity;
+            }
+            map<string, vector<int> >::const_iterator it;
+            for (it = record.veq.begin(); it != record.veq.end(); ++it) {
+                merged.veq[it->first] = it->second;
+            }
+            string buf = serialize(key, merged);
+            string tmp = dir + "/tmp.XXXXXX";
+            vector<char> name(tmp.begin(), tmp.end());
+            name.push_back('\0');
+            int tmp_fd = mkstemp(&name[0]);
+            if (tmp_fd < 0) {
+                throw runtime_error("can't write " + tmp);
+            }
+            tmp = &name[0];
+            // mkstemp は所有者だけが読めるファイルを作る
+            fchmod(tmp_fd, 0644);
+            FILE * fp = fdopen(tmp_fd, "wb");
+            if (fp == NULL) {
+                close(tmp_fd);
+                unlink(tmp.c_str());
+                throw runtime_error("can't write " + tmp);
+            }
+            size_t written = fwrite(buf.data(), 1, buf.size(), fp);
+            if (fclose(fp) != 0 || written != buf.size()
+                || rename(tmp.c_str(), slotPath(hash, slot).c_str()) != 0) {
+                unlink(tmp.c_str());
+                throw runtime_error("can't write cache in " + dir);
+            }
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+    }
+}
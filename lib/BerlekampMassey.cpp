@@ -0,0 +1,207 @@
+#include <stdexcept>
+#include <MTToolBox/BerlekampMassey.hpp>
+#include <MTToolBox/polyio.hpp>
+#include <MTToolBox/Parallel.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+    using namespace NTL;
+
+    /*
+     * 数列は逆順に詰める。n 項目は maxLength - 1 - n ビット目に置くので、
+     * s[n], s[n-1], ..., s[n-L] が連続したビットになり、接続多項式の
+     * 係数とワード単位で内積をとれる。
+     */
+    BerlekampMassey::BerlekampMassey(long maxLength)
+    {
+        if (maxLength <= 0) {
+            throw invalid_argument("maxLength should be positive");
+        }
+        this->maxLength = maxLength;
+        count = 0;
+        complexity = 0;
+        prevComplexity = 0;
+        shift = 1;
+        size_t words = static_cast<size_t>(maxLength / 64 + 2);
+        sequence.resize(words, 0);
+        connection.resize(words, 0);
+        previous.resize(words, 0);
+        work.resize(words, 0);
+        connection[0] = 1;
+        previous[0] = 1;
+    }
+
+    /*
+     * 不一致 d = sum_{j=0}^{L} C_j s[n-j]
+     */
+    uint64_t BerlekampMassey::discrepancy() const
+    {
+        long p = maxLength - 1 - count;
+        long top = complexity / 64;
+        uint64_t acc = 0;
+        for (long w = 0; w <= top; w++) {
+            long q = p + 64 * w;
+            size_t i = static_cast<size_t>(q >> 6);
+            int b = static_cast<int>(q & 63);
+            uint64_t s = sequence[i] >> b;
+            if (b != 0) {
+                s |= sequence[i + 1] << (64 - b);
+            }
+            acc ^= connection[static_cast<size_t>(w)] & s;
+        }
+        return static_cast<uint64_t>(count_bit(acc) & 1);
+    }
+
+    /*
+     * dst += src * x^s
+     */
+    void BerlekampMassey::addShifted(vector<uint64_t>& dst,
+                                     const vector<uint64_t>& src,
+                                     long srcDegree, long s)
+    {
+        size_t ws = static_cast<size_t>(s >> 6);
+        int bs = static_cast<int>(s & 63);
+        size_t top = static_cast<size_t>(srcDegree / 64);
+        if (bs == 0) {
+            for (size_t k = 0; k <= top; k++) {
+                dst[k + ws] ^= src[k];
+            }
+        } else {
+            for (size_t k = 0; k <= top; k++) {
+                dst[k + ws] ^= src[k] << bs;
+                dst[k + ws + 1] ^= src[k] >> (64 - bs);
+            }
+        }
+    }
+
+    void BerlekampMassey::push(int bit)
+    {
+        if (count >= maxLength) {
+            throw length_error("sequence is longer than maxLength");
+        }
+        if (bit & 1) {
+            long p = maxLength - 1 - count;
+            sequence[static_cast<size_t>(p >> 6)]
+                |= UINT64_C(1) << (p & 63);
+        }
+        if (discrepancy() == 0) {
+            shift++;
+        } else if (2 * complexity <= count) {
+            // work に入っている多項式の次数は complexity 以下なので、
+            // complexity までのワードを写せば十分
+            size_t top = static_cast<size_t>(complexity / 64);
+            for (size_t k = 0; k <= top; k++) {
+                work[k] = connection[k];
+            }
+            addShifted(connection, previous, prevComplexity, shift);
+            prevComplexity = complexity;
+            complexity = count + 1 - complexity;
+            previous.swap(work);
+            shift = 1;
+        } else {
+            addShifted(connection, previous, prevComplexity, shift);
+            shift++;
+        }
+        count++;
+    }
+
+    /*
+     * 最小多項式は接続多項式 C の相反多項式 x^L C(1/x)
+     */
+    void BerlekampMassey::getMinPoly(GF2X& poly) const
+    {
+        vector<uint64_t> words(static_cast<size_t>(complexity / 64 + 1), 0);
+        for (long j = 0; j <= complexity; j++) {
+            uint64_t c = connection[static_cast<size_t>(j >> 6)] >> (j & 63);
+            if (c & 1) {
+                long k = complexity - j;
+                words[static_cast<size_t>(k >> 6)]
+                    |= UINT64_C(1) << (k & 63);
+            }
+        }
+        words_to_poly(poly, words);
+    }
+
+    namespace {
+        /*
+         * first 番目から count 個の数列の最小多項式を、スレッドごとに
+         * 番号を取り合って求める。
+         */
+        class MinPolyJob : public Runnable {
+        public:
+            MinPolyJob(const vector<vector<uint64_t> >& sequences,
+                       long length, size_t first, size_t count)
+                : sequences(sequences), results(count) {
+                this->length = length;
+                this->first = first;
+                next = 0;
+            }
+
+            void run(int) {
+                for (;;) {
+                    size_t i;
+                    {
+                        ScopedLock lock(mutex);
+                        i = next++;
+                    }
+                    if (i >= results.size()) {
+                        return;
+                    }
+                    const vector<uint64_t>& s = sequences[first + i];
+                    BerlekampMassey bm(length);
+                    for (long j = 0; j < length; j++) {
+                        bm.push(static_cast<int>(
+                                    (s[static_cast<size_t>(j / 64)]
+                                     >> (j % 64)) & 1));
+                    }
+                    bm.getMinPoly(results[i]);
+                }
+            }
+
+            const vector<GF2X>& getResults() const {
+                return results;
+            }
+        private:
+            const vector<vector<uint64_t> >& sequences;
+            long length;
+            size_t first;
+            size_t next;
+            Mutex mutex;
+            vector<GF2X> results;
+        };
+    }
+
+    void lcm_minpoly_sequences(GF2X& lcm,
+                               const vector<vector<uint64_t> >& sequences,
+                               long length, long degree, int threads)
+    {
+        if (threads < 1) {
+            threads = 1;
+        }
+        if (IsZero(lcm)) {
+            NTL::set(lcm);
+        }
+        size_t batch = static_cast<size_t>(threads);
+        for (size_t first = 0; first < sequences.size(); first += batch) {
+            if (deg(lcm) >= degree) {
+                return;
+            }
+            size_t count = sequences.size() - first;
+            if (count > batch) {
+                count = batch;
+            }
+            MinPolyJob job(sequences, length, first, count);
+            if (count == 1) {
+                job.run(0);
+            } else {
+                WorkerPool pool;
+                pool.start(job, static_cast<int>(count));
+                pool.join();
+            }
+            const vector<GF2X>& results = job.getResults();
+            for (size_t i = 0; i < results.size(); i++) {
+                LCM(lcm, lcm, results[i]);
+            }
+        }
+    }
+}
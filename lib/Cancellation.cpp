@@ -0,0 +1,36 @@
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <MTToolBox/Cancellation.hpp>
+
+namespace MTToolBox {
+    static volatile sig_atomic_t signal_received = 0;
+
+    static void on_signal(int) {
+        signal_received = 1;
+    }
+
+    /*
+     * SA_RESTART をつけて、出力中の write などが失敗しないようにする。
+     */
+    void CancellationToken::handleSignals() {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = on_signal;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        sigaction(SIGTERM, &sa, NULL);
+        sigaction(SIGINT, &sa, NULL);
+    }
+
+    bool CancellationToken::signalled() {
+        return signal_received != 0;
+    }
+
+    double CancellationToken::now() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<double>(ts.tv_sec)
+            + static_cast<double>(ts.tv_nsec) * 1.0e-9;
+    }
+}
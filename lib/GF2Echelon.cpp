@@ -0,0 +1,59 @@
+#include <MTToolBox/GF2Echelon.hpp>
+#include <MTToolBox/util.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+
+    GF2Echelon::GF2Echelon(int cols)
+    {
+        words = (cols + 63) / 64;
+        count = 0;
+        basis.resize(static_cast<size_t>(cols) * static_cast<size_t>(words));
+        pivot.assign(static_cast<size_t>(cols), -1);
+        work.resize(static_cast<size_t>(words));
+    }
+
+    /*
+     * 最下位の 1 の位置に基底があればそれを足して消す。基底のその位置
+     * より下位のワードは 0 なので、そのワードから先だけを足せばよい。
+     */
+    bool GF2Echelon::add(const uint64_t * v)
+    {
+        for (int k = 0; k < words; k++) {
+            work[static_cast<size_t>(k)] = v[k];
+        }
+        int start = 0;
+        for (;;) {
+            while (start < words && work[static_cast<size_t>(start)] == 0) {
+                start++;
+            }
+            if (start == words) {
+                return false;
+            }
+            uint64_t x = work[static_cast<size_t>(start)];
+            int low = start * 64 + count_bit((x & (~x + 1)) - 1);
+            int index = pivot[static_cast<size_t>(low)];
+            if (index < 0) {
+                uint64_t * p = &basis[static_cast<size_t>(count)
+                                      * static_cast<size_t>(words)];
+                for (int k = 0; k < words; k++) {
+                    p[k] = work[static_cast<size_t>(k)];
+                }
+                pivot[static_cast<size_t>(low)] = count;
+                count++;
+                return true;
+            }
+            const uint64_t * p = &basis[static_cast<size_t>(index)
+                                       * static_cast<size_t>(words)];
+            for (int k = start; k < words; k++) {
+                work[static_cast<size_t>(k)] ^= p[k];
+            }
+        }
+    }
+
+    void GF2Echelon::clear()
+    {
+        count = 0;
+        pivot.assign(pivot.size(), -1);
+    }
+}
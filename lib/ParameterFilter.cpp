@@ -0,0 +1,229 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <MTToolBox/ParameterFilter.hpp>
+#include <MTToolBox/FileLock.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+
+    /*
+     * ブルームフィルタのファイルの形式
+     * 先頭の 32 バイトは magic、ビット数、ハッシュ関数の数、予備で、
+     * その後にビット配列が 64 ビットのワード単位で並ぶ。
+     * ファイルをそのままマップするので、数値はホストのバイト順。
+     */
+    static const char bloom_magic[8] = {'M', 'T', 'T', 'B',
+                                        'B', 'L', 'M', '1'};
+    static const size_t bloom_header = 32;
+
+    static uint64_t mix64(uint64_t x) {
+        x ^= x >> 30;
+        x *= UINT64_C(0xbf58476d1ce4e5b9);
+        x ^= x >> 27;
+        x *= UINT64_C(0x94d049bb133111eb);
+        x ^= x >> 31;
+        return x;
+    }
+
+    /*
+     * FNV-1a のハッシュ値をかき混ぜて二つのハッシュ値を作り、
+     * i 番目のハッシュ関数は h1 + i * h2 とする。
+     */
+    static void hash_pair(const string& key, uint64_t& h1, uint64_t& h2) {
+        uint64_t h = UINT64_C(0xcbf29ce484222325);
+        for (size_t i = 0; i < key.size(); i++) {
+            h ^= static_cast<unsigned char>(key[i]);
+            h *= UINT64_C(0x100000001b3);
+        }
+        h1 = mix64(h);
+        h2 = mix64(h ^ UINT64_C(0x9e3779b97f4a7c15)) | 1;
+    }
+
+    static bool read_all(int fd, void * buf, size_t size, off_t offset) {
+        return pread(fd, buf, size, offset) == static_cast<ssize_t>(size);
+    }
+
+    BloomParameterFilter::BloomParameterFilter(const string& path,
+                                               uint64_t bits, int hashes) {
+        if (bits == 0 || hashes <= 0) {
+            throw invalid_argument("bits and hashes should be positive");
+        }
+        this->bits = (bits + 63) / 64 * 64;
+        this->hashes = hashes;
+        fd = -1;
+        if (path.empty()) {
+            mapSize = bloom_header + this->bits / 8;
+            map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (map == MAP_FAILED) {
+                throw runtime_error("can't allocate bloom filter");
+            }
+            words = reinterpret_cast<uint64_t *>(
+                static_cast<char *>(map) + bloom_header);
+            return;
+        }
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0666);
+        if (fd < 0) {
+            throw runtime_error("can't open " + path);
+        }
+        try {
+            // 作るときと読むときは、他のプロセスと排他する
+            FileLock lock(fd);
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                throw runtime_error("can't stat " + path);
+            }
+            uint64_t header[4];
+            if (st.st_size == 0) {
+                memcpy(&header[0], bloom_magic, 8);
+                header[1] = this->bits;
+                header[2] = static_cast<uint64_t>(hashes);
+                header[3] = 0;
+                mapSize = bloom_header + this->bits / 8;
+                if (pwrite(fd, header, sizeof(header), 0)
+                    != static_cast<ssize_t>(sizeof(header))
+                    || ftruncate(fd, static_cast<off_t>(mapSize)) != 0) {
+                    throw runtime_error("can't write " + path);
+                }
+            } else {
+                if (!read_all(fd, header, sizeof(header), 0)
+                    || memcmp(&header[0], bloom_magic, 8) != 0
+                    || header[1] == 0 || header[1] % 64 != 0
+                    || header[2] == 0 || header[2] > 64) {
+                    throw runtime_error("not a bloom filter file: " + path);
+                }
+                this->bits = header[1];
+                this->hashes = static_cast<int>(header[2]);
+                mapSize = bloom_header + this->bits / 8;
+                if (static_cast<uint64_t>(st.st_size) != mapSize) {
+                    throw runtime_error("broken bloom filter file: " + path);
+                }
+            }
+            map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       fd, 0);
+            if (map == MAP_FAILED) {
+                throw runtime_error("can't map " + path);
+            }
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        words = reinterpret_cast<uint64_t *>(
+            static_cast<char *>(map) + bloom_header);
+    }
+
+    BloomParameterFilter::~BloomParameterFilter() {
+        munmap(map, mapSize);
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool BloomParameterFilter::contains(const string& key) {
+        uint64_t h1;
+        uint64_t h2;
+        hash_pair(key, h1, h2);
+        for (int i = 0; i < hashes; i++) {
+            uint64_t idx = (h1 + static_cast<uint64_t>(i) * h2) % bits;
+            if (((words[idx >> 6] >> (idx & 63)) & 1) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * 他のスレッドやプロセスが同じワードに書くことがあるので、
+     * 不可分な or で立てる。
+     */
+    void BloomParameterFilter::add(const string& key) {
+        uint64_t h1;
+        uint64_t h2;
+        hash_pair(key, h1, h2);
+        for (int i = 0; i < hashes; i++) {
+            uint64_t idx = (h1 + static_cast<uint64_t>(i) * h2) % bits;
+            __sync_fetch_and_or(&words[idx >> 6],
+                                UINT64_C(1) << (idx & 63));
+        }
+    }
+
+    /*
+     * 集合のファイルの形式
+     * 一行にひとつ、キーの長さ (10 進)、空白、キー、改行を書く。
+     * キーに改行が含まれていてもよい。書きかけで終わった最後の記録は
+     * 無視する。
+     */
+    ExactParameterFilter::ExactParameterFilter(const string& path) {
+        fd = -1;
+        if (path.empty()) {
+            return;
+        }
+        ifstream ifs(path.c_str(), ios::binary);
+        if (ifs) {
+            for (;;) {
+                size_t length;
+                if (!(ifs >> length)) {
+                    if (ifs.eof()) {
+                        break;
+                    }
+                    throw runtime_error("wrong format: " + path);
+                }
+                string key(length, '\0');
+                if (ifs.get() != ' '
+                    || !ifs.read(&key[0], static_cast<streamsize>(length))
+                    || ifs.get() != '\n') {
+                    break;
+                }
+                keys.insert(key);
+            }
+        }
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0666);
+        if (fd < 0) {
+            throw runtime_error("can't open " + path);
+        }
+    }
+
+    ExactParameterFilter::~ExactParameterFilter() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    size_t ExactParameterFilter::size() {
+        ScopedLock lock(mutex);
+        return keys.size();
+    }
+
+    bool ExactParameterFilter::contains(const string& key) {
+        ScopedLock lock(mutex);
+        return keys.find(key) != keys.end();
+    }
+
+    /*
+     * 一回の write で追記するので、複数のプロセスが同じファイルに
+     * 追記しても記録が混ざらない。
+     */
+    void ExactParameterFilter::add(const string& key) {
+        ScopedLock lock(mutex);
+        if (!keys.insert(key).second || fd < 0) {
+            return;
+        }
+        stringstream ss;
+        ss << dec << key.size() << ' ' << key << '\n';
+        string line = ss.str();
+        ssize_t r;
+        do {
+            r = write(fd, line.data(), line.size());
+        } while (r < 0 && errno == EINTR);
+        if (r != static_cast<ssize_t>(line.size())) {
+            throw runtime_error("can't write rejected parameter");
+        }
+    }
+}
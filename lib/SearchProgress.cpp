@@ -0,0 +1,297 @@
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <MTToolBox/SearchProgress.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+
+    /*
+     * 標準正規分布の q 分位点を erfc の二分法で求める。
+     * 呼ばれるのは report() などだけなので、速さは問わない。
+     */
+    static double normal_quantile(double q) {
+        double low = -10;
+        double high = 10;
+        for (int i = 0; i < 100; i++) {
+            double mid = (low + high) / 2;
+            if (0.5 * erfc(-mid / sqrt(2.0)) < q) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        return (low + high) / 2;
+    }
+
+    /*
+     * 形状 k、尺度 1 のガンマ分布の q 分位点
+     * k = 1 は指数分布なので正確に求め、それ以外は Wilson-Hilferty の
+     * 近似を使う。
+     */
+    static double gamma_quantile(long k, double q) {
+        if (k == 1) {
+            return -log(1 - q);
+        }
+        double kk = static_cast<double>(k);
+        double t = 1 - 1 / (9 * kk) + normal_quantile(q) / (3 * sqrt(kk));
+        if (t < 0) {
+            return 0;
+        }
+        return kk * t * t * t;
+    }
+
+    SearchProgress::SearchProgress(double probability, long target) {
+        if (!(probability > 0 && probability <= 1)) {
+            throw invalid_argument("probability should be in (0, 1]");
+        }
+        prior = probability;
+        this->target = target;
+        start = now();
+        candidates = 0;
+        found = 0;
+        post = 0;
+        candidateSeconds = 0;
+        postSeconds = 0;
+        out = NULL;
+        interval = 0;
+        lastReport = start;
+    }
+
+    /*
+     * 2^degree - 1 の相異なる素因数 q について (1 - 1/q) をかけると
+     * φ(2^degree - 1) / (2^degree - 1) になる。大きな素因数は double に
+     * 丸めても 1/q は十分正確である。
+     */
+    double SearchProgress::primitiveProbability(int degree,
+                                                const char * prime_factors[]) {
+        if (degree <= 0) {
+            throw invalid_argument("degree should be positive");
+        }
+        double ratio;
+        if (prime_factors == NULL) {
+            ratio = 1 - ldexp(1.0, 1 - degree);
+        } else {
+            ratio = 1;
+            for (int i = 0; prime_factors[i] != NULL; i++) {
+                ratio *= 1 - 1 / strtod(prime_factors[i], NULL);
+            }
+        }
+        return ratio / degree;
+    }
+
+    double SearchProgress::now() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<double>(ts.tv_sec)
+            + static_cast<double>(ts.tv_nsec) * 1.0e-9;
+    }
+
+    void SearchProgress::setTarget(long target) {
+        ScopedLock lock(mutex);
+        this->target = target;
+    }
+
+    void SearchProgress::setReport(std::ostream * os, double interval) {
+        ScopedLock lock(mutex);
+        out = os;
+        this->interval = interval;
+    }
+
+    /*
+     * report() もロックを取るので、出力するかどうかだけをロックの
+     * 中で決める。
+     */
+    void SearchProgress::addCandidate(double seconds, bool found) {
+        bool output = false;
+        {
+            ScopedLock lock(mutex);
+            candidates++;
+            candidateSeconds += seconds;
+            if (found) {
+                this->found++;
+            }
+            if (out != NULL) {
+                double t = now();
+                if (t - lastReport >= interval) {
+                    lastReport = t;
+                    output = true;
+                }
+            }
+        }
+        if (output) {
+            report(*out);
+        }
+    }
+
+    void SearchProgress::addPostProcess(double seconds) {
+        ScopedLock lock(mutex);
+        post++;
+        postSeconds += seconds;
+    }
+
+    long SearchProgress::getCandidates() const {
+        ScopedLock lock(mutex);
+        return candidates;
+    }
+
+    long SearchProgress::getFound() const {
+        ScopedLock lock(mutex);
+        return found;
+    }
+
+    double SearchProgress::getElapsed() const {
+        return now() - start;
+    }
+
+    double SearchProgress::getRate() const {
+        snapshot s;
+        take(s);
+        if (s.elapsed <= 0) {
+            return 0;
+        }
+        return static_cast<double>(s.candidates) / s.elapsed;
+    }
+
+    double SearchProgress::getProbability() const {
+        snapshot s;
+        take(s);
+        return probability(s);
+    }
+
+    double SearchProgress::getCandidateCost() const {
+        snapshot s;
+        take(s);
+        if (s.candidates == 0) {
+            return 0;
+        }
+        return s.candidateSeconds / static_cast<double>(s.candidates);
+    }
+
+    double SearchProgress::getPostProcessCost() const {
+        snapshot s;
+        take(s);
+        if (s.post == 0) {
+            return 0;
+        }
+        return s.postSeconds / static_cast<double>(s.post);
+    }
+
+    double SearchProgress::getRemaining() const {
+        snapshot s;
+        take(s);
+        if (s.found >= s.target) {
+            return 0;
+        }
+        if (s.candidates == 0) {
+            return -1;
+        }
+        double search;
+        double postCost;
+        costs(s, search, postCost);
+        return static_cast<double>(s.target - s.found)
+            * (search + postCost) / parallelism(s);
+    }
+
+    /*
+     * 残り k 個を見つけるまでに試す候補の数に成功確率をかけたものは、
+     * 成功確率が小さければ形状 k のガンマ分布に近い。後処理の時間は
+     * k 個分で一定とみなす。
+     */
+    void SearchProgress::getInterval(double confidence, double& low,
+                                     double& high) const {
+        if (!(confidence > 0 && confidence < 1)) {
+            throw invalid_argument("confidence should be in (0, 1)");
+        }
+        snapshot s;
+        take(s);
+        if (s.found >= s.target) {
+            low = 0;
+            high = 0;
+            return;
+        }
+        if (s.candidates == 0) {
+            low = -1;
+            high = -1;
+            return;
+        }
+        long k = s.target - s.found;
+        double search;
+        double postCost;
+        costs(s, search, postCost);
+        double parallel = parallelism(s);
+        double alpha = (1 - confidence) / 2;
+        double postTotal = static_cast<double>(k) * postCost;
+        low = (search * gamma_quantile(k, alpha) + postTotal) / parallel;
+        high = (search * gamma_quantile(k, 1 - alpha) + postTotal)
+            / parallel;
+    }
+
+    void SearchProgress::report(std::ostream& os) const {
+        snapshot s;
+        take(s);
+        double rate = 0;
+        if (s.elapsed > 0) {
+            rate = static_cast<double>(s.candidates) / s.elapsed;
+        }
+        stringstream ss;
+        ss << "progress: " << dec << s.candidates << " candidates, "
+           << fixed << setprecision(1) << rate << "/s, found "
+           << s.found << "/" << s.target << ", p = "
+           << scientific << setprecision(3) << probability(s);
+        double remaining = getRemaining();
+        if (remaining >= 0) {
+            double low;
+            double high;
+            getInterval(0.9, low, high);
+            ss << fixed << setprecision(0) << ", eta " << remaining
+               << "s (90%: " << low << "s - " << high << "s)";
+        }
+        os << ss.str() << endl;
+    }
+
+    void SearchProgress::take(snapshot& s) const {
+        ScopedLock lock(mutex);
+        s.candidates = candidates;
+        s.found = found;
+        s.target = target;
+        s.post = post;
+        s.candidateSeconds = candidateSeconds;
+        s.postSeconds = postSeconds;
+        s.elapsed = now() - start;
+    }
+
+    double SearchProgress::probability(const snapshot& s) const {
+        return static_cast<double>(1 + s.found)
+            / (1 / prior + static_cast<double>(s.candidates));
+    }
+
+    /*
+     * 処理時間の和が経過時間を越えていれば、その比の数のスレッドで
+     * 並列に探索しているとみなす。出力など段階の外で使った時間が
+     * あれば比は小さくなり、残り時間にはその分も含まれる。
+     */
+    double SearchProgress::parallelism(const snapshot& s) const {
+        double busy = s.candidateSeconds + s.postSeconds;
+        if (s.elapsed > 0 && busy > 0) {
+            return busy / s.elapsed;
+        }
+        return 1;
+    }
+
+    /*
+     * ひとつ見つけるまでに候補を試す時間と、後処理の時間
+     */
+    void SearchProgress::costs(const snapshot& s, double& search,
+                               double& postCost) const {
+        search = s.candidateSeconds / static_cast<double>(s.candidates)
+            / probability(s);
+        postCost = 0;
+        if (s.post > 0) {
+            postCost = s.postSeconds / static_cast<double>(s.post);
+        }
+    }
+}
@@ -0,0 +1,147 @@
+#include <ctype.h>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <MTToolBox/SourceEmitter.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+
+    SourceEmitter::SourceEmitter(ostream& out, const string& name)
+        : out(out), name(name), indent(0)
+    {
+        if (!isIdentifier(name)) {
+            throw invalid_argument("name should be an identifier: " + name);
+        }
+    }
+
+    /*
+     * 説明は行ごとに " * " をつけてコメントにする。
+     */
+    void SourceEmitter::beginHeader(const string& description)
+    {
+        out << "/*" << endl;
+        out << " * " << name << ".h" << endl;
+        out << " *" << endl;
+        istringstream ss(description);
+        string text;
+        while (getline(ss, text)) {
+            if (text.empty()) {
+                out << " *" << endl;
+            } else {
+                out << " * " << text << endl;
+            }
+        }
+        out << " */" << endl;
+        out << "#ifndef " << guard() << endl;
+        out << "#define " << guard() << endl;
+        out << endl;
+        out << "#include <stdint.h>" << endl;
+        out << "#include <string.h>" << endl;
+    }
+
+    void SourceEmitter::endHeader()
+    {
+        out << "#endif /* " << guard() << " */" << endl;
+    }
+
+    void SourceEmitter::line(const string& text)
+    {
+        if (!text.empty()) {
+            out << string(static_cast<size_t>(indent) * 4, ' ') << text;
+        }
+        out << endl;
+    }
+
+    void SourceEmitter::directive(const string& text)
+    {
+        out << text << endl;
+    }
+
+    void SourceEmitter::open(const string& head)
+    {
+        line(head + " {");
+        indent++;
+    }
+
+    void SourceEmitter::close(const string& tail)
+    {
+        if (indent > 0) {
+            indent--;
+        }
+        line("}" + tail);
+    }
+
+    void SourceEmitter::enumConstant(const string& constName, int value)
+    {
+        ostringstream ss;
+        ss << "enum { " << constName << " = " << dec << value << " };";
+        line(ss.str());
+    }
+
+    void SourceEmitter::constant32(const string& constName, uint32_t value)
+    {
+        line("static const uint32_t " + constName + " = "
+             + literal32(value) + ";");
+    }
+
+    void SourceEmitter::constant64(const string& constName, uint64_t value)
+    {
+        ostringstream ss;
+        ss << "static const uint64_t " << constName << " = UINT64_C(0x"
+           << hex << setw(16) << setfill('0') << value << ");";
+        line(ss.str());
+    }
+
+    /*
+     * 一行に４個ずつ書く。
+     */
+    void SourceEmitter::array32(const string& arrayName,
+                                const vector<uint32_t>& values)
+    {
+        open("static const uint32_t " + arrayName + "[] =");
+        for (size_t i = 0; i < values.size(); i += 4) {
+            string text;
+            for (size_t j = i; j < i + 4 && j < values.size(); j++) {
+                if (j > i) {
+                    text += " ";
+                }
+                text += literal32(values[j]) + ",";
+            }
+            line(text);
+        }
+        close(";");
+    }
+
+    string SourceEmitter::literal32(uint32_t value)
+    {
+        ostringstream ss;
+        ss << "UINT32_C(0x" << hex << setw(8) << setfill('0') << value
+           << ")";
+        return ss.str();
+    }
+
+    bool SourceEmitter::isIdentifier(const string& str)
+    {
+        if (str.empty()) {
+            return false;
+        }
+        for (size_t i = 0; i < str.size(); i++) {
+            int c = static_cast<unsigned char>(str[i]);
+            if (!(isalpha(c) || c == '_' || (i > 0 && isdigit(c)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    string SourceEmitter::guard() const
+    {
+        string g;
+        for (size_t i = 0; i < name.size(); i++) {
+            g += static_cast<char>(
+                toupper(static_cast<unsigned char>(name[i])));
+        }
+        return g + "_H";
+    }
+}
@@ -0,0 +1,304 @@
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <MTToolBox/Topology.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+
+    static bool read_line(const string& path, string& line) {
+        ifstream ifs(path.c_str());
+        if (!ifs || !getline(ifs, line)) {
+            return false;
+        }
+        return true;
+    }
+
+    /*
+     * "0-3,8,10-11" の形式の CPU の並びを読む。
+     */
+    static bool read_list(const string& path, vector<int>& list) {
+        string line;
+        list.clear();
+        if (!read_line(path, line)) {
+            return false;
+        }
+        stringstream ss(line);
+        string item;
+        while (getline(ss, item, ',')) {
+            if (item.empty()) {
+                continue;
+            }
+            char * end;
+            long first = strtol(item.c_str(), &end, 10);
+            long last = first;
+            if (*end == '-') {
+                last = strtol(end + 1, NULL, 10);
+            }
+            for (long i = first; i <= last; i++) {
+                list.push_back(static_cast<int>(i));
+            }
+        }
+        return !list.empty();
+    }
+
+    /*
+     * "107520K" や "32M" の形式の大きさを読む。
+     */
+    static size_t read_size(const string& path) {
+        string line;
+        if (!read_line(path, line)) {
+            return 0;
+        }
+        char * end;
+        size_t size = static_cast<size_t>(strtoul(line.c_str(), &end, 10));
+        if (*end == 'K') {
+            size *= 1024;
+        } else if (*end == 'M') {
+            size *= 1024 * 1024;
+        }
+        return size;
+    }
+
+    static string cpu_dir(const string& root, int cpu) {
+        stringstream ss;
+        ss << root << "/cpu/cpu" << dec << cpu;
+        return ss.str();
+    }
+
+    /*
+     * 命令キャッシュ以外でいちばん深いレベルのキャッシュを LLC とし、
+     * それを共有する CPU のうち最小の番号を LLC の識別に使う。
+     */
+    static bool read_llc(const string& root, int cpu, int& key,
+                         size_t& size) {
+        int level = 0;
+        for (int i = 0;; i++) {
+            stringstream ss;
+            ss << cpu_dir(root, cpu) << "/cache/index" << dec << i;
+            string dir = ss.str();
+            string line;
+            if (!read_line(dir + "/level", line)) {
+                break;
+            }
+            int lv = atoi(line.c_str());
+            string type;
+            if (read_line(dir + "/type", type) && type == "Instruction") {
+                continue;
+            }
+            vector<int> shared;
+            if (lv <= level || !read_list(dir + "/shared_cpu_list", shared)) {
+                continue;
+            }
+            level = lv;
+            key = *min_element(shared.begin(), shared.end());
+            size = read_size(dir + "/size");
+        }
+        return level > 0;
+    }
+
+    static pthread_once_t system_once = PTHREAD_ONCE_INIT;
+    static CpuTopology * system_topology = NULL;
+
+    static void init_system() {
+        system_topology = new CpuTopology();
+    }
+
+    CpuTopology::CpuTopology() {
+        probe("/sys/devices/system", true);
+    }
+
+    CpuTopology::CpuTopology(const string& root) {
+        probe(root, false);
+    }
+
+    const CpuTopology& CpuTopology::system() {
+        pthread_once(&system_once, init_system);
+        return *system_topology;
+    }
+
+    size_t CpuTopology::workingSet(int bitSize, int copies) {
+        // 状態を 64 ビットのワードで持ち、オブジェクトの分を足す
+        size_t state = static_cast<size_t>((bitSize + 63) / 64) * 8 + 64;
+        return state * static_cast<size_t>(copies);
+    }
+
+    bool CpuTopology::pin(int cpu) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set)
+            == 0;
+    }
+
+    size_t CpuTopology::getCacheSize() const {
+        size_t size = 0;
+        for (size_t i = 0; i < cacheSize.size(); i++) {
+            size = max(size, cacheSize[i]);
+        }
+        return size;
+    }
+
+    int CpuTopology::placement(int index) const {
+        if (index < 0) {
+            index = 0;
+        }
+        return cpus[order[static_cast<size_t>(index) % order.size()]];
+    }
+
+    int CpuTopology::getNode(int cpu) const {
+        for (size_t i = 0; i < cpus.size(); i++) {
+            if (cpus[i] == cpu) {
+                return node[i];
+            }
+        }
+        return -1;
+    }
+
+    int CpuTopology::concurrencyFor(size_t workingSet) const {
+        if (workingSet == 0) {
+            return getCpus();
+        }
+        int threads = 0;
+        for (size_t d = 0; d < cacheSize.size(); d++) {
+            int sharing = static_cast<int>(count(domain.begin(), domain.end(),
+                                                 static_cast<int>(d)));
+            if (cacheSize[d] == 0) {
+                threads += sharing;
+                continue;
+            }
+            size_t fit = cacheSize[d] / workingSet;
+            fit = min(fit, static_cast<size_t>(sharing));
+            threads += fit < 1 ? 1 : static_cast<int>(fit);
+        }
+        return threads;
+    }
+
+    void CpuTopology::probe(const string& root, bool affinity) {
+        vector<int> online;
+        if (!read_list(root + "/cpu/online", online)) {
+            long n = sysconf(_SC_NPROCESSORS_ONLN);
+            for (long i = 0; i < max(n, 1L); i++) {
+                online.push_back(static_cast<int>(i));
+            }
+        }
+        cpus.clear();
+        if (affinity) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+                for (size_t i = 0; i < online.size(); i++) {
+                    if (online[i] < CPU_SETSIZE && CPU_ISSET(online[i], &set)) {
+                        cpus.push_back(online[i]);
+                    }
+                }
+            }
+        }
+        if (cpus.empty()) {
+            cpus = online;
+        }
+        // ノード: node/online に並ぶノードの cpulist を読む
+        size_t n = cpus.size();
+        node.assign(n, 0);
+        map<int, int> nodeIndex;
+        vector<int> nodeIds;
+        read_list(root + "/node/online", nodeIds);
+        for (size_t k = 0; k < nodeIds.size(); k++) {
+            stringstream ss;
+            ss << root << "/node/node" << dec << nodeIds[k] << "/cpulist";
+            vector<int> list;
+            if (!read_list(ss.str(), list)) {
+                continue;
+            }
+            for (size_t i = 0; i < n; i++) {
+                if (find(list.begin(), list.end(), cpus[i]) == list.end()) {
+                    continue;
+                }
+                if (nodeIndex.find(nodeIds[k]) == nodeIndex.end()) {
+                    int next = static_cast<int>(nodeIndex.size());
+                    nodeIndex[nodeIds[k]] = next;
+                }
+                node[i] = nodeIndex[nodeIds[k]];
+            }
+        }
+        nodes = max(1, static_cast<int>(nodeIndex.size()));
+        // LLC: 読めなければノードごとにひとつとし、大きさは sysconf
+        domain.assign(n, 0);
+        cacheSize.clear();
+        map<int, int> domainIndex;
+        for (size_t i = 0; i < n; i++) {
+            int key;
+            size_t size;
+            if (!read_llc(root, cpus[i], key, size)) {
+                key = -1 - node[i];
+                size = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+                if (affinity) {
+                    long s = sysconf(_SC_LEVEL3_CACHE_SIZE);
+                    size = s > 0 ? static_cast<size_t>(s) : 0;
+                }
+#endif
+            }
+            if (domainIndex.find(key) == domainIndex.end()) {
+                int next = static_cast<int>(domainIndex.size());
+                domainIndex[key] = next;
+                cacheSize.push_back(size);
+            }
+            domain[i] = domainIndex[key];
+        }
+        // SMT の兄弟の中での順番
+        vector<int> sibling(n, 0);
+        for (size_t i = 0; i < n; i++) {
+            vector<int> list;
+            if (read_list(cpu_dir(root, cpus[i])
+                          + "/topology/thread_siblings_list", list)) {
+                sort(list.begin(), list.end());
+                sibling[i] = static_cast<int>(
+                    find(list.begin(), list.end(), cpus[i]) - list.begin());
+            }
+        }
+        /*
+         * 各ノードの中で (兄弟の中での順番, LLC の中での順番, LLC, CPU)
+         * の順に並べ、ノードを順番に巡って取り出す。
+         */
+        vector<vector<int> > perNode(static_cast<size_t>(nodes));
+        vector<int> rankInDomain(n, 0);
+        {
+            map<pair<int, int>, int> used;
+            for (size_t i = 0; i < n; i++) {
+                rankInDomain[i] = used[make_pair(domain[i], sibling[i])]++;
+            }
+        }
+        vector<pair<vector<int>, int> > keys;
+        for (size_t i = 0; i < n; i++) {
+            vector<int> k;
+            k.push_back(sibling[i]);
+            k.push_back(rankInDomain[i]);
+            k.push_back(domain[i]);
+            k.push_back(cpus[i]);
+            keys.push_back(make_pair(k, static_cast<int>(i)));
+        }
+        sort(keys.begin(), keys.end());
+        for (size_t j = 0; j < keys.size(); j++) {
+            int i = keys[j].second;
+            perNode[static_cast<size_t>(node[static_cast<size_t>(i)])]
+                .push_back(i);
+        }
+        order.clear();
+        for (size_t r = 0; order.size() < n; r++) {
+            for (size_t k = 0; k < perNode.size(); k++) {
+                if (r < perNode[k].size()) {
+                    order.push_back(perNode[k][r]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <MTToolBox/WorkQueue.hpp>
+#include <MTToolBox/FileLock.hpp>
+#include <MTToolBox/SequentialShards.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+
+    static const char * const state_names[] = {"pending", "claimed", "done"};
+
+    static const string lock_path(const string& path) {
+        return path + ".lock";
+    }
+
+    static const string results_path(const string& path) {
+        return path + ".results";
+    }
+
+    static const string host_name() {
+        char buf[256];
+        if (gethostname(buf, sizeof(buf)) != 0) {
+            return "-";
+        }
+        buf[sizeof(buf) - 1] = '\0';
+        return buf;
+    }
+
+    void WorkQueue::create(const string& path,
+                           uint64_t start, uint64_t floor, int count) {
+        SequentialShards<uint64_t> shards(0, start, floor, count);
+        WorkQueue queue;
+        queue.path = path;
+        queue.lock_fd = FileLock::open(lock_path(path));
+        FileLock lock(queue.lock_fd);
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            throw runtime_error("work queue already exists: " + path);
+        }
+        for (int i = 0; i < count; i++) {
+            Record r;
+            r.top = shards.getShardStart(i);
+            r.floor = shards.getShardFloor(i);
+            r.status = r.top;
+            r.state = shards.isDone(i) ? done : pending;
+            r.tried = 0;
+            r.found = 0;
+            r.host = "-";
+            r.pid = 0;
+            queue.records.push_back(r);
+        }
+        ofstream ofs(results_path(path).c_str(), ios::trunc);
+        if (!ofs) {
+            throw runtime_error("can't create " + results_path(path));
+        }
+        queue.write();
+    }
+
+    WorkQueue::WorkQueue() {
+        lock_fd = -1;
+        reported = 0;
+    }
+
+    WorkQueue::WorkQueue(const string& path) {
+        this->path = path;
+        reported = 0;
+        lock_fd = FileLock::open(lock_path(path));
+        try {
+            FileLock lock(lock_fd);
+            read();
+        } catch (...) {
+            close(lock_fd);
+            throw;
+        }
+    }
+
+    WorkQueue::~WorkQueue() {
+        if (lock_fd >= 0) {
+            close(lock_fd);
+        }
+    }
+
+    bool WorkQueue::claim(WorkItem& item) {
+        FileLock lock(lock_fd);
+        read();
+        for (size_t i = 0; i < records.size(); i++) {
+            Record& r = records[i];
+            if (r.state == done) {
+                continue;
+            }
+            if (r.state == claimed && isAlive(r)) {
+                continue;
+            }
+            r.state = claimed;
+            r.host = host_name();
+            r.pid = static_cast<long>(getpid());
+            write();
+            item.index = static_cast<int>(i);
+            item.start = r.status;
+            item.floor = r.floor;
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t WorkQueue::report(const WorkItem& item, uint64_t key,
+                               const string& line) {
+        FileLock lock(lock_fd);
+        read();
+        Record& r = records.at(item.index);
+        if (key > r.top || key < r.floor) {
+            throw invalid_argument("reported key out of range");
+        }
+        // 前のワーカーが結果を書いた後、状態を書く前に止まったときは
+        // 同じパラメータがもう一度報告される
+        if (countReported(-1, key, key) == 0) {
+            ofstream ofs(results_path(path).c_str(), ios::app);
+            ofs << dec << item.index << " " << hex << key << " "
+                << line << endl;
+            if (!ofs) {
+                throw runtime_error("can't write " + results_path(path));
+            }
+            reported++;
+        }
+        // 試行数と発見数もここまでの分を記録する。範囲の最後なら
+        // 進めないので、取り直したワーカーは key をもう一度試すが、
+        // 上で重複を除くので結果は変わらない
+        if (key > r.floor && key <= r.status) {
+            r.tried += r.status - key + 1;
+            r.found += 1;
+            r.status = key - 1;
+        }
+        write();
+        return reported;
+    }
+
+    void WorkQueue::release(const WorkItem& item, uint64_t status,
+                            uint64_t tried, uint64_t found) {
+        FileLock lock(lock_fd);
+        read();
+        Record& r = records.at(item.index);
+        if (status > r.top || status < r.floor) {
+            throw invalid_argument("released status out of range");
+        }
+        credit(item, r, tried, found);
+        r.status = status;
+        r.state = pending;
+        r.host = "-";
+        r.pid = 0;
+        write();
+    }
+
+    void WorkQueue::complete(const WorkItem& item,
+                             uint64_t tried, uint64_t found) {
+        FileLock lock(lock_fd);
+        read();
+        Record& r = records.at(item.index);
+        credit(item, r, tried, found);
+        r.status = r.floor;
+        r.state = done;
+        r.host = "-";
+        r.pid = 0;
+        write();
+    }
+
+    bool WorkQueue::isAllDone() {
+        FileLock lock(lock_fd);
+        read();
+        for (size_t i = 0; i < records.size(); i++) {
+            if (records[i].state != done) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void WorkQueue::getStatistics(uint64_t& tried, uint64_t& found) {
+        FileLock lock(lock_fd);
+        read();
+        tried = 0;
+        found = 0;
+        for (size_t i = 0; i < records.size(); i++) {
+            tried += records[i].tried;
+            found += records[i].found;
+        }
+    }
+
+    uint64_t WorkQueue::getReported() {
+        FileLock lock(lock_fd);
+        read();
+        return reported;
+    }
+
+    void WorkQueue::collect(vector<pair<uint64_t, string> >& results) {
+        {
+            FileLock lock(lock_fd);
+            ifstream ifs(results_path(path).c_str());
+            if (!ifs) {
+                throw runtime_error("can't open " + results_path(path));
+            }
+            string line;
+            while (getline(ifs, line)) {
+                stringstream ss(line);
+                int index;
+                uint64_t key;
+                if (!(ss >> dec >> index >> hex >> key)) {
+                    continue;
+                }
+                ss.get();
+                string rest;
+                getline(ss, rest);
+                results.push_back(make_pair(key, rest));
+            }
+        }
+        SequentialShards<uint64_t>::merge(results);
+    }
+
+    /*
+     * 状態のファイルを読む。ロックを持っていること。
+     */
+    void WorkQueue::read() {
+        ifstream ifs(path.c_str());
+        if (!ifs) {
+            throw runtime_error("can't open work queue: " + path);
+        }
+        string line;
+        size_t count;
+        getline(ifs, line);
+        stringstream hs(line);
+        string sharp, work, queue;
+        if (!(hs >> sharp >> work >> queue >> dec >> count >> reported)
+            || sharp != "#" || work != "work" || queue != "queue") {
+            throw runtime_error("broken work queue: " + path);
+        }
+        vector<Record> work_records;
+        for (size_t i = 0; i < count; i++) {
+            Record r;
+            size_t index;
+            string state;
+            if (!(ifs >> dec >> index >> hex >> r.top >> r.floor >> r.status
+                  >> state >> dec >> r.tried >> r.found >> r.host >> r.pid)
+                || index != i) {
+                throw runtime_error("broken work queue: " + path);
+            }
+            if (state == state_names[pending]) {
+                r.state = pending;
+            } else if (state == state_names[claimed]) {
+                r.state = claimed;
+            } else if (state == state_names[done]) {
+                r.state = done;
+            } else {
+                throw runtime_error("broken work queue: " + path);
+            }
+            work_records.push_back(r);
+        }
+        records.swap(work_records);
+    }
+
+    /*
+     * 状態のファイルを書く。ロックを持っていること。
+     * 一時ファイルに書いてから名前を変える。
+     */
+    void WorkQueue::write() {
+        string tmp = path + ".tmp";
+        {
+            ofstream ofs(tmp.c_str(), ios::trunc);
+            ofs << "# work queue " << dec << records.size() << " "
+                << reported << endl;
+            for (size_t i = 0; i < records.size(); i++) {
+                const Record& r = records[i];
+                ofs << dec << i << " " << hex << r.top << " " << r.floor
+                    << " " << r.status << " " << state_names[r.state]
+                    << " " << dec << r.tried << " " << r.found << " "
+                    << r.host << " " << r.pid << endl;
+            }
+            if (!ofs) {
+                throw runtime_error("can't write work queue: " + path);
+            }
+        }
+        if (rename(tmp.c_str(), path.c_str()) != 0) {
+            throw runtime_error("can't write work queue: " + path);
+        }
+    }
+
+    /*
+     * index 番目の範囲から報告された、キーが low から high までの
+     * パラメータの数を数える。index が負ならすべての範囲を数える。
+     * ロックを持っていること。
+     */
+    uint64_t WorkQueue::countReported(int index,
+                                      uint64_t low, uint64_t high) const {
+        ifstream ifs(results_path(path).c_str());
+        if (!ifs) {
+            throw runtime_error("can't open " + results_path(path));
+        }
+        uint64_t count = 0;
+        string line;
+        while (getline(ifs, line)) {
+            stringstream ss(line);
+            int i;
+            uint64_t key;
+            if (!(ss >> dec >> i >> hex >> key)) {
+                continue;
+            }
+            if ((index < 0 || i == index) && key >= low && key <= high) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /*
+     * item を取ってからの試行数と発見数を記録に加える。report() で
+     * 記録した分、すなわち item.start から r.status の手前までの分は
+     * 除く。ロックを持っていること。
+     */
+    void WorkQueue::credit(const WorkItem& item, Record& r,
+                           uint64_t tried, uint64_t found) const {
+        uint64_t done_tried = item.start - r.status;
+        uint64_t done_found = 0;
+        if (done_tried > 0) {
+            done_found = countReported(item.index, r.status + 1, item.start);
+        }
+        r.tried += tried > done_tried ? tried - done_tried : 0;
+        r.found += found > done_found ? found - done_found : 0;
+    }
+
+    /*
+     * 範囲を取ったプロセスが動いているか調べる。
+     * 別のホストのプロセスは調べられないので動いているとみなす。
+     */
+    bool WorkQueue::isAlive(const Record& r) const {
+        if (r.host != host_name()) {
+            return true;
+        }
+        pid_t pid = static_cast<pid_t>(r.pid);
+        if (pid <= 0) {
+            return false;
+        }
+        return kill(pid, 0) == 0 || errno == EPERM;
+    }
+}
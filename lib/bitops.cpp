@@ -0,0 +1,241 @@
+#include <stdlib.h>
+#include <string.h>
+#include <MTToolBox/bitops.hpp>
+#include <MTToolBox/util.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MTTOOLBOX_BITOPS_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace MTToolBox {
+    using namespace std;
+
+    /*
+     * どの CPU でも動く実装
+     * util.hpp のレジスタ内SIMDアルゴリズムを使う。
+     */
+    static int generic_count_bit(const uint64_t * p, int n) {
+        int c = 0;
+        for (int i = 0; i < n; i++) {
+            c += count_bit(p[i]);
+        }
+        return c;
+    }
+
+    static int generic_lowest_one(const uint64_t * p, int n) {
+        for (int i = 0; i < n; i++) {
+            if (p[i] != 0) {
+                return 64 * i + 63 - calc_1pos(p[i]);
+            }
+        }
+        return -1;
+    }
+
+    static int generic_highest_one(const uint64_t * p, int n) {
+        for (int i = n - 1; i >= 0; i--) {
+            uint64_t x = p[i];
+            if (x != 0) {
+                x |= x >> 1;
+                x |= x >> 2;
+                x |= x >> 4;
+                x |= x >> 8;
+                x |= x >> 16;
+                x |= x >> 32;
+                return 64 * i + count_bit(x) - 1;
+            }
+        }
+        return -1;
+    }
+
+    static uint64_t generic_extract_bits(uint64_t x, uint64_t mask) {
+        uint64_t r = 0;
+        uint64_t b = 1;
+        while (mask != 0) {
+            uint64_t low = mask & (~mask + 1);
+            if (x & low) {
+                r |= b;
+            }
+            b <<= 1;
+            mask ^= low;
+        }
+        return r;
+    }
+
+#if defined(MTTOOLBOX_BITOPS_X86)
+    /*
+     * POPCNT 命令を使う実装
+     * 最下位・最上位の 1 の位置は x86-64 の基本命令 (BSF, BSR) で求める。
+     */
+    __attribute__((target("popcnt")))
+    static int popcnt_count_bit(const uint64_t * p, int n) {
+        int c = 0;
+        for (int i = 0; i < n; i++) {
+            c += __builtin_popcountll(p[i]);
+        }
+        return c;
+    }
+
+    static int popcnt_lowest_one(const uint64_t * p, int n) {
+        for (int i = 0; i < n; i++) {
+            if (p[i] != 0) {
+                return 64 * i + __builtin_ctzll(p[i]);
+            }
+        }
+        return -1;
+    }
+
+    static int popcnt_highest_one(const uint64_t * p, int n) {
+        for (int i = n - 1; i >= 0; i--) {
+            if (p[i] != 0) {
+                return 64 * i + 63 - __builtin_clzll(p[i]);
+            }
+        }
+        return -1;
+    }
+
+    /*
+     * BMI, BMI2, LZCNT 命令を使う実装 (Haswell 以降)
+     */
+    __attribute__((target("bmi")))
+    static int bmi2_lowest_one(const uint64_t * p, int n) {
+        for (int i = 0; i < n; i++) {
+            if (p[i] != 0) {
+                return 64 * i + static_cast<int>(_tzcnt_u64(p[i]));
+            }
+        }
+        return -1;
+    }
+
+    __attribute__((target("lzcnt")))
+    static int bmi2_highest_one(const uint64_t * p, int n) {
+        for (int i = n - 1; i >= 0; i--) {
+            if (p[i] != 0) {
+                return 64 * i + 63 - static_cast<int>(_lzcnt_u64(p[i]));
+            }
+        }
+        return -1;
+    }
+
+    __attribute__((target("bmi2")))
+    static uint64_t bmi2_extract_bits(uint64_t x, uint64_t mask) {
+        return _pext_u64(x, mask);
+    }
+
+    /*
+     * AVX-512 VPOPCNTDQ 命令を使う実装 (Ice Lake 以降)
+     * 8ワードずつ数え、残りは POPCNT 命令で数える。
+     */
+    __attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+    static int avx512_count_bit(const uint64_t * p, int n) {
+        __m512i acc = _mm512_setzero_si512();
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512i v = _mm512_loadu_si512(p + i);
+            acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+        }
+        uint64_t sum[8];
+        _mm512_storeu_si512(sum, acc);
+        int c = 0;
+        for (int j = 0; j < 8; j++) {
+            c += static_cast<int>(sum[j]);
+        }
+        for (; i < n; i++) {
+            c += __builtin_popcountll(p[i]);
+        }
+        return c;
+    }
+
+    static bool has_lzcnt() {
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (ecx & (1U << 5)) != 0;
+    }
+#endif
+
+    /*
+     * 速い順に並べた実装の表
+     */
+    enum { generic_index, popcnt_index, bmi2_index, avx512_index };
+
+    static const bit_primitives_t implementations[] = {
+        {"generic", generic_count_bit, generic_lowest_one,
+         generic_highest_one, generic_extract_bits},
+#if defined(MTTOOLBOX_BITOPS_X86)
+        {"popcnt", popcnt_count_bit, popcnt_lowest_one,
+         popcnt_highest_one, generic_extract_bits},
+        {"bmi2", popcnt_count_bit, bmi2_lowest_one,
+         bmi2_highest_one, bmi2_extract_bits},
+        {"avx512", avx512_count_bit, bmi2_lowest_one,
+         bmi2_highest_one, bmi2_extract_bits},
+#endif
+    };
+
+    /*
+     * index 番目の実装が実行中の CPU で使えるか判定する。
+     */
+    static bool is_available(int index) {
+#if defined(MTTOOLBOX_BITOPS_X86)
+        __builtin_cpu_init();
+        switch (index) {
+        case generic_index:
+            return true;
+        case popcnt_index:
+            return __builtin_cpu_supports("popcnt");
+        case bmi2_index:
+            return __builtin_cpu_supports("popcnt")
+                && __builtin_cpu_supports("bmi")
+                && __builtin_cpu_supports("bmi2")
+                && has_lzcnt();
+        case avx512_index:
+            return is_available(bmi2_index)
+                && __builtin_cpu_supports("avx512f")
+                && __builtin_cpu_supports("avx512vpopcntdq");
+        default:
+            return false;
+        }
+#else
+        return index == generic_index;
+#endif
+    }
+
+    const bit_primitives_t * bit_primitives_by_name(const char * name) {
+        int count = static_cast<int>(sizeof(implementations)
+                                     / sizeof(implementations[0]));
+        for (int i = 0; i < count; i++) {
+            if (strcmp(implementations[i].name, name) == 0) {
+                if (is_available(i)) {
+                    return &implementations[i];
+                }
+                return NULL;
+            }
+        }
+        return NULL;
+    }
+
+    static const bit_primitives_t * select_bit_primitives() {
+        const char * env = getenv("MTTOOLBOX_BITOPS");
+        if (env != NULL) {
+            const bit_primitives_t * p = bit_primitives_by_name(env);
+            if (p != NULL) {
+                return p;
+            }
+        }
+        int count = static_cast<int>(sizeof(implementations)
+                                     / sizeof(implementations[0]));
+        for (int i = count - 1; i > 0; i--) {
+            if (is_available(i)) {
+                return &implementations[i];
+            }
+        }
+        return &implementations[generic_index];
+    }
+
+    const bit_primitives_t& bit_primitives() {
+        static const bit_primitives_t * selected = select_bit_primitives();
+        return *selected;
+    }
+}
@@ -1,4 +1,6 @@
 #include <sstream>
+#include <vector>
+#include <sys/time.h>
 #include <NTL/GF2XFactoring.h>
 #include <NTL/ZZ.h>
 #include <NTL/vector.h>
@@ -19,16 +21,51 @@ namespace MTToolBox {
      1257787, 1398269, 2976221, 3021377, 6972593, 13466917,
      20996011, 25964951, -1};
 
+    /**
+     * 試し割りによる素数判定
+     */
+    static bool is_prime_number(long n)
+    {
+        if (n < 2) {
+            return false;
+        }
+        for (long d = 2; d * d <= n; d++) {
+            if (n % d == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**
      * 既約判定
      * poly が既約であるか判定する。
+     * 次数 n が素数のときは、既約因子の次数は 1 か n しかないので、
+     * 一次の因子を持たず x^(2^n) = x (mod poly) であれば既約である。
+     * この場合は GCD を一回だけにして、二乗を GF2XModulus で計算する。
      * @param[in] poly
      * @returns true polyが既約が公式の場合
      */
     bool
     isIrreducible(const NTL::GF2X& poly)
     {
-        return static_cast<bool>(IterIrredTest(poly));
+        static const GF2X t1 = GF2X(1, 1);
+        static const GF2X t2t1 = GF2X(2, 1) + GF2X(1, 1);
+        long n = deg(poly);
+        if (n <= 2 || !is_prime_number(n)) {
+            return static_cast<bool>(IterIrredTest(poly));
+        }
+        GF2X g;
+        GCD(g, poly, t2t1);
+        if (!IsOne(g)) {
+            return false;
+        }
+        GF2XModulus mod(poly);
+        GF2X h = t1;
+        for (long i = 0; i < n; i++) {
+            SqrMod(h, h, mod);
+        }
+        return h == t1;
     }
 
     /**
@@ -156,44 +193,78 @@ namespace MTToolBox {
     }
 
     /**
-     * 与えられた多項式が degree 次の既約因子を持つか判定する。
-     * poly は常に破壊される。結果がtrue の時、polyには
-     * 指定された次数の既約多項式がセットされる。
-     * degree は一般にはメルセンヌ指数であり、polyの次数より
-     * 少しだけ小さい。degree 次の既約多項式が複数
-     * 存在するという可能性は考慮していない。
+     * まとめて GCD をとる x^(2^m) - x の個数
      */
-    bool
-    hasFactorOfDegree(NTL::GF2X& poly, long degree)
+    static const long gcd_batch = 16;
+
+    /**
+     * hasFactorOfDegree の本体
+     * m = 1, 2, ... の順に m 次の既約因子を poly から割り出す。
+     * m 次未満の因子を割り出した後の poly の因子はすべて m 次以上なので、
+     * deg(poly) - degree が 0 より大きく m より小さくなったら、degree 次
+     * の既約多項式だけを残すことはできない。
+     * x^(2^m) は GF2XModulus を使って二乗で求め、gcd_batch 個の
+     * x^(2^m) - x の積と poly が互いに素かどうかを一回の GCD で調べる。
+     * 互いに素でないときだけ、その GCD とひとつずつ GCD をとって因子
+     * を求め、重複も含めて poly から割り出す。
+     */
+    static bool
+    has_factor(GF2X& poly, long degree, FactorStatistics& stat)
     {
-        static const GF2X t2 = GF2X(2, 1);
         static const GF2X t1 = GF2X(1, 1);
-        GF2X t2m;
-        GF2X t;
-        GF2X alpha;
-        int m;
-
-        t2m = t2;
         if (deg(poly) < degree) {
             return false;
         }
-        t = t1;
-        t += t2m;
-
-        for (m = 1; deg(poly) > degree; m++) {
-            for(;;) {
-                GCD(alpha, poly, t);
-                if (IsOne(alpha)) {
-                    break;
-                }
-                poly /= alpha;
-                if (deg(poly) < degree) {
-                    return false;
+        GF2XModulus mod(poly);
+        vector<GF2X> power(gcd_batch + 1);
+        GF2X t2m;
+        GF2X prod;
+        GF2X t;
+        GF2X alpha;
+        GF2X factor;
+        rem(t2m, t1, mod);
+        long m = 1;
+        while (deg(poly) > degree) {
+            long rest = deg(poly) - degree;
+            if (m > rest) {
+                return false;
+            }
+            long k = min(gcd_batch, rest - m + 1);
+            power[0] = t2m;
+            conv(prod, 1);
+            for (long j = 1; j <= k; j++) {
+                SqrMod(power[j], power[j - 1], mod);
+                add(t, power[j], t1);
+                MulMod(prod, prod, t, mod);
+            }
+            stat.squarings += k;
+            GCD(alpha, poly, prod);
+            stat.gcds++;
+            if (IsOne(alpha)) {
+                t2m = power[k];
+                m += k;
+                continue;
+            }
+            long j;
+            for (j = 1; j <= k && deg(poly) > degree; j++, m++) {
+                add(t, power[j], t1);
+                GCD(factor, alpha, t);
+                stat.gcds++;
+                while (!IsOne(factor)) {
+                    GCD(factor, poly, factor);
+                    stat.gcds++;
+                    if (IsOne(factor)) {
+                        break;
+                    }
+                    poly /= factor;
+                    stat.divisions++;
+                    if (deg(poly) < degree) {
+                        return false;
+                    }
                 }
             }
-            t2m *= t2m;
-            t2m %= poly;
-            add(t, t2m, t1);
+            rem(t2m, power[j - 1], poly);
+            build(mod, poly);
         }
         if (deg(poly) != degree) {
             return false;
@@ -201,4 +272,39 @@ namespace MTToolBox {
         return isIrreducible(poly);
     }
 
+    /**
+     * 与えられた多項式が degree 次の既約因子を持つか判定する。
+     * poly は常に破壊される。結果がtrue の時、polyには
+     * 指定された次数の既約多項式がセットされる。
+     * degree は一般にはメルセンヌ指数であり、polyの次数より
+     * 少しだけ小さい。degree 次の既約多項式が複数
+     * 存在するという可能性は考慮していない。
+     */
+    bool
+    hasFactorOfDegree(NTL::GF2X& poly, long degree)
+    {
+        FactorStatistics stat;
+        return hasFactorOfDegree(poly, degree, stat);
+    }
+
+    /**
+     * hasFactorOfDegree と同じ判定をし、計算量を stat に加算する。
+     */
+    bool
+    hasFactorOfDegree(NTL::GF2X& poly, long degree, FactorStatistics& stat)
+    {
+        struct timeval start;
+        struct timeval end;
+        gettimeofday(&start, NULL);
+        bool result = has_factor(poly, degree, stat);
+        gettimeofday(&end, NULL);
+        stat.calls++;
+        if (result) {
+            stat.found++;
+        }
+        stat.microseconds += (end.tv_sec - start.tv_sec) * 1000000L
+            + (end.tv_usec - start.tv_usec);
+        return result;
+    }
+
 }
@@ -0,0 +1,132 @@
+#include <climits>
+#include <MTToolBox/polyio.hpp>
+
+namespace MTToolBox {
+    using namespace std;
+    using namespace NTL;
+
+    /*
+     * 8 バイトをリトルエンディアンで書く・読む
+     */
+    static void put_le64(unsigned char * p, uint64_t x) {
+        for (int i = 0; i < 8; i++) {
+            p[i] = static_cast<unsigned char>(x >> (8 * i));
+        }
+    }
+
+    static uint64_t get_le64(const unsigned char * p) {
+        uint64_t x = 0;
+        for (int i = 0; i < 8; i++) {
+            x |= static_cast<uint64_t>(p[i]) << (8 * i);
+        }
+        return x;
+    }
+
+    void poly_to_words(vector<uint64_t>& words, const GF2X& poly) {
+        long d = deg(poly);
+        size_t size = static_cast<size_t>((d + 64) / 64);
+        words.resize(size);
+        if (size == 0) {
+            return;
+        }
+        vector<unsigned char> bytes(size * 8);
+        BytesFromGF2X(&bytes[0], poly, static_cast<long>(bytes.size()));
+        for (size_t i = 0; i < size; i++) {
+            words[i] = get_le64(&bytes[i * 8]);
+        }
+    }
+
+    void words_to_poly(GF2X& poly, const vector<uint64_t>& words) {
+        if (words.empty()) {
+            clear(poly);
+            return;
+        }
+        vector<unsigned char> bytes(words.size() * 8);
+        for (size_t i = 0; i < words.size(); i++) {
+            put_le64(&bytes[i * 8], words[i]);
+        }
+        GF2XFromBytes(poly, &bytes[0], static_cast<long>(bytes.size()));
+    }
+
+    void write_poly(ostream& os, const GF2X& poly) {
+        vector<uint64_t> words;
+        poly_to_words(words, poly);
+        vector<unsigned char> bytes((words.size() + 1) * 8);
+        put_le64(&bytes[0], static_cast<uint64_t>(deg(poly)));
+        for (size_t i = 0; i < words.size(); i++) {
+            put_le64(&bytes[(i + 1) * 8], words[i]);
+        }
+        os.write(reinterpret_cast<const char *>(&bytes[0]),
+                 static_cast<streamsize>(bytes.size()));
+    }
+
+    bool read_poly(GF2X& poly, istream& is) {
+        // NTL の次数は long で、32 ビットの環境もあるので INT_MAX まで
+        const int64_t max_degree = INT_MAX;
+        // 壊れた次数で大きな領域を確保しないように、少しずつ読む
+        const size_t chunk = 8192;
+        unsigned char head[8];
+        if (!is.read(reinterpret_cast<char *>(head), 8)) {
+            return false;
+        }
+        int64_t d = static_cast<int64_t>(get_le64(head));
+        if (d < -1 || d > max_degree) {
+            return false;
+        }
+        size_t size = static_cast<size_t>((d + 64) / 64);
+        vector<uint64_t> words;
+        vector<unsigned char> bytes(chunk * 8);
+        while (words.size() < size) {
+            size_t n = size - words.size();
+            if (n > chunk) {
+                n = chunk;
+            }
+            if (!is.read(reinterpret_cast<char *>(&bytes[0]),
+                         static_cast<streamsize>(n * 8))) {
+                return false;
+            }
+            for (size_t i = 0; i < n; i++) {
+                words.push_back(get_le64(&bytes[i * 8]));
+            }
+        }
+        words_to_poly(poly, words);
+        // 最高次の係数が 1 でなければ壊れている
+        return deg(poly) == d;
+    }
+
+    /*
+     * MurmurHash64A と同じ混ぜ方をワードごとに行う。
+     * 次数を初期値に混ぜるので、上位の係数が 0 のワードの有無も区別
+     * される。
+     */
+    uint64_t poly_hash(const GF2X& poly) {
+        const uint64_t m = UINT64_C(0xc6a4a7935bd1e995);
+        const int r = 47;
+        vector<uint64_t> words;
+        poly_to_words(words, poly);
+        uint64_t h = UINT64_C(0x5bd1e9955bd1e995)
+            ^ (static_cast<uint64_t>(deg(poly)) * m);
+        for (size_t i = 0; i < words.size(); i++) {
+            uint64_t k = words[i];
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+
+    void poly_hash_string(string& str, const GF2X& poly) {
+        static const char hex_digits[] = "0123456789abcdef";
+        uint64_t h = poly_hash(poly);
+        char buf[16];
+        for (int i = 0; i < 16; i++) {
+            buf[i] = hex_digits[(h >> (60 - 4 * i)) & 0x0f];
+        }
+        str.assign(buf, 16);
+    }
+}
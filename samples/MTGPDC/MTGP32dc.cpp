@@ -20,6 +20,7 @@
 #include <sstream>
 #include <fstream>
 #include <MTToolBox/AlgorithmRecursionAndTempering.hpp>
+#include <MTToolBox/SearchProgress.hpp>
 #include <MTToolBox/util.hpp>
 #include "MTGP32search.hpp"
 #include "parse_opt.hpp"
@@ -32,7 +33,8 @@ typedef AlgorithmPartialBitPattern<uint32_t, 32, 4, 23, 5> st32;
 typedef AlgorithmPartialBitPattern<uint32_t, 32, 4, 9, 5, true>
 stlsb32;
 
-int indexed_search(mtgp_options& opt, bool first);
+int indexed_search(mtgp_options& opt, bool first,
+                   SearchProgress * progress);
 
 int main(int argc, char** argv) {
     mtgp_options opt;
@@ -41,19 +43,31 @@ int main(int argc, char** argv) {
     if (!parse) {
         return -1;
     }
+    SearchProgress * progress = NULL;
+    if (opt.progress > 0) {
+        progress = new SearchProgress(
+            SearchProgress::primitiveProbability(opt.mexp), opt.count);
+        progress->setReport(&cerr, opt.progress);
+    }
     while (opt.count > 0) {
-        if (indexed_search(opt, first)) {
+        if (indexed_search(opt, first, progress)) {
             opt.id += 1;
             opt.count -= 1;
         } else {
+            delete progress;
             return -1;
         }
         first = false;
     }
+    if (progress != NULL) {
+        progress->report(cerr);
+        delete progress;
+    }
     return 0;
 }
 
-int indexed_search(mtgp_options& opt, bool first) {
+int indexed_search(mtgp_options& opt, bool first,
+                   SearchProgress * progress) {
     mtgp32 mtgp(opt.mexp, opt.id);
     if (opt.verbose) {
         time_t t = time(NULL);
@@ -64,6 +78,7 @@ int indexed_search(mtgp_options& opt, bool first) {
     MersenneTwister mt;
     mt.seed(opt.seed);
     AlgorithmRecursionAndTempering<uint32_t> all(mt);
+    all.setProgress(progress);
     st32 st;
     stlsb32 stlsb;
     if (all.search(mtgp, st, stlsb, opt.verbose)) {
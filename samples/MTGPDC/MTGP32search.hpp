@@ -29,6 +29,7 @@
 #include <MTToolBox/ParameterGenerator.hpp>
 #include <MTToolBox/MersenneTwister.hpp>
 #include <MTToolBox/util.hpp>
+#include <MTToolBox/CowBuffer.hpp>
 #include "mtgp_param.h"
 
 /**
@@ -62,7 +63,7 @@ namespace mtgp {
             param.mask = (~UINT32_C(0))
                 << (bit_size<uint32_t>() * state_size - param.mexp);
             param.id = id_;
-            state = new uint32_t[static_cast<unsigned long>(state_size)];
+            state = CowBuffer<uint32_t>(ss);
             idx = 0;
             reverse_bit_flag = false;
             seed(0);
@@ -73,18 +74,11 @@ namespace mtgp {
          * @param src source object
          */
         mtgp32(const mtgp32& src) : TemperingCalculatable<uint32_t>(),
-                                    param(src.param) {
+                                    param(src.param),
+                                    state(src.state) {
             state_size = src.state_size;
-            state = new uint32_t[static_cast<unsigned long>(state_size)];
             idx = src.idx;
             reverse_bit_flag = src.reverse_bit_flag;
-            for (int i = 0; i < state_size; i++) {
-                state[i] = src.state[i];
-            }
-        }
-
-        ~mtgp32() {
-            delete[] state;
         }
 
         mtgp32 * clone() const {
@@ -232,9 +226,11 @@ namespace mtgp {
                     "the adder should have the same parameter as the addee.");
             }
 #endif
+            uint32_t * st = state.writable();
+            const uint32_t * src = that->state.data();
             for (int i = 0; i < state_size; i++) {
-                state[(i + idx) % state_size]
-                    ^= that->state[(i + that->idx) % state_size];
+                st[(i + idx) % state_size]
+                    ^= src[(i + that->idx) % state_size];
             }
         }
 
@@ -251,10 +247,11 @@ namespace mtgp {
          * @param seed seed of initialization
          */
         void seed(uint32_t value) {
-            state[0] = value;
+            uint32_t * st = state.writable();
+            st[0] = value;
             for (int i = 1; i < state_size; i++) {
-                state[i] = UINT32_C(1812433253)
-                    * (state[i - 1] ^ (state[i - 1] >> 30))
+                st[i] = UINT32_C(1812433253)
+                    * (st[i - 1] ^ (st[i - 1] >> 30))
                     + static_cast<uint32_t>(i);
             }
             idx = state_size - 1;
@@ -264,9 +261,7 @@ namespace mtgp {
          * This method is called by the functions in simple_shortest_basis.hpp
          */
         void setZero() {
-            for (int i = 0; i < state_size; i++) {
-                state[i] = 0;
-            }
+            state.setZero();
         }
 
         /**
@@ -310,7 +305,7 @@ namespace mtgp {
         mtgp_param<uint32_t> param;
         int idx;
         bool reverse_bit_flag;
-        uint32_t * state;
+        CowBuffer<uint32_t> state;
 
         /**
          * transform internal state
@@ -319,10 +314,11 @@ namespace mtgp {
          * @param index of state array
          */
         void next_state() {
+            uint32_t * st = state.writable();
             idx = (idx + 1) % state_size;
-            state[idx] = rec(state[idx],
-                             state[(idx + 1) % state_size],
-                             state[(idx + param.pos) % state_size]);
+            st[idx] = rec(st[idx],
+                          st[(idx + 1) % state_size],
+                          st[(idx + param.pos) % state_size]);
         }
         /**
          */
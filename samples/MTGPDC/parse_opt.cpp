@@ -33,11 +33,13 @@ bool parse_opt(mtgp_options& opt, int argc, char **argv) {
         {"verbose", no_argument, NULL, 'v'},
         {"output-file", required_argument, NULL, 'f'},
         {"count", required_argument, NULL, 'c'},
+        {"progress", required_argument, NULL, 'p'},
         {NULL, 0, NULL, 0}};
     opt.verbose = false;
     opt.count = 1;
+    opt.progress = 0;
     for (;;) {
-        c = getopt_long(argc, argv, "vs:f:c:", longopts, NULL);
+        c = getopt_long(argc, argv, "vs:f:c:p:", longopts, NULL);
         if (error) {
             break;
         }
@@ -61,6 +63,13 @@ bool parse_opt(mtgp_options& opt, int argc, char **argv) {
                 cerr << "count must be number" << endl;
             }
             break;
+        case 'p':
+            opt.progress = strtod(optarg, NULL);
+            if (errno || opt.progress <= 0) {
+                error = true;
+                cerr << "progress must be a positive number" << endl;
+            }
+            break;
         case '?':
         default:
             error = true;
@@ -107,7 +116,8 @@ bool parse_opt(mtgp_options& opt, int argc, char **argv) {
     }
     if (error) {
         cerr << pgm
-             << " [-v] [-c count] [-s seed_string] [-f outputfile] mexp id"
+             << " [-v] [-c count] [-s seed_string] [-f outputfile]"
+             << " [-p seconds] mexp id"
              << endl;
         cerr << "mexp                   mersenne exponent of search" << endl;
         cerr << "                       the generator will have the period "
@@ -127,6 +137,10 @@ bool parse_opt(mtgp_options& opt, int argc, char **argv) {
              << "standard output." << endl;
         cerr << "--count,-c count       output count. increment id and "
              << "repeat output." << endl;
+        cerr << "--progress,-p seconds  output progress and estimated "
+             << "remaining time" << endl;
+        cerr << "                       to standard error every seconds."
+             << endl;
         return false;
     }
     if (opt.seed.length() == 0) {
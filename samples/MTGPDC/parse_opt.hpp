@@ -27,6 +27,7 @@ public:
     int mexp;
     uint32_t id;
     long long count;
+    double progress;
 };
 
 bool parse_opt(mtgp_options& opt, int argc, char **argv);
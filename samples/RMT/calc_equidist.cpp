@@ -2,6 +2,7 @@
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
 #include <MTToolBox/period.hpp>
+#include <MTToolBox/AnalysisCache.hpp>
 #include <NTL/GF2X.h>
 #include <errno.h>
 #include <stdlib.h>
@@ -11,7 +12,8 @@ using namespace std;
 int main(int argc, char * argv[])
 {
     if (argc <= 1) {
-        cout << argv[0] << "\n mexp,pos,mata,mskb,mskc,parity" << endl;
+        cout << argv[0] << "\n mexp,pos,mata,mskb,mskc,parity [cache-dir]"
+             << endl;
         return 1;
     }
     char * para = argv[1];
@@ -31,33 +33,55 @@ int main(int argc, char * argv[])
     rmt.setParityValue(parity);
     //cout << rmt.getParamString() << endl;
     rmt.seed(1234);
-    GF2X poly;
-    minpoly<uint64_t>(poly, rmt);
-    //cout << "deg poly = " << dec << deg(poly) << endl;
-    GF2X irreducible = poly;
-    //cout << "deg irreducible = " << dec << deg(irreducible) << endl;
-    //cout << "mexp = " << dec << mexp << endl;
-    if (!hasFactorOfDegree(irreducible, mexp)) {
-        cout << "error does not have factor of degree " << dec << mexp
-             << endl;
-        cout << "degree = " << dec << deg(irreducible) << endl;
-        return -1;
+    // キャッシュに結果があれば計算しない
+    AnalysisCache * cache = NULL;
+    AnalysisRecord record;
+    string key;
+    if (argc > 2) {
+        cache = new AnalysisCache(argv[2]);
+        key = AnalysisCache::makeKey("rmt64", rmt.getParamString());
     }
-    calcCharacteristicPolynomial(&rmt, poly);
-    //cout << "deg characteristic = " << dec << deg(poly) << endl;
-    GF2X quotient = poly / irreducible;
-    //cout << "deg irreducible = " << dec << deg(irreducible) << endl;
-    //cout << "deg characteristic = " << dec << deg(poly) << endl;
-    //cout << "deg quotient = " << dec << deg(quotient) << endl;
-    if (!IsZero(quotient)) {
-        annihilate<uint64_t>(&rmt, quotient);
+    int veq[64];
+    if (cache == NULL || !cache->lookup(key, record)
+        || !record.getVeq("veq64", veq, 64)) {
+        GF2X poly;
+        minpoly<uint64_t>(poly, rmt);
+        //cout << "deg poly = " << dec << deg(poly) << endl;
+        record.minpoly = poly;
+        GF2X irreducible = poly;
+        //cout << "deg irreducible = " << dec << deg(irreducible) << endl;
+        //cout << "mexp = " << dec << mexp << endl;
+        if (!hasFactorOfDegree(irreducible, mexp)) {
+            cout << "error does not have factor of degree " << dec << mexp
+                 << endl;
+            cout << "degree = " << dec << deg(irreducible) << endl;
+            delete cache;
+            return -1;
+        }
+        record.factor = irreducible;
+        calcCharacteristicPolynomial(&rmt, poly);
+        //cout << "deg characteristic = " << dec << deg(poly) << endl;
+        GF2X quotient = poly / irreducible;
+        //cout << "deg irreducible = " << dec << deg(irreducible) << endl;
+        //cout << "deg characteristic = " << dec << deg(poly) << endl;
+        //cout << "deg quotient = " << dec << deg(quotient) << endl;
+        if (!IsZero(quotient)) {
+            annihilate<uint64_t>(&rmt, quotient);
+        }
+        minpoly<uint64_t>(poly, rmt);
+        //cout << "deg poly = " << dec << deg(poly) << endl;
+        AlgorithmEquidistribution<uint64_t> re(rmt, 64, mexp);
+        re.get_all_equidist(veq);
+        record.setVeq("veq64", veq, 64);
+        if (cache != NULL) {
+            cache->store(key, record);
+        }
     }
-    minpoly<uint64_t>(poly, rmt);
-    //cout << "deg poly = " << dec << deg(poly) << endl;
+    delete cache;
     int delta = 0;
-    AlgorithmEquidistribution<uint64_t> re(rmt, 64, mexp);
-    int veq[64];
-    delta = re.get_all_equidist(veq);
+    for (int j = 0; j < 64; j++) {
+        delta += mexp / (j + 1) - veq[j];
+    }
     cout << rmt.getParamString();
     cout << "," << dec << delta << endl;
 #if 1
@@ -50,15 +50,24 @@ bool parse_opt(tinymt_options& opt, int argc, char **argv, uint32_t start) {
         {"start", required_argument, NULL, 's'},
         {"max", required_argument, NULL, 'm'},
         {"count", required_argument, NULL, 'c'},
+        {"threads", required_argument, NULL, 't'},
+        {"queue", required_argument, NULL, 'q'},
+        {"ranges", required_argument, NULL, 'n'},
+        {"collect", no_argument, NULL, 'r'},
+        {"limit", required_argument, NULL, 'l'},
         {NULL, 0, NULL, 0}};
     opt.verbose = false;
     opt.count = 1;
     opt.max_delta = 10;
     opt.start = start;
     opt.all = false;
+    opt.threads = 1;
+    opt.ranges = 0;
+    opt.collect = false;
+    opt.limit = 0;
     errno = 0;
     for (;;) {
-        c = getopt_long(argc, argv, "vas:m:f:c:", longopts, NULL);
+        c = getopt_long(argc, argv, "vas:m:f:c:t:q:n:rl:", longopts, NULL);
         if (error) {
             break;
         }
@@ -100,6 +109,33 @@ bool parse_opt(tinymt_options& opt, int argc, char **argv, uint32_t start) {
                 cerr << "count must be a number" << endl;
             }
             break;
+        case 't':
+            opt.threads = static_cast<int>(strtol(optarg, NULL, 10));
+            if (errno || opt.threads < 1) {
+                error = true;
+                cerr << "threads must be a positive number" << endl;
+            }
+            break;
+        case 'q':
+            opt.queue = optarg;
+            break;
+        case 'n':
+            opt.ranges = static_cast<int>(strtol(optarg, NULL, 10));
+            if (errno || opt.ranges < 1) {
+                error = true;
+                cerr << "ranges must be a positive number" << endl;
+            }
+            break;
+        case 'r':
+            opt.collect = true;
+            break;
+        case 'l':
+            opt.limit = strtod(optarg, NULL);
+            if (errno || opt.limit <= 0) {
+                error = true;
+                cerr << "limit must be a positive number" << endl;
+            }
+            break;
         case '?':
         default:
             error = true;
@@ -119,6 +155,10 @@ bool parse_opt(tinymt_options& opt, int argc, char **argv, uint32_t start) {
         }
         opt.uid = static_cast<uint32_t>(id);
     }
+    if (opt.queue.empty() && (opt.ranges > 0 || opt.collect)) {
+        error = true;
+        cerr << "ranges and collect need queue" << endl;
+    }
     if (!opt.filename.empty()) {
         ofstream ofs(opt.filename.c_str());
         if (ofs) {
@@ -143,7 +183,8 @@ static void output_help(string& pgm, uint32_t start) {
     cerr << "usage:" << endl;
     cerr << pgm
          << " [-v] [-c count] [-a] [-s start_pos] [-m max-delta]"
-         << " [-f outputfile]"
+         << " [-f outputfile] [-t threads]"
+         << " [-q queue [-n ranges | -r]] [-l seconds]"
          << " id" << endl;
     static string help_string1 = "\n"
 "id                   ID of generator. the parameters searched with different\n"
@@ -159,6 +200,20 @@ static void output_help(string& pgm, uint32_t start) {
 "--max, -m max-delta  Search parameters whose total dimension defect is\n"
 "                     smaller than or equal to max-delta. if 0 is specified,\n"
 "                     search parameters for maximally equidistributed\n"
-"                     generators.";
+"                     generators.\n"
+"--threads, -t num    Search by a pipeline of num threads. Parameters are\n"
+"                     outputted in the order they are found.\n"
+"--queue, -q file     Search as a worker of the work queue file. Several\n"
+"                     processes can share a search by the same queue.\n"
+"                     Parameters are reported to the queue, and workers\n"
+"                     stop when count parameters are reported in total.\n"
+"--ranges, -n num     Create the work queue which divides the search range\n"
+"                     into num ranges, and exit.\n"
+"--collect, -r        Output parameters reported to the work queue in the\n"
+"                     order of search.\n"
+"--limit, -l seconds  Stop searching after seconds, and output parameters\n"
+"                     found so far. SIGTERM and SIGINT also stop searching.\n"
+"                     A queue worker returns the rest of its range to the\n"
+"                     queue.";
     cerr << help_string1 << "0x" << hex << start << help_string2 << endl;
 }
@@ -32,6 +32,11 @@ public:
     long long count;
     uint32_t start;
     int max_delta;
+    int threads;
+    std::string queue;
+    int ranges;
+    bool collect;
+    double limit;
 };
 
 bool parse_opt(tinymt_options& opt, int argc, char **argv, uint32_t start);
@@ -26,8 +26,12 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
 #include <MTToolBox/AlgorithmRecursionAndTempering.hpp>
+#include <MTToolBox/AlgorithmPipelinedSearch.hpp>
 #include <MTToolBox/Sequential.hpp>
+#include <MTToolBox/WorkQueue.hpp>
+#include <MTToolBox/Cancellation.hpp>
 #include "tinymt32search.hpp"
 #include "parse_opt.hpp"
 
@@ -37,6 +41,9 @@ using namespace tinymt;
 static const uint32_t sequence_max = 0x7fffffff;
 
 int search(tinymt_options& opt, int count);
+int pipelined_search(tinymt_options& opt, int count);
+int queue_search(tinymt_options& opt, int count);
+int queue_collect(tinymt_options& opt, int count);
 const std::string toString(GF2X& poly);
 
 /**
@@ -52,9 +59,25 @@ int main(int argc, char** argv) {
         return -1;
     }
     try {
+        if (opt.ranges > 0) {
+            WorkQueue::create(opt.queue, opt.start, 0, opt.ranges);
+            return 0;
+        }
+        if (opt.collect) {
+            return queue_collect(opt, static_cast<int>(opt.count));
+        }
+        if (!opt.queue.empty()) {
+            return queue_search(opt, static_cast<int>(opt.count));
+        }
+        if (opt.threads > 1) {
+            return pipelined_search(opt, static_cast<int>(opt.count));
+        }
         return search(opt, static_cast<int>(opt.count));
     } catch (underflow_error &e) {
         return 0;
+    } catch (runtime_error &e) {
+        cerr << e.what() << endl;
+        return -1;
     }
 }
 
@@ -73,12 +96,22 @@ int search(tinymt_options& opt, int count) {
         cout << "search start at " << ctime(&t);
         cout << "id:" << dec << opt.uid << endl;
     }
+    CancellationToken token;
+    CancellationToken::handleSignals();
+    if (opt.limit > 0) {
+        token.setTimeLimit(opt.limit);
+    }
     AlgorithmRecursionAndTempering<uint32_t> all(sq);
+    all.setCancellation(&token);
     st32 st;
     stlsb32 stlsb;
     int i = 0;
     while (i < count || opt.all) {
         if (all.search(g, st, stlsb, opt.verbose)) {
+            if (!all.isComplete()) {
+                cerr << "search cancelled while tempering" << endl;
+                break;
+            }
             int delta = all.getDelta();
             if (delta > opt.max_delta) {
                 continue;
@@ -103,6 +136,9 @@ int search(tinymt_options& opt, int count) {
                                                     opt, i == 0);
 #endif
             i++;
+        } else if (token.isCancelled()) {
+            cerr << "search cancelled" << endl;
+            break;
         } else {
             cout << "search failed" << endl;
             break;
@@ -115,6 +151,196 @@ int search(tinymt_options& opt, int count) {
     return 0;
 }
 
+/**
+ * 見つかったパラメータを出力する
+ */
+class Printer : public PipelineResultHandler<uint32_t> {
+public:
+    Printer(tinymt_options& opt, int count) : opt(opt), count(count) {
+        i = 0;
+    }
+    bool operator()(TemperingCalculatable<uint32_t>& lg,
+                    const GF2X& poly, int weight, int delta,
+                    const int veq[]) {
+        UNUSED_VARIABLE(&veq);
+        if (delta > opt.max_delta) {
+            return true;
+        }
+        if (i == 0) {
+            cout << "# characteristic, "
+                 << lg.getHeaderString()
+                 << ", weight, delta"
+                 << endl;
+        }
+        GF2X p = poly;
+        cout << toString(p) << ","
+             << lg.getParamString()
+             << dec << weight << "," << delta
+             << endl;
+        i++;
+        return i < count || opt.all;
+    }
+private:
+    tinymt_options& opt;
+    int count;
+    int i;
+};
+
+/**
+ * search parameters using pipeline
+ * @param opt command line options
+ * @param count number of parameters user requested
+ * @return 0 if this ends normally
+ */
+int pipelined_search(tinymt_options& opt, int count) {
+    Sequential<uint32_t> sq(0, opt.start);
+    tinymt32 g(opt.uid);
+
+    if (opt.verbose) {
+        time_t t = time(NULL);
+        cout << "search start at " << ctime(&t);
+        cout << "id:" << dec << opt.uid << endl;
+        cout << "threads:" << dec << opt.threads << endl;
+    }
+    int tempering_workers = opt.threads / 2;
+    if (tempering_workers < 1) {
+        tempering_workers = 1;
+    }
+    vector<AlgorithmTempering<uint32_t> *> st;
+    vector<AlgorithmTempering<uint32_t> *> stlsb;
+    for (int j = 0; j < tempering_workers; j++) {
+        st.push_back(new st32);
+        stlsb.push_back(new stlsb32);
+    }
+    CancellationToken token;
+    CancellationToken::handleSignals();
+    if (opt.limit > 0) {
+        token.setTimeLimit(opt.limit);
+    }
+    AlgorithmPipelinedSearch<uint32_t> all(sq, opt.threads);
+    all.setCancellation(&token);
+    Printer printer(opt, count);
+    all.search(g, st, stlsb, printer);
+    if (token.isCancelled()) {
+        cerr << "search cancelled" << endl;
+    }
+    for (int j = 0; j < tempering_workers; j++) {
+        delete st[j];
+        delete stlsb[j];
+    }
+    if (opt.verbose) {
+        time_t t = time(NULL);
+        cout << "count = " << dec << all.getCount() << endl;
+        cout << "search end at " << ctime(&t) << endl;
+    }
+    return 0;
+}
+
+/**
+ * search parameters as a worker of the work queue
+ *
+ * Ranges are taken from the queue and searched, and found parameters
+ * are reported to the queue. When count distinct parameters are
+ * reported in total, or the search is cancelled, the rest of the
+ * range is returned to the queue.
+ * @param opt command line options
+ * @param count number of parameters user requested
+ * @return 0 if this ends normally
+ */
+int queue_search(tinymt_options& opt, int count) {
+    WorkQueue queue(opt.queue);
+    tinymt32 g(opt.uid);
+    st32 st;
+    stlsb32 stlsb;
+    WorkItem item;
+    CancellationToken token;
+    CancellationToken::handleSignals();
+    if (opt.limit > 0) {
+        token.setTimeLimit(opt.limit);
+    }
+    bool stop = !opt.all
+        && queue.getReported() >= static_cast<uint64_t>(count);
+    while (!stop && !token.isCancelled() && queue.claim(item)) {
+        Sequential<uint32_t> sq(0, static_cast<uint32_t>(item.start),
+                                static_cast<uint32_t>(item.floor));
+        AlgorithmRecursionAndTempering<uint32_t> all(sq);
+        all.setCancellation(&token);
+        uint64_t found = 0;
+        bool cut = false;
+        if (opt.verbose) {
+            cout << "range " << dec << item.index << " from 0x"
+                 << hex << item.start << endl;
+        }
+        try {
+            while (!stop) {
+                if (!all.search(g, st, stlsb, opt.verbose)) {
+                    break;
+                }
+                if (!all.isComplete()) {
+                    cut = true;
+                    break;
+                }
+                if (all.getDelta() > opt.max_delta) {
+                    continue;
+                }
+                GF2X poly = all.getCharacteristicPolynomial();
+                stringstream ss;
+                ss << toString(poly) << ","
+                   << g.getParamString()
+                   << dec << all.getWeight() << "," << all.getDelta();
+                // duplicates from a reclaimed range are not counted
+                uint64_t unique = queue.report(item, sq.getLast(), ss.str());
+                found++;
+                stop = !opt.all && unique >= static_cast<uint64_t>(count);
+            }
+        } catch (underflow_error &e) {
+        }
+        if (sq.isExhausted() && !cut) {
+            queue.complete(item, item.start - item.floor + 1, found);
+        } else {
+            // the parameter whose tempering was cancelled is searched again
+            uint64_t status = cut ? sq.getLast() : sq.getStatus();
+            queue.release(item, status, item.start - status, found);
+        }
+    }
+    if (token.isCancelled()) {
+        cerr << "search cancelled" << endl;
+    }
+    return 0;
+}
+
+/**
+ * output parameters reported to the work queue in the order of search
+ * @param opt command line options
+ * @param count number of parameters user requested
+ * @return 0 if this ends normally
+ */
+int queue_collect(tinymt_options& opt, int count) {
+    WorkQueue queue(opt.queue);
+    tinymt32 g(opt.uid);
+    vector<pair<uint64_t, string> > results;
+    queue.collect(results);
+    cout << "# characteristic, "
+         << g.getHeaderString()
+         << ", weight, delta"
+         << endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!opt.all && i >= static_cast<size_t>(count)) {
+            break;
+        }
+        cout << results[i].second << endl;
+    }
+    if (opt.verbose) {
+        uint64_t tried;
+        uint64_t found;
+        queue.getStatistics(tried, found);
+        cout << "tried = " << dec << tried << endl;
+        cout << "found = " << dec << found << endl;
+        cout << "done = " << (queue.isAllDone() ? "yes" : "no") << endl;
+    }
+    return 0;
+}
+
 const std::string toString(GF2X& poly) {
     uint64_t p1;
     uint64_t p2;
@@ -8,6 +8,8 @@
 #include <MTToolBox/AlgorithmRecursionSearch.hpp>
 #include <MTToolBox/AlgorithmPrimitivity.hpp>
 #include <MTToolBox/Sequential.hpp>
+#include <MTToolBox/SequentialShards.hpp>
+#include <MTToolBox/Parallel.hpp>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
@@ -176,9 +178,73 @@ void search(Sequential<uint32_t>& seq,
     }
 }
 
-int main() {
-    Sequential<uint32_t> seq(0, 0x3ffff);
+/*
+ * シャードごとに探索する。各スレッドは自分の XorShift を使い、
+ * AlgorithmPrimitivity は共有する。
+ */
+class ShardSearch : public Runnable {
+public:
+    ShardSearch(SequentialShards<uint32_t>& shards, AlgorithmPrimitivity& ap)
+        : shards(shards), ap(ap) {}
+    void run(int) {
+        for (int i = shards.claim(); i >= 0; i = shards.claim()) {
+            Sequential<uint32_t> * seq = shards.newShard(i);
+            if (seq == NULL) {
+                continue;
+            }
+            XorShift xs(1);
+            AlgorithmRecursionSearch<uint32_t> rs(xs, *seq, ap);
+            try {
+                for (;;) {
+                    if (rs.start(0x3ffff)) {
+                        AlgorithmEquidistribution<uint32_t> eq(xs, 32);
+                        int veq[32];
+                        int delta = eq.get_all_equidist(veq);
+                        stringstream ss;
+                        ss << dec << delta << ":" << xs.getParamString();
+                        ScopedLock lock(mutex);
+                        results.push_back(make_pair(seq->getLast(),
+                                                    ss.str()));
+                    }
+                }
+            } catch (underflow_error &e) {
+            }
+            shards.checkpoint(i, *seq);
+            delete seq;
+        }
+    }
+    vector<pair<uint32_t, string> > results;
+private:
+    SequentialShards<uint32_t>& shards;
+    AlgorithmPrimitivity& ap;
+    Mutex mutex;
+};
+
+/*
+ * 引数にスレッド数を与えると範囲を分割して並列に探索する。
+ * 出力は分割しないときと同じ順番になる。
+ */
+int main(int argc, char * argv[]) {
+    int threads = 1;
+    if (argc > 1) {
+        threads = atoi(argv[1]);
+    }
     AlgorithmPrimitivity ap(prime_factors2_128_1);
+    if (threads > 1) {
+        SequentialShards<uint32_t> shards(0, 0x3ffff, 0, threads * 4);
+        ShardSearch job(shards, ap);
+        WorkerPool pool;
+        pool.start(job, threads);
+        pool.join();
+        SequentialShards<uint32_t>::merge(job.results);
+        XorShift xs(1);
+        cout << "delta:" << xs.getHeaderString() << endl;
+        for (size_t i = 0; i < job.results.size(); i++) {
+            cout << job.results[i].second << endl;
+        }
+        return 0;
+    }
+    Sequential<uint32_t> seq(0, 0x3ffff);
     bool first = true;
     try {
         for(;;) {
@@ -3,6 +3,8 @@
 #include <NTL/GF2X.h>
 #include <MTToolBox/period.hpp>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
+#include <MTToolBox/BerlekampMassey.hpp>
+#include <MTToolBox/Parallel.hpp>
 
 using namespace NTL;
 using namespace std;
@@ -56,13 +58,26 @@ void getLCMPoly(GF2X& lcm, const dSFMT& sf)
     }
 }
 
+/*
+ * lung の 128 ビットそれぞれの数列を一度の生成で作り、
+ * 最小多項式の LCM を並列に求める
+ */
 static void lungLCM(GF2X& lcm, dSFMT& sf)
 {
-    GF2X poly;
-    for (int i = 0; i < 128; i++) {
-        minPolyLung(poly, sf, i);
-        LCM(lcm, lcm, poly);
+    long length = 2 * sf.bitSize();
+    vector<vector<uint64_t> > sequences(128,
+                                        vector<uint64_t>(length / 64 + 1, 0));
+    for (long i = 0; i < length; i++) {
+        sf.generate();
+        w128_t w = sf.getParityValue();
+        for (int j = 0; j < 128; j++) {
+            if (getBitOfPos(w, j)) {
+                sequences[j][i / 64] |= UINT64_C(1) << (i % 64);
+            }
+        }
     }
+    lcm_minpoly_sequences(lcm, sequences, length, sf.bitSize(),
+                          WorkerPool::hardwareConcurrency());
 }
 
 static void minPolyLung(GF2X& poly, dSFMT& sf, int pos)
@@ -3,6 +3,7 @@
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
 #include <MTToolBox/period.hpp>
+#include <MTToolBox/AnalysisCache.hpp>
 #include <NTL/GF2X.h>
 #include <errno.h>
 #include <stdlib.h>
@@ -17,6 +18,7 @@ public:
     bool verbose;
     bool reverse;
     uint64_t seed;
+    string cache;
     dSFMT_param params;
 };
 
@@ -52,16 +54,36 @@ int main(int argc, char * argv[])
     }
     sf.d_p();
 #endif
-    if (!anni(sf)) {
-        return -1;
+    // キャッシュに結果があれば計算しない
+    AnalysisCache * cache = NULL;
+    AnalysisRecord record;
+    string key;
+    if (!opt.cache.empty()) {
+        cache = new AnalysisCache(opt.cache);
+        key = AnalysisCache::makeKey("dSFMT", sf.getParamString());
     }
-    int delta52 = 0;
     int veq52[52];
-    DSFMTInfo info;
-    info.bitSize = 128; // IMPORTANT
-    info.elementNo = 2;
-    delta52 = calc_dSFMT_equidistribution<w128_t, dSFMT>(sf, veq52, 52, info,
-                                                         opt.params.mexp);
+    if (cache == NULL || !cache->lookup(key, record)
+        || !record.getVeq("veq52", veq52, 52)) {
+        if (!anni(sf)) {
+            delete cache;
+            return -1;
+        }
+        DSFMTInfo info;
+        info.bitSize = 128; // IMPORTANT
+        info.elementNo = 2;
+        calc_dSFMT_equidistribution<w128_t, dSFMT>(sf, veq52, 52, info,
+                                                   opt.params.mexp);
+        record.setVeq("veq52", veq52, 52);
+        if (cache != NULL) {
+            cache->store(key, record);
+        }
+    }
+    delete cache;
+    int delta52 = 0;
+    for (int j = 0; j < 52; j++) {
+        delta52 += opt.params.mexp / (j + 1) - veq52[j];
+    }
     cout << sf.getParamString();
     cout << dec << delta52 << endl;
     if (opt.verbose) {
@@ -108,16 +130,18 @@ static void printBinary(FILE *fp, GF2X& poly)
 static bool parse_opt(options& opt, int argc, char **argv) {
     opt.verbose = false;
     opt.seed = (uint64_t)clock();
+    opt.cache = "";
     int c;
     bool error = false;
     string pgm = argv[0];
     static struct option longopts[] = {
         {"verbose", no_argument, NULL, 'v'},
         {"seed", required_argument, NULL, 's'},
+        {"cache", required_argument, NULL, 'c'},
         {NULL, 0, NULL, 0}};
     errno = 0;
     for (;;) {
-        c = getopt_long(argc, argv, "vs:", longopts, NULL);
+        c = getopt_long(argc, argv, "vs:c:", longopts, NULL);
         if (error) {
             break;
         }
@@ -135,6 +159,9 @@ static bool parse_opt(options& opt, int argc, char **argv) {
         case 'v':
             opt.verbose = true;
             break;
+        case 'c':
+            opt.cache = optarg;
+            break;
         case '?':
         default:
             error = true;
@@ -179,12 +206,14 @@ static void output_help(string& pgm)
 {
     cerr << "usage:" << endl;
     cerr << pgm
-         << " [-v] [-r]"
+         << " [-v] [-r] [-c cache-dir]"
          << " mexp,pos1,sl1,msk1,msk2,fix1,fix2,"
          << "parity1,parity2"
          << endl;
     static string help_string1 = "\n"
 "--verbose, -v        Verbose mode. Output detailed information.\n"
+"--cache, -c dir      Cache directory. Results saved in the directory are\n"
+"                     used instead of calculation.\n"
         ;
     cerr << help_string1 << endl;
 }
@@ -16,30 +16,34 @@ using namespace std;
 w128_t calc_fixpoint(const dSFMT& dsfmt, const GF2X& irreducible,
                      const GF2X& quotient)
 {
-    GF2X a, b, d;
-    dSFMT dsfmt_const(dsfmt);
-    /* a*irreducible + b*quotient = d */
-    XGCD(d, a, b, irreducible, quotient);
-    if (deg(d) != 0) {
-        cout << "failure d != 1" << endl;
-        throw new logic_error("failure d != 1");
-    }
-    b *= quotient;
-    a *= irreducible;
-    dsfmt_const.setConst();
-    annihilate<w128_t>(&dsfmt_const, b);
+    ReducibleAnalysis<w128_t, dSFMT> analysis(dsfmt, irreducible,
+                                              irreducible * quotient);
+    return calc_fixpoint(dsfmt, analysis);
+}
 
+/*
+ * 定数ベクトルを q で殲滅される成分を消す射影と (t + 1) の f を法と
+ * した逆元で順に殲滅していたが、二つの積を h を法として求めて一度だけ
+ * 殲滅する。
+ */
+w128_t calc_fixpoint(const dSFMT& dsfmt,
+                     ReducibleAnalysis<w128_t, dSFMT>& analysis)
+{
+    dSFMT dsfmt_const(dsfmt);
     GF2X t1(1, 1);
     SetCoeff(t1, 0);
-    /* a*irreducible + b*t1 = d */
-    XGCD(d, a, b, irreducible, t1);
-    if (deg(d) != 0) {
+    GF2X inverse;
+    try {
+        analysis.inverseModIrreducible(inverse, t1);
+    } catch (logic_error& e) {
         cout << "failure d != 1" << endl;
-        cout << "deg(d) = " << dec << deg(d) << endl;
-        cout << "deg(irreducible) = " << dec << deg(irreducible) << endl;
-        cout << "deg(t1) = " << dec << deg(t1) << endl;
-        throw new logic_error("failure d != 1");
+        cout << "deg(irreducible) = " << dec
+             << deg(analysis.getIrreducibleFactor()) << endl;
+        throw;
     }
-    annihilate<w128_t>(&dsfmt_const, b);
+    GF2X poly;
+    analysis.multiply(poly, analysis.getProjector(), inverse);
+    dsfmt_const.setConst();
+    analysis.apply(dsfmt_const, poly);
     return dsfmt_const.getParityValue();
 }
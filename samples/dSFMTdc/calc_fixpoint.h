@@ -2,9 +2,14 @@
 #ifndef CALC_FIXPOINT_H
 #define CALC_FIXPOINT_H
 #include <NTL/GF2X.h>
+#include <MTToolBox/ReducibleAnalysis.hpp>
 #include "dSFMTsearch.hpp"
 
 MTToolBox::w128_t calc_fixpoint(const MTToolBox::dSFMT& dsfmt,
                                 const NTL::GF2X& irreducible,
                                 const NTL::GF2X& quotient);
+MTToolBox::w128_t calc_fixpoint(
+    const MTToolBox::dSFMT& dsfmt,
+    MTToolBox::ReducibleAnalysis<MTToolBox::w128_t,
+                                 MTToolBox::dSFMT>& analysis);
 #endif
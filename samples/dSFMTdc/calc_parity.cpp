@@ -18,7 +18,8 @@ using namespace std;
 
 w128_t calc_parity(dSFMT& dsfmt, const GF2X& irreducible)
 {
-    AlgorithmCalculateParity<w128_t, dSFMT> cp;
+    AlgorithmCalculateParity<w128_t, dSFMT>
+        cp(WorkerPool::hardwareConcurrency());
     cp.searchParity(dsfmt, irreducible);
     return dsfmt.getParityValue();
 }
@@ -26,8 +26,9 @@
 #include <sstream>
 #include <fstream>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
-#include <MTToolBox/AlgorithmCalculateParity.hpp>
+#include <MTToolBox/ReducibleAnalysis.hpp>
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
+#include <MTToolBox/AlgorithmFieldEquidistribution.hpp>
 #include <MTToolBox/MersenneTwister64.hpp>
 #include <NTL/GF2X.h>
 #include <getopt.h>
@@ -44,6 +45,7 @@ class options {
 public:
     int mexp;
     bool verbose;
+    bool exact;
     bool fixed;
     int fixedSL1;
     uint64_t seed;
@@ -92,9 +94,14 @@ int search(options& opt, int count) {
     }
     AlgorithmReducibleRecursionSearch<w128_t> ars(g, mt);
     int i = 0;
-    AlgorithmCalculateParity<w128_t, dSFMT> cp;
-    cout << "# " << g.getHeaderString() << ", delta52"
-         << endl;
+    // 並列の殲滅では、ワーカーごとに生成器の複製を二つ持つ
+    int threads = CpuTopology::system().concurrencyFor(
+        CpuTopology::workingSet(g.bitSize(), 2));
+    cout << "# " << g.getHeaderString() << ", delta52";
+    if (opt.exact) {
+        cout << ", exact52";
+    }
+    cout << endl;
     while (i < count) {
         if (ars.start(opt.mexp * 100)) {
             GF2X irreducible = ars.getIrreducibleFactor();
@@ -102,31 +109,48 @@ int search(options& opt, int count) {
             //cout << "deg irreducible = " << dec << deg(irreducible) << endl;
             //cout << "deg characteristic = " << dec << deg(characteristic)
             //     << endl;
-            //cout << "deg quotient = " << dec << deg(quotient) << endl;
             if (deg(irreducible) != opt.mexp) {
                 cout << "error" << endl;
                 return -1;
             }
             getLCMPoly(characteristic, g);
-            GF2X quotient = characteristic / irreducible;
-            w128_t fixpoint = calc_fixpoint(g, irreducible, quotient);
+            ReducibleAnalysis<w128_t, dSFMT> analysis(g, irreducible,
+                                                      characteristic,
+                                                      threads);
+            w128_t fixpoint = calc_fixpoint(g, analysis);
             g.setFixPoint(fixpoint);
-            cp.searchParity(g, irreducible);
+            analysis.getParity(g);
             w128_t seed = {{1, 0, 0, 0}};
             g.seed(seed);
-            if (!anni(g)) {
+            analysis.annihilateQuotient(g);
+            // 殲滅後の状態の最小多項式は f になるはずである。状態が 0 に
+            // なるなどしてそうならなければ、パラメータを出力せずに終わる
+            dSFMT annihilated(g);
+            GF2X minimal;
+            minpoly<w128_t>(minimal, annihilated);
+            if (deg(minimal) != opt.mexp) {
+                cout << "error annihilated state does not have degree "
+                     << dec << opt.mexp << endl;
                 return -1;
             }
-            annihilate<w128_t>(&g, quotient);
             int veq52[52];
             DSFMTInfo info;
             info.bitSize = 128;
             info.elementNo = 2;
-            int delta52
-                = calc_dSFMT_equidistribution<w128_t, dSFMT>(g, veq52, 52, info,
-                                                           opt.mexp);
+            int delta52 = calc_dSFMT_equidistribution<w128_t, dSFMT>(
+                g, veq52, 52, info, opt.mexp);
             cout << g.getParamString();
-            cout << dec << delta52 << endl;
+            cout << dec << delta52;
+            if (opt.exact) {
+                // PIS 法の k(v) は厳密な値の下界なので、出力行列の階数から
+                // 求めた値を別の列に出す。各 64 ビットの下位 52 ビットが
+                // 仮数部
+                AlgorithmFieldEquidistribution<w128_t> field(g, 2, 51, 52,
+                                                             opt.mexp);
+                int exact52 = field.get_all_equidist(veq52);
+                cout << "," << dec << exact52;
+            }
+            cout << endl;
             i++;
         } else {
             cout << "search failed" << endl;
@@ -135,6 +159,11 @@ int search(options& opt, int count) {
     }
     if (opt.verbose) {
         time_t t = time(NULL);
+        const FactorStatistics& stat = ars.getFactorStatistics();
+        cout << "factor check: " << dec << stat.calls << " calls, "
+             << stat.squarings << " squarings, " << stat.gcds << " gcds, "
+             << (stat.calls > 0 ? stat.microseconds / stat.calls : 0)
+             << " usec per call" << endl;
         cout << "search end at " << ctime(&t) << endl;
     }
     return 0;
@@ -152,6 +181,7 @@ static void output_help(string& pgm);
  */
 bool parse_opt(options& opt, int argc, char **argv) {
     opt.verbose = false;
+    opt.exact = false;
     opt.mexp = 0;
     opt.count = 1;
     opt.seed = (uint64_t)clock();
@@ -163,6 +193,7 @@ bool parse_opt(options& opt, int argc, char **argv) {
     string pgm = argv[0];
     static struct option longopts[] = {
         {"verbose", no_argument, NULL, 'v'},
+        {"exact", no_argument, NULL, 'e'},
         {"file", required_argument, NULL, 'f'},
         {"count", required_argument, NULL, 'c'},
         {"seed", required_argument, NULL, 's'},
@@ -170,7 +201,7 @@ bool parse_opt(options& opt, int argc, char **argv) {
         {NULL, 0, NULL, 0}};
     errno = 0;
     for (;;) {
-        c = getopt_long(argc, argv, "vs:f:c:x::", longopts, NULL);
+        c = getopt_long(argc, argv, "ves:f:c:x::", longopts, NULL);
         if (error) {
             break;
         }
@@ -201,6 +232,9 @@ bool parse_opt(options& opt, int argc, char **argv) {
         case 'v':
             opt.verbose = true;
             break;
+        case 'e':
+            opt.exact = true;
+            break;
         case 'f':
             opt.filename = optarg;
             break;
@@ -272,12 +306,16 @@ bool parse_opt(options& opt, int argc, char **argv) {
 static void output_help(string& pgm) {
     cerr << "usage:" << endl;
     cerr << pgm
-         << " [-s seed] [-v] [-c count]"
-         << " [-f outputfile]"
+         << " [-s seed] [-v] [-e] [-c count]"
+         << " [-f outputfile] [-x [fixedSL]]"
          << " mexp"
          << endl;
     static string help_string1 = "\n"
 "--verbose, -v        Verbose mode. Output parameters, calculation time, etc.\n"
+"--exact, -e          Output also exact52, the dimension of equidistribution\n"
+"                     of the mantissa computed from the rank of the output\n"
+"                     matrix. delta52 is computed by the lattice method and\n"
+"                     may be larger than exact52.\n"
 "--file, -f filename  Parameters are outputted to this file. without this\n"
 "                     option, parameters are outputted to standard output.\n"
 "--count, -c count    Output count. The number of parameters to be outputted.\n"
@@ -28,6 +28,7 @@
 #include <MTToolBox/ReducibleGenerator.hpp>
 #include <MTToolBox/MersenneTwister64.hpp>
 #include <MTToolBox/util.hpp>
+#include <MTToolBox/CowBuffer.hpp>
 #include "w128.hpp"
 
 /**
@@ -89,16 +90,30 @@ namespace MTToolBox {
         }
 
         /**
-         * This method is used in output.hpp.
-         * @return string of parameters
+         * This method is used as the key of rejected parameters.
+         * fix and parity are excluded, because they are calculated
+         * after the parameters are found.
+         * @return string of parameters of the recursion
          */
-        const string get_string() const {
+        const string get_recursion_string() const {
             stringstream ss;
             ss << dec << mexp << ",";
             ss << dec << pos1 << ",";
             ss << dec << sl1 << ",";
             ss << hex << setw(16) << setfill('0') << msk1 << ",";
             ss << hex << setw(16) << setfill('0') << msk2 << ",";
+            string s;
+            ss >> s;
+            return s;
+        }
+
+        /**
+         * This method is used in output.hpp.
+         * @return string of parameters
+         */
+        const string get_string() const {
+            stringstream ss;
+            ss << get_recursion_string();
             ss << hex << setw(16) << setfill('0') << fix1 << ",";
             ss << hex << setw(16) << setfill('0') << fix2 << ",";
             ss << hex << setw(16) << setfill('0') << parity1 << ",";
@@ -148,7 +163,7 @@ namespace MTToolBox {
          */
         dSFMT(int mexp) {
             size = (mexp - 128) / 104 + 1;
-            state = new w128_t[static_cast<unsigned long>(size)];
+            state = CowBuffer<w128_t>(static_cast<size_t>(size));
             param.mexp = mexp;
             param.pos1 = 0;
             param.sl1 = 0;
@@ -168,20 +183,12 @@ namespace MTToolBox {
             fixedSL1 = 0;
         }
 
-        ~dSFMT() {
-            delete[] state;
-        }
-
         /**
          * The copy constructor.
          * @param src The origin of copy.
          */
-        dSFMT(const dSFMT& src) : param(src.param) {
+        dSFMT(const dSFMT& src) : state(src.state), param(src.param) {
             size = src.size;
-            state = new w128_t[static_cast<unsigned long>(size)];
-            for (int i = 0; i < size; i++) {
-                state[i] = src.state[i];
-            }
             lung = src.lung;
             index = src.index;
             start_mode = src.start_mode;
@@ -198,12 +205,7 @@ namespace MTToolBox {
          */
         dSFMT(const dSFMT_param& src_param) : param(src_param) {
             size = (src_param.mexp - 128) / 104 + 1;
-            state = new w128_t[static_cast<unsigned long>(size)];
-            for (int i = 0; i < size; i++) {
-                for (int j = 0; j < 2; j++) {
-                    state[i].u64[j] = 0;
-                }
-            }
+            state = CowBuffer<w128_t>(static_cast<size_t>(size));
             index = 0;
             start_mode = 0;
             weight_mode = 2;
@@ -275,10 +277,11 @@ namespace MTToolBox {
          * Important state transition function.
          */
         void next_state() {
+            w128_t * st = state.writable();
             index = (index + 1) % size;
-            do_recursion(&state[index],
-                         &state[index],
-                         &state[(index + param.pos1) % size],
+            do_recursion(&st[index],
+                         &st[index],
+                         &st[(index + param.pos1) % size],
                          &lung);
         }
 
@@ -391,11 +394,7 @@ namespace MTToolBox {
         }
 
         void setZero() {
-            for (int i = 0; i < size; i++) {
-                for (int j = 0; j < 2; j++) {
-                    state[i].u64[j] = 0;
-                }
-            }
+            state.setZero();
             lung.u64[0] = 0;
             lung.u64[1] = 0;
             index = 0;
@@ -470,10 +469,12 @@ namespace MTToolBox {
         }
 
         void add(const dSFMT * that) {
+            w128_t * st = state.writable();
+            const w128_t * src = that->state.data();
             for (int i = 0; i < size; i++) {
                 for (int j = 0; j < 2; j++) {
-                    state[(i + index) % size].u64[j]
-                        ^= that->state[(i + that->index) % size].u64[j];
+                    st[(i + index) % size].u64[j]
+                        ^= src[(i + that->index) % size].u64[j];
                 }
             }
             lung ^= that->lung;
@@ -496,6 +497,10 @@ namespace MTToolBox {
             return param.get_string();
         }
 
+        const std::string getRecursionKey() {
+            return param.get_recursion_string();
+        }
+
         /**
          * This method is called by the functions in search_temper.hpp
          * to calculate the equidistribution properties from LSB
@@ -535,10 +540,12 @@ namespace MTToolBox {
                 || (lung.u64[1] != that.lung.u64[1])) {
                 return false;
             }
+            const w128_t * st = state.data();
+            const w128_t * src = that.state.data();
             for (int i = 0; i < size; i++) {
                 for (int j = 0; j < 2; j++) {
-                    if (state[(index + i) % size].u64[j]
-                        != that.state[(that.index + i) % size].u64[j]) {
+                    if (st[(index + i) % size].u64[j]
+                        != src[(that.index + i) % size].u64[j]) {
                         return false;
                     }
                 }
@@ -615,14 +622,15 @@ namespace MTToolBox {
         }
         void setup_prefix() {
             const uint64_t clear = UINT64_C(0x000fffffffffffff);
+            w128_t * st = state.writable();
             for (int i = 0; i < size; i++) {
-                state[i].u64[0] &= clear;
-                state[i].u64[1] &= clear;
+                st[i].u64[0] &= clear;
+                st[i].u64[1] &= clear;
             }
             if (prefix != 0) {
                 for (int i = 0; i < size; i++) {
-                    state[i].u64[0] |= prefix;
-                    state[i].u64[1] |= prefix;
+                    st[i].u64[0] |= prefix;
+                    st[i].u64[1] |= prefix;
                 }
             }
         }
@@ -633,7 +641,7 @@ namespace MTToolBox {
         int index;
         int start_mode;
         int weight_mode;
-        w128_t * state;
+        CowBuffer<w128_t> state;
         w128_t lung;
         dSFMT_param param;
         w128_t previous;
@@ -0,0 +1,111 @@
+/**
+ * @file test_field.cpp
+ *
+ * @brief compare k(v) of the mantissa by AlgorithmFieldEquidistribution
+ * with calc_dSFMT_equidistribution.
+ *
+ * With -e, dSFMTdc outputs exact52 by AlgorithmFieldEquidistribution
+ * next to delta52. calc_dSFMT_equidistribution finds k(v) as a multiple of
+ * two outputs, and an odd k(v) only as one less than that multiple,
+ * so it is a lower bound of the exact k(v). The values must agree
+ * where k(v) is even, and differ at most by one where k(v) is odd.
+ *
+ * @author Mutsuo Saito (Hiroshima University)
+ * @author Makoto Matsumoto (The University of Tokyo)
+ *
+ * Copyright (C) 2013 Mutsuo Saito, Makoto Matsumoto
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include "dSFMTsearch.hpp"
+#include "AlgorithmDSFMTEquidistribution.hpp"
+#include <MTToolBox/AlgorithmFieldEquidistribution.hpp>
+#include <stdlib.h>
+#include "Annihilate.h"
+
+using namespace MTToolBox;
+using namespace std;
+
+static const char * params[] = {
+    // dSFMT-521 and dSFMT-1279 of the original distribution
+    "521,3,25,000fbfefff77efff,000ffeebfbdfbfdf,"
+    "cfb393d661638469,c166867883ae2adb,ccaa588000000000,0000000000000001",
+    "1279,9,19,000efff7ffddffee,000fbffffff77fff,"
+    "b66627623d1a31be,04b6c51147b6109b,7049f2da382a6aeb,de4ca84a40000001"
+};
+
+static void parse(dSFMT_param& param, const char * str)
+{
+    char * para = const_cast<char *>(str);
+    param.mexp = static_cast<int>(strtoul(para, &para, 10));
+    para++;
+    param.pos1 = static_cast<int>(strtoul(para, &para, 10));
+    para++;
+    param.sl1 = static_cast<int>(strtoul(para, &para, 10));
+    para++;
+    param.msk1 = static_cast<uint64_t>(strtoull(para, &para, 16));
+    para++;
+    param.msk2 = static_cast<uint64_t>(strtoull(para, &para, 16));
+    para++;
+    param.fix1 = static_cast<uint64_t>(strtoull(para, &para, 16));
+    para++;
+    param.fix2 = static_cast<uint64_t>(strtoull(para, &para, 16));
+    para++;
+    param.parity1 = static_cast<uint64_t>(strtoull(para, &para, 16));
+    para++;
+    param.parity2 = static_cast<uint64_t>(strtoull(para, &para, 16));
+}
+
+static bool check(const char * str)
+{
+    dSFMT_param param;
+    parse(param, str);
+    dSFMT sf(param);
+    w128_t seed;
+    seed.u64[0] = 1234;
+    seed.u64[1] = 0;
+    sf.seed(seed);
+    if (!anni(sf)) {
+        return false;
+    }
+    int pis[52];
+    int exact[52];
+    DSFMTInfo info;
+    info.bitSize = 128;
+    info.elementNo = 2;
+    calc_dSFMT_equidistribution<w128_t, dSFMT>(sf, pis, 52, info,
+                                               param.mexp);
+    AlgorithmFieldEquidistribution<w128_t> field(sf, 2, 51, 52,
+                                                 param.mexp);
+    field.get_all_equidist(exact);
+    for (int v = 0; v < 52; v++) {
+        bool ok;
+        if (exact[v] % 2 == 0) {
+            ok = pis[v] == exact[v];
+        } else {
+            ok = pis[v] == exact[v] || pis[v] == exact[v] - 1;
+        }
+        if (!ok) {
+            cout << "mexp " << dec << param.mexp << ": k(" << (v + 1)
+                 << ") = " << exact[v] << ", PIS " << pis[v] << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    cout << "testing field equidistribution of dSFMT ...";
+    for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); i++) {
+        if (!check(params[i])) {
+            cout << "NG" << endl;
+            return 1;
+        }
+    }
+    cout << "ok" << endl;
+    return 0;
+}
@@ -3,12 +3,13 @@
 #include <NTL/GF2X.h>
 #include <MTToolBox/period.hpp>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
+#include <MTToolBox/Parallel.hpp>
 
 using namespace NTL;
 using namespace std;
 using namespace MTToolBox;
 
-static void getLCMPoly(GF2X& lcm, const sfmt& sf);
+static void unitLCMPoly(GF2X& lcm, const sfmt& sf);
 
 bool anni(sfmt& sf)
 {
@@ -22,9 +23,10 @@ bool anni(sfmt& sf)
              << endl;
         return false;
     }
-    calcCharacteristicPolynomial(&sf, poly);
+    calcCharacteristicPolynomial(&sf, poly,
+                                 WorkerPool::hardwareConcurrency());
     if (deg(poly) != sf.bitSize()) {
-        getLCMPoly(poly, sf);
+        unitLCMPoly(poly, sf);
     }
     //printBinary(stdout, poly);
     GF2X quotient = poly / irreducible;
@@ -40,7 +42,21 @@ bool anni(sfmt& sf)
     return true;
 }
 
-static void getLCMPoly(GF2X& lcm, const sfmt& sf)
+/*
+ * 出力の全ビットの最小多項式の LCM をとり、次数が状態空間のビット数に
+ * 足りなければ単位ベクトルの最小多項式の LCM もとる
+ */
+void getLCMPoly(GF2X& lcm, const sfmt& sf)
+{
+    sfmt gen(sf);
+    calcCharacteristicPolynomial(&gen, lcm,
+                                 WorkerPool::hardwareConcurrency());
+    if (deg(lcm) != sf.bitSize()) {
+        unitLCMPoly(lcm, sf);
+    }
+}
+
+static void unitLCMPoly(GF2X& lcm, const sfmt& sf)
 {
     sfmt gen(sf);
     int bitSize = gen.bitSize();
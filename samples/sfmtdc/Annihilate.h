@@ -3,6 +3,7 @@
 #define ANNIHILATE_H
 
 #include "sfmtsearch.hpp"
+void getLCMPoly(NTL::GF2X& lcm, const MTToolBox::sfmt& sf);
 bool anni(MTToolBox::sfmt& sf);
 
 #endif // ANNIHILATE_H
@@ -3,6 +3,7 @@
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
 #include <MTToolBox/period.hpp>
+#include <MTToolBox/AnalysisCache.hpp>
 #include <NTL/GF2X.h>
 #include <errno.h>
 #include <stdlib.h>
@@ -17,6 +18,7 @@ public:
     bool verbose;
     bool reverse;
     uint64_t seed;
+    string cache;
     sfmt_param params;
 };
 
@@ -37,36 +39,70 @@ int main(int argc, char * argv[])
     w128_t wseed;
     wseed.u64[0] = opt.seed;
     sf.seed(wseed);
-    if (!anni(sf)) {
-        return -1;
-    }
-    int delta128 = 0;
-    int delta32 = 0;
-    int delta64 = 0;
     bool lsb = false;
     const char * lsb_str = "";
+    string prefix = "";
     if (opt.reverse) {
-        sf.set_reverse_bit();
         lsb = true;
         cout << "Equidistribution from LSB" << endl;
         lsb_str = " from LSB";
+        prefix = "lsb-";
+    }
+    // キャッシュに結果があれば計算しない
+    AnalysisCache * cache = NULL;
+    AnalysisRecord record;
+    string key;
+    if (!opt.cache.empty()) {
+        cache = new AnalysisCache(opt.cache);
+        key = AnalysisCache::makeKey("sfmt", sf.getParamString());
     }
-    AlgorithmEquidistribution<w128_t> re(sf, 128, opt.params.mexp);
     int veq[128];
-    delta128 = re.get_all_equidist(veq);
-    SIMDInfo info;
-    info.bitSize = 128;
     int veq32[32];
-    info.bitMode = 32;
-    info.elementNo = 4;
-    sf.reset_reverse_bit();
-    delta32 = calc_SIMD_equidistribution<w128_t, sfmt>(sf, veq32, 32, info,
-                                                       opt.params.mexp, lsb);
     int veq64[64];
-    info.bitMode = 64;
-    info.elementNo = 2;
-    delta64 = calc_SIMD_equidistribution<w128_t, sfmt>(sf, veq64, 64, info,
-                                                       opt.params.mexp, lsb);
+    if (cache == NULL || !cache->lookup(key, record)
+        || !record.getVeq(prefix + "veq128", veq, 128)
+        || !record.getVeq(prefix + "veq32", veq32, 32)
+        || !record.getVeq(prefix + "veq64", veq64, 64)) {
+        if (!anni(sf)) {
+            delete cache;
+            return -1;
+        }
+        if (opt.reverse) {
+            sf.set_reverse_bit();
+        }
+        AlgorithmEquidistribution<w128_t> re(sf, 128, opt.params.mexp);
+        re.get_all_equidist(veq);
+        SIMDInfo info;
+        info.bitSize = 128;
+        info.bitMode = 32;
+        info.elementNo = 4;
+        sf.reset_reverse_bit();
+        calc_SIMD_equidistribution<w128_t, sfmt>(sf, veq32, 32, info,
+                                                 opt.params.mexp, lsb);
+        info.bitMode = 64;
+        info.elementNo = 2;
+        calc_SIMD_equidistribution<w128_t, sfmt>(sf, veq64, 64, info,
+                                                 opt.params.mexp, lsb);
+        record.setVeq(prefix + "veq128", veq, 128);
+        record.setVeq(prefix + "veq32", veq32, 32);
+        record.setVeq(prefix + "veq64", veq64, 64);
+        if (cache != NULL) {
+            cache->store(key, record);
+        }
+    }
+    delete cache;
+    int delta128 = 0;
+    int delta32 = 0;
+    int delta64 = 0;
+    for (int j = 0; j < 128; j++) {
+        delta128 += opt.params.mexp / (j + 1) - veq[j];
+    }
+    for (int j = 0; j < 32; j++) {
+        delta32 += opt.params.mexp / (j + 1) - veq32[j];
+    }
+    for (int j = 0; j < 64; j++) {
+        delta64 += opt.params.mexp / (j + 1) - veq64[j];
+    }
     cout << sf.getParamString();
     cout << dec << delta32 << "," << delta64 << ","
          << delta128 << endl;
@@ -129,6 +165,7 @@ static bool parse_opt(options& opt, int argc, char **argv) {
     opt.verbose = false;
     opt.seed = (uint64_t)clock();
     opt.reverse = false;
+    opt.cache = "";
     int c;
     bool error = false;
     string pgm = argv[0];
@@ -136,10 +173,11 @@ static bool parse_opt(options& opt, int argc, char **argv) {
         {"verbose", no_argument, NULL, 'v'},
         {"seed", required_argument, NULL, 's'},
         {"reverse", no_argument, NULL, 'r'},
+        {"cache", required_argument, NULL, 'c'},
         {NULL, 0, NULL, 0}};
     errno = 0;
     for (;;) {
-        c = getopt_long(argc, argv, "vrs:", longopts, NULL);
+        c = getopt_long(argc, argv, "vrs:c:", longopts, NULL);
         if (error) {
             break;
         }
@@ -160,6 +198,9 @@ static bool parse_opt(options& opt, int argc, char **argv) {
         case 'r':
             opt.reverse = true;
             break;
+        case 'c':
+            opt.cache = optarg;
+            break;
         case '?':
         default:
             error = true;
@@ -214,13 +255,15 @@ static void output_help(string& pgm)
 {
     cerr << "usage:" << endl;
     cerr << pgm
-         << " [-v] [-r]"
+         << " [-v] [-r] [-c cache-dir]"
          << " mexp,pos1,sl1,sl2,sr1,sr2,msk1,msk2,msk3,msk4,"
          << "parity1,parity2,parity3,parity4"
          << endl;
     static string help_string1 = "\n"
 "--verbose, -v        Verbose mode. Output detailed information.\n"
 "--reverse, -r        Reverse mode. Calculate equidistribution from LSB.\n"
+"--cache, -c dir      Cache directory. Results saved in the directory are\n"
+"                     used instead of calculation.\n"
         ;
     cerr << help_string1 << endl;
 }
@@ -18,7 +18,8 @@ using namespace std;
 
 w128_t calc_parity(sfmt& sf, const GF2X& irreducible)
 {
-    AlgorithmCalculateParity<w128_t, sfmt> cp;
+    AlgorithmCalculateParity<w128_t, sfmt>
+        cp(WorkerPool::hardwareConcurrency());
     cp.searchParity(sf, irreducible);
     return sf.getParityValue();
 }
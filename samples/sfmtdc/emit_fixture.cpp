@@ -0,0 +1,51 @@
+/**
+ * @file emit_fixture.cpp
+ *
+ * @brief write a specialized header for SFMT-607 to be tested by
+ * test_emitted.
+ *
+ * @author Mutsuo Saito (Manieth corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (C) 2015 Mutsuo Saito, Makoto Matsumoto,
+ * Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <iostream>
+#include <string>
+#include <MTToolBox/SourceEmitter.hpp>
+#include "sfmtsearch.hpp"
+#include "emit_source.h"
+
+using namespace MTToolBox;
+using namespace std;
+
+int main(int argc, char * argv[])
+{
+    if (argc != 2 || !SourceEmitter::isIdentifier(argv[1])) {
+        cerr << "usage: " << argv[0] << " name" << endl;
+        return 1;
+    }
+    // SFMT-607 of the original distribution
+    sfmt_param params;
+    params.mexp = 607;
+    params.pos1 = 2;
+    params.sl1 = 15;
+    params.sl2 = 3;
+    params.sr1 = 13;
+    params.sr2 = 3;
+    params.msk1 = UINT32_C(0xfdff37ff);
+    params.msk2 = UINT32_C(0xef7f3f7d);
+    params.msk3 = UINT32_C(0xff777b7d);
+    params.msk4 = UINT32_C(0x7ff7fb2f);
+    params.parity1 = UINT32_C(0x00000001);
+    params.parity2 = UINT32_C(0x00000000);
+    params.parity3 = UINT32_C(0x00000000);
+    params.parity4 = UINT32_C(0x5986f054);
+    sfmt sf(params);
+    emit_source(cout, sf, argv[1]);
+    return 0;
+}
@@ -0,0 +1,307 @@
+/**
+ * @file emit_source.cpp
+ *
+ * @brief write source of SFMT specialized for found parameters.
+ *
+ * The written header is standalone. Parameters are compile time
+ * constants, and the whole state array is regenerated at once, using
+ * SSE2 if available. It has self_check(), which compares outputs with
+ * those of the search class sfmt computed here.
+ *
+ * @author Mutsuo Saito (Manieth corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (C) 2015 Mutsuo Saito, Makoto Matsumoto,
+ * Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <MTToolBox/SourceEmitter.hpp>
+#include "emit_source.h"
+
+using namespace std;
+using namespace MTToolBox;
+
+static string num(int value)
+{
+    ostringstream ss;
+    ss << dec << value;
+    return ss.str();
+}
+
+/*
+ * 探索用クラスの状態配列 s と出力用の状態配列 t は t[i] = s[i + 1] の
+ * 関係にある。探索用クラスは index を進めてから計算するので、こう
+ * ずらすと通常の SFMT と同じく t[0] から順に計算して出力すればよい。
+ */
+static void emit_init(SourceEmitter& e)
+{
+    e.open("void init(uint32_t seed)");
+    e.line("uint32_t s[N32];");
+    e.line("s[0] = seed;");
+    e.open("for (int i = 1; i < N32; i++)");
+    e.line("s[i] = UINT32_C(1812433253) * (s[i - 1] ^ (s[i - 1] >> 30))");
+    e.line("    + static_cast<uint32_t>(i);");
+    e.close();
+    e.line("period_certification(s);");
+    e.line("memcpy(&state[0].u[0], &s[4], sizeof(uint32_t) * (N32 - 4));");
+    e.line("memcpy(&state[N - 1].u[0], &s[0], sizeof(uint32_t) * 4);");
+    e.line("idx = N32;");
+    e.close();
+}
+
+static void emit_output(SourceEmitter& e)
+{
+    e.open("uint32_t next()");
+    e.open("if (idx >= N32)");
+    e.line("gen_rand_all();");
+    e.line("idx = 0;");
+    e.close();
+    e.line("uint32_t r = state[idx / 4].u[idx % 4];");
+    e.line("idx++;");
+    e.line("return r;");
+    e.close();
+    e.line("");
+    e.open("void fill_array32(uint32_t * array, int size)");
+    e.line("int i = 0;");
+    e.open("while (i < size && idx < N32)");
+    e.line("array[i++] = state[idx / 4].u[idx % 4];");
+    e.line("idx++;");
+    e.close();
+    e.open("while (size - i >= N32)");
+    e.line("gen_rand_all();");
+    e.line("memcpy(&array[i], &state[0].u[0], sizeof(uint32_t) * N32);");
+    e.line("i += N32;");
+    e.close();
+    e.open("while (i < size)");
+    e.line("array[i++] = next();");
+    e.close();
+    e.close();
+}
+
+static void emit_self_check(SourceEmitter& e, const sfmt& sf, uint32_t seed,
+                            int count)
+{
+    sfmt g(sf);
+    g.setStartMode(0);
+    g.setWeightMode(4);
+    g.reset_reverse_bit();
+    w128_t s = {{seed, 0, 0, 0}};
+    g.seed(s);
+    g.periodCertification();
+    vector<uint32_t> expected;
+    for (int i = 0; i < count / 4; i++) {
+        w128_t w = g.generate();
+        for (int j = 0; j < 4; j++) {
+            expected.push_back(w.u[j]);
+        }
+    }
+    e.open("static bool self_check()");
+    e.array32("expected", expected);
+    e.line("enum { count = " + num(count) + " };");
+    e.line("uint32_t array[count];");
+    e.line(e.getName() + " g(" + SourceEmitter::literal32(seed) + ");");
+    e.line(e.getName() + " h(" + SourceEmitter::literal32(seed) + ");");
+    e.line("h.fill_array32(array, count);");
+    e.open("for (int i = 0; i < count; i++)");
+    e.open("if (g.next() != expected[i] || array[i] != expected[i])");
+    e.line("return false;");
+    e.close();
+    e.close();
+    e.line("return true;");
+    e.close();
+}
+
+static void emit_period_certification(SourceEmitter& e)
+{
+    e.open("static void period_certification(uint32_t s[])");
+    e.line("const uint32_t parity[4] = {PARITY1, PARITY2, PARITY3, PARITY4};");
+    e.line("uint32_t inner = 0;");
+    e.open("for (int i = 0; i < 4; i++)");
+    e.line("inner ^= s[i] & parity[i];");
+    e.close();
+    e.open("for (int i = 16; i > 0; i >>= 1)");
+    e.line("inner ^= inner >> i;");
+    e.close();
+    e.open("if (inner & 1)");
+    e.line("return;");
+    e.close();
+    e.open("for (int i = 0; i < 4; i++)");
+    e.line("uint32_t work = 1;");
+    e.open("for (int j = 0; j < 32; j++)");
+    e.open("if (work & parity[i])");
+    e.line("s[i] ^= work;");
+    e.line("return;");
+    e.close();
+    e.line("work = work << 1;");
+    e.close();
+    e.close();
+    e.close();
+}
+
+/*
+ * 漸化式は探索用クラスの do_recursion と同じ。128 ビットのバイト単位の
+ * シフトは、SSE2 では _mm_slli_si128 と _mm_srli_si128 になる。
+ */
+static void emit_recursion(SourceEmitter& e)
+{
+    e.directive("#if defined(__SSE2__)");
+    e.line("static __m128i recursion(__m128i a, __m128i b, __m128i c,");
+    e.open("                         __m128i d)");
+    e.line("const __m128i mask = _mm_set_epi32(static_cast<int>(MSK4),");
+    e.line("                                   static_cast<int>(MSK3),");
+    e.line("                                   static_cast<int>(MSK2),");
+    e.line("                                   static_cast<int>(MSK1));");
+    e.line("__m128i x = _mm_slli_si128(a, SL2);");
+    e.line("__m128i y = _mm_srli_si128(c, SR2);");
+    e.line("__m128i z = _mm_and_si128(_mm_srli_epi32(b, SR1), mask);");
+    e.line("__m128i v = _mm_slli_epi32(d, SL1);");
+    e.line("z = _mm_xor_si128(z, a);");
+    e.line("z = _mm_xor_si128(z, x);");
+    e.line("z = _mm_xor_si128(z, y);");
+    e.line("return _mm_xor_si128(z, v);");
+    e.close();
+    e.line("");
+    e.open("void gen_rand_all()");
+    e.line("__m128i r1 = state[N - 2].si;");
+    e.line("__m128i r2 = state[N - 1].si;");
+    e.line("int i;");
+    e.open("for (i = 0; i < N - POS1; i++)");
+    e.line("state[i].si = recursion(state[i].si, state[i + POS1].si, r1, r2);");
+    e.line("r1 = r2;");
+    e.line("r2 = state[i].si;");
+    e.close();
+    e.open("for (; i < N; i++)");
+    e.line("state[i].si = recursion(state[i].si, state[i + POS1 - N].si,");
+    e.line("                        r1, r2);");
+    e.line("r1 = r2;");
+    e.line("r2 = state[i].si;");
+    e.close();
+    e.close();
+    e.directive("#else");
+    e.line("static void recursion(w128 * r, const w128 * a, const w128 * b,");
+    e.open("                      const w128 * c, const w128 * d)");
+    e.line("uint64_t ah = (static_cast<uint64_t>(a->u[3]) << 32) | a->u[2];");
+    e.line("uint64_t al = (static_cast<uint64_t>(a->u[1]) << 32) | a->u[0];");
+    e.line("uint64_t ch = (static_cast<uint64_t>(c->u[3]) << 32) | c->u[2];");
+    e.line("uint64_t cl = (static_cast<uint64_t>(c->u[1]) << 32) | c->u[0];");
+    e.line("uint64_t xh = (ah << (SL2 * 8)) | (al >> (64 - SL2 * 8));");
+    e.line("uint64_t xl = al << (SL2 * 8);");
+    e.line("uint64_t yh = ch >> (SR2 * 8);");
+    e.line("uint64_t yl = (cl >> (SR2 * 8)) | (ch << (64 - SR2 * 8));");
+    e.line("const uint32_t x[4] = {static_cast<uint32_t>(xl),");
+    e.line("                       static_cast<uint32_t>(xl >> 32),");
+    e.line("                       static_cast<uint32_t>(xh),");
+    e.line("                       static_cast<uint32_t>(xh >> 32)};");
+    e.line("const uint32_t y[4] = {static_cast<uint32_t>(yl),");
+    e.line("                       static_cast<uint32_t>(yl >> 32),");
+    e.line("                       static_cast<uint32_t>(yh),");
+    e.line("                       static_cast<uint32_t>(yh >> 32)};");
+    e.line("const uint32_t mask[4] = {MSK1, MSK2, MSK3, MSK4};");
+    e.open("for (int j = 0; j < 4; j++)");
+    e.line("r->u[j] = a->u[j] ^ x[j] ^ ((b->u[j] >> SR1) & mask[j])");
+    e.line("    ^ y[j] ^ (d->u[j] << SL1);");
+    e.close();
+    e.close();
+    e.line("");
+    e.open("void gen_rand_all()");
+    e.line("w128 * r1 = &state[N - 2];");
+    e.line("w128 * r2 = &state[N - 1];");
+    e.line("int i;");
+    e.open("for (i = 0; i < N - POS1; i++)");
+    e.line("recursion(&state[i], &state[i], &state[i + POS1], r1, r2);");
+    e.line("r1 = r2;");
+    e.line("r2 = &state[i];");
+    e.close();
+    e.open("for (; i < N; i++)");
+    e.line("recursion(&state[i], &state[i], &state[i + POS1 - N], r1, r2);");
+    e.line("r1 = r2;");
+    e.line("r2 = &state[i];");
+    e.close();
+    e.close();
+    e.directive("#endif");
+}
+
+/**
+ * write source of SFMT specialized for parameters of \b sf.
+ *
+ * Outputs of the written generator initialized by \b seed are the
+ * same as those of \b sf seeded by {seed, 0, 0, 0} and
+ * periodCertification().
+ * @param os output stream
+ * @param sf SFMT whose parameters are written
+ * @param name name of the class and the header
+ * @param seed seed used in self_check()
+ */
+void emit_source(ostream& os, const sfmt& sf, const string& name,
+                 uint32_t seed)
+{
+    const sfmt_param& p = sf.getParam();
+    if (p.sl2 < 1 || p.sl2 > 7 || p.sr2 < 1 || p.sr2 > 7) {
+        throw invalid_argument("sl2 and sr2 should be from 1 to 7");
+    }
+    SourceEmitter e(os, name);
+    int size = p.mexp / 128 + 1;
+    int count = 2 * size * 4 + 8;
+    if (count < 1000) {
+        count = 1000;
+    }
+    e.beginHeader("SFMT specialized for the parameters found by sfmtdc.\n"
+                  + p.get_header() + "\n" + p.get_string() + "\n\n"
+                  "Outputs of " + name + "(seed) are the same as the "
+                  "search class sfmt\n"
+                  "seeded by {seed, 0, 0, 0} and periodCertification().");
+    e.directive("#if defined(__SSE2__)");
+    e.directive("#include <emmintrin.h>");
+    e.directive("#endif");
+    e.line("");
+    e.open("class " + name);
+    e.directive("public:");
+    e.enumConstant("MEXP", p.mexp);
+    e.enumConstant("N", size);
+    e.enumConstant("N32", size * 4);
+    e.enumConstant("POS1", p.pos1);
+    e.enumConstant("SL1", p.sl1);
+    e.enumConstant("SL2", p.sl2);
+    e.enumConstant("SR1", p.sr1);
+    e.enumConstant("SR2", p.sr2);
+    e.constant32("MSK1", p.msk1);
+    e.constant32("MSK2", p.msk2);
+    e.constant32("MSK3", p.msk3);
+    e.constant32("MSK4", p.msk4);
+    e.constant32("PARITY1", p.parity1);
+    e.constant32("PARITY2", p.parity2);
+    e.constant32("PARITY3", p.parity3);
+    e.constant32("PARITY4", p.parity4);
+    e.line("");
+    e.open("explicit " + name + "(uint32_t seed)");
+    e.line("init(seed);");
+    e.close();
+    e.line("");
+    emit_init(e);
+    e.line("");
+    emit_output(e);
+    e.line("");
+    emit_self_check(e, sf, seed, count);
+    e.directive("private:");
+    e.open("union w128");
+    e.line("uint32_t u[4];");
+    e.directive("#if defined(__SSE2__)");
+    e.line("__m128i si;");
+    e.directive("#endif");
+    e.close(";");
+    e.line("w128 state[N];");
+    e.line("int idx;");
+    e.line("");
+    emit_period_certification(e);
+    e.line("");
+    emit_recursion(e);
+    e.close(";");
+    e.line("");
+    e.endHeader();
+}
@@ -0,0 +1,11 @@
+#pragma once
+#ifndef EMIT_SOURCE_H
+#define EMIT_SOURCE_H
+
+#include <iostream>
+#include <string>
+#include "sfmtsearch.hpp"
+void emit_source(std::ostream& os, const MTToolBox::sfmt& sf,
+                 const std::string& name, uint32_t seed = 1234);
+
+#endif // EMIT_SOURCE_H
@@ -26,14 +26,17 @@
 #include <sstream>
 #include <fstream>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
-#include <MTToolBox/AlgorithmCalculateParity.hpp>
+#include <MTToolBox/ReducibleAnalysis.hpp>
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
 #include <MTToolBox/MersenneTwister.hpp>
+#include <MTToolBox/SourceEmitter.hpp>
+#include <MTToolBox/SearchProgress.hpp>
 #include <NTL/GF2X.h>
 #include <getopt.h>
 #include "sfmtsearch.hpp"
 #include "AlgorithmSIMDEquidistribution.hpp"
 #include "Annihilate.h"
+#include "emit_source.h"
 
 using namespace std;
 using namespace MTToolBox;
@@ -45,7 +48,11 @@ public:
     bool verbose;
     uint64_t seed;
     std::string filename;
+    std::string emit;
+    std::string rejected;
     long count;
+    double progress;
+    bool affinity;
 };
 
 bool parse_opt(options& opt, int argc, char **argv);
@@ -84,30 +91,61 @@ int search(options& opt, int count) {
         cout << "search start at " << ctime(&t);
     }
     AlgorithmReducibleRecursionSearch<w128_t> ars(g, mt);
+    BloomParameterFilter * filter = NULL;
+    if (!opt.rejected.empty()) {
+        try {
+            filter = new BloomParameterFilter(opt.rejected);
+        } catch (runtime_error& e) {
+            cerr << e.what() << endl;
+            return -1;
+        }
+        ars.setFilter(filter);
+    }
+    SearchProgress progress(SearchProgress::primitiveProbability(opt.mexp),
+                            count);
+    if (opt.progress > 0) {
+        progress.setReport(&cerr, opt.progress);
+    }
+    ars.setProgress(&progress);
     int i = 0;
-    AlgorithmCalculateParity<w128_t, sfmt> cp;
+    // 並列の殲滅では、ワーカーごとに生成器の複製を二つ持つ
+    int threads = CpuTopology::system().concurrencyFor(
+        CpuTopology::workingSet(g.bitSize(), 2));
+    WorkerPool::setPinning(opt.affinity);
     cout << "# " << g.getHeaderString() << ", delta32, delta64, delta128"
          << endl;
     while (i < count) {
         if (ars.start(opt.mexp * 100)) {
+            double begin = SearchProgress::now();
             GF2X irreducible = ars.getIrreducibleFactor();
-            GF2X characteristic = ars.getCharacteristicPolynomial();
-            GF2X quotient = characteristic / irreducible;
             //cout << "deg irreducible = " << dec << deg(irreducible) << endl;
             //cout << "deg characteristic = " << dec << deg(characteristic)
             //     << endl;
-            //cout << "deg quotient = " << dec << deg(quotient) << endl;
             if (deg(irreducible) != opt.mexp) {
                 cout << "error" << endl;
+                delete filter;
                 return -1;
             }
-            cp.searchParity(g, irreducible);
+            GF2X characteristic;
+            getLCMPoly(characteristic, g);
+            ReducibleAnalysis<w128_t, sfmt> analysis(g, irreducible,
+                                                     characteristic,
+                                                     threads);
+            analysis.getParity(g);
             w128_t seed = {{1, 0, 0, 0}};
             g.seed(seed);
-            if (!anni(g)) {
+            analysis.annihilateQuotient(g);
+            // 殲滅後の状態の最小多項式は f になるはずである。状態が 0 に
+            // なるなどしてそうならなければ、パラメータを出力せずに終わる
+            sfmt annihilated(g);
+            GF2X minimal;
+            minpoly<w128_t>(minimal, annihilated);
+            if (deg(minimal) != opt.mexp) {
+                cout << "error annihilated state does not have degree "
+                     << dec << opt.mexp << endl;
+                delete filter;
                 return -1;
             }
-            //annihilate<w128_t>(&g, quotient);
             //AlgorithmReducibleEquidistribution<w128_t, sfmt, uint32_t>
             //    re(g, irreducible, 128);
             AlgorithmEquidistribution<w128_t> re(g, 128, opt.mexp);
@@ -130,9 +168,22 @@ int search(options& opt, int count) {
             delta64
                 = calc_SIMD_equidistribution<w128_t, sfmt>(g, veq64, 64, info,
                                                            opt.mexp);
+            progress.addPostProcess(SearchProgress::now() - begin);
             cout << g.getParamString();
             cout << dec << delta32 << "," << delta64 << ","
                  << delta128 << endl;
+            if (!opt.emit.empty()) {
+                stringstream ss;
+                ss << opt.emit << "_" << dec << i;
+                string emitfile = ss.str() + ".h";
+                ofstream ofs(emitfile.c_str());
+                emit_source(ofs, g, ss.str());
+                if (!ofs) {
+                    cerr << "can't write file:" << emitfile << endl;
+                    delete filter;
+                    return -1;
+                }
+            }
 #if 0
             cout << "32bit veq" << endl;
             for (int j = 0; j < 32; j++) {
@@ -158,8 +209,21 @@ int search(options& opt, int count) {
     }
     if (opt.verbose) {
         time_t t = time(NULL);
+        const FactorStatistics& stat = ars.getFactorStatistics();
+        cout << "factor check: " << dec << stat.calls << " calls, "
+             << stat.squarings << " squarings, " << stat.gcds << " gcds, "
+             << (stat.calls > 0 ? stat.microseconds / stat.calls : 0)
+             << " usec per call" << endl;
+        progress.report(cout);
+        if (filter != NULL) {
+            cout << "rejected filter: " << dec << filter->getLookups()
+                 << " lookups, " << filter->getHits() << " hits ("
+                 << filter->getHitRate() * 100 << "%), "
+                 << filter->getInserts() << " inserts" << endl;
+        }
         cout << "search end at " << ctime(&t) << endl;
     }
+    delete filter;
     return 0;
 }
 
@@ -179,6 +243,10 @@ bool parse_opt(options& opt, int argc, char **argv) {
     opt.count = 1;
     opt.seed = (uint64_t)clock();
     opt.filename = "";
+    opt.emit = "";
+    opt.rejected = "";
+    opt.progress = 0;
+    opt.affinity = false;
     int c;
     bool error = false;
     string pgm = argv[0];
@@ -187,10 +255,14 @@ bool parse_opt(options& opt, int argc, char **argv) {
         {"file", required_argument, NULL, 'f'},
         {"count", required_argument, NULL, 'c'},
         {"seed", required_argument, NULL, 's'},
+        {"emit", required_argument, NULL, 'e'},
+        {"rejected", required_argument, NULL, 'r'},
+        {"progress", required_argument, NULL, 'p'},
+        {"affinity", no_argument, NULL, 'a'},
         {NULL, 0, NULL, 0}};
     errno = 0;
     for (;;) {
-        c = getopt_long(argc, argv, "vs:f:c:", longopts, NULL);
+        c = getopt_long(argc, argv, "vs:f:c:e:r:p:a", longopts, NULL);
         if (error) {
             break;
         }
@@ -211,6 +283,26 @@ bool parse_opt(options& opt, int argc, char **argv) {
         case 'f':
             opt.filename = optarg;
             break;
+        case 'e':
+            opt.emit = optarg;
+            if (!SourceEmitter::isIdentifier(opt.emit)) {
+                error = true;
+                cerr << "emit name must be an identifier" << endl;
+            }
+            break;
+        case 'r':
+            opt.rejected = optarg;
+            break;
+        case 'a':
+            opt.affinity = true;
+            break;
+        case 'p':
+            opt.progress = strtod(optarg, NULL);
+            if (errno || opt.progress <= 0) {
+                error = true;
+                cerr << "progress must be a positive number" << endl;
+            }
+            break;
         case 'c':
             opt.count = strtoll(optarg, NULL, 10);
             if (errno) {
@@ -280,7 +372,7 @@ static void output_help(string& pgm) {
     cerr << "usage:" << endl;
     cerr << pgm
          << " [-s seed] [-v] [-c count]"
-         << " [-f outputfile]"
+         << " [-f outputfile] [-e name] [-r file] [-p seconds] [-a]"
          << " mexp"
          << endl;
     static string help_string1 = "\n"
@@ -289,6 +381,14 @@ static void output_help(string& pgm) {
 "                     option, parameters are outputted to standard output.\n"
 "--count, -c count    Output count. The number of parameters to be outputted.\n"
 "--seed, -s seed      seed of randomness.\n"
+"--emit, -e name      C++ header specialized for each parameter is\n"
+"                     written to name_N.h, where N is the sequential number.\n"
+"--rejected, -r file  Rejected parameters are recorded in this file, and\n"
+"                     skipped in later searches of the same mexp.\n"
+"--progress, -p sec   Progress and estimated remaining time are outputted\n"
+"                     to standard error every sec seconds.\n"
+"--affinity, -a       Worker threads are pinned to CPUs spread over NUMA\n"
+"                     nodes. Don't use when several processes share a host.\n"
 "mexp                 mersenne exponent.\n"
         ;
     cerr << help_string1 << endl;
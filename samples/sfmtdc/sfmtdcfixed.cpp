@@ -26,7 +26,7 @@
 #include <sstream>
 #include <fstream>
 #include <MTToolBox/AlgorithmReducibleRecursionSearch.hpp>
-#include <MTToolBox/AlgorithmCalculateParity.hpp>
+#include <MTToolBox/ReducibleAnalysis.hpp>
 #include <MTToolBox/AlgorithmEquidistribution.hpp>
 #include <MTToolBox/MersenneTwister.hpp>
 #include <NTL/GF2X.h>
@@ -86,29 +86,38 @@ int search(options& opt, int count) {
     }
     AlgorithmReducibleRecursionSearch<w128_t> ars(g, mt);
     int i = 0;
-    AlgorithmCalculateParity<w128_t, sfmt> cp;
+    int threads = WorkerPool::hardwareConcurrency();
     cout << "# " << g.getHeaderString() << ", delta32, delta64, delta128"
          << endl;
     while (i < count) {
         if (ars.start(opt.mexp * 100)) {
             GF2X irreducible = ars.getIrreducibleFactor();
-            GF2X characteristic = ars.getCharacteristicPolynomial();
-            GF2X quotient = characteristic / irreducible;
             //cout << "deg irreducible = " << dec << deg(irreducible) << endl;
             //cout << "deg characteristic = " << dec << deg(characteristic)
             //     << endl;
-            //cout << "deg quotient = " << dec << deg(quotient) << endl;
             if (deg(irreducible) != opt.mexp) {
                 cout << "error" << endl;
                 return -1;
             }
-            cp.searchParity(g, irreducible);
+            GF2X characteristic;
+            getLCMPoly(characteristic, g);
+            ReducibleAnalysis<w128_t, sfmt> analysis(g, irreducible,
+                                                     characteristic,
+                                                     threads);
+            analysis.getParity(g);
             w128_t seed = {{1, 0, 0, 0}};
             g.seed(seed);
-            if (!anni(g)) {
+            analysis.annihilateQuotient(g);
+            // 殲滅後の状態の最小多項式は f になるはずである。状態が 0 に
+            // なるなどしてそうならなければ、パラメータを出力せずに終わる
+            sfmt annihilated(g);
+            GF2X minimal;
+            minpoly<w128_t>(minimal, annihilated);
+            if (deg(minimal) != opt.mexp) {
+                cout << "error annihilated state does not have degree "
+                     << dec << opt.mexp << endl;
                 return -1;
             }
-            //annihilate<w128_t>(&g, quotient);
             //AlgorithmReducibleEquidistribution<w128_t, sfmt, uint32_t>
             //    re(g, irreducible, 128);
             AlgorithmEquidistribution<w128_t> re(g, 128, opt.mexp);
@@ -159,6 +168,11 @@ int search(options& opt, int count) {
     }
     if (opt.verbose) {
         time_t t = time(NULL);
+        const FactorStatistics& stat = ars.getFactorStatistics();
+        cout << "factor check: " << dec << stat.calls << " calls, "
+             << stat.squarings << " squarings, " << stat.gcds << " gcds, "
+             << (stat.calls > 0 ? stat.microseconds / stat.calls : 0)
+             << " usec per call" << endl;
         cout << "search end at " << ctime(&t) << endl;
     }
     return 0;
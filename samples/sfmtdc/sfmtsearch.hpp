@@ -29,6 +29,7 @@
 #include <MTToolBox/ReducibleGenerator.hpp>
 #include <MTToolBox/MersenneTwister.hpp>
 #include <MTToolBox/util.hpp>
+#include <MTToolBox/CowBuffer.hpp>
 
 /**
  * @namespace sfmt
@@ -106,10 +107,12 @@ namespace MTToolBox {
         }
 
         /**
-         * This method is used in output.hpp.
-         * @return string of parameters
+         * This method is used as the key of rejected parameters.
+         * parity is excluded, because it is calculated after the
+         * parameters are found.
+         * @return string of parameters of the recursion
          */
-        const string get_string() const {
+        const string get_recursion_string() const {
             stringstream ss;
             ss << dec << mexp << ",";
             ss << dec << pos1 << ",";
@@ -121,6 +124,18 @@ namespace MTToolBox {
             ss << hex << setw(8) << setfill('0') << msk2 << ",";
             ss << hex << setw(8) << setfill('0') << msk3 << ",";
             ss << hex << setw(8) << setfill('0') << msk4 << ",";
+            string s;
+            ss >> s;
+            return s;
+        }
+
+        /**
+         * This method is used in output.hpp.
+         * @return string of parameters
+         */
+        const string get_string() const {
+            stringstream ss;
+            ss << get_recursion_string();
             ss << hex << setw(8) << setfill('0') << parity1 << ",";
             ss << hex << setw(8) << setfill('0') << parity2 << ",";
             ss << hex << setw(8) << setfill('0') << parity3 << ",";
@@ -169,7 +184,7 @@ namespace MTToolBox {
          */
         sfmt(int mexp) {
             size = mexp / 128 + 1;
-            state = new w128_t[static_cast<unsigned long>(size)];
+            state = CowBuffer<w128_t>(static_cast<size_t>(size));
             param.mexp = mexp;
             param.pos1 = 0;
             param.sl1 = 0;
@@ -192,20 +207,12 @@ namespace MTToolBox {
             previous.u64[1] = 0;
         }
 
-        ~sfmt() {
-            delete[] state;
-        }
-
         /**
          * The copy constructor.
          * @param src The origin of copy.
          */
-        sfmt(const sfmt& src) : param(src.param) {
+        sfmt(const sfmt& src) : state(src.state), param(src.param) {
             size = src.size;
-            state = new w128_t[static_cast<unsigned long>(size)];
-            for (int i = 0; i < size; i++) {
-                state[i] = src.state[i];
-            }
             index = src.index;
             start_mode = src.start_mode;
             weight_mode = src.weight_mode;
@@ -219,12 +226,7 @@ namespace MTToolBox {
          */
         sfmt(const sfmt_param& src_param) : param(src_param) {
             size = src_param.mexp / 128 + 1;
-            state = new w128_t[static_cast<unsigned long>(size)];
-            for (int i = 0; i < size; i++) {
-                for (int j = 0; j < 2; j++) {
-                    state[i].u64[j] = 0;
-                }
-            }
+            state = CowBuffer<w128_t>(static_cast<size_t>(size));
             index = 0;
             start_mode = 0;
             weight_mode = 4;
@@ -307,12 +309,13 @@ namespace MTToolBox {
          * Important state transition function.
          */
         void next_state() {
+            w128_t * st = state.writable();
             index = (index + 1) % size;
-            do_recursion(&state[index],
-                         &state[index],
-                         &state[(index + param.pos1) % size],
-                         &state[(index + size - 2) % size],
-                         &state[(index + size - 1) % size]);
+            do_recursion(&st[index],
+                         &st[index],
+                         &st[(index + param.pos1) % size],
+                         &st[(index + size - 2) % size],
+                         &st[(index + size - 1) % size]);
             //index = (index + 1) % size;
         }
 
@@ -481,11 +484,7 @@ namespace MTToolBox {
         }
 
         void setZero() {
-            for (int i = 0; i < size; i++) {
-                for (int j = 0; j < 2; j++) {
-                    state[i].u64[j] = 0;
-                }
-            }
+            state.setZero();
             index = 0;
             previous.u64[0] = 0;
             previous.u64[1] = 0;
@@ -552,10 +551,12 @@ namespace MTToolBox {
                 throw std::invalid_argument(
                     "the adder should have same type as the addee.");
             }
+            w128_t * st = state.writable();
+            const w128_t * src = that->state.data();
             for (int i = 0; i < size; i++) {
                 for (int j = 0; j < 2; j++) {
-                    state[(i + index) % size].u64[j]
-                        ^= that->state[(i + that->index) % size].u64[j];
+                    st[(i + index) % size].u64[j]
+                        ^= src[(i + that->index) % size].u64[j];
                 }
             }
             previous ^= that->previous;
@@ -577,6 +578,14 @@ namespace MTToolBox {
             return param.get_string();
         }
 
+        const std::string getRecursionKey() {
+            return param.get_recursion_string();
+        }
+
+        const sfmt_param& getParam() const {
+            return param;
+        }
+
         /**
          * This method is called by the functions in search_temper.hpp
          * to calculate the equidistribution properties from LSB
@@ -640,7 +649,7 @@ namespace MTToolBox {
         int index;
         int start_mode;
         int weight_mode;
-        w128_t * state;
+        CowBuffer<w128_t> state;
         sfmt_param param;
         bool reverse_bit_flag;
         w128_t previous;
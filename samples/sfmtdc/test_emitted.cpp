@@ -0,0 +1,35 @@
+/**
+ * @file test_emitted.cpp
+ *
+ * @brief compile and run a header written by emit_source().
+ *
+ * sfmt607_fixture.h is written by emit_fixture at build time, so this
+ * fails to compile if the emitted source is broken, and fails to run
+ * if its outputs differ from those of the search class sfmt.
+ *
+ * @author Mutsuo Saito (Manieth corp.)
+ * @author Makoto Matsumoto (Hiroshima University)
+ *
+ * Copyright (C) 2015 Mutsuo Saito, Makoto Matsumoto,
+ * Hiroshima University.
+ * All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include <iostream>
+#include "sfmt607_fixture.h"
+
+using namespace std;
+
+int main()
+{
+    cout << "testing emitted SFMT source ...";
+    if (sfmt607_fixture::self_check()) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
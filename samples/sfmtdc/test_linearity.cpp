@@ -1,5 +1,6 @@
 #include "sfmtsearch.hpp"
 #include <MTToolBox/TestLinearity.hpp>
+#include <MTToolBox/Topology.hpp>
 #include <errno.h>
 #include <stdlib.h>
 using namespace MTToolBox;
@@ -43,22 +44,22 @@ int main(int argc, char * argv[])
     sfmt sf(params);
     cout << sf.getParamString() << endl;
     bool success = true;
-    for (int se = 1; se < 20; se++) {
-        w128_t seedw;
-        seedw.u[0] = static_cast<uint32_t>(se);
-        sf.seed(seedw);
-        for (int i = 0; i < 4; i++) {
-            for (int j = 4; j >= 1; j--) {
-                TestLinearity<w128_t> tl;
-                sfmt sf2 = sf;
-                sf2.setStartMode(i);
-                sf2.setWeightMode(j);
-                if (tl(sf2)) {
-                    cout << ".";
-                } else {
-                    cout << "Linearity Test fail" << endl;
-                    success = false;
-                }
+    // operator() が種を決めるので、種の組は TestLinearity に任せる
+    int threads = CpuTopology::system().getCpus();
+    for (int i = 0; i < 4; i++) {
+        for (int j = 4; j >= 1; j--) {
+            TestLinearity<w128_t> tl;
+            tl.setTrials(64);
+            tl.setLength(1000);
+            tl.setThreads(threads);
+            sfmt sf2 = sf;
+            sf2.setStartMode(i);
+            sf2.setWeightMode(j);
+            if (tl(sf2)) {
+                cout << ".";
+            } else {
+                cout << "Linearity Test fail: " << tl.getFailure() << endl;
+                success = false;
             }
         }
     }
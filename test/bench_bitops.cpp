@@ -0,0 +1,91 @@
+/*
+ * ビット演算プリミティブのベンチマーク
+ * make bench_bitops でビルドする。
+ * 実行中の CPU で使える実装ごとに、1 回あたりの時間を表示する。
+ */
+#include <iostream>
+#include <iomanip>
+#include <time.h>
+#include <MTToolBox/bitops.hpp>
+#include <MTToolBox/util.hpp>
+#include <MTToolBox/MersenneTwister64.hpp>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    const char * names[] = {"generic", "popcnt", "bmi2", "avx512", NULL};
+    enum { array_size = 4096, repeat = 2000 };
+
+    double now() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+    }
+
+    /* 512ビットワード (8ワード) ごとに呼び出す */
+    void bench(const bit_primitives_t& bp, const uint64_t * array,
+               const uint64_t * sparse) {
+        int calls = array_size / 8 * repeat;
+        long sum = 0;
+        double start = now();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < array_size; i += 8) {
+                sum += bp.count_bit(array + i, 8);
+            }
+        }
+        double t1 = now();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < array_size; i += 8) {
+                sum += bp.lowest_one(sparse + i, 8);
+            }
+        }
+        double t2 = now();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < array_size; i += 8) {
+                sum += bp.highest_one(sparse + i, 8);
+            }
+        }
+        double t3 = now();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < array_size; i += 8) {
+                sum += static_cast<long>(
+                    bp.extract_bits(array[i], array[i + 1]) & 1);
+            }
+        }
+        double t4 = now();
+        cout << setw(8) << bp.name << fixed << setprecision(2)
+             << setw(12) << (t1 - start) * 1.0e9 / calls
+             << setw(12) << (t2 - t1) * 1.0e9 / calls
+             << setw(12) << (t3 - t2) * 1.0e9 / calls
+             << setw(12) << (t4 - t3) * 1.0e9 / calls
+             << "  (" << sum << ")" << endl;
+    }
+}
+
+int main(void)
+{
+    uint64_t * array = new uint64_t[array_size];
+    uint64_t * sparse = new uint64_t[array_size];
+    MersenneTwister64 mt(1234);
+    for (int i = 0; i < array_size; i++) {
+        array[i] = mt.getUint64();
+        sparse[i] = (mt.getUint64() % 4 == 0) ? mt.getUint64() : 0;
+    }
+    cout << "ns per call on 512 bits" << endl;
+    cout << setw(8) << "impl" << setw(12) << "count_bit"
+         << setw(12) << "lowest" << setw(12) << "highest"
+         << setw(12) << "extract" << endl;
+    for (int i = 0; names[i] != NULL; i++) {
+        const bit_primitives_t * bp = bit_primitives_by_name(names[i]);
+        if (bp == NULL) {
+            cout << setw(8) << names[i] << "  not available" << endl;
+            continue;
+        }
+        bench(*bp, array, sparse);
+    }
+    cout << "selected: " << bit_primitives().name << endl;
+    delete[] array;
+    delete[] sparse;
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * 並列実行のスケーリングのベンチマーク
+ * make bench_parallel でビルドする。
+ * ./bench_parallel [bitSize [copies]]
+ * 各ワーカーは状態 bitSize ビットの複製を copies 個持ち、それらを
+ * 足し合わせる (EquidistributionCalculatable::add() と同じ形の処理)。
+ * 既定は MTGP 44497 の 32 ビット精度均等分布次元の計算にあたる
+ * 44497 ビット、33 個。
+ * スレッド数を変えながら、CPU に固定しない場合と固定した場合の
+ * 速さと 1 スレッドに対する倍率を表示する。* はワーキングセットから
+ * CpuTopology::concurrencyFor() が選んだスレッド数。
+ */
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <MTToolBox/Parallel.hpp>
+#include <MTToolBox/Topology.hpp>
+#include <MTToolBox/SearchProgress.hpp>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    enum { rounds = 200 };
+
+    /* 作業領域はワーカー自身が確保して書き込む */
+    class AddJob : public Runnable {
+    public:
+        AddJob(size_t words, int copies) : words(words), copies(copies) {
+            sum = 0;
+        }
+        void run(int index) {
+            size_t size = words * static_cast<size_t>(copies);
+            vector<uint64_t> states(size);
+            for (size_t i = 0; i < size; i++) {
+                states[i] = (i + 1) * UINT64_C(0x9e3779b97f4a7c15)
+                    ^ static_cast<uint64_t>(index);
+            }
+            for (int r = 0; r < rounds; r++) {
+                for (int c = 0; c < copies; c++) {
+                    uint64_t * dst = &states[words
+                                             * static_cast<size_t>(c)];
+                    const uint64_t * src = &states[
+                        words * static_cast<size_t>((c + r + 1) % copies)];
+                    for (size_t i = 0; i < words; i++) {
+                        dst[i] ^= (src[i] << 1) | (src[i] >> 63);
+                    }
+                }
+            }
+            uint64_t x = 0;
+            for (size_t i = 0; i < size; i++) {
+                x ^= states[i];
+            }
+            __sync_fetch_and_xor(&sum, x);
+        }
+        uint64_t sum;
+    private:
+        size_t words;
+        int copies;
+    };
+
+    /* 各スレッドが同じ量の処理をしたときの、状態の足し算の回数/秒 */
+    double measure(int threads, bool pin, size_t words, int copies) {
+        WorkerPool::setPinning(pin);
+        AddJob job(words, copies);
+        double start = SearchProgress::now();
+        WorkerPool pool;
+        pool.start(job, threads);
+        pool.join();
+        double t = SearchProgress::now() - start;
+        return static_cast<double>(threads) * rounds * copies / t;
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    int bitSize = 44497;
+    int copies = 33;
+    if (argc > 1) {
+        bitSize = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        copies = atoi(argv[2]);
+    }
+    if (bitSize <= 0 || copies <= 0) {
+        cerr << "usage: " << argv[0] << " [bitSize [copies]]" << endl;
+        return 1;
+    }
+    const CpuTopology& topology = CpuTopology::system();
+    size_t ws = CpuTopology::workingSet(bitSize, copies);
+    int suggested = topology.concurrencyFor(ws);
+    size_t words = static_cast<size_t>((bitSize + 63) / 64);
+    cout << "cpus " << dec << topology.getCpus()
+         << ", nodes " << topology.getNodes()
+         << ", llc " << topology.getCacheDomains() << " x "
+         << topology.getCacheSize() / 1024 << "KB" << endl;
+    cout << "working set " << ws / 1024 << "KB per worker" << endl;
+    vector<int> counts;
+    for (int t = 1; t < topology.getCpus(); t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(topology.getCpus());
+    if (suggested < topology.getCpus()) {
+        counts.push_back(suggested);
+    }
+    cout << setw(8) << "threads" << setw(14) << "adds/s"
+         << setw(8) << "x" << setw(14) << "pinned"
+         << setw(8) << "x" << endl;
+    measure(1, false, words, copies); // 暖機
+    double base = measure(1, false, words, copies);
+    double basePinned = measure(1, true, words, copies);
+    for (size_t i = 0; i < counts.size(); i++) {
+        int t = counts[i];
+        double plain = measure(t, false, words, copies);
+        double pinned = measure(t, true, words, copies);
+        cout << setw(7) << t << (t == suggested ? "*" : " ")
+             << fixed << setprecision(0) << setw(14) << plain
+             << setprecision(2) << setw(8) << plain / base
+             << setprecision(0) << setw(14) << pinned
+             << setprecision(2) << setw(8) << pinned / basePinned << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * 複数パラメータの TinyMT のベンチマーク
+ * make bench_tinymt でビルドする。
+ * パラメータの異なる L 個の tinymt を、参照実装で一個ずつ動かす
+ * 場合と TinyMT32Lanes, TinyMT64Lanes で一斉に動かす場合について、
+ * 出力１個あたりの時間を表示する。
+ */
+#include <iostream>
+#include <iomanip>
+#include <time.h>
+#include <MTToolBox/TinyMTLanes.hpp>
+#include <MTToolBox/MersenneTwister64.hpp>
+#include <tinymt32.h>
+#include <tinymt64.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    enum { steps = 1024, repeat = 2000 };
+
+    double now() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+    }
+
+    void print(const char * name, int lanes, double scalar, double simd,
+               uint64_t sum) {
+        double outputs = static_cast<double>(lanes) * steps * repeat;
+        cout << setw(10) << name << setw(6) << lanes << fixed
+             << setprecision(3)
+             << setw(12) << scalar * 1.0e9 / outputs
+             << setw(12) << simd * 1.0e9 / outputs
+             << setw(10) << setprecision(2) << scalar / simd
+             << "  (" << sum << ")" << endl;
+    }
+
+    template<int L>
+    void bench32(MersenneTwister64& mt) {
+        tinymt32_t ref[L];
+        TinyMT32Lanes<L> lanes;
+        for (int l = 0; l < L; l++) {
+            ref[l].mat1 = static_cast<uint32_t>(mt.next());
+            ref[l].mat2 = static_cast<uint32_t>(mt.next());
+            ref[l].tmat = static_cast<uint32_t>(mt.next());
+            tinymt32_init(&ref[l], 1234);
+            lanes.setParam(l, ref[l].mat1, ref[l].mat2, ref[l].tmat);
+        }
+        lanes.seed(1234);
+        uint32_t * array = new uint32_t[L * steps];
+        uint64_t sum = 0;
+        double start = now();
+        // 参照実装ではレーンごとに steps 個ずつ続けて生成する
+        for (int r = 0; r < repeat; r++) {
+            for (int l = 0; l < L; l++) {
+                for (int t = 0; t < steps; t++) {
+                    array[l * steps + t]
+                        = tinymt32_generate_uint32(&ref[l]);
+                }
+            }
+            sum += array[r % (L * steps)];
+        }
+        double t1 = now();
+        for (int r = 0; r < repeat; r++) {
+            lanes.fill_array(array, steps);
+            sum += array[r % (L * steps)];
+        }
+        double t2 = now();
+        print("tinymt32", L, t1 - start, t2 - t1, sum);
+        delete[] array;
+    }
+
+    template<int L>
+    void bench64(MersenneTwister64& mt) {
+        tinymt64_t ref[L];
+        TinyMT64Lanes<L> lanes;
+        for (int l = 0; l < L; l++) {
+            ref[l].mat1 = static_cast<uint32_t>(mt.next());
+            ref[l].mat2 = static_cast<uint32_t>(mt.next());
+            ref[l].tmat = mt.next();
+            tinymt64_init(&ref[l], 1234);
+            lanes.setParam(l, ref[l].mat1, ref[l].mat2, ref[l].tmat);
+        }
+        lanes.seed(1234);
+        uint64_t * array = new uint64_t[L * steps];
+        uint64_t sum = 0;
+        double start = now();
+        for (int r = 0; r < repeat; r++) {
+            for (int l = 0; l < L; l++) {
+                for (int t = 0; t < steps; t++) {
+                    array[l * steps + t]
+                        = tinymt64_generate_uint64(&ref[l]);
+                }
+            }
+            sum += array[r % (L * steps)];
+        }
+        double t1 = now();
+        for (int r = 0; r < repeat; r++) {
+            lanes.fill_array(array, steps);
+            sum += array[r % (L * steps)];
+        }
+        double t2 = now();
+        print("tinymt64", L, t1 - start, t2 - t1, sum);
+        delete[] array;
+    }
+}
+
+int main(void)
+{
+    MersenneTwister64 mt(1234);
+    cout << "ns per output, vector bytes = "
+         << MTTOOLBOX_TINYMT_VECTOR_BYTES << endl;
+    cout << setw(10) << "generator" << setw(6) << "lanes"
+         << setw(12) << "scalar" << setw(12) << "lanes"
+         << setw(10) << "speedup" << endl;
+    bench32<8>(mt);
+    bench32<16>(mt);
+    bench64<8>(mt);
+    bench64<16>(mt);
+    return 0;
+}
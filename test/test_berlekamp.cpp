@@ -0,0 +1,142 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <MTToolBox/BerlekampMassey.hpp>
+#include <MTToolBox/period.hpp>
+#include <MTToolBox/MersenneTwister.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include <NTL/GF2X.h>
+#include "test_generator.hpp"
+
+using namespace MTToolBox;
+using namespace NTL;
+using namespace std;
+
+namespace {
+    template<typename U>
+    bool check_generator(AbstractGenerator<U>& a, AbstractGenerator<U>& b,
+                         int pos) {
+        GF2X p;
+        GF2X q;
+        minpoly(p, a, pos);
+        minpoly_stream(q, b, pos);
+        return p == q && deg(p) > 0;
+    }
+
+    /* 途中で打ち切った数列も MinPolySeq と一致する */
+    bool check_random() {
+        MersenneTwister mt(5678);
+        for (int length = 1; length < 300; length += 7) {
+            Vec<GF2> v;
+            v.SetLength(length);
+            BerlekampMassey bm(length);
+            for (int i = 0; i < length; i++) {
+                int bit = static_cast<int>(mt.getUint32() & 1);
+                v[i] = bit;
+                bm.push(bit);
+            }
+            GF2X p;
+            GF2X q;
+            MinPolySeq(p, v, length);
+            bm.getMinPoly(q);
+            if (p != q || bm.getCount() != length
+                || bm.getComplexity() != deg(q)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* 全ビット位置の LCM は minpoly() を位置ごとに呼んだ LCM と一致する */
+    /* テスト用の生成器はコピーできないので、毎回作る */
+    AbstractGenerator<uint32_t> * make_rtiny() {
+        return new RTiny32(0x59c94057, 0xfd77d893, 15, 16, 3, 9, 1234);
+    }
+
+    AbstractGenerator<uint32_t> * make_rlittle() {
+        return new RLittle32(0x80903834, 7, 1, 31, 26, 26, 1234);
+    }
+
+    bool check_lcm(AbstractGenerator<uint32_t> * (*make)()) {
+        GF2X expected;
+        NTL::set(expected);
+        for (int pos = 0; pos < 32; pos++) {
+            AbstractGenerator<uint32_t> * a = make();
+            int size = a->bitSize();
+            if (deg(expected) == size) {
+                delete a;
+                break;
+            }
+            GF2X p;
+            minpoly(p, *a, pos);
+            LCM(expected, expected, p);
+            delete a;
+        }
+        for (int threads = 1; threads <= 3; threads += 2) {
+            AbstractGenerator<uint32_t> * b = make();
+            GF2X q;
+            lcm_minpoly(q, *b, 0, threads);
+            delete b;
+            if (q != expected) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool check_overflow() {
+        BerlekampMassey bm(3);
+        bm.push(1);
+        bm.push(0);
+        bm.push(1);
+        try {
+            bm.push(1);
+        } catch (length_error& e) {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main() {
+    cout << "testing streaming berlekamp massey ...";
+    bool ok = check_random() && check_overflow();
+    for (int pos = 0; ok && pos < 32; pos += 9) {
+        Tiny32 a(1234);
+        Tiny32 b(1234);
+        ok = check_generator(a, b, pos);
+    }
+    if (ok) {
+        Tiny64 a(1234);
+        Tiny64 b(1234);
+        ok = check_generator(a, b, 63);
+    }
+    if (ok) {
+        // 可約な場合
+        RTiny32 a(0x59c94057, 0xfd77d893, 15, 16, 3, 9, 1234);
+        RTiny32 b(0x59c94057, 0xfd77d893, 15, 16, 3, 9, 1234);
+        ok = check_generator(a, b, 0);
+    }
+    if (ok) {
+        RLittle32 a(0x80903834, 7, 1, 31, 26, 26, 1234);
+        RLittle32 b(0x80903834, 7, 1, 31, 26, 26, 1234);
+        ok = check_generator(a, b, 5);
+    }
+    if (ok) {
+        ok = check_lcm(make_rtiny) && check_lcm(make_rlittle);
+    }
+    if (ok) {
+        stringstream ss;
+        Tiny32 a(1234);
+        GF2X p;
+        minpoly_stream(p, a, 0, 0, &ss);
+        ok = !ss.str().empty();
+    }
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
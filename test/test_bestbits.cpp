@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <MTToolBox/AlgorithmBestBits.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include "test_temper_searcher.hpp"
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    const int shifts[] = {1, 2};
+
+    /*
+     * MT と同じ形のテンパリングを TinyMT の出力に重ねる
+     * y ^= (y << 1) & b; y ^= (y << 2) & c;
+     * シフトが小さいので、c の探索で一度決めた b のビットが数ビット
+     * 後で書き換えられ、ビームの中に同じパターンができる。
+     */
+    class Tempered32 : public Tiny32 {
+    public:
+        Tempered32(uint32_t seed) : Tiny32(seed) {
+            b = 0;
+            c = 0;
+        }
+        Tempered32 * clone() const {
+            return new Tempered32(*this);
+        }
+        uint32_t generate() {
+            uint32_t y = Tiny32::generate();
+            y ^= (y << shifts[0]) & b;
+            y ^= (y << shifts[1]) & c;
+            return y;
+        }
+        uint32_t generate(int outBitLen) {
+            uint32_t mask = 0;
+            mask = (~mask) << (32 - outBitLen);
+            return generate() & mask;
+        }
+        void setTemperingPattern(uint32_t mask, uint32_t pattern,
+                                 int index) {
+            uint32_t& t = index == 0 ? b : c;
+            t &= ~mask;
+            t |= pattern & mask;
+        }
+        const std::string getParamString() {
+            stringstream ss;
+            ss << Tiny32::getParamString();
+            ss << "b:" << hex << b << endl;
+            ss << "c:" << hex << c << endl;
+            return ss.str();
+        }
+    private:
+        uint32_t b;
+        uint32_t c;
+    };
+
+    bool check(size_t budget) {
+        Tempered32 memo(1234);
+        Tempered32 plain(1234);
+        AlgorithmBestBits<uint32_t> st(32, shifts, 2, 4);
+        st.setMemoBudget(budget);
+        AlgorithmBestBits<uint32_t> stPlain(32, shifts, 2, 4);
+        stPlain.setMemoBudget(0);
+        st(memo, false);
+        stPlain(plain, false);
+        // 覚えた結果を使っても同じテンパリングパラメータになる
+        if (memo.getParamString() != plain.getParamString()) {
+            return false;
+        }
+        if (stPlain.getMemoHits() != 0) {
+            return false;
+        }
+        return st.getMemoHits() > 0
+            && st.getMemoHits() + st.getMemoMisses()
+            == stPlain.getMemoMisses();
+    }
+}
+
+int main(void)
+{
+    cout << "testing best bits memo ...";
+    // 既定の上限と、途中で一杯になる上限
+    if (!check(16 * 1024 * 1024) || !check(4096)) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    cout << "ok" << endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <iomanip>
+#include <MTToolBox/bitops.hpp>
+#include <MTToolBox/util.hpp>
+#include <MTToolBox/MersenneTwister64.hpp>
+//#include <UnitTest++/UnitTest++.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    const char * names[] = {"generic", "popcnt", "bmi2", "avx512", NULL};
+
+    /* 1ビットずつ計算した結果と比較する */
+    bool check(const bit_primitives_t& bp, MersenneTwister64& mt) {
+        uint64_t array[21];
+        for (int k = 0; k < 1000; k++) {
+            int n = static_cast<int>(mt.getUint64() % 22);
+            for (int i = 0; i < n; i++) {
+                array[i] = mt.getUint64();
+                if (k % 3 == 0) {
+                    array[i] &= mt.getUint64() & mt.getUint64();
+                }
+                if (k % 5 == 0 && i != n / 2) {
+                    array[i] = 0;
+                }
+            }
+            int count = 0;
+            int lowest = -1;
+            int highest = -1;
+            for (int i = 0; i < 64 * n; i++) {
+                if ((array[i / 64] >> (i % 64)) & 1) {
+                    count++;
+                    if (lowest < 0) {
+                        lowest = i;
+                    }
+                    highest = i;
+                }
+            }
+            if (bp.count_bit(array, n) != count
+                || bp.lowest_one(array, n) != lowest
+                || bp.highest_one(array, n) != highest) {
+                return false;
+            }
+            uint64_t x = mt.getUint64();
+            uint64_t mask = mt.getUint64();
+            uint64_t expected = 0;
+            for (int i = 0, j = 0; i < 64; i++) {
+                if ((mask >> i) & 1) {
+                    expected |= ((x >> i) & 1) << j;
+                    j++;
+                }
+            }
+            if (bp.extract_bits(x, mask) != expected) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* util.hpp の関数を1ビットずつ計算した結果と比較する */
+    bool check_util(MersenneTwister64& mt) {
+        for (int k = 0; k < 1000; k++) {
+            uint64_t x = mt.getUint64() & mt.getUint64();
+            uint32_t y = static_cast<uint32_t>(x);
+            int count = 0;
+            int pos = -1;
+            uint64_t rev = 0;
+            for (int i = 0; i < 64; i++) {
+                uint64_t b = (x >> i) & 1;
+                count += static_cast<int>(b);
+                if (b && pos < 0) {
+                    pos = 63 - i;
+                }
+                rev |= b << (63 - i);
+            }
+            if (count_bit(x) != count || calc_1pos(x) != pos
+                || reverse_bit(x) != rev) {
+                return false;
+            }
+            if (count_bit(y) != count_bit(x & 0xffffffffU)
+                || reverse_bit(y) != static_cast<uint32_t>(rev >> 32)
+                || calc_1pos(y) != (y == 0 ? -1 : pos - 32)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(void)
+{
+    cout << "testing bit primitives ...";
+    MersenneTwister64 mt(1234);
+    if (!check_util(mt)) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    for (int i = 0; names[i] != NULL; i++) {
+        const bit_primitives_t * bp = bit_primitives_by_name(names[i]);
+        if (bp == NULL) {
+            continue;
+        }
+        if (!check(*bp, mt)) {
+            cout << names[i] << " NG" << endl;
+            return -1;
+        }
+    }
+    cout << "ok (" << bit_primitives().name << ")" << endl;
+    return 0;
+}
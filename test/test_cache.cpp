@@ -0,0 +1,206 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <MTToolBox/AnalysisCache.hpp>
+#include <MTToolBox/Parallel.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include <NTL/GF2X.h>
+
+using namespace MTToolBox;
+using namespace NTL;
+using namespace std;
+
+namespace {
+    enum { workers = 4 };
+
+    void make_poly(GF2X& poly, long degree, long step) {
+        clear(poly);
+        for (long i = 0; i < degree; i += step) {
+            SetCoeff(poly, i, 1);
+        }
+        SetCoeff(poly, degree, 1);
+    }
+
+    bool check_store(const string& dir) {
+        AnalysisCache cache(dir);
+        string key = AnalysisCache::makeKey("test", "1,2,3");
+        AnalysisRecord r;
+        if (cache.lookup(key, r)) {
+            return false;
+        }
+        make_poly(r.minpoly, 19937, 3);
+        make_poly(r.factor, 521, 5);
+        r.parity.push_back(1);
+        r.parity.push_back(UINT64_C(0x8000000000000000));
+        int veq[5] = {100, 50, -1, 25, 0};
+        r.setVeq("veq", veq, 5);
+        cache.store(key, r);
+
+        // 別のオブジェクトから読む
+        AnalysisCache other(dir);
+        AnalysisRecord s;
+        int v[5];
+        if (!other.lookup(key, s) || s.minpoly != r.minpoly
+            || s.factor != r.factor || s.parity != r.parity
+            || !s.getVeq("veq", v, 5) || s.getVeq("veq", v, 4)) {
+            return false;
+        }
+        for (int i = 0; i < 5; i++) {
+            if (v[i] != veq[i]) {
+                return false;
+            }
+        }
+        // 違うキーは見つからない
+        AnalysisRecord t;
+        if (other.lookup(AnalysisCache::makeKey("test", "1,2,4"), t)
+            || other.lookup(AnalysisCache::makeKey("tset", "1,2,3"), t)) {
+            return false;
+        }
+
+        // 記録した項目だけ置き換わる
+        AnalysisRecord u;
+        int lsb[2] = {7, 8};
+        u.setVeq("lsb", lsb, 2);
+        make_poly(u.factor, 127, 2);
+        other.store(key, u);
+        AnalysisRecord w;
+        return cache.lookup(key, w) && w.minpoly == r.minpoly
+            && w.factor == u.factor && w.parity == r.parity
+            && w.getVeq("veq", v, 5) && w.getVeq("lsb", lsb, 2);
+    }
+
+    /* store_items() で書いた項目がすべて揃っているか調べる */
+    bool check_items(const AnalysisRecord& r) {
+        if (r.veq.size() != static_cast<size_t>(workers * 20)) {
+            return false;
+        }
+        for (int i = 0; i < workers; i++) {
+            for (int j = 0; j < 20; j++) {
+                stringstream ss;
+                ss << "veq" << dec << i << "-" << j;
+                int v[1];
+                if (!r.getVeq(ss.str(), v, 1) || v[0] != i * 100 + j) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /* i 番目のワーカーの項目を一つずつ書く */
+    void store_items(AnalysisCache& cache, const string& key, int i) {
+        for (int j = 0; j < 20; j++) {
+            AnalysisRecord r;
+            stringstream ss;
+            ss << "veq" << dec << i << "-" << j;
+            int v[1] = {i * 100 + j};
+            r.setVeq(ss.str(), v, 1);
+            cache.store(key, r);
+        }
+    }
+
+    /*
+     * 同じプロセスの複数のスレッドが書いても失われない。
+     * 半分のスレッドは同じオブジェクトを、残りは自分のオブジェクトを
+     * 使う。
+     */
+    class Storer : public Runnable {
+    public:
+        Storer(const string& dir, const string& key)
+            : shared(dir), dir(dir), key(key) {}
+        void run(int index) {
+            try {
+                if (index % 2 == 0) {
+                    store_items(shared, key, index);
+                } else {
+                    AnalysisCache own(dir);
+                    store_items(own, key, index);
+                }
+            } catch (...) {
+                error.capture();
+            }
+        }
+        FirstError error;
+    private:
+        AnalysisCache shared;
+        const string dir;
+        const string key;
+    };
+
+    bool check_threads(const string& dir) {
+        string key = AnalysisCache::makeKey("test", "threads");
+        Storer storer(dir, key);
+        WorkerPool pool;
+        pool.start(storer, workers);
+        pool.join();
+        if (storer.error.failed()) {
+            return false;
+        }
+        AnalysisCache cache(dir);
+        AnalysisRecord r;
+        return cache.lookup(key, r) && check_items(r);
+    }
+
+    /* 複数のプロセスが同じキーに別の項目を書いても失われない */
+    bool check_concurrent(const string& dir) {
+        string key = AnalysisCache::makeKey("test", "concurrent");
+        pid_t pids[workers];
+        for (int i = 0; i < workers; i++) {
+            pids[i] = fork();
+            if (pids[i] < 0) {
+                return false;
+            }
+            if (pids[i] == 0) {
+                try {
+                    AnalysisCache cache(dir);
+                    store_items(cache, key, i);
+                } catch (exception& e) {
+                    cerr << e.what() << endl;
+                    _exit(1);
+                }
+                _exit(0);
+            }
+        }
+        bool ok = true;
+        for (int i = 0; i < workers; i++) {
+            int status;
+            if (waitpid(pids[i], &status, 0) < 0 || !WIFEXITED(status)
+                || WEXITSTATUS(status) != 0) {
+                ok = false;
+            }
+        }
+        AnalysisCache cache(dir);
+        AnalysisRecord r;
+        return ok && cache.lookup(key, r) && check_items(r);
+    }
+}
+
+int main() {
+    cout << "testing analysis cache ...";
+    stringstream ss;
+    ss << "test_cache." << dec << getpid() << ".dir";
+    string dir = ss.str();
+    bool ok;
+    try {
+        ok = check_store(dir) && check_concurrent(dir)
+            && check_threads(dir);
+    } catch (exception& e) {
+        cout << e.what() << endl;
+        ok = false;
+    }
+    string cmd = "rm -rf " + dir;
+    if (system(cmd.c_str()) != 0) {
+        ok = false;
+    }
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
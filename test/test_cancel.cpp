@@ -0,0 +1,136 @@
+#include <iostream>
+#include <sstream>
+#include <signal.h>
+#include <MTToolBox/Cancellation.hpp>
+#include <MTToolBox/AlgorithmRecursionSearch.hpp>
+#include <MTToolBox/AlgorithmRecursionAndTempering.hpp>
+#include <MTToolBox/AlgorithmPartialBitPattern.hpp>
+#include <MTToolBox/AlgorithmEquidistribution.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include "test_temper_searcher.hpp"
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    typedef AlgorithmPartialBitPattern<uint32_t, 32, 1, 23, 6, false> st32;
+    typedef AlgorithmPartialBitPattern<uint32_t, 32, 1, 9, 5, true> stlsb32;
+
+    bool check_token() {
+        CancellationToken token;
+        if (token.isCancelled() || token.remaining() >= 0
+            || is_cancelled(NULL)) {
+            return false;
+        }
+        token.setTimeLimit(100);
+        double r = token.remaining();
+        if (token.isCancelled() || r <= 0 || r > 100) {
+            return false;
+        }
+        token.setTimeLimit(0);
+        if (!token.isCancelled() || token.remaining() != 0) {
+            return false;
+        }
+        token.clearTimeLimit();
+        if (token.isCancelled()) {
+            return false;
+        }
+        token.cancel();
+        try {
+            token.throwIfCancelled();
+            return false;
+        } catch (Cancelled&) {
+            return is_cancelled(&token);
+        }
+    }
+
+    /* 打ち切られたら最小多項式を計算せずに false を返す */
+    bool check_recursion() {
+        CancellationToken token;
+        token.cancel();
+        Tiny32 tiny(1234);
+        MersenneTwister mt;
+        AlgorithmRecursionSearch<uint32_t> search(tiny, mt);
+        search.setCancellation(&token);
+        return !search.start(10000) && search.getCount() == 0;
+    }
+
+    /* 期限を過ぎていれば、均等分布次元の計算は Cancelled を投げる */
+    bool check_equidist() {
+        Tiny32 tiny(0x8f7011ee, 0xfc78ff1f, 0x3793fdff, 1234);
+        int veq[32];
+        CancellationToken token;
+        AlgorithmEquidistribution<uint32_t> plain(tiny, 32);
+        plain.setCancellation(&token);
+        int delta = plain.get_all_equidist(veq);
+        token.setTimeLimit(0);
+        AlgorithmEquidistribution<uint32_t> sb(tiny, 32);
+        sb.setCancellation(&token);
+        try {
+            sb.get_all_equidist(veq);
+            return false;
+        } catch (Cancelled&) {
+            return delta >= 0;
+        }
+    }
+
+    /*
+     * 原始多項式を見つける前に打ち切られると false、テンパリングの
+     * 探索中に打ち切られると、設定したパラメータの delta を持って戻る。
+     */
+    bool check_tempering() {
+        CancellationToken token;
+        token.cancel();
+        MersenneTwister mt1;
+        Tiny32 tiny1(0x8f7011ee, 0xfc78ff1f, 0, 1234);
+        st32 st;
+        stlsb32 stlsb;
+        AlgorithmRecursionAndTempering<uint32_t> all(mt1);
+        all.setCancellation(&token);
+        if (all.search(tiny1, st, stlsb, false) || all.isComplete()) {
+            return false;
+        }
+        MersenneTwister mt2;
+        Tiny32 tiny2(0x8f7011ee, 0xfc78ff1f, 0, 1234);
+        AlgorithmRecursionSearch<uint32_t> search(tiny2, mt2);
+        if (!search.start(10000)) {
+            return false;
+        }
+        st.setCancellation(&token);
+        st(tiny2, false);
+        int veq[32];
+        AlgorithmEquidistribution<uint32_t> sb(tiny2, 32);
+        int delta = sb.get_all_equidist(veq);
+        return delta >= 0;
+    }
+
+    /* シグナルを受け取ると、すべてのトークンが打ち切りを指示する */
+    bool check_signal() {
+        CancellationToken token;
+        if (CancellationToken::signalled()) {
+            return false;
+        }
+        CancellationToken::handleSignals();
+        raise(SIGTERM);
+        return CancellationToken::signalled() && token.isCancelled();
+    }
+}
+
+int main() {
+    cout << "testing cancellation ...";
+    bool ok;
+    try {
+        ok = check_token() && check_recursion() && check_equidist()
+            && check_tempering() && check_signal();
+    } catch (exception& e) {
+        cout << e.what() << endl;
+        ok = false;
+    }
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
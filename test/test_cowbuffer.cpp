@@ -0,0 +1,74 @@
+#include <iostream>
+#include <stdint.h>
+#include <MTToolBox/CowBuffer.hpp>
+//#include <UnitTest++/UnitTest++.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    bool check_share() {
+        CowBuffer<uint32_t> a(10);
+        for (int i = 0; i < 10; i++) {
+            if (a[i] != 0) {
+                return false;
+            }
+            a[i] = static_cast<uint32_t>(i + 1);
+        }
+        CowBuffer<uint32_t> b(a);
+        // コピーは配列を共有する
+        if (!a.isShared() || !b.isShared() || a.data() != b.data()) {
+            return false;
+        }
+        // 書き込むと b だけが複製を持つ
+        b[3] = 100;
+        if (a.isShared() || b.isShared() || a.data() == b.data()
+            || a[3] != 4 || b[3] != 100 || b[4] != 5) {
+            return false;
+        }
+        // 代入も共有する
+        b = a;
+        if (a.data() != b.data() || b[3] != 4) {
+            return false;
+        }
+        return true;
+    }
+
+    bool check_zero() {
+        CowBuffer<uint64_t> a(5);
+        for (int i = 0; i < 5; i++) {
+            a[i] = UINT64_C(0xffffffffffffffff);
+        }
+        const uint64_t * p = a.data();
+        CowBuffer<uint64_t> b(a);
+        // 共有中の setZero は元の配列に触れない
+        b.setZero();
+        if (a.data() != p || b.data() == p || a.isShared()) {
+            return false;
+        }
+        for (int i = 0; i < 5; i++) {
+            const CowBuffer<uint64_t>& ca = a;
+            const CowBuffer<uint64_t>& cb = b;
+            if (ca[i] != UINT64_C(0xffffffffffffffff) || cb[i] != 0) {
+                return false;
+            }
+        }
+        // 共有していなければ同じ配列を 0 にする
+        a.setZero();
+        if (a.data() != p || a[0] != 0) {
+            return false;
+        }
+        return true;
+    }
+}
+
+int main() {
+    cout << "testing copy on write buffer ...";
+    if (check_share() && check_zero()) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <stdint.h>
+#include <MTToolBox/SourceEmitter.hpp>
+//#include <UnitTest++/UnitTest++.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    bool contains(const string& text, const string& part) {
+        return text.find(part) != string::npos;
+    }
+
+    bool check_identifier() {
+        if (!SourceEmitter::isIdentifier("sfmt607_0")
+            || !SourceEmitter::isIdentifier("_x1")
+            || SourceEmitter::isIdentifier("")
+            || SourceEmitter::isIdentifier("1x")
+            || SourceEmitter::isIdentifier("a-b")) {
+            return false;
+        }
+        ostringstream os;
+        try {
+            SourceEmitter e(os, "bad name");
+            return false;
+        } catch (invalid_argument&) {
+            return true;
+        }
+    }
+
+    bool check_output() {
+        ostringstream os;
+        SourceEmitter e(os, "gen_1");
+        e.beginHeader("first\n\nsecond");
+        e.open("class gen_1");
+        e.enumConstant("N", 5);
+        e.constant32("MSK", UINT32_C(0xabc));
+        e.constant64("MSK64", UINT64_C(0x123456789));
+        vector<uint32_t> v;
+        for (uint32_t i = 1; i <= 5; i++) {
+            v.push_back(i);
+        }
+        e.array32("expected", v);
+        e.close(";");
+        e.endHeader();
+        string s = os.str();
+        // 説明の空行は " *" になり、ブロックの中は４桁ずつ字下げされる
+        return contains(s, " * gen_1.h\n")
+            && contains(s, " * first\n *\n * second\n */\n")
+            && contains(s, "#ifndef GEN_1_H\n#define GEN_1_H\n")
+            && contains(s, "#include <stdint.h>\n")
+            && contains(s, "class gen_1 {\n")
+            && contains(s, "    enum { N = 5 };\n")
+            && contains(s, "    static const uint32_t MSK"
+                        " = UINT32_C(0x00000abc);\n")
+            && contains(s, "    static const uint64_t MSK64"
+                        " = UINT64_C(0x0000000123456789);\n")
+            && contains(s, "    static const uint32_t expected[] = {\n"
+                        "        UINT32_C(0x00000001), UINT32_C(0x00000002),"
+                        " UINT32_C(0x00000003), UINT32_C(0x00000004),\n"
+                        "        UINT32_C(0x00000005),\n"
+                        "    };\n")
+            && contains(s, "};\n#endif /* GEN_1_H */\n");
+    }
+}
+
+int main() {
+    cout << "testing source emitter ...";
+    if (check_identifier() && check_output()) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
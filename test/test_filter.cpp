@@ -0,0 +1,263 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <MTToolBox/ParameterFilter.hpp>
+#include <MTToolBox/AlgorithmRecursionSearch.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include "test_generator.hpp"
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    enum { keys = 1000, workers = 4 };
+
+    const string make_key(const char * prefix, int i) {
+        stringstream ss;
+        ss << prefix << dec << i << "\nmat2:" << hex << i * 7;
+        return ss.str();
+    }
+
+    /* 記録したものは必ず見つかり、誤って見つかるものは少ない */
+    bool check_bloom_memory() {
+        BloomParameterFilter filter("", 1 << 16, 7);
+        for (int i = 0; i < keys; i++) {
+            filter.reject(make_key("a", i));
+        }
+        for (int i = 0; i < keys; i++) {
+            if (!filter.rejected(make_key("a", i))) {
+                return false;
+            }
+        }
+        int false_positive = 0;
+        for (int i = 0; i < keys; i++) {
+            if (filter.rejected(make_key("b", i))) {
+                false_positive++;
+            }
+        }
+        // 理論値はおよそ 0.0001%
+        return false_positive < 10 && filter.getInserts() == keys
+            && filter.getLookups() == 2 * keys
+            && filter.getHits() == keys + false_positive
+            && filter.getHitRate() >= 0.5;
+    }
+
+    /* ファイルの記録は次のインスタンスや他のプロセスから見える */
+    bool check_bloom_file(const string& path) {
+        {
+            BloomParameterFilter filter(path, 1000, 5);
+            if (filter.getBits() != 1024 || filter.getHashes() != 5) {
+                return false;
+            }
+            for (int i = 0; i < 10; i++) {
+                filter.reject(make_key("a", i));
+            }
+        }
+        pid_t pids[workers];
+        for (int w = 0; w < workers; w++) {
+            pids[w] = fork();
+            if (pids[w] < 0) {
+                return false;
+            }
+            if (pids[w] == 0) {
+                try {
+                    BloomParameterFilter filter(path);
+                    for (int i = 0; i < 10; i++) {
+                        filter.reject(make_key("w", w * 100 + i));
+                    }
+                } catch (exception& e) {
+                    cerr << e.what() << endl;
+                    _exit(1);
+                }
+                _exit(0);
+            }
+        }
+        for (int w = 0; w < workers; w++) {
+            int status;
+            if (waitpid(pids[w], &status, 0) < 0 || !WIFEXITED(status)
+                || WEXITSTATUS(status) != 0) {
+                return false;
+            }
+        }
+        // 既存のファイルの大きさが使われる
+        BloomParameterFilter filter(path, 1 << 20, 7);
+        if (filter.getBits() != 1024 || filter.getHashes() != 5) {
+            return false;
+        }
+        for (int i = 0; i < 10; i++) {
+            if (!filter.rejected(make_key("a", i))) {
+                return false;
+            }
+            for (int w = 0; w < workers; w++) {
+                if (!filter.rejected(make_key("w", w * 100 + i))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool check_wrong_file(const string& path) {
+        FILE * fp = fopen(path.c_str(), "w");
+        if (fp == NULL) {
+            return false;
+        }
+        fputs("not a filter", fp);
+        fclose(fp);
+        try {
+            BloomParameterFilter filter(path);
+            return false;
+        } catch (runtime_error&) {
+            return true;
+        }
+    }
+
+    /* 改行を含むキーも正確に読み戻せる */
+    bool check_exact_file(const string& path) {
+        {
+            ExactParameterFilter filter(path);
+            for (int i = 0; i < 10; i++) {
+                filter.reject(make_key("a", i));
+            }
+            filter.reject(make_key("a", 0));
+            if (filter.size() != 10 || filter.rejected(make_key("b", 0))) {
+                return false;
+            }
+        }
+        ExactParameterFilter filter(path);
+        if (filter.size() != 10) {
+            return false;
+        }
+        for (int i = 0; i < 10; i++) {
+            if (!filter.rejected(make_key("a", i))) {
+                return false;
+            }
+        }
+        return !filter.rejected(make_key("a", 10));
+    }
+
+    /*
+     * 見つかった後に設定される値 (SFMT のパリティベクトルのような) を
+     * パラメータ文字列に含む生成器
+     */
+    class Stamped32 : public Tiny32 {
+    public:
+        Stamped32(uint32_t seed) : Tiny32(seed) {
+            stamp = 0;
+        }
+
+        Stamped32 * clone() const {
+            return new Stamped32(*this);
+        }
+
+        void setStamp(int value) {
+            stamp = value;
+        }
+
+        const std::string getParamString() {
+            std::stringstream ss;
+            ss << Tiny32::getParamString() << "stamp:" << dec << stamp;
+            return ss.str();
+        }
+
+        const std::string getRecursionKey() {
+            return Tiny32::getParamString();
+        }
+    private:
+        int stamp;
+    };
+
+    /*
+     * 二つ目のパラメータを見つけるまでに棄却したパラメータは、一つ目を
+     * 見つけた後の値が違っても、探索しなおすと飛ばされる。
+     */
+    long search_twice(ParameterFilter& filter, int stamp, long& skipped) {
+        Stamped32 g(1234);
+        MersenneTwister mt;
+        AlgorithmRecursionSearch<uint32_t> search(g, mt);
+        search.setFilter(&filter);
+        if (!search.start(10000)) {
+            return -1;
+        }
+        g.setStamp(stamp);
+        if (!search.start(10000)) {
+            return -1;
+        }
+        skipped = search.getSkipped();
+        return search.getCount();
+    }
+
+    bool check_recursion_key() {
+        ExactParameterFilter filter;
+        long skipped;
+        long count = search_twice(filter, 1, skipped);
+        if (count < 0 || skipped != 0
+            || filter.size() != static_cast<size_t>(count - 2)) {
+            return false;
+        }
+        long again = search_twice(filter, 2, skipped);
+        return again == 2 && skipped == count - 2
+            && filter.size() == static_cast<size_t>(count - 2);
+    }
+
+    /*
+     * 同じ種で探索しなおすと、前回棄却したパラメータは最小多項式を
+     * 計算せずに飛ばされ、同じパラメータが見つかる。
+     */
+    bool check_search() {
+        ExactParameterFilter filter;
+        Tiny32 tiny1(1234);
+        MersenneTwister mt1;
+        AlgorithmRecursionSearch<uint32_t> first(tiny1, mt1);
+        first.setFilter(&filter);
+        if (!first.start(10000)) {
+            return false;
+        }
+        long rejected = first.getCount() - 1;
+        if (first.getSkipped() != 0
+            || filter.size() != static_cast<size_t>(rejected)) {
+            return false;
+        }
+        Tiny32 tiny2(1234);
+        MersenneTwister mt2;
+        AlgorithmRecursionSearch<uint32_t> second(tiny2, mt2);
+        second.setFilter(&filter);
+        if (!second.start(10000)) {
+            return false;
+        }
+        return second.getSkipped() == rejected && second.getCount() == 1
+            && second.getParamString() == first.getParamString()
+            && filter.getHits() == rejected;
+    }
+}
+
+int main() {
+    cout << "testing parameter filter ...";
+    stringstream ss;
+    ss << "test_filter." << dec << getpid();
+    string bloom = ss.str() + ".bloom";
+    string wrong = ss.str() + ".wrong";
+    string exact = ss.str() + ".exact";
+    bool ok;
+    try {
+        ok = check_bloom_memory() && check_bloom_file(bloom)
+            && check_wrong_file(wrong) && check_exact_file(exact)
+            && check_search() && check_recursion_key();
+    } catch (exception& e) {
+        cout << e.what() << endl;
+        ok = false;
+    }
+    unlink(bloom.c_str());
+    unlink(wrong.c_str());
+    unlink(exact.c_str());
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
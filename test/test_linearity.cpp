@@ -9,6 +9,84 @@ using namespace MTToolBox;
 using namespace NTL;
 using namespace std;
 
+namespace {
+    /*
+     * 501 個目からの出力が線形でない生成器
+     * 既定の 100 個の検査では見つからない。
+     */
+    class Late32 : public Tiny32 {
+    public:
+        Late32(uint32_t seed) : Tiny32(seed) {
+            count = 0;
+        }
+        Late32 * clone() const {
+            return new Late32(*this);
+        }
+        uint32_t generate() {
+            uint32_t y = Tiny32::generate();
+            count++;
+            if (count > 500) {
+                y |= 1;
+            }
+            return y;
+        }
+    private:
+        int count;
+    };
+
+    /*
+     * 種が 0x10000 以上だと状態がゼロになる生成器
+     * 決まった種 1234, 4321 では見つからない。
+     */
+    class LowSeed32 : public Tiny32 {
+    public:
+        LowSeed32(uint32_t seed) : Tiny32(seed) {}
+        LowSeed32 * clone() const {
+            return new LowSeed32(*this);
+        }
+        void seed(uint32_t value) {
+            if (value >= 0x10000) {
+                setZero();
+            } else {
+                Tiny32::seed(value);
+            }
+        }
+    };
+
+    /* 決まった種の組ではなく、でたらめな種の組で見つかったこと */
+    bool found_by_random(const TestLinearity<uint32_t>& TL,
+                         const char * check) {
+        const string& failure = TL.getFailure();
+        return failure.find(check) == 0
+            && failure.find("seeds 1234, 4321") == string::npos;
+    }
+
+    bool check_random(int threads) {
+        Tiny32 tiny(0x8f7011ee, 0xfc78ff1f, 0, 1234);
+        TestLinearity<uint32_t> TL;
+        TL.setTrials(100);
+        TL.setLength(1000);
+        TL.setThreads(threads);
+        if (!TL(tiny) || !TL.getFailure().empty()) {
+            return false;
+        }
+        Late32 late(1234);
+        TestLinearity<uint32_t> fixed;
+        if (!fixed(late)) {
+            return false;
+        }
+        // 決まった種の組は setLength() によらず 100 個しか比べない
+        if (TL(late) || !found_by_random(TL, "add self failed")) {
+            return false;
+        }
+        LowSeed32 low(1234);
+        if (!fixed(low)) {
+            return false;
+        }
+        return !TL(low) && found_by_random(TL, "isZero failed");
+    }
+}
+
 int main(void)
 {
     cout << "testing linearity ...";
@@ -18,6 +96,10 @@ int main(void)
         cout << "NG" << endl;
         return -1;
     }
+    if (!check_random(1) || !check_random(4)) {
+        cout << "NG" << endl;
+        return -1;
+    }
     cout << "ok" << endl;
     return 0;
 }
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <MTToolBox/AlgorithmFieldEquidistribution.hpp>
+#include <MTToolBox/AlgorithmEquidistribution.hpp>
+#include <MTToolBox/GF2Echelon.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include "test_generator.hpp"
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    /* 出力のビットを反転する。上位ビットの均等分布が最良でなくなる */
+    class Reversed : public EquidistributionCalculatable<uint32_t> {
+    public:
+        Reversed(uint32_t seed) : inner(seed) {}
+        Reversed(const Reversed& that) :
+            EquidistributionCalculatable<uint32_t>(), inner(that.inner) {}
+        Reversed * clone() const {
+            return new Reversed(*this);
+        }
+        uint32_t generate() {
+            return reverse_bit(inner.generate());
+        }
+        uint32_t generate(int outBitLen) {
+            uint32_t mask = 0;
+            mask = (~mask) << (32 - outBitLen);
+            return generate() & mask;
+        }
+        void seed(uint32_t value) {
+            inner.seed(value);
+        }
+        int bitSize() const {
+            return inner.bitSize();
+        }
+        void add(EquidistributionCalculatable<uint32_t>& other) {
+            Reversed * that = dynamic_cast<Reversed *>(&other);
+            if (that == 0) {
+                throw std::invalid_argument(
+                    "the adder should have the same type as the addee.");
+            }
+            inner.add(that->inner);
+        }
+        void setZero() {
+            inner.setZero();
+        }
+        bool isZero() const {
+            return inner.isZero();
+        }
+        void setUpParam(ParameterGenerator& mt) {
+            inner.setUpParam(mt);
+        }
+        const std::string getHeaderString() {
+            return inner.getHeaderString();
+        }
+        const std::string getParamString() {
+            return inner.getParamString();
+        }
+    private:
+        Tiny32 inner;
+    };
+
+    /*
+     * 連続する二つの出力の上位 28 ビットを、64 ビットの各レーンの
+     * 下位 28 ビットに詰める。
+     */
+    class Paired : public EquidistributionCalculatable<uint64_t> {
+    public:
+        Paired(uint32_t seed) : inner(seed) {}
+        Paired(const Paired& that) :
+            EquidistributionCalculatable<uint64_t>(), inner(that.inner) {}
+        Paired * clone() const {
+            return new Paired(*this);
+        }
+        uint64_t generate() {
+            uint64_t x = inner.generate() >> 4;
+            uint64_t y = inner.generate() >> 4;
+            return x | (y << 32);
+        }
+        uint64_t generate(int outBitLen) {
+            uint64_t mask = 0;
+            mask = (~mask) << (64 - outBitLen);
+            return generate() & mask;
+        }
+        void seed(uint64_t value) {
+            inner.seed(static_cast<uint32_t>(value));
+        }
+        int bitSize() const {
+            return inner.bitSize();
+        }
+        void add(EquidistributionCalculatable<uint64_t>& other) {
+            Paired * that = dynamic_cast<Paired *>(&other);
+            if (that == 0) {
+                throw std::invalid_argument(
+                    "the adder should have the same type as the addee.");
+            }
+            inner.add(that->inner);
+        }
+        void setZero() {
+            inner.setZero();
+        }
+        bool isZero() const {
+            return inner.isZero();
+        }
+        void setUpParam(ParameterGenerator& mt) {
+            inner.setUpParam(mt);
+        }
+        const std::string getHeaderString() {
+            return inner.getHeaderString();
+        }
+        const std::string getParamString() {
+            return inner.getParamString();
+        }
+    private:
+        Reversed inner;
+    };
+
+    /*
+     * フィールドの列は元の生成器の出力列と同じなので、どちらの
+     * レーンから数えても元の生成器の PIS 法の結果と同じになる。
+     */
+    bool check_field(uint32_t seed) {
+        Reversed reversed(seed);
+        Paired paired(seed);
+        AlgorithmEquidistribution<uint32_t> pis(reversed, 28);
+        AlgorithmFieldEquidistribution<uint64_t> field(paired, 2, 27, 28);
+        int veq1[28];
+        int veq2[28];
+        int delta1 = pis.get_all_equidist(veq1);
+        int delta2 = field.get_all_equidist(veq2);
+        if (delta1 != delta2) {
+            return false;
+        }
+        for (int i = 0; i < 28; i++) {
+            if (veq1[i] != veq2[i]) {
+                return false;
+            }
+        }
+        return field.get_equidist_v(5) == veq1[4];
+    }
+
+    bool check_echelon() {
+        GF2Echelon echelon(70);
+        uint64_t v[4][2] = {{2, UINT64_C(1) << 5},
+                            {0, UINT64_C(1) << 5},
+                            {2, 0},
+                            {1, 0}};
+        bool independent[4] = {true, true, false, true};
+        for (int i = 0; i < 4; i++) {
+            if (echelon.add(v[i]) != independent[i]) {
+                return false;
+            }
+        }
+        if (echelon.rank() != 3) {
+            return false;
+        }
+        echelon.clear();
+        return echelon.rank() == 0 && echelon.add(v[2]);
+    }
+}
+
+int main() {
+    cout << "testing echelon and field equidistribution ...";
+    bool ok = check_echelon();
+    for (uint32_t seed = 1; ok && seed < 4; seed++) {
+        ok = check_field(seed);
+    }
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
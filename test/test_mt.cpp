@@ -2,6 +2,7 @@
 #include <iomanip>
 #include <stdint.h>
 #include <MTToolBox/MersenneTwister.hpp>
+#include <MTToolBox/MersenneTwister64.hpp>
 //#include <UnitTest++/UnitTest++.h>
 
 using namespace MTToolBox;
@@ -9,6 +10,8 @@ using namespace std;
 
 bool array_seed(void);
 bool single_seed(void);
+bool block(void);
+bool fill_array(void);
 
 int main(void)
 {
@@ -19,6 +22,12 @@ int main(void)
     if (!single_seed()) {
         return -1;
     }
+    if (!block()) {
+        return -1;
+    }
+    if (!fill_array()) {
+        return -1;
+    }
     return 0;
 }
 
@@ -68,6 +77,70 @@ bool single_seed(void)
         return false;
     }
 }
+/*
+ * 10000 番目の出力は C++11 の mt19937, mt19937_64 で規定された値
+ */
+bool block(void)
+{
+    cout << "testing block generation ...";
+    MersenneTwister mt(5489);
+    MersenneTwister64 mt64(5489);
+    for (int i = 0; i < 9999; i++) {
+        mt.next();
+        mt64.next();
+    }
+    if (mt.next() == UINT32_C(4123659995)
+        && mt64.next() == UINT64_C(9981545732273789042)) {
+        cout << "ok" << endl;
+        return true;
+    } else {
+        cout << "NG" << endl;
+        return false;
+    }
+}
+
+bool fill_array(void)
+{
+    cout << "testing fill_array ...";
+    MersenneTwister a(1234);
+    MersenneTwister b(1234);
+    MersenneTwister64 a64(1234);
+    MersenneTwister64 b64(1234);
+    uint32_t buf[2000];
+    uint64_t buf64[1000];
+    bool success = true;
+    for (int i = 0; i < 5; i++) {
+        a.next();
+        b.next();
+        a64.next();
+        b64.next();
+    }
+    a.fill_array32(buf, 2000);
+    for (int i = 0; i < 2000; i++) {
+        if (buf[i] != b.next()) {
+            success = false;
+        }
+    }
+    a64.fill_array64(buf64, 1000);
+    for (int i = 0; i < 1000; i++) {
+        if (buf64[i] != b64.next()) {
+            success = false;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        if (a.next() != b.next() || a64.next() != b64.next()) {
+            success = false;
+        }
+    }
+    if (success) {
+        cout << "ok" << endl;
+        return true;
+    } else {
+        cout << "NG" << endl;
+        return false;
+    }
+}
+
 #if 0
 SUITE(MERSENNETWISTER) {
     TEST(ARRAY_SEED)
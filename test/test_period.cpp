@@ -2,8 +2,10 @@
 #include <iomanip>
 #include <MTToolBox/period.hpp>
 #include <MTToolBox/AbstractGenerator.hpp>
+#include <MTToolBox/MersenneTwister.hpp>
 //#include <UnitTest++/UnitTest++.h>
 #include <NTL/GF2X.h>
+#include <NTL/GF2XFactoring.h>
 #include "test_generator.hpp"
 
 using namespace MTToolBox;
@@ -16,6 +18,8 @@ bool is_irreducible(void);
 bool is_prime(void);
 bool is_prime2(void);
 bool has_factor(void);
+bool irreducible_random(void);
+bool has_factor_random(void);
 
 int main()
 {
@@ -38,6 +42,12 @@ int main()
     if (!has_factor()) {
         return -1;
     }
+    if (!irreducible_random()) {
+        return -1;
+    }
+    if (!has_factor_random()) {
+        return -1;
+    }
     return 0;
 }
 
@@ -148,6 +158,122 @@ bool has_factor(void)
     return true;
 }
 
+static void random_poly(GF2X& poly, MersenneTwister& mt, long degree)
+{
+    clear(poly);
+    for (long i = 0; i < degree; i++) {
+        if (mt.getUint32() & 1) {
+            SetCoeff(poly, i, 1);
+        }
+    }
+    SetCoeff(poly, degree, 1);
+}
+
+static void random_irreducible(GF2X& poly, MersenneTwister& mt, long degree)
+{
+    do {
+        random_poly(poly, mt, degree);
+    } while (!IterIrredTest(poly));
+}
+
+/* 以前の実装 */
+static bool reference_has_factor(GF2X& poly, long degree)
+{
+    static const GF2X t2 = GF2X(2, 1);
+    static const GF2X t1 = GF2X(1, 1);
+    GF2X t2m = t2;
+    GF2X t;
+    GF2X alpha;
+    if (deg(poly) < degree) {
+        return false;
+    }
+    t = t1;
+    t += t2m;
+    for (int m = 1; deg(poly) > degree; m++) {
+        for(;;) {
+            GCD(alpha, poly, t);
+            if (IsOne(alpha)) {
+                break;
+            }
+            poly /= alpha;
+            if (deg(poly) < degree) {
+                return false;
+            }
+        }
+        t2m *= t2m;
+        t2m %= poly;
+        add(t, t2m, t1);
+    }
+    if (deg(poly) != degree) {
+        return false;
+    }
+    return IterIrredTest(poly);
+}
+
+bool irreducible_random(void)
+{
+    cout << "testing irreducible random ...";
+    MersenneTwister mt(1234);
+    const long degrees[] = {3, 7, 31, 61, 64, 89, 100, 127};
+    for (size_t i = 0; i < sizeof(degrees) / sizeof(degrees[0]); i++) {
+        for (int j = 0; j < 50; j++) {
+            GF2X poly;
+            random_poly(poly, mt, degrees[i]);
+            if (isIrreducible(poly) != static_cast<bool>(IterIrredTest(poly))) {
+                cout << "NG" << endl;
+                return false;
+            }
+        }
+    }
+    cout << "ok" << endl;
+    return true;
+}
+
+/* 既約多項式の積について以前の実装と比べる */
+bool has_factor_random(void)
+{
+    cout << "testing has factor random ...";
+    MersenneTwister mt(4321);
+    FactorStatistics stat;
+    int found = 0;
+    for (int i = 0; i < 60; i++) {
+        GF2X target;
+        random_irreducible(target, mt, 127);
+        GF2X poly = target;
+        int count = static_cast<int>(mt.getUint32() % 4);
+        for (int j = 0; j < count; j++) {
+            GF2X factor;
+            long d = 1 + static_cast<long>(mt.getUint32() % 40);
+            if (i % 10 == 9) {
+                d += 100;
+            }
+            random_irreducible(factor, mt, d);
+            poly *= factor;
+        }
+        if (i % 15 == 14) {
+            poly *= target;
+        }
+        GF2X a = poly;
+        GF2X b = poly;
+        bool ra = hasFactorOfDegree(a, 127, stat);
+        bool rb = reference_has_factor(b, 127);
+        if (ra != rb || (ra && a != target)) {
+            cout << "NG" << endl;
+            return false;
+        }
+        if (ra) {
+            found++;
+        }
+    }
+    if (stat.calls != 60 || stat.found != found || found == 0
+        || found == 60) {
+        cout << "NG" << endl;
+        return false;
+    }
+    cout << "ok" << endl;
+    return true;
+}
+
 #if 0
 SUITE(CALC_EQUIDISTRIBUTION) {
     TEST(PERIOD_U32)
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <MTToolBox/AlgorithmPipelinedSearch.hpp>
+#include <MTToolBox/AlgorithmPartialBitPattern.hpp>
+#include <MTToolBox/Cancellation.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include <NTL/GF2X.h>
+#include "test_temper_searcher.hpp"
+
+using namespace MTToolBox;
+using namespace NTL;
+using namespace std;
+
+namespace {
+    typedef AlgorithmPartialBitPattern<uint32_t, 32, 1, 23, 6, false> st32;
+    typedef AlgorithmPartialBitPattern<uint32_t, 32, 1, 9, 5, true> stlsb32;
+
+    /* 受け取ったパラメータを逐次探索と同じ方法で検算する */
+    class Checker : public PipelineResultHandler<uint32_t> {
+    public:
+        Checker() : ok(true), count(0) {}
+        bool operator()(TemperingCalculatable<uint32_t>& lg,
+                        const GF2X& poly, int weight, int delta,
+                        const int veq[]) {
+            count++;
+            if (lg.getParamString().find("tmat") == string::npos
+                || weight != NTL::weight(poly)
+                || !MersennePrimitivity(lg.bitSize(), poly)) {
+                ok = false;
+            }
+            GF2X p;
+            lg.seed(1234);
+            minpoly(p, lg);
+            int v[32];
+            AlgorithmEquidistribution<uint32_t> eq(lg, 32);
+            if (p != poly || eq.get_all_equidist(v) != delta
+                || delta > 10) {
+                ok = false;
+            }
+            for (int i = 0; i < 32; i++) {
+                if (v[i] != veq[i]) {
+                    ok = false;
+                }
+            }
+            return true;
+        }
+        bool ok;
+        int count;
+    };
+
+    /* ワーカーのスレッドで例外を投げる */
+    class Failing : public AlgorithmTempering<uint32_t> {
+    public:
+        int operator()(TemperingCalculatable<uint32_t>&, bool) {
+            throw std::domain_error("tempering failed");
+        }
+    };
+
+    /* 探索を呼んだスレッドで例外を投げる */
+    class Throwing : public PipelineResultHandler<uint32_t> {
+    public:
+        bool operator()(TemperingCalculatable<uint32_t>&, const GF2X&,
+                        int, int, const int[]) {
+            throw std::domain_error("handler failed");
+        }
+    };
+
+    /* 最初のパラメータを受け取ったら打ち切る */
+    class Cancelling : public PipelineResultHandler<uint32_t> {
+    public:
+        Cancelling(CancellationToken& t) : token(t), count(0) {}
+        bool operator()(TemperingCalculatable<uint32_t>&, const GF2X&,
+                        int, int, const int[]) {
+            count++;
+            token.cancel();
+            return true;
+        }
+        CancellationToken& token;
+        int count;
+    };
+
+    /* テンパリングの途中で打ち切る */
+    class CancellingTempering : public AlgorithmTempering<uint32_t> {
+    public:
+        CancellingTempering(CancellationToken& t) : token(t) {}
+        int operator()(TemperingCalculatable<uint32_t>&, bool) {
+            token.cancel();
+            return 0;
+        }
+        CancellationToken& token;
+    };
+
+    /*
+     * 打ち切ると上限なしの探索も終わる。テンパリングの途中で
+     * 打ち切られた候補は handler に渡されない。
+     */
+    bool check_cancel(const TemperingCalculatable<uint32_t>& lg,
+                      vector<AlgorithmTempering<uint32_t> *>& st1) {
+        vector<AlgorithmTempering<uint32_t> *> none;
+        MersenneTwister mt;
+        CancellationToken token;
+        AlgorithmPipelinedSearch<uint32_t> searcher(mt, 2);
+        searcher.setCancellation(&token);
+        Cancelling cancelling(token);
+        int found = searcher.search(lg, st1, none, cancelling, 0);
+        if (found < 1 || found != cancelling.count) {
+            return false;
+        }
+        // 打ち切られた後は候補を作らない
+        long count = searcher.getCount();
+        if (searcher.search(lg, st1, none, cancelling, 0) != 0
+            || searcher.getCount() != count) {
+            return false;
+        }
+        CancellationToken cut;
+        AlgorithmPipelinedSearch<uint32_t> tempering(mt, 2);
+        tempering.setCancellation(&cut);
+        CancellingTempering cancelling_st(cut);
+        vector<AlgorithmTempering<uint32_t> *> cancelling_sts(
+            1, &cancelling_st);
+        Checker checker;
+        return tempering.search(lg, cancelling_sts, none, checker, 0) == 0
+            && checker.count == 0;
+    }
+
+    /*
+     * 例外は止まらずに search() から投げ直される。
+     * 例外のメッセージが what なら true
+     */
+    bool check_error(const TemperingCalculatable<uint32_t>& lg,
+                     vector<AlgorithmTempering<uint32_t> *>& st1,
+                     PipelineResultHandler<uint32_t>& handler,
+                     const string& what) {
+        vector<AlgorithmTempering<uint32_t> *> none;
+        MersenneTwister mt;
+        AlgorithmPipelinedSearch<uint32_t> searcher(mt, 2);
+        try {
+            searcher.search(lg, st1, none, handler, 3);
+        } catch (std::exception& e) {
+            return what == e.what();
+        }
+        return false;
+    }
+}
+
+int main(void)
+{
+    cout << "testing pipelined search ...";
+    Tiny32 tiny(0x8f7011ee, 0xfc78ff1f, 0, 1234);
+    vector<AlgorithmTempering<uint32_t> *> st1;
+    vector<AlgorithmTempering<uint32_t> *> st2;
+    for (int i = 0; i < 2; i++) {
+        st1.push_back(new st32);
+        st2.push_back(new stlsb32);
+    }
+    MersenneTwister mt;
+    AlgorithmPipelinedSearch<uint32_t> searcher(mt, 2);
+    Checker checker;
+    int found = searcher.search(tiny, st1, st2, checker, 3);
+    if (found != 3 || checker.count != 3 || !checker.ok) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    // 候補の数の上限で止まる
+    AlgorithmPipelinedSearch<uint32_t> limited(mt, 2);
+    limited.setMaxTry(5);
+    limited.search(tiny, st1, st2, checker, 0);
+    if (limited.getCount() != 5 || !checker.ok) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    Throwing throwing;
+    if (!check_error(tiny, st1, throwing, "handler failed")) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    Failing failing;
+    vector<AlgorithmTempering<uint32_t> *> failing_st(2, &failing);
+    if (!check_error(tiny, failing_st, checker, "tempering failed")) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    if (!check_cancel(tiny, st1)) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        delete st1[i];
+        delete st2[i];
+    }
+    cout << "ok" << endl;
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <set>
+#include <string>
+#include <MTToolBox/polyio.hpp>
+#include <MTToolBox/util.hpp>
+#include <MTToolBox/MersenneTwister64.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include <NTL/GF2X.h>
+
+using namespace MTToolBox;
+using namespace NTL;
+using namespace std;
+
+namespace {
+    void random_poly(GF2X& poly, MersenneTwister64& mt, long degree) {
+        clear(poly);
+        for (long i = 0; i < degree; i++) {
+            if (mt.getUint64() & 1) {
+                SetCoeff(poly, i, 1);
+            }
+        }
+        SetCoeff(poly, degree, 1);
+    }
+
+    /* 係数をひとつずつ見る素朴な変換と比べる */
+    bool check_words(const GF2X& poly) {
+        vector<uint64_t> words;
+        poly_to_words(words, poly);
+        if (words.size() != static_cast<size_t>((deg(poly) + 64) / 64)) {
+            return false;
+        }
+        for (long i = 0; i <= deg(poly); i++) {
+            uint64_t w = words[static_cast<size_t>(i / 64)];
+            uint64_t bit = (w >> (i % 64)) & 1;
+            if (bit != static_cast<uint64_t>(IsOne(coeff(poly, i)))) {
+                return false;
+            }
+        }
+        GF2X back;
+        words_to_poly(back, words);
+        return back == poly;
+    }
+
+    bool check_stream(const vector<GF2X>& polys) {
+        stringstream ss;
+        for (size_t i = 0; i < polys.size(); i++) {
+            write_poly(ss, polys[i]);
+        }
+        for (size_t i = 0; i < polys.size(); i++) {
+            GF2X p;
+            if (!read_poly(p, ss) || p != polys[i]) {
+                return false;
+            }
+        }
+        GF2X p;
+        return !read_poly(p, ss);
+    }
+
+    /* 途中で切れたデータは読めない */
+    bool check_truncated(const GF2X& poly) {
+        stringstream ss;
+        write_poly(ss, poly);
+        string s = ss.str();
+        stringstream cut(s.substr(0, s.size() - 1));
+        GF2X p;
+        return !read_poly(p, cut);
+    }
+
+    /*
+     * 大きすぎる次数や、データより大きい次数のヘッダは読まない。
+     * 次数の分の領域を先に確保すると、ここでメモリが足りなくなる。
+     */
+    bool check_huge_degree() {
+        const int64_t degrees[] = {
+            INT64_C(0x7fffffffffffffff),
+            INT64_C(0x80000000),
+            INT64_C(0x7fffffff),
+            INT64_C(1000000)
+        };
+        for (size_t i = 0; i < sizeof(degrees) / sizeof(degrees[0]); i++) {
+            string s;
+            for (int j = 0; j < 8; j++) {
+                s += static_cast<char>(degrees[i] >> (8 * j));
+            }
+            s += string(64, '\xff');
+            stringstream ss(s);
+            GF2X p;
+            if (read_poly(p, ss)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* 一ビットだけ違う多項式のハッシュ値は違う */
+    bool check_hash(const GF2X& poly) {
+        std::set<uint64_t> hashes;
+        hashes.insert(poly_hash(poly));
+        GF2X copy = poly;
+        if (poly_hash(copy) != poly_hash(poly)) {
+            return false;
+        }
+        for (long i = 0; i < deg(poly); i++) {
+            GF2X q = poly;
+            SetCoeff(q, i, IsOne(coeff(q, i)) ? 0 : 1);
+            if (!hashes.insert(poly_hash(q)).second) {
+                return false;
+            }
+        }
+        string str;
+        poly_hash_string(str, poly);
+        return str.size() == 16;
+    }
+
+#if defined(USE_SHA)
+    /* 以前の実装と同じダイジェストになる */
+    void reference_sha1(string& str, const GF2X& poly) {
+        SHA_CTX ctx;
+        SHA1_Init(&ctx);
+        if (deg(poly) < 0) {
+            SHA1_Update(&ctx, "-1", 2);
+        }
+        for (int i = 0; i <= deg(poly); i++) {
+            if (rep(coeff(poly, i)) == 1) {
+                SHA1_Update(&ctx, "1", 1);
+            } else {
+                SHA1_Update(&ctx, "0", 1);
+            }
+        }
+        unsigned char md[SHA_DIGEST_LENGTH];
+        SHA1_Final(md, &ctx);
+        stringstream ss;
+        for (int i = 0; i < SHA_DIGEST_LENGTH; i++) {
+            ss << setfill('0') << setw(2) << hex
+               << static_cast<int>(md[i]);
+        }
+        ss >> str;
+    }
+
+    bool check_sha1(const GF2X& poly) {
+        string a;
+        string b;
+        poly_sha1(a, poly);
+        reference_sha1(b, poly);
+        return a == b;
+    }
+#endif
+}
+
+int main() {
+    cout << "testing polynomial io ...";
+    MersenneTwister64 mt(1234);
+    vector<GF2X> polys;
+    polys.push_back(GF2X());
+    const long degrees[] = {0, 1, 63, 64, 65, 127, 521, 19937};
+    for (size_t i = 0; i < sizeof(degrees) / sizeof(degrees[0]); i++) {
+        GF2X p;
+        random_poly(p, mt, degrees[i]);
+        polys.push_back(p);
+    }
+    bool ok = check_stream(polys) && check_huge_degree();
+    for (size_t i = 0; ok && i < polys.size(); i++) {
+        ok = check_words(polys[i]);
+#if defined(USE_SHA)
+        ok = ok && check_sha1(polys[i]);
+#endif
+        if (ok && deg(polys[i]) >= 0) {
+            ok = check_truncated(polys[i]);
+        }
+        if (ok && deg(polys[i]) >= 0 && deg(polys[i]) <= 1000) {
+            ok = check_hash(polys[i]);
+        }
+    }
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
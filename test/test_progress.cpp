@@ -0,0 +1,121 @@
+#include <iostream>
+#include <sstream>
+#include <math.h>
+#include <MTToolBox/SearchProgress.hpp>
+#include <MTToolBox/AlgorithmRecursionSearch.hpp>
+#include <MTToolBox/AlgorithmPrimitivity.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include "test_generator.hpp"
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    bool near(double a, double b, double eps) {
+        return fabs(a - b) <= eps * fabs(b);
+    }
+
+    bool check_probability() {
+        // 2^127 - 1 は素数
+        if (!near(SearchProgress::primitiveProbability(127), 1.0 / 127,
+                  1e-12)) {
+            return false;
+        }
+        double ratio = 1;
+        for (int i = 0; prime_factors2_128_1[i] != NULL; i++) {
+            stringstream ss(prime_factors2_128_1[i]);
+            double q;
+            ss >> q;
+            ratio *= 1 - 1 / q;
+        }
+        double p = SearchProgress::primitiveProbability(128,
+                                                        prime_factors2_128_1);
+        // 3, 5, 17, 257, ... があるので 1/128 の半分ほどになる
+        return near(p, ratio / 128, 1e-12) && p < 0.6 / 128;
+    }
+
+    /*
+     * 100 個のうち 2 個成功すると、事前の確率 1/100 を 1 個分と数えて
+     * 3/200 と推定する。
+     */
+    bool check_estimate() {
+        SearchProgress progress(0.01, 5);
+        if (progress.getRemaining() >= 0) {
+            return false;
+        }
+        for (int i = 1; i <= 100; i++) {
+            progress.addCandidate(0.001, i % 50 == 0);
+        }
+        progress.addPostProcess(0.01);
+        progress.addPostProcess(0.03);
+        if (progress.getCandidates() != 100 || progress.getFound() != 2
+            || !near(progress.getProbability(), 3.0 / 200, 1e-12)
+            || !near(progress.getCandidateCost(), 0.001, 1e-9)
+            || !near(progress.getPostProcessCost(), 0.02, 1e-9)) {
+            return false;
+        }
+        double remaining = progress.getRemaining();
+        double low;
+        double high;
+        progress.getInterval(0.9, low, high);
+        if (!(remaining > 0 && low < remaining && remaining < high)) {
+            return false;
+        }
+        progress.setTarget(2);
+        progress.getInterval(0.9, low, high);
+        return progress.getRemaining() == 0 && low == 0 && high == 0;
+    }
+
+    /* 残り 1 個なら、待ち時間は指数分布の分位点に比例する */
+    bool check_interval() {
+        SearchProgress progress(0.5, 1);
+        progress.addCandidate(0.001, false);
+        double low;
+        double high;
+        progress.getInterval(0.9, low, high);
+        return near(high / low, log(20.0) / -log(0.95), 1e-9);
+    }
+
+    bool check_report() {
+        stringstream ss;
+        SearchProgress progress(0.01, 1);
+        progress.setReport(&ss, 0);
+        progress.addCandidate(0.001, false);
+        string line = ss.str();
+        return line.find("1 candidates") != string::npos
+            && line.find("eta") != string::npos;
+    }
+
+    /* 最小多項式を計算した候補だけを数える */
+    bool check_search() {
+        SearchProgress progress(SearchProgress::primitiveProbability(127));
+        Tiny32 tiny(1234);
+        MersenneTwister mt;
+        AlgorithmRecursionSearch<uint32_t> search(tiny, mt);
+        search.setProgress(&progress);
+        if (!search.start(10000)) {
+            return false;
+        }
+        return progress.getCandidates() == search.getCount()
+            && progress.getFound() == 1 && progress.getRemaining() == 0;
+    }
+}
+
+int main() {
+    cout << "testing search progress ...";
+    bool ok;
+    try {
+        ok = check_probability() && check_estimate() && check_interval()
+            && check_report() && check_search();
+    } catch (exception& e) {
+        cout << e.what() << endl;
+        ok = false;
+    }
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
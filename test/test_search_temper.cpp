@@ -39,6 +39,22 @@ int main(void)
         cout << "NG" << endl;
         return -1;
     }
+    /*
+     * LSB からの均等分布次元は LSB からのテンパリングの直後、
+     * MSB からのテンパリングの前に表示する。
+     * テンパリングのアルゴリズムも cout に表示する。
+     */
+    streambuf * saved = cout.rdbuf(ss.rdbuf());
+    searcher.search(tiny, st32, stlsb32, true, ss);
+    cout.rdbuf(saved);
+    const string log = ss.str();
+    size_t lsb = log.find("lsb delta = ");
+    size_t msb = log.find("\ntempering parameters are found at ");
+    if (lsb == string::npos || msb == string::npos || lsb > msb
+        || log.find("lsb tempering parameters are found at ") > lsb) {
+        cout << "NG" << endl;
+        return -1;
+    }
     cout << "ok" << endl;
     return 0;
 }
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <utility>
+#include <unistd.h>
+#include <MTToolBox/SequentialShards.hpp>
+//#include <UnitTest++/UnitTest++.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    enum { mask = 0x5a, start = 1000, floor = 3, shard_count = 7 };
+
+    /* 下限で止まる */
+    bool check_floor() {
+        Sequential<uint32_t> sq(mask, 10, 8);
+        if (sq.getUint32() != (10 ^ mask) || sq.getUint32() != (9 ^ mask)
+            || sq.getUint32() != (8 ^ mask) || !sq.isExhausted()) {
+            return false;
+        }
+        try {
+            sq.getUint32();
+        } catch (underflow_error&) {
+            return true;
+        }
+        return false;
+    }
+
+    /* 偶数番目を「見つかった」ことにする探索の結果 */
+    void process(SequentialShards<uint32_t>& shards, int index, int limit,
+                 vector<pair<uint32_t, uint32_t> >& results) {
+        Sequential<uint32_t> * sq = shards.newShard(index);
+        if (sq == NULL) {
+            return;
+        }
+        try {
+            for (int i = 0; limit < 0 || i < limit; i++) {
+                uint32_t v = sq->getUint32();
+                if (v % 2 == 0) {
+                    results.push_back(make_pair(sq->getLast(), v));
+                }
+                if (i % 10 == 9) {
+                    shards.checkpoint(index, *sq);
+                }
+            }
+        } catch (underflow_error&) {
+            shards.checkpoint(index, *sq);
+        }
+        delete sq;
+    }
+
+    bool check_shards() {
+        // 分割しない場合
+        vector<pair<uint32_t, uint32_t> > expected;
+        Sequential<uint32_t> all(mask, start, floor);
+        try {
+            for (;;) {
+                uint32_t v = all.getUint32();
+                if (v % 2 == 0) {
+                    expected.push_back(make_pair(all.getLast(), v));
+                }
+            }
+        } catch (underflow_error&) {
+        }
+        // シャードが範囲を重なりなく覆う
+        SequentialShards<uint32_t> shards(mask, start, floor, shard_count);
+        uint32_t top = start;
+        for (int i = 0; i < shard_count; i++) {
+            if (shards.getShardStart(i) != top) {
+                return false;
+            }
+            top = shards.getShardFloor(i) - 1;
+        }
+        if (top != floor - 1) {
+            return false;
+        }
+        // 途中で中断して保存し、読み込んで再開する
+        vector<pair<uint32_t, uint32_t> > results;
+        for (int i = 0; i < shard_count; i++) {
+            process(shards, i, (i % 2 == 0) ? 25 : -1, results);
+        }
+        char path[] = "test_sequential.progress";
+        if (!shards.saveProgress(path) || shards.isAllDone()) {
+            return false;
+        }
+        SequentialShards<uint32_t> resumed(mask, start, floor, shard_count);
+        SequentialShards<uint32_t> other(mask, start, floor, shard_count + 1);
+        if (!resumed.loadProgress(path) || other.loadProgress(path)) {
+            return false;
+        }
+        unlink(path);
+        for (int i = resumed.claim(); i >= 0; i = resumed.claim()) {
+            process(resumed, i, -1, results);
+        }
+        if (!resumed.isAllDone()) {
+            return false;
+        }
+        SequentialShards<uint32_t>::merge(results);
+        return results == expected;
+    }
+
+    /* 範囲がシャード数より小さい */
+    bool check_small() {
+        SequentialShards<uint32_t> shards(0, 2, 0, 5);
+        set<uint32_t> values;
+        for (int i = shards.claim(); i >= 0; i = shards.claim()) {
+            Sequential<uint32_t> * sq = shards.newShard(i);
+            try {
+                for (;;) {
+                    values.insert(sq->getUint32());
+                }
+            } catch (underflow_error&) {
+            }
+            delete sq;
+        }
+        return values.size() == 3 && *values.begin() == 0
+            && *values.rbegin() == 2;
+    }
+}
+
+int main(void)
+{
+    cout << "testing sequential shards ...";
+    if (!check_floor() || !check_shards() || !check_small()) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    cout << "ok" << endl;
+    return 0;
+}
@@ -37,6 +37,7 @@ namespace MTToolBox {
         Tiny32(const Tiny32& that) :
             TemperingCalculatable<uint32_t>() {
             tiny = that.tiny;
+            reverse = that.reverse;
         }
 
         ~Tiny32() {
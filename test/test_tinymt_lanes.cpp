@@ -0,0 +1,122 @@
+#include <iostream>
+#include <stdint.h>
+#include <MTToolBox/TinyMTLanes.hpp>
+#include <MTToolBox/MersenneTwister64.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include <tinymt32.h>
+#include <tinymt64.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    enum { steps = 1000 };
+
+    /*
+     * レーンごとに乱数でパラメータと種を決め、同じパラメータと種の
+     * tinymt32 の出力と比べる。
+     * L が SIMD の幅で割り切れないときはスカラーの端数処理も通る。
+     */
+    template<int L>
+    bool check32(uint64_t seed) {
+        MersenneTwister64 mt(seed);
+        TinyMT32Lanes<L> lanes;
+        tinymt32_t ref[L];
+        for (int l = 0; l < L; l++) {
+            ref[l].mat1 = static_cast<uint32_t>(mt.next());
+            ref[l].mat2 = static_cast<uint32_t>(mt.next());
+            ref[l].tmat = static_cast<uint32_t>(mt.next());
+            uint32_t s = static_cast<uint32_t>(mt.next());
+            if (l == 0) {
+                // パラメータがすべて 0 のレーンも混ぜる
+                ref[l].mat1 = 0;
+                ref[l].mat2 = 0;
+                ref[l].tmat = 0;
+                s = 0;
+            }
+            lanes.setParam(l, ref[l].mat1, ref[l].mat2, ref[l].tmat);
+            lanes.seed(l, s);
+            tinymt32_init(&ref[l], s);
+        }
+        uint32_t out[L];
+        for (int t = 0; t < steps; t++) {
+            lanes.generate(out);
+            for (int l = 0; l < L; l++) {
+                uint32_t r = tinymt32_generate_uint32(&ref[l]);
+                if (out[l] != r) {
+                    cout << "NG lanes32 L = " << L << " lane = " << l
+                         << " step = " << t << endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template<int L>
+    bool check64(uint64_t seed) {
+        MersenneTwister64 mt(seed);
+        TinyMT64Lanes<L> lanes;
+        tinymt64_t ref[L];
+        for (int l = 0; l < L; l++) {
+            ref[l].mat1 = static_cast<uint32_t>(mt.next());
+            ref[l].mat2 = static_cast<uint32_t>(mt.next());
+            ref[l].tmat = mt.next();
+            uint64_t s = mt.next();
+            lanes.setParam(l, ref[l].mat1, ref[l].mat2, ref[l].tmat);
+            lanes.seed(l, s);
+            tinymt64_init(&ref[l], s);
+        }
+        uint64_t out[L];
+        for (int t = 0; t < steps; t++) {
+            lanes.generate(out);
+            for (int l = 0; l < L; l++) {
+                uint64_t r = tinymt64_generate_uint64(&ref[l]);
+                if (out[l] != r) {
+                    cout << "NG lanes64 L = " << L << " lane = " << l
+                         << " step = " << t << endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /* fill_array() は generate() を並べたものと同じ */
+    bool check_fill() {
+        TinyMT32Lanes<8> a;
+        TinyMT32Lanes<8> b;
+        for (int l = 0; l < 8; l++) {
+            uint32_t m = static_cast<uint32_t>(l) * UINT32_C(0x9e3779b9);
+            a.setParam(l, m, ~m, m ^ UINT32_C(0x12345678));
+            b.setParam(l, m, ~m, m ^ UINT32_C(0x12345678));
+        }
+        a.seed(5489);
+        b.seed(5489);
+        uint32_t array[8 * 10];
+        a.fill_array(array, 10);
+        uint32_t out[8];
+        for (int t = 0; t < 10; t++) {
+            b.generate(out);
+            for (int l = 0; l < 8; l++) {
+                if (array[t * 8 + l] != out[l]) {
+                    cout << "NG fill_array" << endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    cout << "testing tinymt lanes ...";
+    if (check32<16>(1) && check32<8>(2) && check32<5>(3) && check32<1>(4)
+        && check64<16>(5) && check64<8>(6) && check64<5>(7)
+        && check64<1>(8) && check_fill()) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        return 1;
+    }
+}
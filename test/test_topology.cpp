@@ -0,0 +1,158 @@
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <MTToolBox/Topology.hpp>
+#include <MTToolBox/Parallel.hpp>
+//#include <UnitTest++/UnitTest++.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    void put(const string& path, const string& value) {
+        FILE * fp = fopen(path.c_str(), "w");
+        if (fp != NULL) {
+            fputs(value.c_str(), fp);
+            fputs("\n", fp);
+            fclose(fp);
+        }
+    }
+
+    string num(int n) {
+        stringstream ss;
+        ss << dec << n;
+        return ss.str();
+    }
+
+    /*
+     * 2 ソケット、ソケットあたり 2 コア、コアあたり 2 スレッド、
+     * LLC はソケットごとに 1MB。CPU の番号は Linux の多くの計算機と
+     * 同じく、兄弟スレッドが後半に来る。
+     * node0: 0 1 4 5, node1: 2 3 6 7, 兄弟は (0,4) (1,5) (2,6) (3,7)
+     */
+    void make_sysfs(const string& root) {
+        mkdir(root.c_str(), 0777);
+        mkdir((root + "/cpu").c_str(), 0777);
+        mkdir((root + "/node").c_str(), 0777);
+        put(root + "/cpu/online", "0-7");
+        put(root + "/node/online", "0-1");
+        mkdir((root + "/node/node0").c_str(), 0777);
+        mkdir((root + "/node/node1").c_str(), 0777);
+        put(root + "/node/node0/cpulist", "0-1,4-5");
+        put(root + "/node/node1/cpulist", "2-3,6-7");
+        for (int cpu = 0; cpu < 8; cpu++) {
+            string dir = root + "/cpu/cpu" + num(cpu);
+            mkdir(dir.c_str(), 0777);
+            mkdir((dir + "/topology").c_str(), 0777);
+            put(dir + "/topology/thread_siblings_list",
+                num(cpu % 4) + "," + num(cpu % 4 + 4));
+            mkdir((dir + "/cache").c_str(), 0777);
+            const char * types[] = {"Data", "Instruction", "Unified"};
+            const char * levels[] = {"1", "1", "3"};
+            for (int i = 0; i < 3; i++) {
+                string idx = dir + "/cache/index" + num(i);
+                mkdir(idx.c_str(), 0777);
+                put(idx + "/type", types[i]);
+                put(idx + "/level", levels[i]);
+                if (i < 2) {
+                    put(idx + "/size", "32K");
+                    put(idx + "/shared_cpu_list",
+                        num(cpu % 4) + "," + num(cpu % 4 + 4));
+                } else {
+                    put(idx + "/size", "1024K");
+                    put(idx + "/shared_cpu_list",
+                        cpu % 4 < 2 ? "0-1,4-5" : "2-3,6-7");
+                }
+            }
+        }
+    }
+
+    void remove_sysfs(const string& root) {
+        string command = "rm -rf '" + root + "'";
+        if (system(command.c_str()) != 0) {
+            cerr << "can't remove " << root << endl;
+        }
+    }
+
+    bool check_fake(const string& root) {
+        CpuTopology topology(root);
+        if (topology.getCpus() != 8 || topology.getNodes() != 2
+            || topology.getCacheDomains() != 2
+            || topology.getCacheSize() != 1024 * 1024
+            || topology.getNode(4) != 0 || topology.getNode(6) != 1
+            || topology.getNode(8) != -1) {
+            return false;
+        }
+        // ノードを交互に、コアごとにひとつ置いてから兄弟を使う
+        const int expected[] = {0, 2, 1, 3, 4, 6, 5, 7, 0};
+        for (int i = 0; i < 9; i++) {
+            if (topology.placement(i) != expected[i]) {
+                return false;
+            }
+        }
+        return topology.concurrencyFor(0) == 8
+            && topology.concurrencyFor(300 * 1024) == 6
+            && topology.concurrencyFor(100 * 1024) == 8
+            && topology.concurrencyFor(2 * 1024 * 1024) == 2;
+    }
+
+    bool check_working_set() {
+        // 19937 ビットは 312 ワード
+        return CpuTopology::workingSet(19937, 2) == 2 * (312 * 8 + 64);
+    }
+
+    class WhereJob : public Runnable {
+    public:
+        WhereJob(int count) : cpus(static_cast<size_t>(count), -1) {}
+        void run(int index) {
+            cpus[static_cast<size_t>(index)] = sched_getcpu();
+        }
+        vector<int> cpus;
+    };
+
+    /* 固定したワーカーは placement() の CPU で動く */
+    bool check_pinning() {
+        const CpuTopology& topology = CpuTopology::system();
+        if (topology.getCpus() < 1) {
+            return false;
+        }
+        int count = topology.getCpus() + 1;
+        WhereJob job(count);
+        WorkerPool::setPinning(true);
+        {
+            WorkerPool pool;
+            pool.start(job, count);
+            pool.join();
+        }
+        WorkerPool::setPinning(false);
+        for (int i = 0; i < count; i++) {
+            if (job.cpus[static_cast<size_t>(i)] != topology.placement(i)) {
+                return false;
+            }
+        }
+        return !WorkerPool::getPinning();
+    }
+}
+
+int main() {
+    cout << "testing cpu topology ...";
+    stringstream ss;
+    ss << "test_topology." << dec << getpid();
+    string root = ss.str();
+    make_sysfs(root);
+    bool ok = check_fake(root) && check_working_set() && check_pinning();
+    remove_sysfs(root);
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}
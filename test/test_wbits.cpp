@@ -0,0 +1,295 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <MTToolBox/wbits.hpp>
+#include <MTToolBox/AlgorithmEquidistribution.hpp>
+#include <MTToolBox/TestLinearity.hpp>
+#include <MTToolBox/MersenneTwister64.hpp>
+//#include <UnitTest++/UnitTest++.h>
+#include "test_generator.hpp"
+
+using namespace MTToolBox;
+using namespace NTL;
+using namespace std;
+
+namespace {
+    /*
+     * N/64 個の連続する tinymt64 の出力を連結して N ビットの出力とする。
+     * 最初の出力が最上位になる。
+     */
+    template<int N>
+    class WideTiny64 : public EquidistributionCalculatable<wbits<N> > {
+    public:
+        WideTiny64(uint64_t seed) {
+            tiny.mat1 = 0xfa051f40;
+            tiny.mat2 = 0xffd0fff4;
+            tiny.tmat = UINT64_C(0x58d02ffeffbfffbc);
+            tinymt64_init(&tiny, seed);
+        }
+        WideTiny64(const WideTiny64<N>& that) :
+            EquidistributionCalculatable<wbits<N> >() {
+            tiny = that.tiny;
+        }
+        WideTiny64<N> * clone() const {
+            return new WideTiny64<N>(*this);
+        }
+        wbits<N> generate() {
+            wbits<N> r;
+            for (int i = N / 64 - 1; i >= 0; i--) {
+                r.u64[i] = tinymt64_generate_uint64(&tiny);
+            }
+            return r;
+        }
+        wbits<N> generate(int outBitLen) {
+            return generate() & wbits_msb_mask<N>(outBitLen);
+        }
+        void seed(wbits<N> value) {
+            tinymt64_init(&tiny, value.u64[0]);
+        }
+        int bitSize() const {
+            return tinymt64_get_mexp(&tiny);
+        }
+        void add(EquidistributionCalculatable<wbits<N> >& other) {
+            WideTiny64<N>* that = dynamic_cast<WideTiny64<N> *>(&other);
+            if (that == 0) {
+                throw std::invalid_argument(
+                    "the adder should have the same type as the addee.");
+            }
+            tiny.status[0] ^= that->tiny.status[0];
+            tiny.status[1] ^= that->tiny.status[1];
+        }
+        void setZero() {
+            tiny.status[0] = 0;
+            tiny.status[1] = 0;
+        }
+        bool isZero() const {
+            return (tiny.status[0] & TINYMT64_MASK) == 0
+                && tiny.status[1] == 0;
+        }
+        void setUpParam(ParameterGenerator&) {}
+        const std::string getHeaderString() {
+            return "";
+        }
+        const std::string getParamString() {
+            return "";
+        }
+    private:
+        tinymt64_t tiny;
+    };
+
+    /* 上位 64 ビットだけを返す、WideTiny64<N> と同じ状態遷移の生成器 */
+    template<int N>
+    class TopTiny64 : public EquidistributionCalculatable<uint64_t> {
+    public:
+        TopTiny64(uint64_t seed) : wide(seed) {}
+        TopTiny64<N> * clone() const {
+            return new TopTiny64<N>(*this);
+        }
+        uint64_t generate() {
+            return wide.generate().u64[N / 64 - 1];
+        }
+        uint64_t generate(int outBitLen) {
+            uint64_t mask = ~UINT64_C(0) << (64 - outBitLen);
+            return generate() & mask;
+        }
+        void seed(uint64_t value) {
+            wide.seed(convert<wbits<N> >(value));
+        }
+        int bitSize() const {
+            return wide.bitSize();
+        }
+        void add(EquidistributionCalculatable<uint64_t>& other) {
+            TopTiny64<N>* that = dynamic_cast<TopTiny64<N> *>(&other);
+            wide.add(that->wide);
+        }
+        void setZero() {
+            wide.setZero();
+        }
+        bool isZero() const {
+            return wide.isZero();
+        }
+        void setUpParam(ParameterGenerator&) {}
+        const std::string getHeaderString() {
+            return "";
+        }
+        const std::string getParamString() {
+            return "";
+        }
+    private:
+        WideTiny64<N> wide;
+    };
+
+    /* 上位 N/2 ビットに WideTiny64<N/2> の出力を置く */
+    template<int N>
+    class HalfTiny64 : public EquidistributionCalculatable<wbits<N> > {
+    public:
+        HalfTiny64(uint64_t seed) : half(seed) {}
+        HalfTiny64<N> * clone() const {
+            return new HalfTiny64<N>(*this);
+        }
+        wbits<N> generate() {
+            wbits<N / 2> h = half.generate();
+            wbits<N> r;
+            for (int i = 0; i < N / 128; i++) {
+                r.u64[i] = 0;
+                r.u64[i + N / 128] = h.u64[i];
+            }
+            return r;
+        }
+        wbits<N> generate(int outBitLen) {
+            return generate() & wbits_msb_mask<N>(outBitLen);
+        }
+        void seed(wbits<N> value) {
+            half.seed(convert<wbits<N / 2> >(value.u64[0]));
+        }
+        int bitSize() const {
+            return half.bitSize();
+        }
+        void add(EquidistributionCalculatable<wbits<N> >& other) {
+            HalfTiny64<N>* that = dynamic_cast<HalfTiny64<N> *>(&other);
+            half.add(that->half);
+        }
+        void setZero() {
+            half.setZero();
+        }
+        bool isZero() const {
+            return half.isZero();
+        }
+        void setUpParam(ParameterGenerator&) {}
+        const std::string getHeaderString() {
+            return "";
+        }
+        const std::string getParamString() {
+            return "";
+        }
+    private:
+        WideTiny64<N / 2> half;
+    };
+
+    /* 1ビットずつ計算する参照実装と比較する */
+    template<int N>
+    bool check_primitives(MersenneTwister64& mt) {
+        for (int k = 0; k < 200; k++) {
+            wbits<N> x;
+            wbits<N> y;
+            for (int i = 0; i < N / 64; i++) {
+                x.u64[i] = mt.getUint64();
+                y.u64[i] = mt.getUint64();
+                if (k % 4 == 0) {
+                    x.u64[i] &= mt.getUint64() & mt.getUint64();
+                }
+            }
+            int s = static_cast<int>(mt.getUint64() % (N + 1));
+            wbits<N> a = x ^ y;
+            wbits<N> b = x & y;
+            wbits<N> c = x | y;
+            wbits<N> d = ~x;
+            wbits<N> l = x << s;
+            wbits<N> r = x >> s;
+            wbits<N> rev = reverse_bit(x);
+            int count = 0;
+            int pos = -1;
+            for (int i = 0; i < N; i++) {
+                unsigned int xi = getBitOfPos(x, i);
+                unsigned int yi = getBitOfPos(y, i);
+                count += xi;
+                if (xi && pos < 0) {
+                    pos = N - 1 - i;
+                }
+                if (getBitOfPos(a, i) != (xi ^ yi)
+                    || getBitOfPos(b, i) != (xi & yi)
+                    || getBitOfPos(c, i) != (xi | yi)
+                    || getBitOfPos(d, i) != (xi ^ 1)
+                    || getBitOfPos(rev, N - 1 - i) != xi) {
+                    return false;
+                }
+                unsigned int li = (i >= s) ? getBitOfPos(x, i - s) : 0;
+                unsigned int ri = (i + s < N) ? getBitOfPos(x, i + s) : 0;
+                if (getBitOfPos(l, i) != li || getBitOfPos(r, i) != ri) {
+                    return false;
+                }
+            }
+            if (count_bit(x) != count || calc_1pos(x) != pos) {
+                return false;
+            }
+            if (isZero(x) != (count == 0) || !(a == (y ^ x))
+                || a != (x ^ y) || isZero(x ^ x) == false) {
+                return false;
+            }
+            wbits<N> z = x;
+            setBitOfPos(&z, s % N, 1);
+            if (getBitOfPos(z, s % N) != 1) {
+                return false;
+            }
+            setBitOfPos(&z, s % N, 0);
+            if (getBitOfPos(z, s % N) != 0) {
+                return false;
+            }
+            vec_GF2 vec;
+            toGF2Vec(vec, x);
+            if (!(fromGF2Vec<wbits<N> >(vec) == x)) {
+                return false;
+            }
+        }
+        wbits<N> zero;
+        setZero(zero);
+        if (!isZero(zero) || calc_1pos(zero) != -1
+            || calc_1pos(getOne<wbits<N> >()) != N - 1
+            || count_bit(wbits_msb_mask<N>(N)) != N
+            || calc_1pos(wbits_msb_mask<N>(3)) != 2
+            || count_bit(wbits_msb_mask<N>(0)) != 0) {
+            return false;
+        }
+        return true;
+    }
+
+    /* v <= 64 では上位 64 ビットだけを見る生成器と同じ k(v) になる */
+    template<int N>
+    bool check_equidist() {
+        WideTiny64<N> wide(1234);
+        TestLinearity<wbits<N> > tl;
+        if (!tl(wide)) {
+            return false;
+        }
+        AlgorithmEquidistribution<wbits<N> > weq(wide, N);
+        int wveq[N];
+        weq.get_all_equidist(wveq);
+        TopTiny64<N> top(1234);
+        AlgorithmEquidistribution<uint64_t> teq(top, 64);
+        int tveq[64];
+        teq.get_all_equidist(tveq);
+        for (int i = 0; i < 64; i++) {
+            if (wveq[i] != tveq[i]) {
+                return false;
+            }
+        }
+        HalfTiny64<N * 2> half(1234);
+        AlgorithmEquidistribution<wbits<N * 2> > heq(half, N);
+        int hveq[N];
+        heq.get_all_equidist(hveq);
+        for (int i = 0; i < N; i++) {
+            if (wveq[i] != hveq[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(void)
+{
+    cout << "testing wbits ...";
+    MersenneTwister64 mt(1234);
+    if (!check_primitives<128>(mt)
+        || !check_primitives<256>(mt)
+        || !check_primitives<512>(mt)) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    if (!check_equidist<128>() || !check_equidist<256>()) {
+        cout << "NG" << endl;
+        return -1;
+    }
+    cout << "ok" << endl;
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <MTToolBox/WorkQueue.hpp>
+#include <MTToolBox/Sequential.hpp>
+//#include <UnitTest++/UnitTest++.h>
+
+using namespace MTToolBox;
+using namespace std;
+
+namespace {
+    enum { start = 3000, floor = 5, range_count = 13, workers = 4 };
+
+    /* 7 の倍数を「見つかった」ことにする */
+    bool is_found(uint64_t v) {
+        return v % 7 == 0;
+    }
+
+    const string to_line(uint64_t v) {
+        stringstream ss;
+        ss << "param " << dec << v;
+        return ss.str();
+    }
+
+    /*
+     * ワーカー
+     * limit 個の範囲を探索したら終わる。limit が負なら全部。
+     */
+    void work(const string& path, int limit) {
+        WorkQueue queue(path);
+        WorkItem item;
+        for (int n = 0; limit < 0 || n < limit; n++) {
+            if (!queue.claim(item)) {
+                break;
+            }
+            Sequential<uint64_t> sq(0, item.start, item.floor);
+            uint64_t tried = 0;
+            uint64_t found = 0;
+            try {
+                for (;;) {
+                    uint64_t v = sq.getUint64();
+                    tried++;
+                    if (is_found(v)) {
+                        queue.report(item, sq.getLast(), to_line(v));
+                        found++;
+                    }
+                }
+            } catch (underflow_error&) {
+            }
+            queue.complete(item, tried, found);
+        }
+    }
+
+    /* 範囲を取ったまま終了する */
+    void abandon(const string& path) {
+        WorkQueue queue(path);
+        WorkItem item;
+        queue.claim(item);
+    }
+
+    /* 途中でやめて範囲を返す */
+    bool check_release(const string& path) {
+        WorkQueue queue(path);
+        WorkItem item;
+        if (!queue.claim(item)) {
+            return false;
+        }
+        Sequential<uint64_t> sq(0, item.start, item.floor);
+        uint64_t tried = 0;
+        uint64_t found = 0;
+        for (int i = 0; i < 20; i++) {
+            uint64_t v = sq.getUint64();
+            tried++;
+            if (is_found(v)) {
+                queue.report(item, sq.getLast(), to_line(v));
+                found++;
+            }
+        }
+        queue.release(item, sq.getStatus(), tried, found);
+        WorkItem again;
+        if (!queue.claim(again)) {
+            return false;
+        }
+        bool ok = again.index == item.index && again.start == sq.getStatus();
+        queue.release(again, again.start, 0, 0);
+        return ok;
+    }
+
+    /* 最初に見つけたパラメータを報告して、範囲を返さずに終了する */
+    void report_and_abandon(const string& path) {
+        WorkQueue queue(path);
+        WorkItem item;
+        if (!queue.claim(item)) {
+            return;
+        }
+        Sequential<uint64_t> sq(0, item.start, item.floor);
+        uint64_t v;
+        do {
+            v = sq.getUint64();
+        } while (!is_found(v));
+        queue.report(item, sq.getLast(), to_line(v));
+    }
+
+    bool check_checkpoint(const string& path) {
+        uint64_t before;
+        {
+            WorkQueue queue(path);
+            before = queue.getReported();
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            return false;
+        }
+        if (pid == 0) {
+            try {
+                report_and_abandon(path);
+            } catch (exception& e) {
+                cerr << e.what() << endl;
+                _exit(1);
+            }
+            _exit(0);
+        }
+        int status;
+        if (waitpid(pid, &status, 0) < 0
+            || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            return false;
+        }
+        // 止まったワーカーの範囲は、報告したパラメータの次から取り直される
+        WorkQueue queue(path);
+        WorkItem item;
+        if (!queue.claim(item) || queue.getReported() != before + 1) {
+            return false;
+        }
+        uint64_t key = item.start + 1;
+        vector<pair<uint64_t, string> > results;
+        queue.collect(results);
+        bool ok = false;
+        for (size_t i = 0; i < results.size(); i++) {
+            if (results[i].first == key) {
+                ok = true;
+            }
+        }
+        // 同じパラメータをもう一度報告しても数えない
+        ok = ok && queue.report(item, key, to_line(key)) == before + 1;
+        queue.release(item, item.start, 0, 0);
+        return ok;
+    }
+
+    bool spawn(const string& path, int limit, bool do_abandon,
+               vector<pid_t>& pids) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            return false;
+        }
+        if (pid == 0) {
+            try {
+                if (do_abandon) {
+                    abandon(path);
+                } else {
+                    work(path, limit);
+                }
+            } catch (exception& e) {
+                cerr << e.what() << endl;
+                _exit(1);
+            }
+            _exit(0);
+        }
+        pids.push_back(pid);
+        return true;
+    }
+
+    bool wait_all(vector<pid_t>& pids) {
+        bool ok = true;
+        for (size_t i = 0; i < pids.size(); i++) {
+            int status;
+            if (waitpid(pids[i], &status, 0) < 0
+                || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                ok = false;
+            }
+        }
+        pids.clear();
+        return ok;
+    }
+
+    bool check_queue(const string& path) {
+        WorkQueue::create(path, start, floor, range_count);
+        try {
+            WorkQueue::create(path, start, floor, range_count);
+            return false;
+        } catch (runtime_error&) {
+        }
+        if (!check_release(path)) {
+            cout << "release NG" << endl;
+            return false;
+        }
+        if (!check_checkpoint(path)) {
+            cout << "checkpoint NG" << endl;
+            return false;
+        }
+        vector<pid_t> pids;
+        // 範囲を取ったまま終了したワーカーの分は取り直される
+        if (!spawn(path, 0, true, pids) || !wait_all(pids)) {
+            return false;
+        }
+        // 一部だけ探索して終わるワーカー
+        if (!spawn(path, 2, false, pids) || !wait_all(pids)) {
+            return false;
+        }
+        for (int i = 0; i < workers; i++) {
+            if (!spawn(path, -1, false, pids)) {
+                return false;
+            }
+        }
+        if (!wait_all(pids)) {
+            cout << "worker NG" << endl;
+            return false;
+        }
+        WorkQueue queue(path);
+        if (!queue.isAllDone()) {
+            cout << "not done" << endl;
+            return false;
+        }
+        uint64_t tried;
+        uint64_t found;
+        queue.getStatistics(tried, found);
+        vector<pair<uint64_t, string> > results;
+        queue.collect(results);
+        vector<pair<uint64_t, string> > expected;
+        for (uint64_t v = start; v >= floor; v--) {
+            if (is_found(v)) {
+                expected.push_back(make_pair(v, to_line(v)));
+            }
+        }
+        if (results != expected) {
+            cout << "results NG" << endl;
+            return false;
+        }
+        if (tried != start - floor + 1 || found != expected.size()) {
+            cout << "statistics NG tried = " << dec << tried
+                 << " found = " << found << endl;
+            return false;
+        }
+        return true;
+    }
+
+    void remove_queue(const string& path) {
+        unlink(path.c_str());
+        unlink((path + ".lock").c_str());
+        unlink((path + ".results").c_str());
+        unlink((path + ".tmp").c_str());
+    }
+}
+
+int main() {
+    stringstream ss;
+    ss << "test_workqueue." << dec << getpid() << ".queue";
+    string path = ss.str();
+    cout << "testing work queue ...";
+    bool ok;
+    try {
+        ok = check_queue(path);
+    } catch (exception& e) {
+        cout << e.what() << endl;
+        ok = false;
+    }
+    remove_queue(path);
+    if (ok) {
+        cout << "ok" << endl;
+        return 0;
+    } else {
+        cout << "NG" << endl;
+        return 1;
+    }
+}